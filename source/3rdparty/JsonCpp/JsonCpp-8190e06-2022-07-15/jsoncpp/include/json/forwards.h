@@ -34,6 +34,7 @@ class StaticString;
 class Path;
 class PathArgument;
 class Value;
+class ValueArena;
 class ValueIteratorBase;
 class ValueIterator;
 class ValueConstIterator;
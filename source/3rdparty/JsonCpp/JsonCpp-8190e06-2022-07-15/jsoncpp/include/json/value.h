@@ -40,10 +40,12 @@
 #endif
 
 #include <array>
+#include <cstdint>
 #include <exception>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // Disable warning C4251: <data member>: <type> needs to have dll-interface to
@@ -157,6 +159,120 @@ private:
   const char* c_str_;
 };
 
+/** \brief Monotonic memory for the Values of a whole document.
+ *
+ * While a ValueArena::Scope is alive, the Values created or copied by the
+ * current thread take their strings, member names and objects from the arena.
+ * The arena hands them out of a few large blocks, and releases them all at
+ * once when it is destroyed: building, copying and destroying a document costs
+ * a few allocations instead of several per member.
+ *
+ * The arena must outlive the Values built in its scope. Copying such a Value
+ * outside of the scope makes an ordinary (heap) copy, moving or swapping it
+ * does not.
+ *
+ * Example of usage:
+ * \code
+ * Json::ValueArena arena;
+ * Json::Value root;
+ * {
+ *   Json::ValueArena::Scope scope(arena);
+ *   reader->parse(begin, end, &root, &errs);
+ * }
+ * \endcode
+ */
+class JSON_API ValueArena {
+public:
+  /// \param blockSize Size of the first block, doubled for each new block.
+  explicit ValueArena(size_t blockSize = 64 * 1024);
+  ~ValueArena();
+  ValueArena(const ValueArena&) = delete;
+  ValueArena& operator=(const ValueArena&) = delete;
+
+  /// Returns memory that is only released by ~ValueArena(). \p alignment
+  /// is a power of two.
+  void* allocate(size_t size, size_t alignment) {
+    size_t padding =
+        (0 - reinterpret_cast<uintptr_t>(next_)) & (alignment - 1);
+    if (next_ == nullptr || static_cast<size_t>(end_ - next_) < padding + size)
+      return allocateBlock(size, alignment);
+    char* memory = next_ + padding;
+    next_ = memory + size;
+    used_ += size;
+    return memory;
+  }
+  /// Number of blocks allocated from the heap.
+  size_t blockCount() const { return blocks_.size(); }
+  /// Number of bytes handed out.
+  size_t bytesUsed() const { return used_; }
+
+  /// Arena of the innermost Scope of the current thread, or nullptr.
+  static ValueArena* current();
+
+  /// Makes an arena the current one of the thread for its lifetime.
+  class JSON_API Scope {
+  public:
+    explicit Scope(ValueArena& arena);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ValueArena* previous_;
+  };
+
+private:
+  void* allocateBlock(size_t size, size_t alignment);
+
+  std::vector<std::pair<char*, size_t> > blocks_;
+  size_t blockSize_;
+  char* next_;
+  char* end_;
+  size_t used_;
+};
+
+/** \brief Allocator of the members of an object or array: from the
+ * ValueArena that was current when the object was created, or from the heap.
+ */
+template <typename T> class ValueAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ValueAllocator() : arena_(ValueArena::current()) {}
+  template <typename U>
+  ValueAllocator(const ValueAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_)
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) {
+    if (!arena_)
+      std::allocator<T>().deallocate(p, n);
+  }
+  /// A copy takes its memory from the current arena, not the original's.
+  ValueAllocator select_on_container_copy_construction() const {
+    return ValueAllocator();
+  }
+  ValueArena* arena() const { return arena_; }
+
+private:
+  ValueArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ValueAllocator<T>& a, const ValueAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+template <typename T, typename U>
+bool operator!=(const ValueAllocator<T>& a, const ValueAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represents a:
@@ -260,7 +376,14 @@ private:
 #ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
   class CZString {
   public:
-    enum DuplicationPolicy { noDuplication = 0, duplicate, duplicateOnCopy };
+    // duplicateOnCopy is also used for member names in a ValueArena, and
+    // inlineStorage for short ones kept in cstr_ itself.
+    enum DuplicationPolicy {
+      noDuplication = 0,
+      duplicate,
+      duplicateOnCopy,
+      inlineStorage
+    };
     CZString(ArrayIndex index);
     CZString(char const* str, unsigned length, DuplicationPolicy allocate);
     CZString(CZString const& other);
@@ -279,6 +402,7 @@ private:
 
   private:
     void swap(CZString& other);
+    void duplicateKey(char const* str, unsigned length);
 
     struct StringStorage {
       unsigned policy_ : 2;
@@ -293,7 +417,9 @@ private:
   };
 
 public:
-  typedef std::map<CZString, Value> ObjectValues;
+  typedef std::map<CZString, Value, std::less<CZString>,
+                   ValueAllocator<std::pair<const CZString, Value> > >
+      ObjectValues;
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
 public:
@@ -600,6 +726,9 @@ private:
   void setIsAllocated(bool v) { bits_.allocated_ = v; }
 
   void initBasic(ValueType type, bool allocated = false);
+  void initString(char const* str, unsigned length);
+  void initMap(const ObjectValues* other);
+  bool decodeString(unsigned* length, char const** str) const;
   void dupPayload(const Value& other);
   void releasePayload();
   void dupMeta(const Value& other);
@@ -623,6 +752,7 @@ private:
     bool bool_;
     char* string_; // if allocated_, ptr to { unsigned, char[] }.
     ObjectValues* map_;
+    char chars_[sizeof(double)]; // if inline_, null-terminated.
   } value_;
 
   struct {
@@ -630,6 +760,10 @@ private:
     unsigned int value_type_ : 8;
     // Unless allocated_, string_ must be null-terminated.
     unsigned int allocated_ : 1;
+    // string_ or map_ belongs to a ValueArena, and is not released.
+    unsigned int arena_ : 1;
+    // Length + 1 of a short string stored in chars_, or 0.
+    unsigned int inline_ : 4;
   } bits_;
 
   class Comments {
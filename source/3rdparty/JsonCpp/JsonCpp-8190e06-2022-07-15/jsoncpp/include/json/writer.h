@@ -9,6 +9,7 @@
 #if !defined(JSON_IS_AMALGAMATION)
 #include "value.h"
 #endif // if !defined(JSON_IS_AMALGAMATION)
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -343,6 +344,51 @@ private:
 #pragma warning(pop)
 #endif
 
+/** \brief Writes a Value to a file descriptor or an OStream through a fixed
+ * size buffer.
+ *
+ * Nothing is built as an intermediate String: keys, strings and numbers are
+ * escaped and converted straight into the buffer, which is written out each
+ * time it fills up. Doubles are written with the shortest representation
+ * that reads back as the same value (when the standard library provides
+ * std::to_chars), rather than with "%.17g".
+ *
+ * The \c pretty style has the layout of StreamWriterBuilder's defaults (tab
+ * indentation, all comments). The \c compact style has no whitespace and
+ * drops comments.
+ *
+ * Usage:
+ * \code
+ *   Json::BufferedWriter writer(Json::BufferedWriter::compact);
+ *   if (writer.write(root, fd) != 0)
+ *     perror("write");
+ * \endcode
+ */
+class JSON_API BufferedWriter {
+public:
+  enum Style { compact, pretty };
+
+  explicit BufferedWriter(Style style = pretty, size_t bufferSize = 64 * 1024);
+  ~BufferedWriter();
+
+  BufferedWriter(BufferedWriter const&) = delete;
+  BufferedWriter& operator=(BufferedWriter const&) = delete;
+
+  /** Write \p root to the file descriptor \p fd.
+   * \return 0, or -1 (with errno set) if a write failed.
+   */
+  int write(Value const& root, int fd);
+
+  /** Write \p root to \p sout.
+   * \return 0, or -1 if \p sout went bad.
+   */
+  int write(Value const& root, OStream* sout);
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 #if defined(JSON_HAS_INT64)
 String JSON_API valueToString(Int value);
 String JSON_API valueToString(UInt value);
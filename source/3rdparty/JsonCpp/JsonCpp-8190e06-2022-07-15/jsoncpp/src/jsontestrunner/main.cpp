@@ -14,11 +14,14 @@
  */
 
 #include <algorithm> // sort
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <json/json.h>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 struct Options {
   Json::String path;
@@ -26,6 +29,8 @@ struct Options {
   bool parseOnly;
   using writeFuncType = Json::String (*)(Json::Value const&);
   writeFuncType write;
+  int benchmarkIterations;
+  std::vector<Json::String> benchmarkPaths;
 };
 
 static Json::String normalizeFloatingPointStr(double value) {
@@ -230,16 +235,28 @@ static void printConfig() {
 static int printUsage(const char* argv[]) {
   std::cout << "Usage: " << argv[0] << " [--strict] input-json-file"
             << std::endl;
+  std::cout << "       " << argv[0]
+            << " --benchmark iterations input-json-file..." << std::endl;
   return 3;
 }
 
 static int parseCommandLine(int argc, const char* argv[], Options* opts) {
   opts->parseOnly = false;
   opts->write = &useStyledWriter;
+  opts->benchmarkIterations = 0;
   if (argc < 2) {
     return printUsage(argv);
   }
   int index = 1;
+  if (Json::String(argv[index]) == "--benchmark") {
+    ++index;
+    opts->benchmarkIterations = index < argc ? atoi(argv[index++]) : 0;
+    if (opts->benchmarkIterations <= 0 || index == argc) {
+      return printUsage(argv);
+    }
+    opts->benchmarkPaths.assign(argv + index, argv + argc);
+    return 0;
+  }
   if (Json::String(argv[index]) == "--json-checker") {
     opts->features = Json::Features::strictMode();
     opts->parseOnly = true;
@@ -311,6 +328,99 @@ static int runTest(Options const& opts, bool use_legacy) {
   return exitCode;
 }
 
+struct BenchmarkTimes {
+  double parse = 0;
+  double copy = 0;
+  double destroy = 0;
+};
+
+// Parses, copies and destroys a document, from the heap or from a
+// Json::ValueArena. Returns the number of arena blocks used.
+static size_t benchmarkDocument(Json::String const& input, bool useArena,
+                                BenchmarkTimes* times) {
+  using Clock = std::chrono::steady_clock;
+  auto elapsed = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+  };
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+  std::unique_ptr<Json::ValueArena> arena;
+  std::unique_ptr<Json::Value> root;
+  std::unique_ptr<Json::Value> copy;
+
+  auto start = Clock::now();
+  if (useArena) {
+    arena.reset(new Json::ValueArena);
+  }
+  {
+    std::unique_ptr<Json::ValueArena::Scope> scope;
+    if (arena) {
+      scope.reset(new Json::ValueArena::Scope(*arena));
+    }
+    // The data set has documents that do not parse: they are timed as well.
+    Json::String errors;
+    root.reset(new Json::Value);
+    try {
+      reader->parse(input.data(), input.data() + input.size(), root.get(),
+                    &errors);
+    } catch (const std::exception&) {
+      // fail_test_stack_limit.json
+    }
+    times->parse += elapsed(start);
+
+    start = Clock::now();
+    copy.reset(new Json::Value(*root));
+    times->copy += elapsed(start);
+  }
+  size_t const blocks = arena ? arena->blockCount() : 0;
+
+  start = Clock::now();
+  copy.reset();
+  root.reset();
+  arena.reset();
+  times->destroy += elapsed(start);
+  return blocks;
+}
+
+static int runBenchmark(Options const& opts) {
+  std::vector<Json::String> inputs;
+  size_t bytes = 0;
+  for (auto const& path : opts.benchmarkPaths) {
+    Json::String input = readInputTestFile(path.c_str());
+    if (input.empty()) {
+      std::cerr << "Invalid input file: " << path << std::endl;
+      return 3;
+    }
+    bytes += input.size();
+    inputs.push_back(input);
+  }
+  std::cout << inputs.size() << " files, " << bytes << " bytes, "
+            << opts.benchmarkIterations << " iterations" << std::endl;
+
+  for (bool useArena : {false, true}) {
+    BenchmarkTimes times;
+    size_t blocks = 0;
+    for (int iteration = 0; iteration < opts.benchmarkIterations;
+         ++iteration) {
+      for (auto const& input : inputs) {
+        blocks += benchmarkDocument(input, useArena, &times);
+      }
+    }
+    auto const documents =
+        static_cast<double>(inputs.size()) * opts.benchmarkIterations;
+    std::cout << (useArena ? "arena" : "heap ") << ": parse " << times.parse
+              << " ms, copy " << times.copy << " ms, destroy "
+              << times.destroy << " ms";
+    if (useArena) {
+      std::cout << ", " << static_cast<double>(blocks) / documents
+                << " blocks per document";
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
+
 int main(int argc, const char* argv[]) {
   Options opts;
   try {
@@ -319,6 +429,9 @@ int main(int argc, const char* argv[]) {
       std::cerr << "Failed to parse command-line." << std::endl;
       return exitCode;
     }
+    if (opts.benchmarkIterations > 0) {
+      return runBenchmark(opts);
+    }
 
     const int modern_return_code = runTest(opts, false);
     if (modern_return_code) {
@@ -23,6 +23,16 @@
 #include <utility>
 
 #include <cstdio>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#if defined(__cpp_lib_to_chars)
+#define JSONCPP_READER_FROM_CHARS 1
+#endif
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h>
+#define JSONCPP_READER_SSE2 1
+#endif
 #if __cplusplus >= 201103L
 
 #if !defined(sscanf)
@@ -53,6 +63,99 @@ static size_t const stackLimit_g =
 
 namespace Json {
 
+// Structural scanning shared by Reader and OurReader. Configuration files are
+// mostly indentation and string contents, so both are skipped 16 bytes at a
+// time when SSE2 is available (never reading past the end of the document).
+
+// Returns the first character in [current, end) that is not a JSON space.
+static inline const char* scanPastSpaces(const char* current,
+                                         const char* end) {
+#if defined(JSONCPP_READER_SSE2)
+  // No space, or a single one (after ':' or ','), are the most frequent
+  // cases. Spaces are all below '!'.
+  if (current != end && *current > ' ')
+    return current;
+  if (end - current >= 2 && *current == ' ' && current[1] > ' ')
+    return current + 1;
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  while (end - current >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+    const __m128i isSpace =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                  _mm_cmpeq_epi8(chunk, tab)),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, cr),
+                                  _mm_cmpeq_epi8(chunk, lf)));
+    const unsigned mask =
+        static_cast<unsigned>(_mm_movemask_epi8(isSpace)) ^ 0xFFFFU;
+    if (mask != 0)
+      return current + __builtin_ctz(mask);
+    current += 16;
+  }
+#endif
+  while (current != end && (*current == ' ' || *current == '\t' ||
+                            *current == '\r' || *current == '\n'))
+    ++current;
+  return current;
+}
+
+// Returns the first quote or backslash in [current, end), or end.
+static inline const char* scanToQuoteOrEscape(const char* current,
+                                              const char* end, char quote) {
+#if defined(JSONCPP_READER_SSE2)
+  const __m128i quotes = _mm_set1_epi8(quote);
+  const __m128i backslash = _mm_set1_epi8('\\');
+  while (end - current >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes),
+                     _mm_cmpeq_epi8(chunk, backslash))));
+    if (mask != 0)
+      return current + __builtin_ctz(mask);
+    current += 16;
+  }
+#endif
+  while (current != end && *current != quote && *current != '\\')
+    ++current;
+  return current;
+}
+
+// Moves current past the closing quote of a string (the opening one is
+// already consumed). Returns false if the string is not terminated.
+static inline bool scanString(const char*& current, const char* end,
+                              char quote) {
+  for (;;) {
+    current = scanToQuoteOrEscape(current, end, quote);
+    if (current == end)
+      return false;
+    if (*current++ == quote)
+      return true;
+    if (current == end) // backslash at the end of the document
+      return false;
+    ++current; // escaped character
+  }
+}
+
+// Decodes a number token with std::from_chars, which does not depend on the
+// locale and does not allocate. Returns false when the token is not entirely
+// consumed or out of range, for the stream based conversion to decide.
+static inline bool scanDouble(const char* begin, const char* end,
+                              double& value) {
+#if defined(JSONCPP_READER_FROM_CHARS)
+  const std::from_chars_result result = std::from_chars(begin, end, value);
+  return result.ec == std::errc() && result.ptr == end;
+#else
+  (void)begin;
+  (void)end;
+  (void)value;
+  return false;
+#endif
+}
+
 #if __cplusplus >= 201103L || (defined(_CPPLIB_VER) && _CPPLIB_VER >= 520)
 using CharReaderPtr = std::unique_ptr<CharReader>;
 #else
@@ -306,15 +409,7 @@ bool Reader::readToken(Token& token) {
   return ok;
 }
 
-void Reader::skipSpaces() {
-  while (current_ != end_) {
-    Char c = *current_;
-    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-      ++current_;
-    else
-      break;
-  }
-}
+void Reader::skipSpaces() { current_ = scanPastSpaces(current_, end_); }
 
 bool Reader::match(const Char* pattern, int patternLength) {
   if (end_ - current_ < patternLength)
@@ -428,17 +523,7 @@ void Reader::readNumber() {
   }
 }
 
-bool Reader::readString() {
-  Char c = '\0';
-  while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '"')
-      break;
-  }
-  return c == '"';
-}
+bool Reader::readString() { return scanString(current_, end_, '"'); }
 
 bool Reader::readObject(Token& token) {
   Token tokenName;
@@ -599,6 +684,10 @@ bool Reader::decodeDouble(Token& token) {
 
 bool Reader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+  if (scanDouble(token.start_, token.end_, value)) {
+    decoded = value;
+    return true;
+  }
   String buffer(token.start_, token.end_);
   IStringStream is(buffer);
   if (!(is >> value)) {
@@ -615,10 +704,18 @@ bool Reader::decodeDouble(Token& token, Value& decoded) {
 }
 
 bool Reader::decodeString(Token& token) {
-  String decoded_string;
-  if (!decodeString(token, decoded_string))
-    return false;
-  Value decoded(decoded_string);
+  Value decoded;
+  Location begin = token.start_ + 1; // skip '"'
+  Location end = token.end_ - 1;     // do not include '"'
+  if (scanToQuoteOrEscape(begin, end, '"') == end) {
+    // No escape sequence: no intermediate String
+    decoded = Value(begin, end);
+  } else {
+    String decoded_string;
+    if (!decodeString(token, decoded_string))
+      return false;
+    decoded = Value(decoded_string);
+  }
   currentValue().swapPayload(decoded);
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
@@ -626,9 +723,14 @@ bool Reader::decodeString(Token& token) {
 }
 
 bool Reader::decodeString(Token& token, String& decoded) {
-  decoded.reserve(static_cast<size_t>(token.end_ - token.start_ - 2));
   Location current = token.start_ + 1; // skip '"'
   Location end = token.end_ - 1;       // do not include '"'
+  if (scanToQuoteOrEscape(current, end, '"') == end) {
+    // No escape sequence: copied as it is
+    decoded.assign(current, end);
+    return true;
+  }
+  decoded.reserve(static_cast<size_t>(token.end_ - token.start_ - 2));
   while (current != end) {
     Char c = *current++;
     if (c == '"')
@@ -981,7 +1083,7 @@ private:
   static String normalizeEOL(Location begin, Location end);
   static bool containsNewLine(Location begin, Location end);
 
-  using Nodes = std::stack<Value*>;
+  using Nodes = std::stack<Value*, std::vector<Value*> >;
 
   Nodes nodes_{};
   Errors errors_{};
@@ -1266,15 +1368,7 @@ bool OurReader::readToken(Token& token) {
   return ok;
 }
 
-void OurReader::skipSpaces() {
-  while (current_ != end_) {
-    Char c = *current_;
-    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-      ++current_;
-    else
-      break;
-  }
-}
+void OurReader::skipSpaces() { current_ = scanPastSpaces(current_, end_); }
 
 void OurReader::skipBom(bool skipBom) {
   // The default behavior is to skip BOM.
@@ -1419,33 +1513,19 @@ bool OurReader::readNumber(bool checkInf) {
   }
   return true;
 }
-bool OurReader::readString() {
-  Char c = 0;
-  while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '"')
-      break;
-  }
-  return c == '"';
-}
+bool OurReader::readString() { return scanString(current_, end_, '"'); }
 
 bool OurReader::readStringSingleQuote() {
-  Char c = 0;
-  while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '\'')
-      break;
-  }
-  return c == '\'';
+  return scanString(current_, end_, '\'');
 }
 
 bool OurReader::readObject(Token& token) {
   Token tokenName;
   String name;
+  // The member name, in the document when it has no escape sequence, in
+  // name otherwise.
+  Location nameBegin = nullptr;
+  Location nameEnd = nullptr;
   Value init(objectValue);
   currentValue().swapPayload(init);
   currentValue().setOffsetStart(token.start_ - begin_);
@@ -1456,25 +1536,34 @@ bool OurReader::readObject(Token& token) {
     if (!initialTokenOk)
       break;
     if (tokenName.type_ == tokenObjectEnd &&
-        (name.empty() ||
+        (nameBegin == nameEnd ||
          features_.allowTrailingCommas_)) // empty object or trailing comma
       return true;
-    name.clear();
     if (tokenName.type_ == tokenString) {
-      if (!decodeString(tokenName, name))
-        return recoverFromError(tokenObjectEnd);
+      nameBegin = tokenName.start_ + 1; // skip '"'
+      nameEnd = tokenName.end_ - 1;     // do not include '"'
+      if (scanToQuoteOrEscape(nameBegin, nameEnd, '"') != nameEnd) {
+        name.clear();
+        if (!decodeString(tokenName, name))
+          return recoverFromError(tokenObjectEnd);
+        nameBegin = name.data();
+        nameEnd = name.data() + name.length();
+      }
     } else if (tokenName.type_ == tokenNumber && features_.allowNumericKeys_) {
       Value numberName;
       if (!decodeNumber(tokenName, numberName))
         return recoverFromError(tokenObjectEnd);
       name = numberName.asString();
+      nameBegin = name.data();
+      nameEnd = name.data() + name.length();
     } else {
       break;
     }
-    if (name.length() >= (1U << 30))
+    if (static_cast<size_t>(nameEnd - nameBegin) >= (1U << 30))
       throwRuntimeError("keylength >= 2^30");
-    if (features_.rejectDupKeys_ && currentValue().isMember(name)) {
-      String msg = "Duplicate key: '" + name + "'";
+    if (features_.rejectDupKeys_ &&
+        currentValue().find(nameBegin, nameEnd) != nullptr) {
+      String msg = "Duplicate key: '" + String(nameBegin, nameEnd) + "'";
       return addErrorAndRecover(msg, tokenName, tokenObjectEnd);
     }
 
@@ -1483,7 +1572,7 @@ bool OurReader::readObject(Token& token) {
       return addErrorAndRecover("Missing ':' after object member name", colon,
                                 tokenObjectEnd);
     }
-    Value& value = currentValue()[name];
+    Value& value = *currentValue().demand(nameBegin, nameEnd);
     nodes_.push(&value);
     bool ok = readValue();
     nodes_.pop();
@@ -1511,11 +1600,10 @@ bool OurReader::readArray(Token& token) {
   Value init(arrayValue);
   currentValue().swapPayload(init);
   currentValue().setOffsetStart(token.start_ - begin_);
-  int index = 0;
   for (;;) {
     skipSpaces();
     if (current_ != end_ && *current_ == ']' &&
-        (index == 0 ||
+        (currentValue().empty() ||
          (features_.allowTrailingCommas_ &&
           !features_.allowDroppedNullPlaceholders_))) // empty array or trailing
                                                       // comma
@@ -1524,7 +1612,7 @@ bool OurReader::readArray(Token& token) {
       readToken(endArray);
       return true;
     }
-    Value& value = currentValue()[index++];
+    Value& value = currentValue().append(Value());
     nodes_.push(&value);
     bool ok = readValue();
     nodes_.pop();
@@ -1550,10 +1638,9 @@ bool OurReader::readArray(Token& token) {
 }
 
 bool OurReader::decodeNumber(Token& token) {
-  Value decoded;
-  if (!decodeNumber(token, decoded))
+  // Decoded straight into the current value, which keeps its comments.
+  if (!decodeNumber(token, currentValue()))
     return false;
-  currentValue().swapPayload(decoded);
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
   return true;
@@ -1629,21 +1716,20 @@ bool OurReader::decodeNumber(Token& token, Value& decoded) {
   if (isNegative) {
     // We use the same magnitude assumption here, just in case.
     const auto last_digit = static_cast<Value::UInt>(value % 10);
-    decoded = -Value::LargestInt(value / 10) * 10 - last_digit;
+    Value(-Value::LargestInt(value / 10) * 10 - last_digit)
+        .swapPayload(decoded);
   } else if (value <= Value::LargestUInt(Value::maxLargestInt)) {
-    decoded = Value::LargestInt(value);
+    Value(Value::LargestInt(value)).swapPayload(decoded);
   } else {
-    decoded = value;
+    Value(value).swapPayload(decoded);
   }
 
   return true;
 }
 
 bool OurReader::decodeDouble(Token& token) {
-  Value decoded;
-  if (!decodeDouble(token, decoded))
+  if (!decodeDouble(token, currentValue()))
     return false;
-  currentValue().swapPayload(decoded);
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
   return true;
@@ -1651,6 +1737,10 @@ bool OurReader::decodeDouble(Token& token) {
 
 bool OurReader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
+  if (scanDouble(token.start_, token.end_, value)) {
+    Value(value).swapPayload(decoded);
+    return true;
+  }
   const String buffer(token.start_, token.end_);
   IStringStream is(buffer);
   if (!(is >> value)) {
@@ -1662,25 +1752,36 @@ bool OurReader::decodeDouble(Token& token, Value& decoded) {
       return addError(
         "'" + String(token.start_, token.end_) + "' is not a number.", token);
   }
-  decoded = value;
+  Value(value).swapPayload(decoded);
   return true;
 }
 
 bool OurReader::decodeString(Token& token) {
-  String decoded_string;
-  if (!decodeString(token, decoded_string))
-    return false;
-  Value decoded(decoded_string);
-  currentValue().swapPayload(decoded);
+  Location begin = token.start_ + 1; // skip '"'
+  Location end = token.end_ - 1;     // do not include '"'
+  if (scanToQuoteOrEscape(begin, end, '"') == end) {
+    // No escape sequence: no intermediate String
+    Value(begin, end).swapPayload(currentValue());
+  } else {
+    String decoded_string;
+    if (!decodeString(token, decoded_string))
+      return false;
+    Value(decoded_string).swapPayload(currentValue());
+  }
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
   return true;
 }
 
 bool OurReader::decodeString(Token& token, String& decoded) {
-  decoded.reserve(static_cast<size_t>(token.end_ - token.start_ - 2));
   Location current = token.start_ + 1; // skip '"'
   Location end = token.end_ - 1;       // do not include '"'
+  if (scanToQuoteOrEscape(current, end, '"') == end) {
+    // No escape sequence: copied as it is
+    decoded.assign(current, end);
+    return true;
+  }
+  decoded.reserve(static_cast<size_t>(token.end_ - token.start_ - 2));
   while (current != end) {
     Char c = *current++;
     if (c == '"')
@@ -12,9 +12,12 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <sstream>
+#include <tuple>
 #include <utility>
 
 // Provide implementation equivalent of std::snprintf for older _MSC compilers
@@ -112,13 +115,15 @@ static inline bool InRange(double d, T min, U max) {
  *               computed using strlen(value).
  * @return Pointer on the duplicate instance of string.
  */
-static inline char* duplicateStringValue(const char* value, size_t length) {
+static inline char* duplicateStringValue(const char* value, size_t length,
+                                         ValueArena* arena = nullptr) {
   // Avoid an integer overflow in the call to malloc below by limiting length
   // to a sane value.
   if (length >= static_cast<size_t>(Value::maxInt))
     length = Value::maxInt - 1;
 
-  auto newString = static_cast<char*>(malloc(length + 1));
+  auto newString = static_cast<char*>(arena ? arena->allocate(length + 1, 1)
+                                            : malloc(length + 1));
   if (newString == nullptr) {
     throwRuntimeError("in Json::Value::duplicateStringValue(): "
                       "Failed to allocate string value buffer");
@@ -131,7 +136,8 @@ static inline char* duplicateStringValue(const char* value, size_t length) {
 /* Record the length as a prefix.
  */
 static inline char* duplicateAndPrefixStringValue(const char* value,
-                                                  unsigned int length) {
+                                                  unsigned int length,
+                                                  ValueArena* arena = nullptr) {
   // Avoid an integer overflow in the call to malloc below by limiting length
   // to a sane value.
   JSON_ASSERT_MESSAGE(length <= static_cast<unsigned>(Value::maxInt) -
@@ -139,7 +145,9 @@ static inline char* duplicateAndPrefixStringValue(const char* value,
                       "in Json::Value::duplicateAndPrefixStringValue(): "
                       "length too big for prefixing");
   size_t actualLength = sizeof(length) + length + 1;
-  auto newString = static_cast<char*>(malloc(actualLength));
+  auto newString = static_cast<char*>(
+      arena ? arena->allocate(actualLength, alignof(unsigned))
+            : malloc(actualLength));
   if (newString == nullptr) {
     throwRuntimeError("in Json::Value::duplicateAndPrefixStringValue(): "
                       "Failed to allocate string value buffer");
@@ -183,6 +191,58 @@ static inline void releasePrefixedStringValue(char* value) { free(value); }
 static inline void releaseStringValue(char* value, unsigned) { free(value); }
 #endif // JSONCPP_USING_SECURE_MEMORY
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class ValueArena
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+// Blocks stop doubling at this size.
+static size_t const maxArenaBlockSize = 16 * 1024 * 1024;
+
+static thread_local ValueArena* currentArena = nullptr;
+
+ValueArena::ValueArena(size_t blockSize)
+    : blockSize_(blockSize ? blockSize : 1), next_(nullptr), end_(nullptr),
+      used_(0) {}
+
+ValueArena::~ValueArena() {
+  for (auto& block : blocks_) {
+#if JSONCPP_USING_SECURE_MEMORY
+    memset(block.first, 0, block.second);
+#endif
+    free(block.first);
+  }
+}
+
+// Starts a new block, large enough for size bytes at any alignment.
+void* ValueArena::allocateBlock(size_t size, size_t alignment) {
+  size_t newSize = blocks_.empty()
+                       ? blockSize_
+                       : std::min(blocks_.back().second * 2,
+                                  std::max(blockSize_, maxArenaBlockSize));
+  newSize = std::max(newSize, size + alignment);
+  auto block = static_cast<char*>(malloc(newSize));
+  if (block == nullptr) {
+    throwRuntimeError("in Json::ValueArena::allocate(): "
+                      "Failed to allocate an arena block");
+  }
+  blocks_.emplace_back(block, newSize);
+  next_ = block;
+  end_ = block + newSize;
+  return allocate(size, alignment);
+}
+
+ValueArena* ValueArena::current() { return currentArena; }
+
+ValueArena::Scope::Scope(ValueArena& arena) : previous_(currentArena) {
+  currentArena = &arena;
+}
+
+ValueArena::Scope::~Scope() { currentArena = previous_; }
+
 } // namespace Json
 
 // //////////////////////////////////////////////////////////////////
@@ -243,20 +303,31 @@ Value::CZString::CZString(char const* str, unsigned length,
   storage_.length_ = length & 0x3FFFFFFF;
 }
 
-Value::CZString::CZString(const CZString& other) {
-  cstr_ = (other.storage_.policy_ != noDuplication && other.cstr_ != nullptr
-               ? duplicateStringValue(other.cstr_, other.storage_.length_)
-               : other.cstr_);
-  storage_.policy_ =
-      static_cast<unsigned>(
-          other.cstr_
-              ? (static_cast<DuplicationPolicy>(other.storage_.policy_) ==
-                         noDuplication
-                     ? noDuplication
-                     : duplicate)
-              : static_cast<DuplicationPolicy>(other.storage_.policy_)) &
-      3U;
-  storage_.length_ = other.storage_.length_;
+Value::CZString::CZString(const CZString& other)
+    : cstr_(other.cstr_), index_(other.index_) {
+  // Static and inline names are copied as they are.
+  if (cstr_ != nullptr && (storage_.policy_ == duplicate ||
+                           storage_.policy_ == duplicateOnCopy))
+    duplicateKey(other.cstr_, other.storage_.length_);
+}
+
+// Short names are kept in cstr_ itself, the others come from the current
+// ValueArena (not owned: duplicated on copy) or from the heap.
+void Value::CZString::duplicateKey(char const* str, unsigned length) {
+  if (length > 0 && length < sizeof(cstr_) && str[0] != '\0') {
+    // A non-zero first character keeps cstr_ from reading as nullptr.
+    char chars[sizeof(cstr_)] = {};
+    memcpy(chars, str, length);
+    memcpy(&cstr_, chars, sizeof(cstr_));
+    storage_.policy_ = inlineStorage;
+  } else if (ValueArena* arena = ValueArena::current()) {
+    cstr_ = duplicateStringValue(str, length, arena);
+    storage_.policy_ = duplicateOnCopy;
+  } else {
+    cstr_ = duplicateStringValue(str, length);
+    storage_.policy_ = duplicate;
+  }
+  storage_.length_ = length & 0x3FFFFFFF;
 }
 
 Value::CZString::CZString(CZString&& other) noexcept
@@ -301,7 +372,7 @@ bool Value::CZString::operator<(const CZString& other) const {
   unsigned other_len = other.storage_.length_;
   unsigned min_len = std::min<unsigned>(this_len, other_len);
   JSON_ASSERT(this->cstr_ && other.cstr_);
-  int comp = memcmp(this->cstr_, other.cstr_, min_len);
+  int comp = memcmp(this->data(), other.data(), min_len);
   if (comp < 0)
     return true;
   if (comp > 0)
@@ -319,14 +390,18 @@ bool Value::CZString::operator==(const CZString& other) const {
   if (this_len != other_len)
     return false;
   JSON_ASSERT(this->cstr_ && other.cstr_);
-  int comp = memcmp(this->cstr_, other.cstr_, this_len);
+  int comp = memcmp(this->data(), other.data(), this_len);
   return comp == 0;
 }
 
 ArrayIndex Value::CZString::index() const { return index_; }
 
 // const char* Value::CZString::c_str() const { return cstr_; }
-const char* Value::CZString::data() const { return cstr_; }
+const char* Value::CZString::data() const {
+  if (cstr_ != nullptr && storage_.policy_ == inlineStorage)
+    return reinterpret_cast<char const*>(&cstr_);
+  return cstr_;
+}
 unsigned Value::CZString::length() const { return storage_.length_; }
 bool Value::CZString::isStaticString() const {
   return storage_.policy_ == noDuplication;
@@ -363,7 +438,7 @@ Value::Value(ValueType type) {
     break;
   case arrayValue:
   case objectValue:
-    value_.map_ = new ObjectValues();
+    initMap(nullptr);
     break;
   case booleanValue:
     value_.bool_ = false;
@@ -399,23 +474,20 @@ Value::Value(double value) {
 }
 
 Value::Value(const char* value) {
-  initBasic(stringValue, true);
+  initBasic(stringValue);
   JSON_ASSERT_MESSAGE(value != nullptr,
                       "Null Value Passed to Value Constructor");
-  value_.string_ = duplicateAndPrefixStringValue(
-      value, static_cast<unsigned>(strlen(value)));
+  initString(value, static_cast<unsigned>(strlen(value)));
 }
 
 Value::Value(const char* begin, const char* end) {
-  initBasic(stringValue, true);
-  value_.string_ =
-      duplicateAndPrefixStringValue(begin, static_cast<unsigned>(end - begin));
+  initBasic(stringValue);
+  initString(begin, static_cast<unsigned>(end - begin));
 }
 
 Value::Value(const String& value) {
-  initBasic(stringValue, true);
-  value_.string_ = duplicateAndPrefixStringValue(
-      value.data(), static_cast<unsigned>(value.length()));
+  initBasic(stringValue);
+  initString(value.data(), static_cast<unsigned>(value.length()));
 }
 
 Value::Value(const StaticString& value) {
@@ -503,17 +575,15 @@ bool Value::operator<(const Value& other) const {
   case booleanValue:
     return value_.bool_ < other.value_.bool_;
   case stringValue: {
-    if ((value_.string_ == nullptr) || (other.value_.string_ == nullptr)) {
-      return other.value_.string_ != nullptr;
-    }
     unsigned this_len;
     unsigned other_len;
     char const* this_str;
     char const* other_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
-    decodePrefixedString(other.isAllocated(), other.value_.string_, &other_len,
-                         &other_str);
+    bool const this_has = decodeString(&this_len, &this_str);
+    bool const other_has = other.decodeString(&other_len, &other_str);
+    if (!this_has || !other_has) {
+      return other_has;
+    }
     unsigned min_len = std::min<unsigned>(this_len, other_len);
     JSON_ASSERT(this_str && other_str);
     int comp = memcmp(this_str, other_str, min_len);
@@ -558,17 +628,15 @@ bool Value::operator==(const Value& other) const {
   case booleanValue:
     return value_.bool_ == other.value_.bool_;
   case stringValue: {
-    if ((value_.string_ == nullptr) || (other.value_.string_ == nullptr)) {
-      return (value_.string_ == other.value_.string_);
-    }
     unsigned this_len;
     unsigned other_len;
     char const* this_str;
     char const* other_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
-    decodePrefixedString(other.isAllocated(), other.value_.string_, &other_len,
-                         &other_str);
+    bool const this_has = decodeString(&this_len, &this_str);
+    bool const other_has = other.decodeString(&other_len, &other_str);
+    if (!this_has || !other_has) {
+      return this_has == other_has;
+    }
     if (this_len != other_len)
       return false;
     JSON_ASSERT(this_str && other_str);
@@ -590,12 +658,10 @@ bool Value::operator!=(const Value& other) const { return !(*this == other); }
 const char* Value::asCString() const {
   JSON_ASSERT_MESSAGE(type() == stringValue,
                       "in Json::Value::asCString(): requires stringValue");
-  if (value_.string_ == nullptr)
-    return nullptr;
   unsigned this_len;
   char const* this_str;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                       &this_str);
+  if (!decodeString(&this_len, &this_str))
+    return nullptr;
   return this_str;
 }
 
@@ -603,12 +669,10 @@ const char* Value::asCString() const {
 unsigned Value::getCStringLength() const {
   JSON_ASSERT_MESSAGE(type() == stringValue,
                       "in Json::Value::asCString(): requires stringValue");
-  if (value_.string_ == 0)
-    return 0;
   unsigned this_len;
   char const* this_str;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                       &this_str);
+  if (!decodeString(&this_len, &this_str))
+    return 0;
   return this_len;
 }
 #endif
@@ -616,11 +680,9 @@ unsigned Value::getCStringLength() const {
 bool Value::getString(char const** begin, char const** end) const {
   if (type() != stringValue)
     return false;
-  if (value_.string_ == nullptr)
-    return false;
   unsigned length;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &length,
-                       begin);
+  if (!decodeString(&length, begin))
+    return false;
   *end = *begin + length;
   return true;
 }
@@ -630,12 +692,10 @@ String Value::asString() const {
   case nullValue:
     return "";
   case stringValue: {
-    if (value_.string_ == nullptr)
-      return "";
     unsigned this_len;
     char const* this_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
+    if (!decodeString(&this_len, &this_str))
+      return "";
     return String(this_str, this_len);
   }
   case booleanValue:
@@ -933,8 +993,9 @@ Value& Value::operator[](ArrayIndex index) {
   if (it != value_.map_->end() && (*it).first == key)
     return (*it).second;
 
-  ObjectValues::value_type defaultValue(key, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
+  it = value_.map_->emplace_hint(it, std::piecewise_construct,
+                                 std::forward_as_tuple(key),
+                                 std::forward_as_tuple());
   return (*it).second;
 }
 
@@ -968,14 +1029,59 @@ const Value& Value::operator[](int index) const {
 void Value::initBasic(ValueType type, bool allocated) {
   setType(type);
   setIsAllocated(allocated);
+  bits_.arena_ = 0;
+  bits_.inline_ = 0;
   comments_ = Comments{};
   start_ = 0;
   limit_ = 0;
 }
 
+// Short strings are stored in value_ itself, the others come from the current
+// ValueArena or from the heap.
+void Value::initString(char const* str, unsigned length) {
+  if (length < sizeof(value_.chars_)) {
+    memset(value_.chars_, 0, sizeof(value_.chars_));
+    memcpy(value_.chars_, str, length);
+    bits_.inline_ = (length + 1U) & 0xFU;
+    return;
+  }
+  ValueArena* arena = ValueArena::current();
+  value_.string_ = duplicateAndPrefixStringValue(str, length, arena);
+  setIsAllocated(true);
+  bits_.arena_ = arena != nullptr;
+}
+
+// An empty map, or a copy of other, from the current ValueArena or the heap.
+void Value::initMap(const ObjectValues* other) {
+  ValueArena* arena = ValueArena::current();
+  if (arena) {
+    void* memory = arena->allocate(sizeof(ObjectValues), alignof(ObjectValues));
+    value_.map_ = other ? new (memory) ObjectValues(*other)
+                        : new (memory) ObjectValues();
+  } else {
+    value_.map_ = other ? new ObjectValues(*other) : new ObjectValues();
+  }
+  bits_.arena_ = arena != nullptr;
+}
+
+// Returns false for a null string_.
+bool Value::decodeString(unsigned* length, char const** str) const {
+  if (bits_.inline_ != 0) {
+    *length = bits_.inline_ - 1U;
+    *str = value_.chars_;
+    return true;
+  }
+  if (value_.string_ == nullptr)
+    return false;
+  decodePrefixedString(isAllocated(), value_.string_, length, str);
+  return true;
+}
+
 void Value::dupPayload(const Value& other) {
   setType(other.type());
   setIsAllocated(false);
+  bits_.arena_ = 0;
+  bits_.inline_ = 0;
   switch (type()) {
   case nullValue:
   case intValue:
@@ -985,20 +1091,22 @@ void Value::dupPayload(const Value& other) {
     value_ = other.value_;
     break;
   case stringValue:
-    if (other.value_.string_ && other.isAllocated()) {
+    if (other.bits_.inline_ != 0) {
+      value_ = other.value_;
+      bits_.inline_ = other.bits_.inline_;
+    } else if (other.value_.string_ && other.isAllocated()) {
       unsigned len;
       char const* str;
       decodePrefixedString(other.isAllocated(), other.value_.string_, &len,
                            &str);
-      value_.string_ = duplicateAndPrefixStringValue(str, len);
-      setIsAllocated(true);
+      initString(str, len);
     } else {
       value_.string_ = other.value_.string_;
     }
     break;
   case arrayValue:
   case objectValue:
-    value_.map_ = new ObjectValues(*other.value_.map_);
+    initMap(other.value_.map_);
     break;
   default:
     JSON_ASSERT_UNREACHABLE;
@@ -1014,12 +1122,15 @@ void Value::releasePayload() {
   case booleanValue:
     break;
   case stringValue:
-    if (isAllocated())
+    if (isAllocated() && !bits_.arena_)
       releasePrefixedStringValue(value_.string_);
     break;
   case arrayValue:
   case objectValue:
-    delete value_.map_;
+    if (bits_.arena_)
+      value_.map_->~ObjectValues();
+    else
+      delete value_.map_;
     break;
   default:
     JSON_ASSERT_UNREACHABLE;
@@ -1047,8 +1158,9 @@ Value& Value::resolveReference(const char* key) {
   if (it != value_.map_->end() && (*it).first == actualKey)
     return (*it).second;
 
-  ObjectValues::value_type defaultValue(actualKey, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
+  it = value_.map_->emplace_hint(it, std::piecewise_construct,
+                                 std::forward_as_tuple(actualKey),
+                                 std::forward_as_tuple());
   Value& value = (*it).second;
   return value;
 }
@@ -1066,8 +1178,9 @@ Value& Value::resolveReference(char const* key, char const* end) {
   if (it != value_.map_->end() && (*it).first == actualKey)
     return (*it).second;
 
-  ObjectValues::value_type defaultValue(actualKey, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
+  it = value_.map_->emplace_hint(it, std::piecewise_construct,
+                                 std::forward_as_tuple(actualKey),
+                                 std::forward_as_tuple());
   Value& value = (*it).second;
   return value;
 }
@@ -1131,7 +1244,10 @@ Value& Value::append(Value&& value) {
   if (type() == nullValue) {
     *this = Value(arrayValue);
   }
-  return this->value_.map_->emplace(size(), std::move(value)).first->second;
+  // The new index is past the last one: append at the end of the map.
+  return this->value_.map_
+      ->emplace_hint(value_.map_->end(), size(), std::move(value))
+      ->second;
 }
 
 bool Value::insert(ArrayIndex index, const Value& newValue) {
@@ -65,7 +65,7 @@ void ValueIteratorBase::copy(const SelfType& other) {
 }
 
 Value ValueIteratorBase::key() const {
-  const Value::CZString czstring = (*current_).first;
+  const Value::CZString& czstring = (*current_).first;
   if (czstring.data()) {
     if (czstring.isStaticString())
       return Value(StaticString(czstring.data()));
@@ -75,7 +75,7 @@ Value ValueIteratorBase::key() const {
 }
 
 UInt ValueIteratorBase::index() const {
-  const Value::CZString czstring = (*current_).first;
+  const Value::CZString& czstring = (*current_).first;
   if (!czstring.data())
     return czstring.index();
   return Value::UInt(-1);
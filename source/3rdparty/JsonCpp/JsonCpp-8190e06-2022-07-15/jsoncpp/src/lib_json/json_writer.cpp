@@ -17,6 +17,19 @@
 #include <sstream>
 #include <utility>
 
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#if defined(__cpp_lib_to_chars)
+#define JSONCPP_WRITER_TO_CHARS 1
+#endif
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <cerrno>
+
 #if __cplusplus >= 201103L
 #include <cmath>
 #include <cstdio>
@@ -264,51 +277,56 @@ static String toHex16Bit(unsigned int x) {
   return result;
 }
 
-static void appendRaw(String& result, unsigned ch) {
-  result += static_cast<char>(ch);
-}
+// Appends to a String, for writeQuotedString().
+struct StringOutput {
+  String& result;
+  void put(char c) { result += c; }
+  void put(const char* s, size_t n) { result.append(s, n); }
+};
 
-static void appendHex(String& result, unsigned ch) {
-  result.append("\\u").append(toHex16Bit(ch));
+template <typename Output> static void appendRaw(Output& out, unsigned ch) {
+  out.put(static_cast<char>(ch));
 }
 
-static String valueToQuotedStringN(const char* value, size_t length,
-                                   bool emitUTF8 = false) {
-  if (value == nullptr)
-    return "";
+template <typename Output> static void appendHex(Output& out, unsigned ch) {
+  out.put("\\u", 2);
+  out.put(toHex16Bit(ch).data(), 4);
+}
 
-  if (!doesAnyCharRequireEscaping(value, length))
-    return String("\"") + value + "\"";
+template <typename Output>
+static void writeQuotedString(Output& out, const char* value, size_t length,
+                              bool emitUTF8) {
+  out.put('\"');
+  if (!doesAnyCharRequireEscaping(value, length)) {
+    out.put(value, length);
+    out.put('\"');
+    return;
+  }
   // We have to walk value and escape any special characters.
-  // Appending to String is not efficient, but this should be rare.
   // (Note: forward slashes are *not* rare, but I am not escaping them.)
-  String::size_type maxsize = length * 2 + 3; // allescaped+quotes+NULL
-  String result;
-  result.reserve(maxsize); // to avoid lots of mallocs
-  result += "\"";
   char const* end = value + length;
   for (const char* c = value; c != end; ++c) {
     switch (*c) {
     case '\"':
-      result += "\\\"";
+      out.put("\\\"", 2);
       break;
     case '\\':
-      result += "\\\\";
+      out.put("\\\\", 2);
       break;
     case '\b':
-      result += "\\b";
+      out.put("\\b", 2);
       break;
     case '\f':
-      result += "\\f";
+      out.put("\\f", 2);
       break;
     case '\n':
-      result += "\\n";
+      out.put("\\n", 2);
       break;
     case '\r':
-      result += "\\r";
+      out.put("\\r", 2);
       break;
     case '\t':
-      result += "\\t";
+      out.put("\\t", 2);
       break;
     // case '/':
     // Even though \/ is considered a legal escape in JSON, a bare
@@ -322,30 +340,41 @@ static String valueToQuotedStringN(const char* value, size_t length,
       if (emitUTF8) {
         unsigned codepoint = static_cast<unsigned char>(*c);
         if (codepoint < 0x20) {
-          appendHex(result, codepoint);
+          appendHex(out, codepoint);
         } else {
-          appendRaw(result, codepoint);
+          appendRaw(out, codepoint);
         }
       } else {
         unsigned codepoint = utf8ToCodepoint(c, end); // modifies `c`
         if (codepoint < 0x20) {
-          appendHex(result, codepoint);
+          appendHex(out, codepoint);
         } else if (codepoint < 0x80) {
-          appendRaw(result, codepoint);
+          appendRaw(out, codepoint);
         } else if (codepoint < 0x10000) {
           // Basic Multilingual Plane
-          appendHex(result, codepoint);
+          appendHex(out, codepoint);
         } else {
           // Extended Unicode. Encode 20 bits as a surrogate pair.
           codepoint -= 0x10000;
-          appendHex(result, 0xd800 + ((codepoint >> 10) & 0x3ff));
-          appendHex(result, 0xdc00 + (codepoint & 0x3ff));
+          appendHex(out, 0xd800 + ((codepoint >> 10) & 0x3ff));
+          appendHex(out, 0xdc00 + (codepoint & 0x3ff));
         }
       }
     } break;
     }
   }
-  result += "\"";
+  out.put('\"');
+}
+
+static String valueToQuotedStringN(const char* value, size_t length,
+                                   bool emitUTF8 = false) {
+  if (value == nullptr)
+    return "";
+
+  String result;
+  result.reserve(length + 2); // grows only if something needs escaping
+  StringOutput out{result};
+  writeQuotedString(out, value, length, emitUTF8);
   return result;
 }
 
@@ -1151,6 +1180,296 @@ bool BuiltStyledStreamWriter::hasCommentForValue(const Value& value) {
          value.hasComment(commentAfter);
 }
 
+///////////////
+// BufferedWriter
+
+class BufferedWriter::Impl {
+public:
+  Impl(Style style, size_t bufferSize);
+
+  int write(Value const& root, int fd, OStream* sout);
+
+  void put(char c) {
+    if (next_ == end_)
+      flush();
+    *next_++ = c;
+  }
+  void put(const char* s, size_t n);
+
+private:
+  void flush();
+  void writeOut(const char* s, size_t n);
+
+  void writeValue(Value const& value);
+  void writeInteger(LargestInt value);
+  void writeInteger(LargestUInt value);
+  void writeDouble(double value);
+  void writeIndent();
+  void writeWithIndent(char c);
+  void writeCommentBeforeValue(Value const& root);
+  void writeCommentAfterValueOnSameLine(Value const& root);
+
+  std::unique_ptr<char[]> buffer_;
+  char* next_;
+  char* end_;
+  int fd_;
+  OStream* sout_;
+  unsigned depth_;
+  bool pretty_ : 1;
+  bool indented_ : 1;
+  bool failed_ : 1;
+};
+
+BufferedWriter::Impl::Impl(Style style, size_t bufferSize)
+    : buffer_(new char[bufferSize < 16 ? 16 : bufferSize]),
+      next_(buffer_.get()),
+      end_(buffer_.get() + (bufferSize < 16 ? 16 : bufferSize)), fd_(-1),
+      sout_(nullptr), depth_(0), pretty_(style == pretty), indented_(false),
+      failed_(false) {}
+
+int BufferedWriter::Impl::write(Value const& root, int fd, OStream* sout) {
+  fd_ = fd;
+  sout_ = sout;
+  next_ = buffer_.get();
+  depth_ = 0;
+  failed_ = false;
+  indented_ = true;
+  writeCommentBeforeValue(root);
+  if (!indented_)
+    writeIndent();
+  indented_ = true;
+  writeValue(root);
+  writeCommentAfterValueOnSameLine(root);
+  flush();
+  sout_ = nullptr;
+  return failed_ ? -1 : 0;
+}
+
+void BufferedWriter::Impl::put(const char* s, size_t n) {
+  if (n <= static_cast<size_t>(end_ - next_)) {
+    memcpy(next_, s, n);
+    next_ += n;
+    return;
+  }
+  flush();
+  if (n <= static_cast<size_t>(end_ - next_)) {
+    memcpy(next_, s, n);
+    next_ += n;
+  } else
+    writeOut(s, n);
+}
+
+void BufferedWriter::Impl::flush() {
+  writeOut(buffer_.get(), static_cast<size_t>(next_ - buffer_.get()));
+  next_ = buffer_.get();
+}
+
+void BufferedWriter::Impl::writeOut(const char* s, size_t n) {
+  // After a failure the rest of the document is dropped, so that errno
+  // still describes the first error when write() returns.
+  if (failed_ || n == 0)
+    return;
+  if (sout_ != nullptr) {
+    sout_->write(s, static_cast<std::streamsize>(n));
+    failed_ = !sout_->good();
+    return;
+  }
+  while (n > 0) {
+#if defined(_WIN32)
+    int written = ::_write(fd_, s, static_cast<unsigned int>(n));
+#else
+    ssize_t written = ::write(fd_, s, n);
+#endif
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      failed_ = true;
+      return;
+    }
+    s += written;
+    n -= static_cast<size_t>(written);
+  }
+}
+
+void BufferedWriter::Impl::writeValue(Value const& value) {
+  switch (value.type()) {
+  case nullValue:
+    put("null", 4);
+    break;
+  case intValue:
+    writeInteger(value.asLargestInt());
+    break;
+  case uintValue:
+    writeInteger(value.asLargestUInt());
+    break;
+  case realValue:
+    writeDouble(value.asDouble());
+    break;
+  case stringValue: {
+    char const* str;
+    char const* end;
+    if (value.getString(&str, &end))
+      writeQuotedString(*this, str, static_cast<size_t>(end - str), false);
+    break;
+  }
+  case booleanValue:
+    if (value.asBool())
+      put("true", 4);
+    else
+      put("false", 5);
+    break;
+  case arrayValue:
+  case objectValue: {
+    // Same layout as BuiltStyledStreamWriter with commentStyle "All", where
+    // every non-empty array is written one element per line.
+    bool const isObject = value.type() == objectValue;
+    if (value.empty()) {
+      put(isObject ? "{}" : "[]", 2);
+      break;
+    }
+    writeWithIndent(isObject ? '{' : '[');
+    ++depth_;
+    Value::const_iterator it = value.begin();
+    Value::const_iterator const end = value.end();
+    for (;;) {
+      Value const& childValue = *it;
+      writeCommentBeforeValue(childValue);
+      if (!indented_)
+        writeIndent();
+      if (isObject) {
+        char const* nameEnd;
+        char const* name = it.memberName(&nameEnd);
+        writeQuotedString(*this, name, static_cast<size_t>(nameEnd - name),
+                          false);
+        if (pretty_)
+          put(" : ", 3);
+        else
+          put(':');
+        indented_ = false;
+      } else
+        indented_ = true;
+      writeValue(childValue);
+      indented_ = false;
+      if (++it == end) {
+        writeCommentAfterValueOnSameLine(childValue);
+        break;
+      }
+      put(',');
+      writeCommentAfterValueOnSameLine(childValue);
+    }
+    --depth_;
+    writeWithIndent(isObject ? '}' : ']');
+  } break;
+  }
+}
+
+void BufferedWriter::Impl::writeInteger(LargestInt value) {
+  UIntToStringBuffer buffer;
+  char* current = buffer + sizeof(buffer);
+  if (value == Value::minLargestInt) {
+    uintToString(LargestUInt(Value::maxLargestInt) + 1, current);
+    *--current = '-';
+  } else if (value < 0) {
+    uintToString(LargestUInt(-value), current);
+    *--current = '-';
+  } else {
+    uintToString(LargestUInt(value), current);
+  }
+  put(current, strlen(current));
+}
+
+void BufferedWriter::Impl::writeInteger(LargestUInt value) {
+  UIntToStringBuffer buffer;
+  char* current = buffer + sizeof(buffer);
+  uintToString(value, current);
+  put(current, strlen(current));
+}
+
+void BufferedWriter::Impl::writeDouble(double value) {
+#if defined(JSONCPP_WRITER_TO_CHARS)
+  if (!isfinite(value)) {
+    static const char* const reps[3] = {"null", "-1e+9999", "1e+9999"};
+    const char* rep = reps[isnan(value) ? 0 : (value < 0) ? 1 : 2];
+    put(rep, strlen(rep));
+    return;
+  }
+  // The shortest digits that read back as the same double, in fixed or
+  // scientific notation, whichever is shorter.
+  char buffer[32];
+  std::to_chars_result const result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value);
+  size_t const length = static_cast<size_t>(result.ptr - buffer);
+  put(buffer, length);
+  // Keep it a double when read back.
+  if (!memchr(buffer, '.', length) && !memchr(buffer, 'e', length))
+    put(".0", 2);
+#else
+  String const str = valueToString(value, false, 17,
+                                   PrecisionType::significantDigits);
+  put(str.data(), str.size());
+#endif
+}
+
+void BufferedWriter::Impl::writeIndent() {
+  if (!pretty_)
+    return;
+  put('\n');
+  for (unsigned i = 0; i < depth_; ++i)
+    put('\t');
+}
+
+void BufferedWriter::Impl::writeWithIndent(char c) {
+  if (!indented_)
+    writeIndent();
+  put(c);
+  indented_ = false;
+}
+
+void BufferedWriter::Impl::writeCommentBeforeValue(Value const& root) {
+  if (!pretty_ || !root.hasComment(commentBefore))
+    return;
+
+  if (!indented_)
+    writeIndent();
+  const String comment = root.getComment(commentBefore);
+  for (auto iter = comment.begin(); iter != comment.end(); ++iter) {
+    put(*iter);
+    if (*iter == '\n' && ((iter + 1) != comment.end() && *(iter + 1) == '/'))
+      for (unsigned i = 0; i < depth_; ++i)
+        put('\t');
+  }
+  indented_ = false;
+}
+
+void BufferedWriter::Impl::writeCommentAfterValueOnSameLine(
+    Value const& root) {
+  if (!pretty_)
+    return;
+  if (root.hasComment(commentAfterOnSameLine)) {
+    const String comment = root.getComment(commentAfterOnSameLine);
+    put(' ');
+    put(comment.data(), comment.size());
+  }
+
+  if (root.hasComment(commentAfter)) {
+    writeIndent();
+    const String comment = root.getComment(commentAfter);
+    put(comment.data(), comment.size());
+  }
+}
+
+BufferedWriter::BufferedWriter(Style style, size_t bufferSize)
+    : impl_(new Impl(style, bufferSize)) {}
+BufferedWriter::~BufferedWriter() = default;
+
+int BufferedWriter::write(Value const& root, int fd) {
+  return impl_->write(root, fd, nullptr);
+}
+
+int BufferedWriter::write(Value const& root, OStream* sout) {
+  return impl_->write(root, -1, sout);
+}
+
 ///////////////
 // StreamWriter
 
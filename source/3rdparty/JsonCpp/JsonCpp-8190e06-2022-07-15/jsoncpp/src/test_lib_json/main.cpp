@@ -13,7 +13,9 @@
 #include "fuzz.h"
 #include "jsontest.h"
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <functional>
 #include <iomanip>
@@ -26,6 +28,9 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
 
 using CharReaderPtr = std::unique_ptr<Json::CharReader>;
 
@@ -1948,6 +1953,77 @@ JSONTEST_FIXTURE_LOCAL(ValueTest, zeroesInKeys) {
   }
 }
 
+JSONTEST_FIXTURE_LOCAL(ValueTest, shortStrings) {
+  // Up to 7 characters are stored in the Value (or member name) itself.
+  char const cstr[] = "\0a\0";
+  Json::String const zeroes(cstr, sizeof(cstr) - 1U);
+  Json::String const strings[] = {"", "a", "abcdefg", "abcdefgh", zeroes};
+  for (const auto& str : strings) {
+    Json::Value value(str);
+    JSONTEST_ASSERT_STRING_EQUAL(str, value.asString());
+    JSONTEST_ASSERT_EQUAL('\0', value.asCString()[str.length()]);
+    Json::Value copy(value);
+    JSONTEST_ASSERT(copy == value);
+    JSONTEST_ASSERT_STRING_EQUAL(str, copy.asString());
+    Json::Value other("ab");
+    other.swap(copy);
+    JSONTEST_ASSERT_STRING_EQUAL(str, other.asString());
+    JSONTEST_ASSERT_STRING_EQUAL("ab", copy.asString());
+    JSONTEST_ASSERT_EQUAL(str < Json::String("ab"), other < copy);
+
+    Json::Value object;
+    object[str] = value;
+    object["z"] = 1;
+    Json::Value objectCopy(object);
+    JSONTEST_ASSERT(objectCopy.isMember(str));
+    JSONTEST_ASSERT_STRING_EQUAL(str, objectCopy[str].asString());
+    JSONTEST_ASSERT_STRING_EQUAL(str, objectCopy.begin().name());
+    JSONTEST_ASSERT(objectCopy.removeMember(
+        str.data(), str.data() + str.length(), nullptr));
+    JSONTEST_ASSERT_EQUAL(1U, objectCopy.size());
+  }
+}
+
+JSONTEST_FIXTURE_LOCAL(ValueTest, arena) {
+  Json::String const doc = "{ \"cameras\" : [ { \"name\" : \"front door camera\","
+                           " \"index\" : 0, \"tags\" : [ \"outdoor\" ] } ],"
+                           " \"a longer member name\" : \"a longer string\" }";
+  Json::Value copy;
+  {
+    Json::ValueArena arena(256);
+    Json::Value root;
+    {
+      Json::ValueArena::Scope scope(arena);
+      JSONTEST_ASSERT(Json::ValueArena::current() == &arena);
+      Json::CharReaderBuilder b;
+      CharReaderPtr reader(b.newCharReader());
+      Json::String errors;
+      JSONTEST_ASSERT(reader->parse(doc.data(), doc.data() + doc.size(), &root,
+                                    &errors));
+      root["cameras"].append(root["cameras"][0]); // copied in the arena
+    }
+    JSONTEST_ASSERT(Json::ValueArena::current() == nullptr);
+    JSONTEST_ASSERT(arena.bytesUsed() > 0);
+    JSONTEST_ASSERT_EQUAL(2U, root["cameras"].size());
+
+    // Changed outside of the scope: from the heap.
+    root["cameras"][1]["name"] = "back door camera";
+    root["new member name"] = root["a longer member name"];
+    root.removeMember("a longer member name");
+
+    copy = root; // heap copy, outliving the arena
+  }
+  JSONTEST_ASSERT_STRING_EQUAL("front door camera",
+                               copy["cameras"][0]["name"].asString());
+  JSONTEST_ASSERT_STRING_EQUAL("back door camera",
+                               copy["cameras"][1]["name"].asString());
+  JSONTEST_ASSERT_STRING_EQUAL("outdoor",
+                               copy["cameras"][1]["tags"][0].asString());
+  JSONTEST_ASSERT_STRING_EQUAL("a longer string",
+                               copy["new member name"].asString());
+  JSONTEST_ASSERT(!copy.isMember("a longer member name"));
+}
+
 JSONTEST_FIXTURE_LOCAL(ValueTest, specialFloats) {
   Json::StreamWriterBuilder b;
   b.settings_["useSpecialFloats"] = true;
@@ -2771,6 +2847,119 @@ JSONTEST_FIXTURE_LOCAL(StreamWriterTest, escapeTabCharacterWindows) {
 }
 #endif
 
+struct BufferedWriterTest : JsonTest::TestCase {
+  Json::String write(Json::Value const& root,
+                     Json::BufferedWriter::Style style, size_t bufferSize) {
+    Json::OStringStream sout;
+    Json::BufferedWriter writer(style, bufferSize);
+    JSONTEST_ASSERT(writer.write(root, &sout) == 0) << "write failed";
+    return sout.str();
+  }
+};
+
+JSONTEST_FIXTURE_LOCAL(BufferedWriterTest, sameLayoutAsStreamWriter) {
+  Json::Value root;
+  root["int"] = -42;
+  root["uint"] = Json::Value::maxLargestUInt;
+  root["min"] = Json::Value::minLargestInt;
+  root["bool"] = true;
+  root["null"] = Json::nullValue;
+  root["escapes"] = "tab\there \"quoted\" \\ \x01 \xe2\x82\xac \xf0\x9f\x98\x80";
+  root["long"] = Json::String(200, 'x');
+  root["empty array"] = Json::arrayValue;
+  root["empty object"] = Json::objectValue;
+  root["array"].append(1);
+  root["array"].append("two");
+  root["array"].append(Json::arrayValue).append(3);
+  root["array"][2].append(4);
+  root["array"].append(Json::objectValue)["five"] = 5;
+  root["object"]["nested"]["deeper"] = "value";
+  root["object"].setComment(Json::String("// before"), Json::commentBefore);
+  root["int"].setComment(Json::String("// same line"),
+                         Json::commentAfterOnSameLine);
+  root["array"][1].setComment(Json::String("// line 1\n// line 2"),
+                              Json::commentBefore);
+  root["bool"].setComment(Json::String("// after"), Json::commentAfter);
+
+  // Small buffers force flushes mid-token and direct writes of long strings.
+  for (size_t bufferSize : {size_t(16), size_t(64 * 1024)}) {
+    Json::StreamWriterBuilder b;
+    JSONTEST_ASSERT_STRING_EQUAL(
+        Json::writeString(b, root),
+        write(root, Json::BufferedWriter::pretty, bufferSize));
+
+    b.settings_["indentation"] = "";
+    b.settings_["commentStyle"] = "None";
+    JSONTEST_ASSERT_STRING_EQUAL(
+        Json::writeString(b, root),
+        write(root, Json::BufferedWriter::compact, bufferSize));
+  }
+}
+
+JSONTEST_FIXTURE_LOCAL(BufferedWriterTest, shortestDoubles) {
+  const double values[] = {0.1,     1.0,     -0.0,   1e22,
+                           5e-324,  1.0 / 3, 29.97,  1.7976931348623157e308,
+                           -2.5e-8, 123456.0};
+  Json::CharReaderBuilder rb;
+  for (double value : values) {
+    Json::String const json =
+        write(Json::Value(value), Json::BufferedWriter::compact, 1024);
+    Json::Value back;
+    Json::String errs;
+    CharReaderPtr reader(rb.newCharReader());
+    JSONTEST_ASSERT(
+        reader->parse(json.data(), json.data() + json.size(), &back, &errs))
+        << json;
+    JSONTEST_ASSERT(back.isDouble()) << json;
+    JSONTEST_ASSERT_EQUAL(value, back.asDouble());
+  }
+#if defined(__cpp_lib_to_chars)
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "0.1", write(Json::Value(0.1), Json::BufferedWriter::compact, 1024));
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "1.0", write(Json::Value(1.0), Json::BufferedWriter::compact, 1024));
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "29.97", write(Json::Value(29.97), Json::BufferedWriter::compact, 1024));
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "1e+22", write(Json::Value(1e22), Json::BufferedWriter::compact, 1024));
+#endif
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "null", write(Json::Value(std::numeric_limits<double>::quiet_NaN()),
+                    Json::BufferedWriter::compact, 1024));
+  JSONTEST_ASSERT_STRING_EQUAL(
+      "-1e+9999", write(Json::Value(-std::numeric_limits<double>::infinity()),
+                        Json::BufferedWriter::compact, 1024));
+}
+
+#if !defined(_WIN32)
+JSONTEST_FIXTURE_LOCAL(BufferedWriterTest, writeToFileDescriptor) {
+  Json::Value root;
+  for (int i = 0; i < 1000; ++i)
+    root["key" + std::to_string(i)] = i;
+
+  std::FILE* file = std::tmpfile();
+  JSONTEST_ASSERT(file != nullptr);
+  Json::BufferedWriter writer(Json::BufferedWriter::compact, 256);
+  JSONTEST_ASSERT(writer.write(root, fileno(file)) == 0);
+
+  std::rewind(file);
+  Json::String json;
+  char buffer[4096];
+  size_t n;
+  while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    json.append(buffer, n);
+  std::fclose(file);
+
+  Json::StreamWriterBuilder b;
+  b.settings_["indentation"] = "";
+  JSONTEST_ASSERT_STRING_EQUAL(Json::writeString(b, root), json);
+
+  errno = 0;
+  JSONTEST_ASSERT(writer.write(root, -1) == -1);
+  JSONTEST_ASSERT_EQUAL(EBADF, errno);
+}
+#endif
+
 struct ReaderTest : JsonTest::TestCase {
   void setStrictMode() {
     reader = std::unique_ptr<Json::Reader>(
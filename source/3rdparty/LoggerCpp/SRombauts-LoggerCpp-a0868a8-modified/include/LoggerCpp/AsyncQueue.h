@@ -0,0 +1,151 @@
+/**
+ * @file    AsyncQueue.h
+ * @ingroup LoggerCpp
+ * @brief   Bounded lock-free queue of Log records for the asynchronous mode of the Manager
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include <LoggerCpp/Log.h>
+#include <LoggerCpp/Channel.h>
+#include <LoggerCpp/DateTime.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Log {
+
+
+/**
+ * @brief   A Log formatted by a producer thread, waiting for the writer thread
+ * @ingroup LoggerCpp
+ */
+struct AsyncRecord {
+    Channel::Ptr    mChannelPtr;    ///< Channel of the Log
+    Log::Level      mSeverity;      ///< Severity of the Log
+    DateTime        mTime;          ///< Timestamp taken by the producer
+    std::string     mMessage;       ///< Text of the Log (the capacity is kept when the slot is reused)
+};
+
+/**
+ * @brief   Bounded lock-free multi-producer single-consumer queue of AsyncRecord
+ * @ingroup LoggerCpp
+ *
+ *  Ring buffer of slots, each with a sequence number telling whether it is free
+ * for the producer of a given position or full for the consumer (D. Vyukov's bounded
+ * queue). Producers claim a position with a compare-and-swap and never wait for
+ * each other or for the consumer: when the ring is full, tryPush() returns false.
+ */
+class AsyncQueue {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param[in] aCapacity Number of records, rounded up to a power of 2 (at least 2)
+     */
+    explicit AsyncQueue(size_t aCapacity) :
+        mEnqueuePos(0),
+        mDequeuePos(0) {
+        size_t capacity = 2;
+        while (capacity < aCapacity) {
+            capacity <<= 1;
+        }
+        mMask = capacity - 1;
+        mCells = std::vector<Cell>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Number of records the queue can hold
+    inline size_t capacity(void) const {
+        return mMask + 1;
+    }
+
+    /**
+     * @brief Copy a Log into the queue (any thread)
+     *
+     * @return false if the queue is full (nothing was copied)
+     */
+    bool tryPush(const Channel::Ptr& aChannelPtr, Log::Level aSeverity, const DateTime& aTime,
+                 const char* apMessage, size_t aSize) {
+        Cell*   pCell;
+        size_t  pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            pCell = &mCells[pos & mMask];
+            size_t  seq = pCell->mSequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (0 == diff) {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // full: the consumer has not freed this slot yet
+            } else {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        pCell->mRecord.mChannelPtr = aChannelPtr;
+        pCell->mRecord.mSeverity = aSeverity;
+        pCell->mRecord.mTime = aTime;
+        pCell->mRecord.mMessage.assign(apMessage, aSize);
+        pCell->mSequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest record out of the queue (writer thread only)
+     *
+     * The message string is swapped with the one of aRecord, so the memory of
+     * both keeps being reused.
+     *
+     * @return false if the queue is empty
+     */
+    bool tryPop(AsyncRecord& aRecord) {
+        Cell*   pCell = &mCells[mDequeuePos & mMask];
+        size_t  seq = pCell->mSequence.load(std::memory_order_acquire);
+        if (seq != mDequeuePos + 1) {
+            return false;
+        }
+
+        aRecord.mChannelPtr.swap(pCell->mRecord.mChannelPtr);
+        aRecord.mSeverity = pCell->mRecord.mSeverity;
+        aRecord.mTime = pCell->mRecord.mTime;
+        aRecord.mMessage.swap(pCell->mRecord.mMessage);
+        pCell->mSequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return true;
+    }
+
+private:
+    /// @brief One slot of the ring
+    struct Cell {
+        std::atomic<size_t> mSequence;
+        AsyncRecord         mRecord;
+
+        Cell(void) : mSequence(0) {}
+    };
+
+    /// @{ Non-copyable object
+    AsyncQueue(const AsyncQueue&);
+    void operator=(const AsyncQueue&);
+    /// @}
+
+private:
+    std::vector<Cell>   mCells;         ///< The ring of slots
+    size_t              mMask;          ///< capacity - 1
+    alignas(64) std::atomic<size_t> mEnqueuePos;  ///< Next position for the producers
+    alignas(64) size_t  mDequeuePos;    ///< Next position for the consumer (writer thread only)
+};
+
+
+} // namespace Log
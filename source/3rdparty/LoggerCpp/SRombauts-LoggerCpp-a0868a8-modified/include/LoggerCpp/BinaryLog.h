@@ -0,0 +1,323 @@
+/**
+ * @file    BinaryLog.h
+ * @ingroup LoggerCpp
+ * @brief   Binary logging with deferred formatting, for hot call sites
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include <LoggerCpp/Log.h>
+#include <LoggerCpp/Logger.h>
+#include <LoggerCpp/Channel.h>
+#include <LoggerCpp/LogStream.h>
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+
+/**
+ * @brief Log through the binary fast path (see BinaryLog).
+ *
+ * The format is a string literal with one "{}" per argument. Arguments can be
+ * integers, bool, char, floating point numbers, pointers, C strings and std::string.
+ *
+ * @code
+ * LOGGER_BINARY(*loggerp, Log::Log::eDebug, "Got buffer with {} bytes", sp_frame->num_items());
+ * @endcode
+ *
+ * The format is registered once per call site (function local static), and nothing
+ * is evaluated if the Logger level filters the Log out. Like LOGGER_DEBUG() and the
+ * others, call sites below LOGGER_MIN_LEVEL are removed at compile time.
+ */
+#define LOGGER_BINARY(aLogger, aSeverity, aFormat, ...)                                                 \
+    do {                                                                                                \
+        if ((static_cast<int>(aSeverity) >= LOGGER_MIN_LEVEL) && ((aSeverity) >= (aLogger).getLevel())) { \
+            static const uint32_t sLoggerBinaryFormatId =                                               \
+                ::Log::BinaryLog::registerFormat(__FILE__, __LINE__, aFormat);                          \
+            ::Log::BinaryLog::write((aLogger), (aSeverity), sLoggerBinaryFormatId, ##__VA_ARGS__);      \
+        }                                                                                               \
+    } while (0)
+
+
+namespace Log {
+
+
+/**
+ * @brief   Binary logging with deferred formatting
+ * @ingroup LoggerCpp
+ *
+ *  A call site (see LOGGER_BINARY) records the id of its format string, a raw
+ * timestamp and the raw bytes of its arguments into a ring buffer owned by the
+ * calling thread. There is no string stream, no string building and no lock, so
+ * it costs tens of nanoseconds instead of the microseconds of a text Log.
+ *
+ *  A background thread takes the records out of the thread buffers, in timestamp
+ * order, and either
+ * - eText: formats them into text and outputs them like any other Log
+ *   (through the asynchronous queue of the Manager if that mode is on), or
+ * - eFile: appends them, still in binary, to a file which decodeFile() (see the
+ *   main_LoggerCpp_binary_log program) turns into text later.
+ *
+ *  Before start() (or after stop()), LOGGER_BINARY formats and outputs the Log
+ * directly on the calling thread, so nothing is lost, only slower.
+ *
+ *  When the buffer of a thread is full, the record is dropped and counted.
+ */
+class BinaryLog {
+public:
+    /// @brief What the background thread does with the records
+    enum Mode {
+        eText = 0,  ///< Format into text and output them through the Manager
+        eFile       ///< Write them as they are to a binary file (decode with decodeFile())
+    };
+
+    /**
+     * @brief Start the background thread.
+     *
+     * @param[in] aMode             What to do with the records
+     * @param[in] apFilename        Binary file (eFile mode only): truncated
+     * @param[in] aThreadBufferSize Size of the ring buffer of each thread (bytes)
+     *
+     * @return false if the binary file cannot be created or it is already started
+     */
+    static bool start(Mode aMode = eText, const char* apFilename = nullptr, size_t aThreadBufferSize = 256 * 1024);
+
+    /// @brief Write out all the records and stop the background thread (also called by Manager::terminate())
+    static void stop(void);
+
+    /// @brief true while the background thread runs
+    static bool isRunning(void);
+
+    /// @brief Number of records dropped because the buffer of their thread was full
+    static unsigned long long getDroppedCount(void);
+
+    /**
+     * @brief Register the format string of a call site (once, see LOGGER_BINARY)
+     *
+     * @return Id of the format, stored in the records
+     */
+    static uint32_t registerFormat(const char* apFile, int aLine, const char* apFormat);
+
+    /**
+     * @brief Record a Log (see LOGGER_BINARY, which also checks the Logger level)
+     */
+    template <typename... Args>
+    static void write(const Logger& aLogger, Log::Level aSeverity, uint32_t aFormatId, const Args&... aArgs) {
+        size_t size = sizeof(RecordHeader) + argsSize(aArgs...);
+        if (size > kMaxRecordSize) {
+            size = kMaxRecordSize;  // strings are truncated to fit, see putString()
+        }
+        size = (size + 7) & ~static_cast<size_t>(7);
+
+        char    localBuffer[kMaxRecordSize];
+        char*   pRecord = reserve(size);
+        bool    bLocal = (nullptr == pRecord);
+        if (bLocal) {
+            if (isRunning()) {
+                return;     // thread buffer full: counted as dropped by reserve()
+            }
+            pRecord = localBuffer;
+        }
+
+        RecordHeader* pHeader = reinterpret_cast<RecordHeader*>(pRecord);
+        pHeader->mSize = static_cast<uint32_t>(size);
+        pHeader->mFormatId = aFormatId;
+        pHeader->mTimestamp = now();
+        pHeader->mChannelId = channelId(aLogger);
+        pHeader->mSeverity = static_cast<uint8_t>(aSeverity);
+        pHeader->mNbArgs = static_cast<uint8_t>(sizeof...(aArgs));
+        char* pEnd = pRecord + size;
+        char* pArg = pRecord + sizeof(RecordHeader);
+        putArgs(pArg, pEnd, aArgs...);
+        // Unused space at the end (rounding up, truncated strings) is left as it is
+
+        if (bLocal) {
+            outputNow(pRecord);
+        } else {
+            commit(size);
+        }
+    }
+
+    /**
+     * @brief Turn a binary file written in eFile mode into text
+     *
+     * @param[in] apFilename    The binary file
+     * @param[in] apOutput      Where the text goes (same layout as OutputFile)
+     *
+     * @return Number of records decoded, or -1 if the file cannot be read or is not a binary log
+     */
+    static long decodeFile(const char* apFilename, FILE* apOutput);
+
+    /**
+     * @brief Output the text of a record like any other Log (used by the background thread)
+     */
+    static void outputFormatted(const Channel::Ptr& aChannelPtr, Log::Level aSeverity, const DateTime& aTime,
+                                LogStream& aStream);
+
+public:
+    /// @brief Type tag of each argument in a record
+    enum ArgType {
+        eArgInt = 1,    ///< int64_t
+        eArgUInt,       ///< uint64_t
+        eArgDouble,     ///< double
+        eArgBool,       ///< uint8_t
+        eArgChar,       ///< char
+        eArgPointer,    ///< uint64_t (shown in hex)
+        eArgString      ///< uint16_t length, then the characters
+    };
+
+    /// @brief Start of each record (followed by the arguments)
+    struct RecordHeader {
+        uint32_t    mSize;          ///< Size of the record including this header, multiple of 8
+        uint32_t    mFormatId;      ///< From registerFormat() (0 = padding up to the end of the ring)
+        uint64_t    mTimestamp;     ///< CLOCK_REALTIME, in nanoseconds
+        uint32_t    mChannelId;     ///< See channelId()
+        uint8_t     mSeverity;      ///< Log::Level
+        uint8_t     mNbArgs;        ///< Number of arguments
+        uint16_t    mReserved;
+    };
+
+    /// @brief Largest record (longer strings are truncated)
+    static const size_t kMaxRecordSize = 2048;
+
+private:
+    /// @{ Fixed-size encoding of the arguments
+    static inline size_t argSize(bool)          { return 1 + sizeof(uint8_t); }
+    static inline size_t argSize(char)          { return 1 + sizeof(char); }
+    static inline size_t argSize(float)         { return 1 + sizeof(double); }
+    static inline size_t argSize(double)        { return 1 + sizeof(double); }
+    static inline size_t argSize(long double)   { return 1 + sizeof(double); }
+    static inline size_t argSize(const char* apString) {
+        return 1 + sizeof(uint16_t) + ((nullptr != apString) ? strlen(apString) : 0);
+    }
+    static inline size_t argSize(const std::string& aString) {
+        return 1 + sizeof(uint16_t) + aString.size();
+    }
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, size_t>::type
+    argSize(const T&) {
+        return 1 + sizeof(uint64_t);
+    }
+    template <typename T>
+    static inline size_t argSize(const T* const&) {
+        return 1 + sizeof(uint64_t);
+    }
+    template <size_t N>
+    static inline size_t argSize(const char (&aString)[N]) {
+        return argSize(static_cast<const char*>(aString));
+    }
+
+    static inline size_t argsSize(void) {
+        return 0;
+    }
+    template <typename T, typename... Rest>
+    static inline size_t argsSize(const T& aArg, const Rest&... aRest) {
+        return argSize(aArg) + argsSize(aRest...);
+    }
+
+    static inline void putRaw(char*& apDest, char* apEnd, ArgType aType, const void* apValue, size_t aSize) {
+        if (apDest + 1 + aSize <= apEnd) {
+            *apDest++ = static_cast<char>(aType);
+            memcpy(apDest, apValue, aSize);
+            apDest += aSize;
+        }
+    }
+    static inline void putString(char*& apDest, char* apEnd, const char* apString, size_t aLength) {
+        if (apDest + 1 + sizeof(uint16_t) > apEnd) {
+            return;
+        }
+        size_t room = static_cast<size_t>(apEnd - apDest) - 1 - sizeof(uint16_t);
+        uint16_t length = static_cast<uint16_t>((aLength < room) ? aLength : room);
+        *apDest++ = static_cast<char>(eArgString);
+        memcpy(apDest, &length, sizeof(length));
+        apDest += sizeof(length);
+        memcpy(apDest, apString, length);
+        apDest += length;
+    }
+
+    static inline void putArg(char*& apDest, char* apEnd, bool aValue) {
+        uint8_t value = aValue ? 1 : 0;
+        putRaw(apDest, apEnd, eArgBool, &value, sizeof(value));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, char aValue) {
+        putRaw(apDest, apEnd, eArgChar, &aValue, sizeof(aValue));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, float aValue) {
+        double value = aValue;
+        putRaw(apDest, apEnd, eArgDouble, &value, sizeof(value));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, double aValue) {
+        putRaw(apDest, apEnd, eArgDouble, &aValue, sizeof(aValue));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, long double aValue) {
+        double value = static_cast<double>(aValue);
+        putRaw(apDest, apEnd, eArgDouble, &value, sizeof(value));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, const char* apString) {
+        if (nullptr == apString) {
+            apString = "(null)";
+        }
+        putString(apDest, apEnd, apString, strlen(apString));
+    }
+    static inline void putArg(char*& apDest, char* apEnd, const std::string& aString) {
+        putString(apDest, apEnd, aString.data(), aString.size());
+    }
+    template <size_t N>
+    static inline void putArg(char*& apDest, char* apEnd, const char (&aString)[N]) {
+        putArg(apDest, apEnd, static_cast<const char*>(aString));
+    }
+    template <typename T>
+    static inline typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value)
+                                          && std::is_signed<T>::value>::type
+    putArg(char*& apDest, char* apEnd, const T& aValue) {
+        int64_t value = static_cast<int64_t>(aValue);
+        putRaw(apDest, apEnd, eArgInt, &value, sizeof(value));
+    }
+    template <typename T>
+    static inline typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value)
+                                          && !std::is_signed<T>::value>::type
+    putArg(char*& apDest, char* apEnd, const T& aValue) {
+        uint64_t value = static_cast<uint64_t>(aValue);
+        putRaw(apDest, apEnd, eArgUInt, &value, sizeof(value));
+    }
+    template <typename T>
+    static inline void putArg(char*& apDest, char* apEnd, const T* const& apValue) {
+        uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(apValue));
+        putRaw(apDest, apEnd, eArgPointer, &value, sizeof(value));
+    }
+
+    static inline void putArgs(char*&, char*) {
+    }
+    template <typename T, typename... Rest>
+    static inline void putArgs(char*& apDest, char* apEnd, const T& aArg, const Rest&... aRest) {
+        putArg(apDest, apEnd, aArg);
+        putArgs(apDest, apEnd, aRest...);
+    }
+    /// @}
+
+    /// @brief Space for a record in the buffer of the calling thread (nullptr if full or not started)
+    static char*    reserve(size_t aSize);
+
+    /// @brief Make the record written in the space given by reserve() visible to the background thread
+    static void     commit(size_t aSize);
+
+    /// @brief Current time (CLOCK_REALTIME in nanoseconds)
+    static uint64_t now(void);
+
+    /// @brief Small number identifying the Channel of the Logger in the records
+    static uint32_t channelId(const Logger& aLogger);
+
+    /// @brief Format and output a record on the calling thread (when not started)
+    static void     outputNow(const char* apRecord);
+};
+
+
+} // namespace Log
@@ -12,6 +12,7 @@
 
 #include <LoggerCpp/Log.h>
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -50,7 +51,8 @@ public:
      */
     Channel(const char* apChannelName, Log::Level aChannelLevel) :
         mName(apChannelName),
-        mLevel(aChannelLevel)
+        mLevel(aChannelLevel),
+        mBinaryId(-1)
     {}
 
     /// @brief Non virtual destructor
@@ -62,14 +64,24 @@ public:
         return mName;
     }
 
-    /// @brief Set the current output Log::Level of the Channel
+    /// @brief Set the current output Log::Level of the Channel (from any thread)
     inline void setLevel(Log::Level aLevel) {
-        mLevel = aLevel;
+        mLevel.store(aLevel, std::memory_order_relaxed);
     }
 
     /// @brief Current Log::Level of the Channel
     inline Log::Level getLevel(void) const {
-        return mLevel;
+        return mLevel.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Id of the Channel in the BinaryLog records (-1 until it is first used there)
+    inline int getBinaryId(void) const {
+        return mBinaryId.load(std::memory_order_acquire);
+    }
+
+    /// @brief Set the id of the Channel in the BinaryLog records (by BinaryLog only)
+    inline void setBinaryId(int aBinaryId) {
+        mBinaryId.store(aBinaryId, std::memory_order_release);
     }
 
 private:
@@ -80,7 +92,8 @@ private:
 
 private:
     std::string mName;  ///< Name of the Channel
-    Log::Level  mLevel; ///< Current Log::Level of the Channel
+    std::atomic<Log::Level> mLevel; ///< Current Log::Level of the Channel
+    std::atomic<int> mBinaryId; ///< Id of the Channel in the BinaryLog records
 };
 
 
@@ -10,6 +10,8 @@
  */
 #pragma once
 
+#include <cstddef>
+
 
 namespace Log {
 
@@ -21,9 +23,42 @@ namespace Log {
  * Using a struct to enable easy direct access to public members.
  *
  * Under Windows, the time is given to the millisecond.
- * Under Linux, the time is given to the microsecond.
+ * Under Linux, the time is given to the microsecond, from the Clock chosen with setClock().
+ *
+ *  Each thread keeps the broken-down local time of the last second it saw, so
+ * make() only calls localtime_r() once per second, and the text of the last
+ * second it formatted, so format() only writes the milliseconds in most cases.
  */
 struct DateTime {
+    /**
+     * @brief Clock used by make() (Linux only, Windows always uses GetLocalTime())
+     */
+    enum Clock {
+        eRealtime = 0,      ///< CLOCK_REALTIME (default)
+        eRealtimeCoarse,    ///< CLOCK_REALTIME_COARSE: cheaper, but only as precise as the kernel tick (1 to 10 ms)
+        eTsc                ///< CPU time stamp counter, calibrated against CLOCK_REALTIME by setClock()
+    };
+
+    /// @brief Size of the text written by format(), including the terminating null character
+    static const size_t kFormatSize = 24;
+
+    /**
+     * @brief Choose the clock used by make(), for all threads.
+     *
+     * eTsc needs an invariant time stamp counter (x86 only). setClock(eTsc) takes about
+     * 20 milliseconds to calibrate it, and anchors it to CLOCK_REALTIME: it does not
+     * follow later adjustments of the system time (call setClock(eTsc) again to re-anchor it:
+     * this is safe while other threads are logging).
+     *
+     * @param[in] aClock    The clock
+     *
+     * @return false if this clock is not available here (the clock is then left unchanged)
+     */
+    static bool setClock(Clock aClock);
+
+    /// @brief Clock currently used by make()
+    static Clock getClock(void);
+
     /**
      * @brief Constructor
      */
@@ -34,6 +69,23 @@ struct DateTime {
      */
     void make(void);
 
+    /**
+     * @brief Set to a time taken earlier (local time of a point in time since the Epoch)
+     *
+     * @param[in] aSeconds      Seconds since the Epoch
+     * @param[in] aMicroseconds Microseconds within that second
+     */
+    void make(long long aSeconds, int aMicroseconds);
+
+    /**
+     * @brief Write the time as "YYYY-MM-DD hh:mm:ss.mmm"
+     *
+     * @param[out] apBuffer At least kFormatSize characters
+     *
+     * @return apBuffer
+     */
+    const char* format(char* apBuffer) const;
+
     int year;    ///< year    [0,30827]
     int month;   ///< month   [1,12]
     int day;     ///< day     [1,31]
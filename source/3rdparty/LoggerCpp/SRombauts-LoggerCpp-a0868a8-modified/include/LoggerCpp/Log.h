@@ -11,6 +11,7 @@
 #pragma once
 
 #include <LoggerCpp/DateTime.h>
+#include <LoggerCpp/LogStream.h>
 #include <LoggerCpp/Utils.h>
 
 #include <sstream>
@@ -22,6 +23,8 @@ namespace Log {
 
 // forward declaration
 class Logger;
+struct Manager;
+class BinaryLog;
 
 
 /**
@@ -40,6 +43,8 @@ class Logger;
  */
 class Log {
     friend class Logger;
+    friend struct Manager;
+    friend class BinaryLog;
 
 public:
     /**
@@ -86,7 +91,7 @@ public:
     }
 
     /// @brief The underlying string stream
-    inline const std::ostringstream& getStream(void) const {
+    inline const LogStream& getStream(void) const {
         return *mpStream;
     }
 
@@ -117,16 +122,27 @@ private:
      */
     Log(const Logger& aLogger, Level aSeverity);
 
+    /**
+     * @brief Construct a Log from a record already formatted on another thread.
+     * Used by the asynchronous writer of the Manager and by BinaryLog; output nothing on destruction.
+     *
+     * @param[in] aSeverity Severity of the Log
+     * @param[in] aTime     Timestamp taken when the Log was produced
+     * @param[in] aStream   Stream holding the text of the Log (owned by the caller)
+     */
+    Log(Level aSeverity, const DateTime& aTime, LogStream& aStream);
+
     /// @{ Non-copyable object
     Log(const Log&);
     void operator=(const Log&);
     /// @}
 
 private:
-    const Logger&       mLogger;    ///< Reference to the parent Logger
-    Level               mSeverity;  ///< Severity of this Log
-    DateTime            mTime;      ///< Timestamp of the output
-    std::ostringstream* mpStream;   ///< The underlying string stream
+    const Logger*       mpLogger;       ///< Pointer to the parent Logger (nullptr for an asynchronous record)
+    Level               mSeverity;      ///< Severity of this Log
+    DateTime            mTime;          ///< Timestamp of the output
+    LogStream*          mpStream;       ///< The underlying string stream
+    bool                mbOwnStream;    ///< The stream was allocated for this Log (the thread stream was busy)
 };
 
 
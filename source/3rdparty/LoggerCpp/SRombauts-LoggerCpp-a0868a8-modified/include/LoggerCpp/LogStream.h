@@ -0,0 +1,99 @@
+/**
+ * @file    LogStream.h
+ * @ingroup LoggerCpp
+ * @brief   Reusable string stream holding the text of a Log
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <cstddef>
+
+
+namespace Log {
+
+
+/**
+ * @brief   Reusable string stream holding the text of a Log
+ * @ingroup LoggerCpp
+ *
+ *  Same use as a std::ostringstream, but the formatted text can be read in place
+ * (data() and size()) without the copy made by str(), and the stream can be reset
+ * for the next Log without releasing its buffer. Each thread keeps one of these
+ * for its Log objects (see Log.cpp), so logging does not allocate in steady state.
+ */
+class LogStream : public std::ostream {
+public:
+    /// @brief Constructor
+    LogStream(void) :
+        std::ostream(&mBuffer) {
+    }
+
+    /// @brief Copy of the text (same as std::ostringstream::str())
+    inline std::string str(void) const {
+        return mBuffer.str();
+    }
+
+    /// @brief Start of the text, not null terminated (valid until the next output to the stream)
+    inline const char* data(void) const {
+        return mBuffer.data();
+    }
+
+    /// @brief Number of characters in the text
+    inline size_t size(void) const {
+        return mBuffer.size();
+    }
+
+    /**
+     * @brief Empty the stream and restore the default formatting flags,
+     * keeping the memory already allocated for the text.
+     */
+    void reset(void) {
+        mBuffer.reset();
+        clear();
+        flags(std::ios_base::skipws | std::ios_base::dec);
+        precision(6);
+        width(0);
+        fill(' ');
+    }
+
+private:
+    /// @brief std::stringbuf giving access to the characters written so far
+    class Buffer : public std::stringbuf {
+    public:
+        Buffer(void) :
+            std::stringbuf(std::ios_base::out) {
+        }
+        inline const char* data(void) const {
+            return pbase();
+        }
+        inline size_t size(void) const {
+            return static_cast<size_t>(pptr() - pbase());
+        }
+        inline void reset(void) {
+            // Moves the put pointer back to the start: the buffer itself is kept.
+            // The (unused) get area is emptied too, since str() returns everything
+            // up to the end of the get area if that is past the put pointer.
+            char* pBase = pbase();
+            setp(pBase, epptr());
+            setg(pBase, pBase, pBase);
+        }
+    };
+
+    /// @{ Non-copyable object
+    LogStream(const LogStream&);
+    void operator=(const LogStream&);
+    /// @}
+
+private:
+    Buffer  mBuffer;    ///< The underlying string buffer
+};
+
+
+} // namespace Log
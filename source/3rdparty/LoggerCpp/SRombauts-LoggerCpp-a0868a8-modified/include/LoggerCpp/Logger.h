@@ -16,6 +16,44 @@
 #include <string>
 
 
+/**
+ * @brief Lowest severity Level (0=Debug ... 5=Critic) compiled in by LOGGER_DEBUG() ... LOGGER_CRITIC()
+ *
+ * Defined on the compiler command line to remove the call sites of the lower Levels from
+ * a build entirely. Default (0) keeps them all, so the runtime Level alone decides.
+ */
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Log to a stream, evaluating the streamed values only if the Log is to be output.
+ *
+ * A Logger method like "aLogger.debug() << std::to_string(x)" evaluates all its operands
+ * even when the Level of the Channel filters the Log out. These macros test the Level first:
+ *
+ * @code
+ * LOGGER_DEBUG(*loggerp) << "Started the process " << Utility::string_enquote(process);
+ * @endcode
+ *
+ * Below LOGGER_MIN_LEVEL the test is a constant, and the compiler drops the call site.
+ * The single pass "for" (rather than an "if") keeps the macro safe, and free of
+ * dangling "else" warnings, inside an unbraced if/else of the caller.
+ */
+#define LOGGER_STREAM(aLogger, aSeverity, aMethod)                                                          \
+    for (bool bLoggerEnabled = (static_cast<int>(aSeverity) >= LOGGER_MIN_LEVEL) &&                         \
+                               ((aSeverity) >= (aLogger).getLevel());                                       \
+         bLoggerEnabled; bLoggerEnabled = false)                                                            \
+        (aLogger).aMethod()
+
+#define LOGGER_DEBUG(aLogger)   LOGGER_STREAM(aLogger, ::Log::Log::eDebug,   debug)     ///< @brief See LOGGER_STREAM
+#define LOGGER_INFO(aLogger)    LOGGER_STREAM(aLogger, ::Log::Log::eInfo,    info)      ///< @brief See LOGGER_STREAM
+#define LOGGER_NOTICE(aLogger)  LOGGER_STREAM(aLogger, ::Log::Log::eNotice,  notice)    ///< @brief See LOGGER_STREAM
+#define LOGGER_WARNING(aLogger) LOGGER_STREAM(aLogger, ::Log::Log::eWarning, warning)   ///< @brief See LOGGER_STREAM
+#define LOGGER_ERROR(aLogger)   LOGGER_STREAM(aLogger, ::Log::Log::eError,   error)     ///< @brief See LOGGER_STREAM
+#define LOGGER_CRITIC(aLogger)  LOGGER_STREAM(aLogger, ::Log::Log::eCritic,  critic)    ///< @brief See LOGGER_STREAM
+
+
 /**
  * @brief   LoggerC++ (LoggerCpp) is a simple, elegant and efficient C++ logger library.
  * @ingroup LoggerCpp
@@ -35,6 +73,7 @@ namespace Log {
  */
 class Logger {
     friend class Log;
+    friend class BinaryLog;
 
 public:
     /**
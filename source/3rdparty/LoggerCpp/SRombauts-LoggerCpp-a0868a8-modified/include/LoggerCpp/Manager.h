@@ -15,10 +15,15 @@
 #include <LoggerCpp/Output.h>
 #include <LoggerCpp/Config.h>
 
+#include <atomic>
+
 
 namespace Log {
 
 
+// forward declaration
+class AsyncQueue;
+
 /**
  * @brief   The static class that manage the registered channels and outputs
  * @ingroup LoggerCpp
@@ -30,9 +35,23 @@ namespace Log {
  * impacting all the Logger objects using it.
  *
  * The Manager also keeps a list of all configured Output object to output the Log objects.
+ *
+ *  Any thread can log, create Logger objects and change Channel levels at any time.
+ * The Channel map and the Output list are never modified once published: get()
+ * and configure() publish a modified copy, and delete the old one only once no
+ * thread can still be reading it. Logging thus takes no lock in the Manager, and
+ * each Output serializes its own output() calls if it needs to (see OutputFile).
  */
 struct Manager {
 public:
+    /**
+     * @brief What a producer does when the asynchronous queue is full
+     */
+    enum AsyncOverflow {
+        eDropIfFull = 0,    ///< Drop the Log and count it (see getDroppedCount()): never blocks
+        eBlockIfFull        ///< Wait for the writer thread to make room
+    };
+
     /**
      * @brief Create and configure the Output objects.
      *
@@ -45,10 +64,38 @@ public:
     /**
      * @brief Destroy the Output objects.
      * 
-     * Clear the Output list to release the ownership.
+     * Stop the BinaryLog and the asynchronous writer if they are running (writing out the queued Logs),
+     * then clear the Output list to release the ownership.
      */
     static void         terminate(void);
 
+    /**
+     * @brief Switch to asynchronous output.
+     *
+     * From now on, output() only copies the Log into a bounded lock-free queue, and a
+     * writer thread passes the queued Logs to the Output objects in batches (flushing
+     * once per batch instead of once per Log). The thread producing a Log never waits
+     * on the disk or the console. Call after configure(), from the main thread.
+     * Does nothing if the asynchronous mode is already on.
+     *
+     * @param[in] aQueueSize    Number of Logs the queue can hold (rounded up to a power of 2)
+     * @param[in] aOverflow     What to do when the queue is full
+     */
+    static void         startAsync(size_t aQueueSize = 8192, AsyncOverflow aOverflow = eDropIfFull);
+
+    /**
+     * @brief Write out the queued Logs, stop the writer thread and go back to synchronous output.
+     *
+     * Also called by terminate(), and at exit.
+     */
+    static void         stopAsync(void);
+
+    /// @brief true while the asynchronous mode is on
+    static bool         isAsync(void);
+
+    /// @brief Number of Logs dropped because the asynchronous queue was full (since the program started)
+    static unsigned long long getDroppedCount(void);
+
     /**
      * @brief Return the Channel corresponding to the provided name
      *
@@ -88,8 +135,15 @@ public:
     static void setChannelConfig(const Config::Ptr& aConfigPtr);
 
 private:
-    static Channel::Map     mChannelMap;    ///< Map of shared pointer of Channel objects
-    static Output::Vector   mOutputList;    ///< List of Output objects
+    /// @brief Synchronous output of the Log to all the active Output objects
+    static void outputToAll(const Channel::Ptr& aChannelPtr, const Log& aLog);
+
+    /// @brief Body of the writer thread of the asynchronous mode
+    static void asyncWriter(AsyncQueue* apQueue);
+
+private:
+    static std::atomic<const Channel::Map*>     mpChannelMap;   ///< Map of shared pointer of Channel objects (nullptr if empty)
+    static std::atomic<const Output::Vector*>   mpOutputList;   ///< List of Output objects (nullptr if empty)
     static Log::Level       mDefaultLevel;  ///< Default Log::Level of any new Channel
 };
 
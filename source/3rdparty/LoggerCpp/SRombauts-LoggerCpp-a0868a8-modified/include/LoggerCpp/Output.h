@@ -12,6 +12,7 @@
 
 #include <LoggerCpp/Channel.h>
 
+#include <atomic>
 #include <vector>
 #include <typeinfo>
 
@@ -34,6 +35,9 @@ class Log;
  */
 class Output {
 public:
+    /// @brief Constructor
+    Output() : mbBatched(false) {}
+
     /// @brief Virtual destructor
     virtual ~Output() {}
 
@@ -46,15 +50,34 @@ public:
     /**
      * @brief Output the Log
      *
+     * Called by any thread producing a Log, concurrently: an Output that is not
+     * naturally thread-safe serializes the calls itself.
+     *
      * @param[in] aChannelPtr   The underlying Channel of the Log
      * @param[in] aLog          The Log to output
      */
     virtual void output(const Channel::Ptr& aChannelPtr, const Log& aLog) const = 0;
 
+    /**
+     * @brief Write out what was buffered by output() calls made in batched mode
+     */
+    virtual void flush() const {}
+
+    /**
+     * @brief In batched mode output() does not flush after each Log: flush() is called
+     * after each batch instead (set by the asynchronous writer of the Manager).
+     */
+    inline void setBatched(bool abBatched) {
+        mbBatched = abBatched;
+    }
+
     /// @brief Return the type name of the Output object
     inline const char* name() const {
         return typeid(this).name();
     }
+
+protected:
+    std::atomic<bool> mbBatched;    ///< output() does not flush (see setBatched())
 };
 
 
@@ -13,6 +13,8 @@
 #include <LoggerCpp/Output.h>
 #include <LoggerCpp/Config.h>
 
+#include <mutex>
+
 
 namespace Log {
 
@@ -56,6 +58,14 @@ public:
      * @param[in] aLog          The Log to output
      */
     virtual void output(const Channel::Ptr& aChannelPtr, const Log& aLog) const;
+
+    /// @brief Flush stdout (batched mode)
+    virtual void flush() const;
+
+#ifdef _WIN32
+private:
+    mutable std::mutex mMutex;  ///< Keeps the color change and the text of a Log together
+#endif // _WIN32
 };
 
 
@@ -14,6 +14,7 @@
 #include <LoggerCpp/Config.h>
 
 #include <string>
+#include <mutex>
 
 
 namespace Log {
@@ -43,6 +44,9 @@ public:
      */
     virtual void output(const Channel::Ptr& aChannelPtr, const Log& aLog) const;
 
+    /// @brief Flush the file (batched mode)
+    virtual void flush() const;
+
 private:
     /// @brief Open the log file
     void open() const;
@@ -52,6 +56,7 @@ private:
     void rotate() const;
 
 private:
+    mutable std::mutex mMutex;  ///< @brief Serializes output(), rotate() and flush() between threads
     mutable FILE*   mpFile; ///< @brief File pointer (mutable to be modified in the const output method)
     mutable long    mSize;  ///< @brief Current size of the log file (mutable to be modified in the const output method)
 
@@ -0,0 +1,133 @@
+/**
+ * @file    OutputMmapFile.h
+ * @ingroup LoggerCpp
+ * @brief   Output to a memory mapped file, rotated by a background thread
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+#pragma once
+
+#ifdef __unix__
+
+#include <LoggerCpp/Output.h>
+#include <LoggerCpp/Config.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+
+namespace Log {
+
+
+/**
+ * @brief   Output to a memory mapped file, rotated by a background thread
+ * @ingroup LoggerCpp
+ *
+ *  The log file is made of fixed size segments: output() copies each line into the
+ * mapped memory of the current segment (no system call), and switches to the next
+ * segment when the current one is full. A background thread prepares the next segment
+ * in advance (create, allocate, map), and completes the full ones (msync, truncate to
+ * the size actually written, rename to "filename.1", "filename.2"... and remove the
+ * oldest), so a rotation costs the logging thread no more than a pointer swap.
+ *
+ *  The current segment keeps its full size (the end of the file is zero filled) until
+ * it is full or the Output is destroyed. Since the lines are written to the page cache
+ * directly, they are not lost if the process crashes.
+ */
+class OutputMmapFile : public Output {
+public:
+    /**
+     * @brief Constructor : create the first segment and start the background thread
+     *
+     * @param[in] aConfigPtr    Config the output file with "filename", "segment_size" and "max_segments"
+     */
+    explicit OutputMmapFile(const Config::Ptr& aConfigPtr);
+
+    /// @brief Destructor : stop the background thread, and truncate the current segment
+    virtual ~OutputMmapFile();
+
+    /**
+     * @brief Output the Log to the mapped memory of the current segment
+     *
+     * @param[in] aChannelPtr   The underlying Channel of the Log
+     * @param[in] aLog          The Log to output
+     */
+    virtual void output(const Channel::Ptr& aChannelPtr, const Log& aLog) const;
+
+    /// @brief Number of Logs dropped because no segment could be created
+    inline unsigned long getDroppedCount() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mDropped;
+    }
+
+private:
+    /// @brief A mapped segment of the log file
+    struct Segment {
+        Segment() : mFd(-1), mpData(nullptr), mUsed(0) {}
+        int     mFd;        ///< File descriptor of the segment
+        char*   mpData;     ///< Start of the mapped memory (nullptr if no segment)
+        size_t  mUsed;      ///< Number of bytes written to the segment
+    };
+
+    /// @brief Create, allocate and map a segment (returns false on error)
+    bool create(const std::string& aFilename, Segment& aSegment) const;
+    /// @brief Sync, unmap, truncate to the used size and close a segment
+    void complete(Segment& aSegment) const;
+    /// @brief Rename "filename" to "filename.1" (and so on), removing the oldest one
+    void shift() const;
+    /// @brief Switch to the next segment (mMutex locked), returns false if there is none
+    bool rollover() const;
+    /// @brief Background thread : prepares the next segment and completes the full ones
+    void run();
+
+private:
+    mutable std::mutex  mMutex;     ///< @brief Serializes output() between threads
+    mutable Segment     mCurrent;   ///< @brief Segment output() writes to
+    mutable unsigned long mDropped; ///< @brief Logs dropped because no segment could be created
+
+    mutable std::mutex              mWorkMutex; ///< @brief Protects the following members, shared with the background thread
+    mutable std::condition_variable mWorkCond;  ///< @brief Wakes the background thread up
+    mutable std::condition_variable mReadyCond; ///< @brief Signals that the next segment is ready
+    mutable Segment                 mNext;      ///< @brief Segment prepared by the background thread
+    mutable bool                    mbFailed;   ///< @brief The last attempt at creating the next segment failed
+    mutable std::vector<Segment>    mFull;      ///< @brief Full segments waiting to be completed
+    mutable bool                    mbPromote;  ///< @brief The next segment is in use, and is to be renamed "filename"
+    bool                            mbStop;     ///< @brief Asks the background thread to stop
+    std::thread                     mThread;    ///< @brief Background thread
+
+    /**
+     * @brief "segment_size" : Size of each segment of the log file.
+     *
+     * Default (64*1024*1024=64Mo). A single line longer than this is truncated.
+     */
+    size_t      mSegmentSize;
+
+    /**
+     * @brief "max_segments" : Number of full segments kept, as "filename.1" (the newest) to "filename.N".
+     *
+     * Default (4). With 0, full segments are removed.
+     */
+    long        mMaxSegments;
+
+    /**
+     * @brief "filename" : Name of the log file
+     */
+    std::string mFilename;
+
+    /**
+     * @brief Name of the next segment, renamed to "filename" once the previous one is completed
+     */
+    std::string mFilenameNext;
+};
+
+
+} // namespace Log
+
+#endif // __unix__
@@ -0,0 +1,711 @@
+/**
+ * @file    BinaryLog.cpp
+ * @ingroup LoggerCpp
+ * @brief   Binary logging with deferred formatting, for hot call sites
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#include <LoggerCpp/BinaryLog.h>
+#include <LoggerCpp/Manager.h>
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <time.h>
+
+
+namespace Log {
+
+
+namespace {
+
+// Ring buffer of records written by one thread and read by the background thread.
+// Positions only grow; the offset in the buffer is (position & mMask).
+struct ThreadRing {
+    explicit ThreadRing(size_t aSize) :
+        mBuffer(aSize),
+        mMask(aSize - 1),
+        mHead(0),
+        mTail(0),
+        mCachedTail(0),
+        mPending(0),
+        mbWriting(false),
+        mbExited(false) {
+    }
+
+    std::vector<char>       mBuffer;
+    size_t                  mMask;
+    alignas(64) std::atomic<uint64_t> mHead;    ///< End of the committed records (written by the thread)
+    alignas(64) std::atomic<uint64_t> mTail;    ///< End of the records read (written by the background thread)
+    alignas(64) uint64_t    mCachedTail;        ///< Last mTail seen by the thread
+    uint64_t                mPending;           ///< Position of the record being written (see reserve())
+    std::atomic<bool>       mbWriting;          ///< Between reserve() and commit(): stop() waits for it
+    std::atomic<bool>       mbExited;           ///< The thread is gone: free the ring once it is read
+};
+
+// A registered format string
+struct FormatInfo {
+    std::string mFile;
+    int         mLine;
+    std::string mFormat;
+};
+
+// Entries of the binary file (eFile mode), each one starting with a uint32_t type
+enum FileEntry {
+    eEntryFormat = 1,   ///< uint32_t id, int32_t line, uint16_t file length, uint16_t format length, file, format
+    eEntryChannel,      ///< uint32_t id, uint16_t name length, name
+    eEntryRecord        ///< the record as it is (RecordHeader then arguments)
+};
+
+const char      kFileMagic[8] = {'L', 'O', 'G', 'B', 'I', 'N', '1', '\n'};
+
+// The background thread wakes up this often to read the thread buffers
+const std::chrono::milliseconds kDrainPeriod(2);
+
+// Smallest ring of a thread
+const size_t    kMinThreadBufferSize = 16 * 1024;
+
+struct BinaryState {
+    BinaryState(void) :
+        mbRunning(false),
+        mbStop(false),
+        mMode(BinaryLog::eText),
+        mThreadBufferSize(256 * 1024),
+        mpFile(nullptr),
+        mDropped(0),
+        mbDraining(false),
+        mbAtExitRegistered(false) {
+    }
+
+    std::atomic<bool>           mbRunning;          ///< Records go to the thread buffers
+    std::atomic<bool>           mbStop;             ///< Tells the background thread to read everything and exit
+    BinaryLog::Mode             mMode;
+    size_t                      mThreadBufferSize;
+    FILE*                       mpFile;             ///< eFile mode
+    std::atomic<unsigned long long> mDropped;
+    std::thread                 mDrainer;
+    std::mutex                  mStartStopMutex;    ///< Serializes start()/stop()
+    std::mutex                  mWakeMutex;         ///< Only used with mWakeCondition
+    std::condition_variable     mWakeCondition;     ///< Wakes up the background thread to stop
+    std::mutex                  mRegistryMutex;     ///< Protects mbDraining and the three vectors below
+    bool                        mbDraining;         ///< The background thread runs: it frees the rings
+    std::vector<ThreadRing*>    mRings;
+    std::vector<FormatInfo>     mFormats;           ///< Index = format id - 1
+    std::vector<Channel::Ptr>   mChannels;          ///< Index = channel id
+    Channel::Ptr                mChannelPtr;        ///< Channel of the "records dropped" reports
+    bool                        mbAtExitRegistered;
+};
+
+BinaryState sBinary;
+
+// Gives the ring of a thread back when the thread ends
+struct ThreadRingOwner {
+    ThreadRingOwner(void) : mpRing(nullptr) {}
+    ~ThreadRingOwner(void) {
+        if (nullptr != mpRing) {
+            std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+            if (sBinary.mbDraining || (mpRing->mHead.load() != mpRing->mTail.load())) {
+                mpRing->mbExited = true;    // the background thread (or stop()) frees it after reading it
+            } else {
+                for (size_t i = 0; i < sBinary.mRings.size(); ++i) {
+                    if (sBinary.mRings[i] == mpRing) {
+                        sBinary.mRings.erase(sBinary.mRings.begin() + i);
+                        break;
+                    }
+                }
+                delete mpRing;
+            }
+        }
+    }
+    ThreadRing* mpRing;
+};
+
+thread_local ThreadRingOwner tRingOwner;
+
+void stopAtExit(void) {
+    BinaryLog::stop();
+}
+
+template <typename T>
+inline T readValue(const char* apData) {
+    T value;
+    memcpy(&value, apData, sizeof(value));
+    return value;
+}
+
+// Write the formatted text of a record (the format with its "{}" replaced by the arguments)
+void formatRecord(const std::string& aFormat, const char* apRecord, std::ostream& aStream) {
+    const BinaryLog::RecordHeader* pHeader = reinterpret_cast<const BinaryLog::RecordHeader*>(apRecord);
+    const char* pArg = apRecord + sizeof(BinaryLog::RecordHeader);
+    const char* pEnd = apRecord + pHeader->mSize;
+    size_t      nbArgs = pHeader->mNbArgs;
+    size_t      start = 0;
+
+    for (;;) {
+        size_t pos = aFormat.find("{}", start);
+        if ((std::string::npos == pos) || (0 == nbArgs)) {
+            aStream.write(aFormat.data() + start, aFormat.size() - start);
+            break;
+        }
+        aStream.write(aFormat.data() + start, pos - start);
+        start = pos + 2;
+
+        if (pArg >= pEnd) {
+            break;  // truncated record
+        }
+        --nbArgs;
+        switch (static_cast<BinaryLog::ArgType>(*pArg++)) {
+            case BinaryLog::eArgInt:
+                aStream << readValue<int64_t>(pArg);
+                pArg += sizeof(int64_t);
+                break;
+            case BinaryLog::eArgUInt:
+                aStream << readValue<uint64_t>(pArg);
+                pArg += sizeof(uint64_t);
+                break;
+            case BinaryLog::eArgDouble:
+                aStream << readValue<double>(pArg);
+                pArg += sizeof(double);
+                break;
+            case BinaryLog::eArgBool:
+                aStream << (readValue<uint8_t>(pArg) ? "true" : "false");
+                pArg += sizeof(uint8_t);
+                break;
+            case BinaryLog::eArgChar:
+                aStream << *pArg;
+                pArg += sizeof(char);
+                break;
+            case BinaryLog::eArgPointer:
+                aStream << "0x" << std::hex << readValue<uint64_t>(pArg) << std::dec;
+                pArg += sizeof(uint64_t);
+                break;
+            case BinaryLog::eArgString: {
+                uint16_t length = readValue<uint16_t>(pArg);
+                pArg += sizeof(uint16_t);
+                aStream.write(pArg, length);
+                pArg += length;
+                break;
+            }
+            default:
+                aStream << "{?}";
+                pArg = pEnd;
+                break;
+        }
+    }
+}
+
+// Turn a record timestamp into a DateTime
+DateTime toDateTime(uint64_t aTimestamp) {
+    DateTime time;
+    time.make(static_cast<long long>(aTimestamp / 1000000000ULL),
+              static_cast<int>((aTimestamp % 1000000000ULL) / 1000));
+    return time;
+}
+
+// Copies of the registry used by the background thread, refreshed when an unknown id shows up
+struct DrainCache {
+    DrainCache(void) : mFormatsWritten(0), mChannelsWritten(0) {}
+
+    const FormatInfo* format(uint32_t aId) {
+        if (aId > mFormats.size()) {
+            std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+            mFormats = sBinary.mFormats;
+        }
+        return (aId <= mFormats.size()) ? &mFormats[aId - 1] : nullptr;
+    }
+    const Channel::Ptr* channel(uint32_t aId) {
+        if (aId >= mChannels.size()) {
+            std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+            mChannels = sBinary.mChannels;
+        }
+        return (aId < mChannels.size()) ? &mChannels[aId] : nullptr;
+    }
+
+    std::vector<FormatInfo>     mFormats;
+    std::vector<Channel::Ptr>   mChannels;
+    size_t                      mFormatsWritten;    ///< eFile mode: definitions already in the file
+    size_t                      mChannelsWritten;
+};
+
+// eFile mode: write the definitions of formats and channels not yet in the file
+void writeDefinitions(DrainCache& aCache, FILE* apFile) {
+    for (; aCache.mFormatsWritten < aCache.mFormats.size(); ++aCache.mFormatsWritten) {
+        const FormatInfo& info = aCache.mFormats[aCache.mFormatsWritten];
+        uint32_t entry = eEntryFormat;
+        uint32_t id = static_cast<uint32_t>(aCache.mFormatsWritten + 1);
+        int32_t  line = info.mLine;
+        uint16_t fileLength = static_cast<uint16_t>(info.mFile.size());
+        uint16_t formatLength = static_cast<uint16_t>(info.mFormat.size());
+        fwrite(&entry, sizeof(entry), 1, apFile);
+        fwrite(&id, sizeof(id), 1, apFile);
+        fwrite(&line, sizeof(line), 1, apFile);
+        fwrite(&fileLength, sizeof(fileLength), 1, apFile);
+        fwrite(&formatLength, sizeof(formatLength), 1, apFile);
+        fwrite(info.mFile.data(), 1, fileLength, apFile);
+        fwrite(info.mFormat.data(), 1, formatLength, apFile);
+    }
+    for (; aCache.mChannelsWritten < aCache.mChannels.size(); ++aCache.mChannelsWritten) {
+        const std::string& name = aCache.mChannels[aCache.mChannelsWritten]->getName();
+        uint32_t entry = eEntryChannel;
+        uint32_t id = static_cast<uint32_t>(aCache.mChannelsWritten);
+        uint16_t nameLength = static_cast<uint16_t>(name.size());
+        fwrite(&entry, sizeof(entry), 1, apFile);
+        fwrite(&id, sizeof(id), 1, apFile);
+        fwrite(&nameLength, sizeof(nameLength), 1, apFile);
+        fwrite(name.data(), 1, nameLength, apFile);
+    }
+}
+
+// Pass one record on (text output or binary file)
+void handleRecord(DrainCache& aCache, const char* apRecord, LogStream& aStream) {
+    const BinaryLog::RecordHeader* pHeader = reinterpret_cast<const BinaryLog::RecordHeader*>(apRecord);
+    const FormatInfo*   pFormat = aCache.format(pHeader->mFormatId);
+    const Channel::Ptr* pChannelPtr = aCache.channel(pHeader->mChannelId);
+    if ((nullptr == pFormat) || (nullptr == pChannelPtr)) {
+        return;
+    }
+
+    if (BinaryLog::eFile == sBinary.mMode) {
+        writeDefinitions(aCache, sBinary.mpFile);
+        uint32_t entry = eEntryRecord;
+        fwrite(&entry, sizeof(entry), 1, sBinary.mpFile);
+        fwrite(apRecord, 1, pHeader->mSize, sBinary.mpFile);
+    } else {
+        aStream.reset();
+        formatRecord(pFormat->mFormat, apRecord, aStream);
+        BinaryLog::outputFormatted(*pChannelPtr, static_cast<Log::Level>(pHeader->mSeverity),
+                                   toDateTime(pHeader->mTimestamp), aStream);
+    }
+}
+
+// Offset of the next real record of a ring (skipping the padding at the end of the buffer),
+// or nullptr if the ring is empty
+const char* nextRecord(ThreadRing& aRing, uint64_t aHead) {
+    for (;;) {
+        uint64_t tail = aRing.mTail.load(std::memory_order_relaxed);
+        if (tail == aHead) {
+            return nullptr;
+        }
+        const char* pRecord = &aRing.mBuffer[tail & aRing.mMask];
+        const BinaryLog::RecordHeader* pHeader = reinterpret_cast<const BinaryLog::RecordHeader*>(pRecord);
+        if (0 != pHeader->mFormatId) {
+            return pRecord;
+        }
+        aRing.mTail.store(tail + pHeader->mSize, std::memory_order_release);
+    }
+}
+
+// Read the records of all the rings, oldest first; return the number of records
+size_t drainRings(DrainCache& aCache, LogStream& aStream) {
+    std::vector<ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+        rings = sBinary.mRings;
+    }
+
+    // Only the records committed before this point: the rest waits for the next pass
+    std::vector<uint64_t> heads(rings.size());
+    for (size_t i = 0; i < rings.size(); ++i) {
+        heads[i] = rings[i]->mHead.load(std::memory_order_acquire);
+    }
+
+    size_t count = 0;
+    for (;;) {
+        ThreadRing* pOldest = nullptr;
+        const char* pOldestRecord = nullptr;
+        uint64_t    oldestTimestamp = 0;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            const char* pRecord = nextRecord(*rings[i], heads[i]);
+            if (nullptr != pRecord) {
+                uint64_t timestamp = reinterpret_cast<const BinaryLog::RecordHeader*>(pRecord)->mTimestamp;
+                if ((nullptr == pOldest) || (timestamp < oldestTimestamp)) {
+                    pOldest = rings[i];
+                    pOldestRecord = pRecord;
+                    oldestTimestamp = timestamp;
+                }
+            }
+        }
+        if (nullptr == pOldest) {
+            break;
+        }
+        handleRecord(aCache, pOldestRecord, aStream);
+        uint32_t size = reinterpret_cast<const BinaryLog::RecordHeader*>(pOldestRecord)->mSize;
+        pOldest->mTail.store(pOldest->mTail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+        ++count;
+    }
+
+    // Free the rings of the threads that are gone, once they are read
+    std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+    for (size_t i = 0; i < sBinary.mRings.size();) {
+        ThreadRing* pRing = sBinary.mRings[i];
+        if (pRing->mbExited.load() && (pRing->mHead.load() == pRing->mTail.load())) {
+            sBinary.mRings.erase(sBinary.mRings.begin() + i);
+            delete pRing;
+        } else {
+            ++i;
+        }
+    }
+
+    return count;
+}
+
+// Body of the background thread
+void drainer(void) {
+    DrainCache          cache;
+    LogStream           stream;
+    unsigned long long  reportedDropped = sBinary.mDropped.load();
+
+    for (;;) {
+        bool bStop = sBinary.mbStop.load();
+        size_t count = drainRings(cache, stream);
+
+        unsigned long long dropped = sBinary.mDropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            DateTime now;
+            now.make();
+            stream.reset();
+            stream << (dropped - reportedDropped) << " binary log records dropped (thread buffer full, "
+                   << dropped << " in total)";
+            BinaryLog::outputFormatted(sBinary.mChannelPtr, Log::eWarning, now, stream);
+            reportedDropped = dropped;
+        }
+
+        if ((count > 0) && (nullptr != sBinary.mpFile)) {
+            fflush(sBinary.mpFile);
+        }
+        if (bStop) {
+            break;  // everything committed before the stop request is written out
+        }
+        if (0 == count) {
+            std::unique_lock<std::mutex> lock(sBinary.mWakeMutex);
+            if (!sBinary.mbStop.load()) {
+                sBinary.mWakeCondition.wait_for(lock, kDrainPeriod);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+
+// Start the background thread.
+bool BinaryLog::start(Mode aMode, const char* apFilename, size_t aThreadBufferSize) {
+    std::lock_guard<std::mutex> lock(sBinary.mStartStopMutex);
+    if (sBinary.mbRunning.load()) {
+        return false;
+    }
+
+    if (eFile == aMode) {
+        if (nullptr == apFilename) {
+            return false;
+        }
+        sBinary.mpFile = fopen(apFilename, "wb");
+        if (nullptr == sBinary.mpFile) {
+            return false;
+        }
+        fwrite(kFileMagic, 1, sizeof(kFileMagic), sBinary.mpFile);
+    }
+
+    if (!sBinary.mbAtExitRegistered) {
+        std::atexit(stopAtExit);
+        sBinary.mbAtExitRegistered = true;
+    }
+    if (!sBinary.mChannelPtr) {
+        sBinary.mChannelPtr = Manager::get("LoggerCpp");
+    }
+
+    size_t size = kMinThreadBufferSize;
+    while (size < aThreadBufferSize) {
+        size <<= 1;
+    }
+    sBinary.mThreadBufferSize = size;
+    sBinary.mMode = aMode;
+    sBinary.mbStop = false;
+    {
+        // Under the registry mutex: see ~ThreadRingOwner()
+        std::lock_guard<std::mutex> registryLock(sBinary.mRegistryMutex);
+        sBinary.mbRunning = true;
+        sBinary.mbDraining = true;
+    }
+    sBinary.mDrainer = std::thread(drainer);
+    return true;
+}
+
+// Write out all the records and stop the background thread
+void BinaryLog::stop(void) {
+    std::lock_guard<std::mutex> lock(sBinary.mStartStopMutex);
+    if (!sBinary.mbRunning.load()) {
+        return;
+    }
+
+    // New records are output directly from now on. Wait for the records being
+    // written right now: the last pass of the background thread must read them.
+    {
+        std::lock_guard<std::mutex> registryLock(sBinary.mRegistryMutex);
+        sBinary.mbRunning = false;
+    }
+    for (bool bWriting = true; bWriting;) {
+        bWriting = false;
+        {
+            std::lock_guard<std::mutex> registryLock(sBinary.mRegistryMutex);
+            for (ThreadRing* pRing : sBinary.mRings) {
+                bWriting = bWriting || pRing->mbWriting.load();
+            }
+        }
+        if (bWriting) {
+            std::this_thread::yield();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> wakeLock(sBinary.mWakeMutex);
+        sBinary.mbStop = true;
+    }
+    sBinary.mWakeCondition.notify_one();
+    sBinary.mDrainer.join();
+
+    // Every ring is read by now: free the rings of the threads that are gone (the
+    // others are kept for their thread, see ~ThreadRingOwner())
+    {
+        std::lock_guard<std::mutex> registryLock(sBinary.mRegistryMutex);
+        sBinary.mbDraining = false;
+        for (size_t i = 0; i < sBinary.mRings.size();) {
+            ThreadRing* pRing = sBinary.mRings[i];
+            if (pRing->mbExited.load()) {
+                sBinary.mRings.erase(sBinary.mRings.begin() + i);
+                delete pRing;
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    if (nullptr != sBinary.mpFile) {
+        fclose(sBinary.mpFile);
+        sBinary.mpFile = nullptr;
+    }
+}
+
+// true while the background thread runs
+bool BinaryLog::isRunning(void) {
+    return sBinary.mbRunning.load(std::memory_order_relaxed);
+}
+
+// Number of records dropped because the buffer of their thread was full
+unsigned long long BinaryLog::getDroppedCount(void) {
+    return sBinary.mDropped.load(std::memory_order_relaxed);
+}
+
+// Register the format string of a call site
+uint32_t BinaryLog::registerFormat(const char* apFile, int aLine, const char* apFormat) {
+    FormatInfo info;
+    info.mFile = (nullptr != apFile) ? apFile : "";
+    info.mLine = aLine;
+    info.mFormat = (nullptr != apFormat) ? apFormat : "";
+
+    std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+    sBinary.mFormats.push_back(info);
+    return static_cast<uint32_t>(sBinary.mFormats.size());  // 0 marks the padding records
+}
+
+// Space for a record in the buffer of the calling thread
+char* BinaryLog::reserve(size_t aSize) {
+    if (!sBinary.mbRunning.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    ThreadRing* pRing = tRingOwner.mpRing;
+    if (nullptr == pRing) {
+        pRing = new ThreadRing(sBinary.mThreadBufferSize);
+        std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+        sBinary.mRings.push_back(pRing);
+        tRingOwner.mpRing = pRing;
+    }
+
+    // stop() clears mbRunning, then waits for mbWriting: either it waits for this
+    // record, or this thread sees that it is stopped (both are seq_cst)
+    pRing->mbWriting.store(true);
+    if (!sBinary.mbRunning.load()) {
+        pRing->mbWriting.store(false, std::memory_order_release);
+        return nullptr;
+    }
+
+    const size_t    capacity = pRing->mMask + 1;
+    uint64_t        head = pRing->mHead.load(std::memory_order_relaxed);
+    size_t          offset = static_cast<size_t>(head & pRing->mMask);
+    // A record never wraps around: skip the end of the buffer if it does not fit
+    size_t          padding = (offset + aSize > capacity) ? (capacity - offset) : 0;
+
+    if (head + padding + aSize - pRing->mCachedTail > capacity) {
+        pRing->mCachedTail = pRing->mTail.load(std::memory_order_acquire);
+        if (head + padding + aSize - pRing->mCachedTail > capacity) {
+            sBinary.mDropped.fetch_add(1, std::memory_order_relaxed);
+            pRing->mbWriting.store(false, std::memory_order_release);
+            return nullptr;
+        }
+    }
+
+    if (padding > 0) {
+        RecordHeader* pPadding = reinterpret_cast<RecordHeader*>(&pRing->mBuffer[offset]);
+        pPadding->mSize = static_cast<uint32_t>(padding);
+        pPadding->mFormatId = 0;
+        head += padding;
+        offset = 0;
+    }
+    pRing->mPending = head;
+    return &pRing->mBuffer[offset];
+}
+
+// Make the record visible to the background thread
+void BinaryLog::commit(size_t aSize) {
+    ThreadRing* pRing = tRingOwner.mpRing;
+    pRing->mHead.store(pRing->mPending + aSize, std::memory_order_release);
+    pRing->mbWriting.store(false, std::memory_order_release);
+}
+
+// Current time (CLOCK_REALTIME in nanoseconds)
+uint64_t BinaryLog::now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// Small number identifying the Channel of the Logger in the records
+uint32_t BinaryLog::channelId(const Logger& aLogger) {
+    int id = aLogger.mChannelPtr->getBinaryId();
+    if (id < 0) {
+        std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+        id = aLogger.mChannelPtr->getBinaryId();
+        if (id < 0) {
+            id = static_cast<int>(sBinary.mChannels.size());
+            sBinary.mChannels.push_back(aLogger.mChannelPtr);
+            aLogger.mChannelPtr->setBinaryId(id);
+        }
+    }
+    return static_cast<uint32_t>(id);
+}
+
+// Format and output a record on the calling thread
+void BinaryLog::outputNow(const char* apRecord) {
+    const RecordHeader* pHeader = reinterpret_cast<const RecordHeader*>(apRecord);
+    std::string     format;
+    Channel::Ptr    channelPtr;
+    {
+        std::lock_guard<std::mutex> lock(sBinary.mRegistryMutex);
+        if ((0 == pHeader->mFormatId) || (pHeader->mFormatId > sBinary.mFormats.size())
+            || (pHeader->mChannelId >= sBinary.mChannels.size())) {
+            return;
+        }
+        format = sBinary.mFormats[pHeader->mFormatId - 1].mFormat;
+        channelPtr = sBinary.mChannels[pHeader->mChannelId];
+    }
+
+    LogStream stream;
+    formatRecord(format, apRecord, stream);
+    outputFormatted(channelPtr, static_cast<Log::Level>(pHeader->mSeverity), toDateTime(pHeader->mTimestamp), stream);
+}
+
+// Output a formatted record like any other Log
+void BinaryLog::outputFormatted(const Channel::Ptr& aChannelPtr, Log::Level aSeverity, const DateTime& aTime,
+                                LogStream& aStream) {
+    Log log(aSeverity, aTime, aStream);
+    Manager::output(aChannelPtr, log);
+}
+
+// Turn a binary file written in eFile mode into text
+long BinaryLog::decodeFile(const char* apFilename, FILE* apOutput) {
+    FILE* pFile = fopen(apFilename, "rb");
+    if (nullptr == pFile) {
+        return -1;
+    }
+
+    char magic[sizeof(kFileMagic)];
+    if ((1 != fread(magic, sizeof(magic), 1, pFile)) || (0 != memcmp(magic, kFileMagic, sizeof(magic)))) {
+        fclose(pFile);
+        return -1;
+    }
+
+    std::vector<std::string>    formats;    // Index = format id - 1
+    std::vector<std::string>    channels;   // Index = channel id
+    std::vector<char>           record(kMaxRecordSize);
+    LogStream                   stream;
+    long                        count = 0;
+    uint32_t                    entry;
+
+    while (1 == fread(&entry, sizeof(entry), 1, pFile)) {
+        bool bOk = true;
+        if (eEntryFormat == entry) {
+            uint32_t id;
+            int32_t  line;
+            uint16_t fileLength, formatLength;
+            bOk = (1 == fread(&id, sizeof(id), 1, pFile)) && (1 == fread(&line, sizeof(line), 1, pFile))
+                && (1 == fread(&fileLength, sizeof(fileLength), 1, pFile))
+                && (1 == fread(&formatLength, sizeof(formatLength), 1, pFile));
+            std::string file(bOk ? fileLength : 0, '\0');
+            std::string format(bOk ? formatLength : 0, '\0');
+            bOk = bOk && (file.size() == fread(&file[0], 1, file.size(), pFile))
+                && (format.size() == fread(&format[0], 1, format.size(), pFile));
+            if (bOk && (id > 0)) {
+                if (formats.size() < id) {
+                    formats.resize(id);
+                }
+                formats[id - 1] = format;
+            }
+        } else if (eEntryChannel == entry) {
+            uint32_t id;
+            uint16_t nameLength;
+            bOk = (1 == fread(&id, sizeof(id), 1, pFile)) && (1 == fread(&nameLength, sizeof(nameLength), 1, pFile));
+            std::string name(bOk ? nameLength : 0, '\0');
+            bOk = bOk && (name.size() == fread(&name[0], 1, name.size(), pFile));
+            if (bOk) {
+                if (channels.size() <= id) {
+                    channels.resize(id + 1);
+                }
+                channels[id] = name;
+            }
+        } else if (eEntryRecord == entry) {
+            RecordHeader* pHeader = reinterpret_cast<RecordHeader*>(&record[0]);
+            bOk = (1 == fread(pHeader, sizeof(RecordHeader), 1, pFile))
+                && (pHeader->mSize >= sizeof(RecordHeader)) && (pHeader->mSize <= kMaxRecordSize)
+                && (1 == fread(&record[sizeof(RecordHeader)], pHeader->mSize - sizeof(RecordHeader), 1, pFile));
+            if (bOk) {
+                stream.reset();
+                if ((pHeader->mFormatId > 0) && (pHeader->mFormatId <= formats.size())) {
+                    formatRecord(formats[pHeader->mFormatId - 1], &record[0], stream);
+                } else {
+                    stream << "(unknown format " << pHeader->mFormatId << ")";
+                }
+                const char* pChannel = (pHeader->mChannelId < channels.size())
+                                     ? channels[pHeader->mChannelId].c_str() : "?";
+                DateTime time = toDateTime(pHeader->mTimestamp);
+                char     timestamp[DateTime::kFormatSize];
+                // Same layout as OutputFile
+                fprintf(apOutput, "%s  %-12s %s %.*s\n",
+                        time.format(timestamp),
+                        pChannel, Log::toString(static_cast<Log::Level>(pHeader->mSeverity)),
+                        static_cast<int>(stream.size()), stream.data());
+                ++count;
+            }
+        } else {
+            bOk = false;
+        }
+
+        if (!bOk) {
+            break;  // truncated file (the program did not stop the BinaryLog) or unknown entry
+        }
+    }
+
+    fclose(pFile);
+    return count;
+}
+
+
+} // namespace Log
@@ -12,16 +12,166 @@
 #include <LoggerCpp/DateTime.h>
 #include <LoggerCpp/Utils.h>
 
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
 #ifdef WIN32
 #include <windows.h>
 #else
 #include <time.h>
 #include <sys/time.h>
 #endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define LOGGERCPP_HAVE_TSC
+#endif
 
 namespace Log {
 
 
+namespace {
+
+// Clock used by DateTime::make()
+std::atomic<int> sClock(DateTime::eRealtime);
+
+#ifdef LOGGERCPP_HAVE_TSC
+// Calibration of the time stamp counter, never changed once published
+struct TscCalibration {
+    unsigned long long  mBase;          ///< Counter at the anchor
+    long long           mBaseNs;        ///< CLOCK_REALTIME at the anchor, in nanoseconds
+    double              mNsPerTick;
+};
+
+// Published by setClock() before sClock. Each re-anchoring publishes a new one: the
+// previous ones are not deleted, as a thread may still be reading one (they are small,
+// and re-anchoring is rare).
+std::atomic<const TscCalibration*> sTsc(nullptr);
+
+// The counter runs at a constant rate whatever the frequency and sleep state of the core
+bool hasInvariantTsc(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (0 == __get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || (eax < 0x80000007)) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (0 != (edx & (1 << 8)));
+}
+#endif
+
+#ifndef WIN32
+#ifdef LOGGERCPP_HAVE_TSC
+long long realtimeNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<long long>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+#endif
+
+// Seconds and microseconds since the Epoch, from the chosen clock
+void readClock(long long& aSeconds, int& aMicroseconds) {
+    struct timespec now;
+    switch (sClock.load(std::memory_order_acquire)) {
+#ifdef LOGGERCPP_HAVE_TSC
+        case DateTime::eTsc: {
+            const TscCalibration* pTsc = sTsc.load(std::memory_order_acquire);
+            // Another core may read a counter slightly behind the anchor: no time has passed then
+            long long ticks = static_cast<long long>(__rdtsc() - pTsc->mBase);
+            if (ticks < 0) {
+                ticks = 0;
+            }
+            long long ns = pTsc->mBaseNs + static_cast<long long>(static_cast<double>(ticks) * pTsc->mNsPerTick);
+            aSeconds = ns / 1000000000LL;
+            aMicroseconds = static_cast<int>((ns % 1000000000LL) / 1000);
+            return;
+        }
+#endif
+#ifdef CLOCK_REALTIME_COARSE
+        case DateTime::eRealtimeCoarse:
+            clock_gettime(CLOCK_REALTIME_COARSE, &now);
+            break;
+#endif
+        default:
+            clock_gettime(CLOCK_REALTIME, &now);
+            break;
+    }
+    aSeconds = now.tv_sec;
+    aMicroseconds = static_cast<int>(now.tv_nsec / 1000);
+}
+#endif // WIN32
+
+// Broken-down local time of the last second seen by the thread
+struct LocalTimeCache {
+    LocalTimeCache(void) : mSeconds(-1) {}
+    long long   mSeconds;
+    struct tm   mTime;
+};
+
+thread_local LocalTimeCache tLocalTime;
+
+// Text of the last second formatted by the thread ("YYYY-MM-DD hh:mm:ss.", without the milliseconds)
+struct FormatCache {
+    FormatCache(void) : mKey(-1) {}
+    long long   mKey;
+    char        mText[DateTime::kFormatSize];
+};
+
+const size_t kSecondsTextSize = 20;
+
+thread_local FormatCache tFormat;
+
+} // anonymous namespace
+
+
+// Choose the clock used by make()
+bool DateTime::setClock(Clock aClock) {
+    switch (aClock) {
+        case eRealtime:
+            break;
+        case eRealtimeCoarse:
+#if defined(WIN32) || !defined(CLOCK_REALTIME_COARSE)
+            return false;
+#else
+            break;
+#endif
+        case eTsc: {
+#if defined(WIN32) || !defined(LOGGERCPP_HAVE_TSC)
+            return false;
+#else
+            if (!hasInvariantTsc()) {
+                return false;
+            }
+            // Ticks of the counter during 20 milliseconds of CLOCK_REALTIME
+            long long           startNs = realtimeNs();
+            unsigned long long  startTsc = __rdtsc();
+            struct timespec     wait = {0, 20 * 1000 * 1000};
+            nanosleep(&wait, nullptr);
+            long long           endNs = realtimeNs();
+            unsigned long long  endTsc = __rdtsc();
+            if (endTsc <= startTsc) {
+                return false;
+            }
+            TscCalibration* pTsc = new TscCalibration;
+            pTsc->mNsPerTick = static_cast<double>(endNs - startNs) / static_cast<double>(endTsc - startTsc);
+            pTsc->mBase = endTsc;
+            pTsc->mBaseNs = endNs;
+            sTsc.store(pTsc, std::memory_order_release);
+            break;
+#endif
+        }
+        default:
+            return false;
+    }
+    sClock.store(aClock, std::memory_order_release);
+    return true;
+}
+
+// Clock currently used by make()
+DateTime::Clock DateTime::getClock(void) {
+    return static_cast<Clock>(sClock.load(std::memory_order_relaxed));
+}
+
 /// Constructor
 DateTime::DateTime(void) :
     year(0),
@@ -50,20 +200,54 @@ void DateTime::make(void) {
     ms      = now.wMilliseconds;
     us      = 0;
 #else
-    struct timeval now;
-    gettimeofday(&now, nullptr);
-    struct tm* timeinfo = localtime(&now.tv_sec);
-
-    year    = timeinfo->tm_year + 1900;
-    month   = timeinfo->tm_mon + 1;
-    day     = timeinfo->tm_mday;
-    hour    = timeinfo->tm_hour;
-    minute  = timeinfo->tm_min;
-    second  = timeinfo->tm_sec;
-    ms      = static_cast<int>(now.tv_usec / 1000);
-    us      = static_cast<int>(now.tv_usec % 1000);
+    long long   seconds;
+    int         microseconds;
+    readClock(seconds, microseconds);
+    make(seconds, microseconds);
 #endif
 }
 
 
+/// Set to a time taken earlier
+void DateTime::make(long long aSeconds, int aMicroseconds) {
+    if (aSeconds != tLocalTime.mSeconds) {
+        time_t seconds = static_cast<time_t>(aSeconds);
+#ifdef WIN32
+        localtime_s(&tLocalTime.mTime, &seconds);
+#else
+        localtime_r(&seconds, &tLocalTime.mTime);
+#endif
+        tLocalTime.mSeconds = aSeconds;
+    }
+    const struct tm& timeinfo = tLocalTime.mTime;
+
+    year    = timeinfo.tm_year + 1900;
+    month   = timeinfo.tm_mon + 1;
+    day     = timeinfo.tm_mday;
+    hour    = timeinfo.tm_hour;
+    minute  = timeinfo.tm_min;
+    second  = timeinfo.tm_sec;
+    ms      = aMicroseconds / 1000;
+    us      = aMicroseconds % 1000;
+}
+
+
+/// Write the time as "YYYY-MM-DD hh:mm:ss.mmm"
+const char* DateTime::format(char* apBuffer) const {
+    long long key = (((((static_cast<long long>(year) * 13 + month) * 32 + day) * 24 + hour) * 60 + minute) * 60) + second;
+    if (key != tFormat.mKey) {
+        snprintf(tFormat.mText, sizeof(tFormat.mText), "%.4u-%.2u-%.2u %.2u:%.2u:%.2u.",
+                 year, month, day, hour, minute, second);
+        tFormat.mKey = key;
+    }
+    memcpy(apBuffer, tFormat.mText, kSecondsTextSize);
+    unsigned int millis = static_cast<unsigned int>(ms) % 1000;
+    apBuffer[kSecondsTextSize]     = static_cast<char>('0' + millis / 100);
+    apBuffer[kSecondsTextSize + 1] = static_cast<char>('0' + (millis / 10) % 10);
+    apBuffer[kSecondsTextSize + 2] = static_cast<char>('0' + millis % 10);
+    apBuffer[kSecondsTextSize + 3] = '\0';
+    return apBuffer;
+}
+
+
 } // namespace Log
@@ -18,26 +18,63 @@
 namespace Log {
 
 
+namespace {
+
+// Stream reused by all the Log objects of a thread, so producing a Log does not
+// allocate (the buffer grows to the longest Log and stays that size).
+struct ThreadStream {
+    ThreadStream(void) : mbInUse(false) {}
+    LogStream   mStream;
+    bool        mbInUse;    ///< A Log of this thread is using the stream
+};
+
+thread_local ThreadStream tThreadStream;
+
+} // anonymous namespace
+
 // Construct a RAII (private) log object for the Logger class
 Log::Log(const Logger& aLogger, Level aSeverity) :
-    mLogger(aLogger),
+    mpLogger(&aLogger),
     mSeverity(aSeverity),
-    mpStream(nullptr) {
+    mpStream(nullptr),
+    mbOwnStream(false) {
     // Construct a stream only if the severity of the Log is above its Logger Log::Level
     if (aSeverity >= aLogger.getLevel()) {
-        mpStream = new(std::ostringstream);
+        if (!tThreadStream.mbInUse) {
+            tThreadStream.mbInUse = true;
+            mpStream = &tThreadStream.mStream;
+            mpStream->reset();
+        } else {
+            // A Log built while another one of the same thread is still alive
+            // (ie. logging from inside an operator<< of a Log)
+            mpStream = new LogStream;
+            mbOwnStream = true;
+        }
     }
 }
 
+// Construct a Log from a record already formatted on another thread
+Log::Log(Level aSeverity, const DateTime& aTime, LogStream& aStream) :
+    mpLogger(nullptr),
+    mSeverity(aSeverity),
+    mTime(aTime),
+    mpStream(&aStream),
+    mbOwnStream(false) {
+}
+
 // Destructor : output the Log string stream
 Log::~Log(void) {
-    if (nullptr != mpStream) {
+    if ((nullptr != mpStream) && (nullptr != mpLogger)) {
         mTime.make();
-        mLogger.output(*this);
+        mpLogger->output(*this);
 
-        delete mpStream;
-        mpStream = nullptr;
+        if (mbOwnStream) {
+            delete mpStream;
+        } else {
+            tThreadStream.mbInUse = false;
+        }
     }
+    mpStream = nullptr;
 }
 
 // Convert a Level to its string representation
@@ -11,12 +11,15 @@
 
 #include <LoggerCpp/Manager.h>
 #include <LoggerCpp/Exception.h>
+#include <LoggerCpp/AsyncQueue.h>
+#include <LoggerCpp/BinaryLog.h>
 
 #include <LoggerCpp/OutputConsole.h>
 #include <LoggerCpp/OutputFile.h>
 
 #ifdef __unix__
 #include <LoggerCpp/OutputSyslog.h>
+#include <LoggerCpp/OutputMmapFile.h>
 #endif
 #ifdef WIN32
 #include <LoggerCpp/OutputDebug.h>
@@ -24,14 +27,183 @@
 
 #include <stdexcept>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <memory>
 
 
 namespace Log {
 
 
-Channel::Map    Manager::mChannelMap;
-Output::Vector  Manager::mOutputList;
-Log::Level      Manager::mDefaultLevel = Log::eDebug;
+std::atomic<const Channel::Map*>    Manager::mpChannelMap(nullptr);
+std::atomic<const Output::Vector*>  Manager::mpOutputList(nullptr);
+Log::Level                          Manager::mDefaultLevel = Log::eDebug;
+
+namespace {
+
+// Readers of the Channel map and of the Output list (see ReadSection) each own a
+// slot, so entering and leaving a read section only writes to a cache line of the
+// reading thread. The state is odd while the thread reads, and grows by one on each
+// entry and exit, so a writer can tell that a read section it saw has ended.
+struct ReaderSlot {
+    ReaderSlot(void);
+    ~ReaderSlot(void);
+
+    std::atomic<unsigned long>  mState;
+    unsigned int                mDepth;     ///< Nested read sections (a Logger used from within an Output)
+};
+
+// All the slots (never destroyed: threads may still exit after the static destructors)
+struct ReaderRegistry {
+    std::mutex                  mMutex;
+    std::vector<ReaderSlot*>    mSlots;
+};
+
+ReaderRegistry& readerRegistry(void) {
+    static ReaderRegistry* pRegistry = new ReaderRegistry;
+    return *pRegistry;
+}
+
+ReaderSlot::ReaderSlot(void) :
+    mState(0),
+    mDepth(0) {
+    ReaderRegistry& registry = readerRegistry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    registry.mSlots.push_back(this);
+}
+
+ReaderSlot::~ReaderSlot(void) {
+    ReaderRegistry& registry = readerRegistry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    for (size_t i = 0; i < registry.mSlots.size(); ++i) {
+        if (registry.mSlots[i] == this) {
+            registry.mSlots.erase(registry.mSlots.begin() + i);
+            break;
+        }
+    }
+}
+
+thread_local ReaderSlot tReaderSlot;
+
+// Scope during which the current Channel map and Output list may be read
+class ReadSection {
+public:
+    ReadSection(void) :
+        mSlot(tReaderSlot) {
+        if (0 == mSlot.mDepth++) {
+            // Sequentially consistent with the loads of the pointers that follow, and with the
+            // publication of a new pointer followed by the check of the slots in synchronizeReaders()
+            mSlot.mState.store(mSlot.mState.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+        }
+    }
+    ~ReadSection(void) {
+        if (0 == --mSlot.mDepth) {
+            mSlot.mState.store(mSlot.mState.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+private:
+    ReaderSlot& mSlot;
+};
+
+// Wait until no thread can still be reading what was replaced just before the call
+// (each thread is either out of any read section, or entered it after the call).
+// Returns false, without waiting, if called from within a read section.
+bool synchronizeReaders(void) {
+    if (0 != tReaderSlot.mDepth) {
+        return false;
+    }
+
+    ReaderRegistry& registry = readerRegistry();
+    std::lock_guard<std::mutex> lock(registry.mMutex);
+    for (size_t i = 0; i < registry.mSlots.size(); ++i) {
+        unsigned long state = registry.mSlots[i]->mState.load(std::memory_order_seq_cst);
+        if (0 != (state & 1)) {
+            while (registry.mSlots[i]->mState.load(std::memory_order_acquire) == state) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    return true;
+}
+
+// Serializes the changes to the Channel map and to the Output list
+std::mutex sConfigMutex;
+
+// Replaced Channel maps and Output lists that could not be deleted (see synchronizeReaders())
+std::vector<const Channel::Map*>    sRetiredMaps;
+std::vector<const Output::Vector*>  sRetiredLists;
+
+// Delete the Channel maps and Output lists retired earlier (sConfigMutex locked,
+// after a successful synchronizeReaders())
+void deleteRetired(void) {
+    for (size_t i = 0; i < sRetiredMaps.size(); ++i) {
+        delete sRetiredMaps[i];
+    }
+    sRetiredMaps.clear();
+    for (size_t i = 0; i < sRetiredLists.size(); ++i) {
+        delete sRetiredLists[i];
+    }
+    sRetiredLists.clear();
+}
+
+// Delete a replaced Channel map or Output list (may be null) once no thread reads it,
+// with those that could not be deleted before (sConfigMutex locked)
+template <typename T>
+void retire(const T* apOld, std::vector<const T*>& aRetired) {
+    if (synchronizeReaders()) {
+        delete apOld;
+        deleteRetired();
+    } else if (nullptr != apOld) {
+        aRetired.push_back(apOld);
+    }
+}
+
+// State of the asynchronous mode (see Manager::startAsync())
+struct AsyncState {
+    AsyncState(void) :
+        mpQueue(nullptr),
+        mpStorage(nullptr),
+        mOverflow(Manager::eDropIfFull),
+        mbStop(false),
+        mbWriterIdle(false),
+        mDropped(0),
+        mbAtExitRegistered(false) {
+    }
+
+    std::atomic<AsyncQueue*>    mpQueue;        ///< Non null while the asynchronous mode is on
+    AsyncQueue*                 mpStorage;      ///< The queue, kept after stopAsync() (see below)
+    Manager::AsyncOverflow      mOverflow;      ///< What producers do when the queue is full
+    std::atomic<bool>           mbStop;         ///< Tells the writer thread to drain the queue and exit
+    std::atomic<bool>           mbWriterIdle;   ///< The writer thread is (about to be) waiting for Logs
+    std::atomic<unsigned long long> mDropped;   ///< Logs dropped because the queue was full
+    std::thread                 mWriter;        ///< The writer thread
+    std::mutex                  mMutex;         ///< Only used with mCondition (never by producers)
+    std::condition_variable     mCondition;     ///< Wakes up the idle writer thread
+    std::mutex                  mStartStopMutex;///< Serializes startAsync()/stopAsync()
+    Channel::Ptr                mChannelPtr;    ///< Channel of the "Logs dropped" reports
+    bool                        mbAtExitRegistered;
+};
+
+AsyncState sAsync;
+
+// Most Logs handed to the Output objects before a flush
+const size_t kAsyncBatchSize = 256;
+
+// The writer thread also wakes up this often on its own, in case a wake up
+// was missed (producers signal it without taking the mutex)
+const std::chrono::milliseconds kAsyncIdleWait(5);
+
+void stopAsyncAtExit(void) {
+    Manager::stopAsync();
+}
+
+} // anonymous namespace
 
 
 // Create and configure the Output objects.
@@ -43,11 +215,16 @@ void Manager::configure(const Config::Vector& aConfigList) {
     std::string outputFile    = typeid(OutputFile).name();
 #ifdef __unix__
     std::string outputSyslog  = typeid(OutputSyslog).name();
+    std::string outputMmapFile = typeid(OutputMmapFile).name();
 #endif
 #ifdef WIN32
     std::string outputDebug   = typeid(OutputDebug).name();
 #endif
 
+    std::lock_guard<std::mutex> lock(sConfigMutex);
+    const Output::Vector*   pOldList = mpOutputList.load();
+    std::unique_ptr<Output::Vector> pNewList((nullptr != pOldList) ? new Output::Vector(*pOldList) : new Output::Vector);
+
     Config::Vector::const_iterator  iConfig;
     for (  iConfig  = aConfigList.begin();
            iConfig != aConfigList.end();
@@ -63,6 +240,8 @@ void Manager::configure(const Config::Vector& aConfigList) {
 #ifdef __unix__
         } else if (std::string::npos != outputSyslog.find(configName)) {
             outputPtr.reset(new OutputSyslog((*iConfig)));
+        } else if (std::string::npos != outputMmapFile.find(configName)) {
+            outputPtr.reset(new OutputMmapFile((*iConfig)));
 #endif
 #ifdef WIN32
         } else if (std::string::npos != outputDebug.find(configName)) {
@@ -71,38 +250,230 @@ void Manager::configure(const Config::Vector& aConfigList) {
         } else {
             LOGGER_THROW("Unknown Output name '" << configName << "'");
         }
-        mOutputList.push_back(outputPtr);
+        outputPtr->setBatched(isAsync());
+        pNewList->push_back(outputPtr);
     }
+
+    mpOutputList.store(pNewList.release());
+    retire(pOldList, sRetiredLists);
 }
 
 // Destroy the Output objects.
 void Manager::terminate(void) {
-    // This effectively destroys the Output objects
-    mOutputList.clear();
+    BinaryLog::stop();
+    stopAsync();
+
+    // This effectively destroys the Output objects (once no thread is using them),
+    // and the Channel maps and Output lists retired earlier
+    std::lock_guard<std::mutex> lock(sConfigMutex);
+    retire(mpOutputList.exchange(nullptr), sRetiredLists);
+}
+
+// Switch to asynchronous output.
+void Manager::startAsync(size_t aQueueSize, AsyncOverflow aOverflow) {
+    std::lock_guard<std::mutex> lock(sAsync.mStartStopMutex);
+    if (nullptr != sAsync.mpQueue.load()) {
+        return;
+    }
+
+    if (!sAsync.mbAtExitRegistered) {
+        std::atexit(stopAsyncAtExit);
+        sAsync.mbAtExitRegistered = true;
+    }
+    if (!sAsync.mChannelPtr) {
+        sAsync.mChannelPtr = get("LoggerCpp");
+    }
+
+    {
+        std::lock_guard<std::mutex> configLock(sConfigMutex);
+        const Output::Vector* pList = mpOutputList.load();
+        if (nullptr != pList) {
+            Output::Vector::const_iterator  iOutputPtr;
+            for (  iOutputPtr  = pList->begin();
+                   iOutputPtr != pList->end();
+                 ++iOutputPtr) {
+                (*iOutputPtr)->setBatched(true);
+            }
+        }
+    }
+
+    // The queue is never deleted: a thread that read the queue pointer just before
+    // stopAsync() may still be pushing into it (or still be running at exit).
+    // A Log pushed that late stays in the queue until the next startAsync().
+    if ((nullptr == sAsync.mpStorage) || (sAsync.mpStorage->capacity() < aQueueSize)) {
+        sAsync.mpStorage = new AsyncQueue(aQueueSize);
+    }
+
+    sAsync.mOverflow = aOverflow;
+    sAsync.mbStop = false;
+    sAsync.mWriter = std::thread(asyncWriter, sAsync.mpStorage);
+    sAsync.mpQueue = sAsync.mpStorage;
+}
+
+// Write out the queued Logs, stop the writer thread and go back to synchronous output.
+void Manager::stopAsync(void) {
+    std::lock_guard<std::mutex> lock(sAsync.mStartStopMutex);
+    // Logs produced from now on are output synchronously
+    if (nullptr == sAsync.mpQueue.exchange(nullptr)) {
+        return;
+    }
+
+    // The writer drains the queue before exiting
+    {
+        std::lock_guard<std::mutex> wakeLock(sAsync.mMutex);
+        sAsync.mbStop = true;
+    }
+    sAsync.mCondition.notify_one();
+    sAsync.mWriter.join();
+
+    std::lock_guard<std::mutex> configLock(sConfigMutex);
+    const Output::Vector* pList = mpOutputList.load();
+    if (nullptr != pList) {
+        Output::Vector::const_iterator  iOutputPtr;
+        for (  iOutputPtr  = pList->begin();
+               iOutputPtr != pList->end();
+             ++iOutputPtr) {
+            (*iOutputPtr)->setBatched(false);
+            (*iOutputPtr)->flush();
+        }
+    }
+}
+
+// true while the asynchronous mode is on
+bool Manager::isAsync(void) {
+    return (nullptr != sAsync.mpQueue.load(std::memory_order_relaxed));
+}
+
+// Number of Logs dropped because the asynchronous queue was full
+unsigned long long Manager::getDroppedCount(void) {
+    return sAsync.mDropped.load(std::memory_order_relaxed);
+}
+
+// Body of the writer thread of the asynchronous mode
+void Manager::asyncWriter(AsyncQueue* apQueue) {
+    AsyncRecord         record;
+    LogStream           stream;
+    unsigned long long  reportedDropped = sAsync.mDropped.load();
+
+    for (;;) {
+        size_t  count = 0;
+        while ((count < kAsyncBatchSize) && apQueue->tryPop(record)) {
+            stream.reset();
+            stream.write(record.mMessage.data(), record.mMessage.size());
+            Log log(record.mSeverity, record.mTime, stream);
+            outputToAll(record.mChannelPtr, log);
+            ++count;
+        }
+
+        // Report the Logs lost since the last report, in the flow of the other Logs
+        unsigned long long dropped = sAsync.mDropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            DateTime now;
+            now.make();
+            stream.reset();
+            stream << (dropped - reportedDropped) << " log records dropped (asynchronous queue full, "
+                   << dropped << " in total)";
+            Log log(Log::eWarning, now, stream);
+            outputToAll(sAsync.mChannelPtr, log);
+            reportedDropped = dropped;
+            ++count;
+        }
+
+        if (count > 0) {
+            ReadSection section;
+            const Output::Vector* pList = mpOutputList.load();
+            if (nullptr != pList) {
+                Output::Vector::const_iterator  iOutputPtr;
+                for (  iOutputPtr  = pList->begin();
+                       iOutputPtr != pList->end();
+                     ++iOutputPtr) {
+                    (*iOutputPtr)->flush();
+                }
+            }
+            continue;   // more may be waiting
+        }
+
+        if (sAsync.mbStop.load()) {
+            break;      // queue is empty and nothing more will come
+        }
+
+        // Nothing to do: wait for a producer (or the timeout)
+        std::unique_lock<std::mutex> lock(sAsync.mMutex);
+        sAsync.mbWriterIdle = true;
+        sAsync.mCondition.wait_for(lock, kAsyncIdleWait);
+        sAsync.mbWriterIdle = false;
+    }
 }
 
 // Return the Channel corresponding to the provided name
 Channel::Ptr Manager::get(const char* apChannelName) {
-    Channel::Ptr            ChannelPtr;
-    Channel::Map::iterator  iChannelPtr = mChannelMap.find(apChannelName);
+    {
+        ReadSection section;
+        const Channel::Map* pMap = mpChannelMap.load();
+        if (nullptr != pMap) {
+            Channel::Map::const_iterator iChannelPtr = pMap->find(apChannelName);
+            if (pMap->end() != iChannelPtr) {
+                return iChannelPtr->second;
+            }
+        }
+    }
 
-    if (mChannelMap.end() != iChannelPtr) {
-        ChannelPtr = iChannelPtr->second;
-    } else {
-        /// @todo Add a basic thread-safety security (throw if multiple threads create Loggers)
-        ChannelPtr.reset(new Channel(apChannelName, mDefaultLevel));
-        mChannelMap[apChannelName] = ChannelPtr;
+    // New Channel: publish a copy of the map with it (another thread may have just done it)
+    std::lock_guard<std::mutex> lock(sConfigMutex);
+    const Channel::Map* pOldMap = mpChannelMap.load();
+    if (nullptr != pOldMap) {
+        Channel::Map::const_iterator iChannelPtr = pOldMap->find(apChannelName);
+        if (pOldMap->end() != iChannelPtr) {
+            return iChannelPtr->second;
+        }
     }
+    Channel::Map*   pNewMap = (nullptr != pOldMap) ? new Channel::Map(*pOldMap) : new Channel::Map;
+    Channel::Ptr    ChannelPtr(new Channel(apChannelName, mDefaultLevel));
+    (*pNewMap)[apChannelName] = ChannelPtr;
+    mpChannelMap.store(pNewMap);
+    retire(pOldMap, sRetiredMaps);
 
     return ChannelPtr;
 }
 
 // Output the Log to all the active Output objects.
 void Manager::output(const Channel::Ptr& aChannelPtr, const Log& aLog) {
-    Output::Vector::iterator    iOutputPtr;
+    AsyncQueue* pQueue = sAsync.mpQueue.load(std::memory_order_acquire);
+    if (nullptr == pQueue) {
+        outputToAll(aChannelPtr, aLog);
+        return;
+    }
+
+    const LogStream& stream = aLog.getStream();
+    while (!pQueue->tryPush(aChannelPtr, aLog.getSeverity(), aLog.getTime(), stream.data(), stream.size())) {
+        if (eDropIfFull == sAsync.mOverflow) {
+            sAsync.mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+        // After stopAsync() nothing drains this queue anymore (until the next startAsync())
+        if (sAsync.mpQueue.load(std::memory_order_acquire) != pQueue) {
+            outputToAll(aChannelPtr, aLog);
+            return;
+        }
+    }
 
-    for (  iOutputPtr  = mOutputList.begin();
-           iOutputPtr != mOutputList.end();
+    if (sAsync.mbWriterIdle.load(std::memory_order_relaxed)) {
+        sAsync.mCondition.notify_one();
+    }
+}
+
+// Synchronous output of the Log to all the active Output objects.
+void Manager::outputToAll(const Channel::Ptr& aChannelPtr, const Log& aLog) {
+    ReadSection section;
+    const Output::Vector* pList = mpOutputList.load();
+    if (nullptr == pList) {
+        return;
+    }
+
+    Output::Vector::const_iterator  iOutputPtr;
+    for (  iOutputPtr  = pList->begin();
+           iOutputPtr != pList->end();
          ++iOutputPtr) {
         (*iOutputPtr)->output(aChannelPtr, aLog);
     }
@@ -112,11 +483,15 @@ void Manager::output(const Channel::Ptr& aChannelPtr, const Log& aLog) {
 Config::Ptr Manager::getChannelConfig(void) {
     Config::Ptr ConfigPtr(new Config("ChannelConfig"));
 
-    Channel::Map::const_iterator iChannel;
-    for (iChannel  = mChannelMap.begin();
-         iChannel != mChannelMap.end();
-         ++iChannel) {
-        ConfigPtr->setValue(iChannel->first.c_str(), Log::toString(iChannel->second->getLevel()));
+    ReadSection section;
+    const Channel::Map* pMap = mpChannelMap.load();
+    if (nullptr != pMap) {
+        Channel::Map::const_iterator iChannel;
+        for (iChannel  = pMap->begin();
+             iChannel != pMap->end();
+             ++iChannel) {
+            ConfigPtr->setValue(iChannel->first.c_str(), Log::toString(iChannel->second->getLevel()));
+        }
     }
 
     return ConfigPtr;
@@ -71,21 +71,24 @@ unsigned int OutputConsole::toEscapeCode(Log::Level aLevel) {
 
 // Output the Log to the standard console using fprintf
 void OutputConsole::output(const Channel::Ptr& aChannelPtr, const Log& aLog) const {
-    const DateTime& time = aLog.getTime();
+    const DateTime&     time = aLog.getTime();
+    const LogStream&    stream = aLog.getStream();
+    char                timestamp[DateTime::kFormatSize];
 
 #ifndef LOGGERCPP_NO_CONSOLE_COLOR
     // THIS IS THE ORIGINAL LOGGERCPP CODE
     // uses fprintf for atomic thread-safe operation
     #ifdef _WIN32
+        std::lock_guard<std::mutex> lock(mMutex);
         SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), toWin32Attribute(aLog.getSeverity()));
-        fprintf(stdout, "%.4u-%.2u-%.2u %.2u:%.2u:%.2u.%.3u  %-12s %s %s\n",
+        fprintf(stdout, "%s  %-12s %s %.*s\n",
     #else  // _WIN32
-        fprintf(stdout, "\x1B[%02um%.4u-%.2u-%.2u %.2u:%.2u:%.2u.%.3u  %-12s %s %s\x1b[39m\n",
+        fprintf(stdout, "\x1B[%02um%s  %-12s %s %.*s\x1b[39m\n",
                 toEscapeCode(aLog.getSeverity()),
     #endif // _WIN32
-                time.year, time.month, time.day,
-                time.hour, time.minute, time.second, time.ms,
-                aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()), (aLog.getStream()).str().c_str());
+                time.format(timestamp),
+                aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()),
+                static_cast<int>(stream.size()), stream.data());
     #ifdef _WIN32
         SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
     #endif // _WIN32
@@ -95,12 +98,19 @@ void OutputConsole::output(const Channel::Ptr& aChannelPtr, const Log& aLog) con
     // THIS MODIFICATION TO THE ORIGINAL LOGGERCPP CODE is meant to simply
     // turn off text color on console output. Changing only linux builds
     // since I cannot test Windows code at this time.
-    fprintf(stdout, "%.4u-%.2u-%.2u %.2u:%.2u:%.2u.%.3u  %-12s %s %s\n",
-                    time.year, time.month, time.day,
-                    time.hour, time.minute, time.second, time.ms,
-                    aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()), (aLog.getStream()).str().c_str());
+    fprintf(stdout, "%s  %-12s %s %.*s\n",
+                    time.format(timestamp),
+                    aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()),
+                    static_cast<int>(stream.size()), stream.data());
 #endif // LOGGERCPP_NO_CONSOLE_COLOR
 
+    if (!mbBatched) {
+        fflush(stdout);
+    }
+}
+
+// Flush stdout (batched mode)
+void OutputConsole::flush() const {
     fflush(stdout);
 }
 
@@ -79,23 +79,36 @@ void OutputFile::rotate() const {
 // Output the Log to the standard console using printf
 void OutputFile::output(const Channel::Ptr& aChannelPtr, const Log& aLog) const {
     const DateTime& time = aLog.getTime();
+    std::lock_guard<std::mutex> lock(mMutex);
 
     if (mSize > mMaxSize) {
         rotate();
     }
 
     if (nullptr != mpFile) {
+        const LogStream&    stream = aLog.getStream();
+        char                timestamp[DateTime::kFormatSize];
+
         // uses fprintf for atomic thread-safe operation
-        int nbWritten = fprintf(mpFile, "%.4u-%.2u-%.2u %.2u:%.2u:%.2u.%.3u  %-12s %s %s\n",
-                                time.year, time.month, time.day,
-                                time.hour, time.minute, time.second, time.ms,
+        int nbWritten = fprintf(mpFile, "%s  %-12s %s %.*s\n",
+                                time.format(timestamp),
                                 aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()),
-                                (aLog.getStream()).str().c_str());
-        fflush(mpFile);
+                                static_cast<int>(stream.size()), stream.data());
+        if (!mbBatched) {
+            fflush(mpFile);
+        }
 
         mSize += nbWritten;
     }
 }
 
+// Flush the file (batched mode)
+void OutputFile::flush() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (nullptr != mpFile) {
+        fflush(mpFile);
+    }
+}
+
 
 } // namespace Log
@@ -0,0 +1,252 @@
+/**
+ * @file    OutputMmapFile.cpp
+ * @ingroup LoggerCpp
+ * @brief   Output to a memory mapped file, rotated by a background thread
+ *
+ * Copyright (c) 2013-2018 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+ *
+ * Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+ * or copy at http://opensource.org/licenses/MIT)
+ */
+
+#ifdef __unix__
+
+#include <LoggerCpp/OutputMmapFile.h>
+#include <LoggerCpp/Exception.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+
+namespace Log {
+
+
+// Create the first segment, and start the background thread preparing the next one
+OutputMmapFile::OutputMmapFile(const Config::Ptr& aConfigPtr) :
+    mDropped(0),
+    mbFailed(false),
+    mbPromote(false),
+    mbStop(false) {
+    assert(aConfigPtr);
+
+    long segmentSize = aConfigPtr->get("segment_size", (long)64*1024*1024);
+    mSegmentSize    = (segmentSize < 4096) ? 4096 : static_cast<size_t>(segmentSize);
+    mMaxSegments    = aConfigPtr->get("max_segments",   (long)4);
+    mFilename       = aConfigPtr->get("filename",       "log.txt");
+    mFilenameNext   = mFilename + ".next";
+
+    // Never append to an existing log file (a segment has a fixed size)
+    struct stat statFile;
+    if (0 == stat(mFilename.c_str(), &statFile)) {
+        shift();
+    }
+    remove(mFilenameNext.c_str());
+
+    if (!create(mFilename, mCurrent)) {
+        LOGGER_THROW("file \"" << mFilename << "\" not mapped (" << strerror(errno) << ")");
+    }
+
+    mThread = std::thread(&OutputMmapFile::run, this);
+}
+
+// Stop the background thread, then complete the current segment and remove the unused next one
+OutputMmapFile::~OutputMmapFile() {
+    {
+        std::lock_guard<std::mutex> lock(mWorkMutex);
+        mbStop = true;
+    }
+    mWorkCond.notify_one();
+    mThread.join();
+
+    if (nullptr != mCurrent.mpData) {
+        complete(mCurrent);
+    }
+    if (nullptr != mNext.mpData) {
+        munmap(mNext.mpData, mSegmentSize);
+        close(mNext.mFd);
+        remove(mFilenameNext.c_str());
+    }
+}
+
+// Create, allocate and map a segment
+bool OutputMmapFile::create(const std::string& aFilename, Segment& aSegment) const {
+    int fd = open(aFilename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Allocate the blocks now: writing to a hole of a full file system would raise SIGBUS
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(mSegmentSize));
+    if ((EOPNOTSUPP == err) || (EINVAL == err)) {
+        err = (0 == ftruncate(fd, static_cast<off_t>(mSegmentSize))) ? 0 : errno;
+    }
+    void* pData = MAP_FAILED;
+    if (0 == err) {
+        // MAP_POPULATE : output() does not take the page faults
+        pData = mmap(nullptr, mSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        err = (MAP_FAILED == pData) ? errno : 0;
+    }
+    if (0 != err) {
+        close(fd);
+        remove(aFilename.c_str());
+        errno = err;
+        return false;
+    }
+
+    aSegment.mFd    = fd;
+    aSegment.mpData = static_cast<char*>(pData);
+    aSegment.mUsed  = 0;
+    return true;
+}
+
+// Sync, unmap, truncate to the used size and close a segment
+void OutputMmapFile::complete(Segment& aSegment) const {
+    msync(aSegment.mpData, mSegmentSize, MS_SYNC);
+    munmap(aSegment.mpData, mSegmentSize);
+    if (0 != ftruncate(aSegment.mFd, static_cast<off_t>(aSegment.mUsed))) {
+        // The end of the segment stays zero filled
+    }
+    close(aSegment.mFd);
+    aSegment = Segment();
+}
+
+// Rename "filename" to "filename.1", "filename.1" to "filename.2"... removing the oldest one
+void OutputMmapFile::shift() const {
+    if (mMaxSegments <= 0) {
+        remove(mFilename.c_str());
+        return;
+    }
+
+    std::ostringstream oldest;
+    oldest << mFilename << '.' << mMaxSegments;
+    remove(oldest.str().c_str());
+    for (long index = mMaxSegments - 1; index >= 1; --index) {
+        std::ostringstream from, to;
+        from << mFilename << '.' << index;
+        to << mFilename << '.' << (index + 1);
+        rename(from.str().c_str(), to.str().c_str());
+    }
+    rename(mFilename.c_str(), (mFilename + ".1").c_str());
+}
+
+// Switch to the next segment, handing the current one to the background thread (mMutex locked)
+bool OutputMmapFile::rollover() const {
+    std::unique_lock<std::mutex> lock(mWorkMutex);
+    if (nullptr != mCurrent.mpData) {
+        mFull.push_back(mCurrent);
+        mCurrent = Segment();
+        mWorkCond.notify_one();
+    }
+
+    // The next segment is usually ready: only a segment filled faster than a file is created waits here
+    while ((nullptr == mNext.mpData) && !mbFailed) {
+        mReadyCond.wait(lock);
+    }
+    if (nullptr == mNext.mpData) {
+        return false;
+    }
+
+    mCurrent = mNext;
+    mNext = Segment();
+    mbPromote = true;
+    mWorkCond.notify_one();
+    return true;
+}
+
+// Background thread : completes the full segments, renames the files, and prepares the next segment
+void OutputMmapFile::run() {
+    std::unique_lock<std::mutex> lock(mWorkMutex);
+    for (;;) {
+        std::vector<Segment> full;
+        full.swap(mFull);
+        const bool promote = mbPromote;
+        const bool prepare = !mbStop && !mbFailed && (nullptr == mNext.mpData);
+        mbPromote = false;
+
+        if (full.empty() && !promote && !prepare) {
+            if (mbStop) {
+                break;
+            }
+            if (mbFailed) {
+                // Try again to create the next segment every second
+                if (std::cv_status::timeout == mWorkCond.wait_for(lock, std::chrono::seconds(1))) {
+                    mbFailed = false;
+                }
+            } else {
+                mWorkCond.wait(lock);
+            }
+            continue;
+        }
+        lock.unlock();
+
+        for (size_t index = 0; index < full.size(); ++index) {
+            complete(full[index]);
+        }
+        // The segment in use was created as "filename.next": it becomes "filename"
+        if (promote) {
+            shift();
+            rename(mFilenameNext.c_str(), mFilename.c_str());
+        }
+        Segment next;
+        const bool bCreated = prepare && create(mFilenameNext, next);
+
+        lock.lock();
+        if (prepare) {
+            if (bCreated) {
+                mNext = next;
+            } else {
+                mbFailed = true;
+            }
+            mReadyCond.notify_all();
+        }
+    }
+}
+
+// Output the Log to the mapped memory of the current segment
+void OutputMmapFile::output(const Channel::Ptr& aChannelPtr, const Log& aLog) const {
+    const DateTime&     time = aLog.getTime();
+    const LogStream&    stream = aLog.getStream();
+    char                timestamp[DateTime::kFormatSize];
+    char                prefix[128];
+
+    // Same layout as OutputFile
+    int nbPrefix = snprintf(prefix, sizeof(prefix), "%s  %-12s %s ",
+                            time.format(timestamp),
+                            aChannelPtr->getName().c_str(), Log::toString(aLog.getSeverity()));
+    size_t prefixSize = (nbPrefix < 0) ? 0 : static_cast<size_t>(nbPrefix);
+    if (prefixSize >= sizeof(prefix)) {
+        prefixSize = sizeof(prefix) - 1;
+    }
+    size_t textSize = stream.size();
+    if (prefixSize + textSize + 1 > mSegmentSize) {
+        textSize = mSegmentSize - prefixSize - 1;
+    }
+    const size_t lineSize = prefixSize + textSize + 1;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if ((nullptr == mCurrent.mpData) || (mCurrent.mUsed + lineSize > mSegmentSize)) {
+        if (!rollover()) {
+            ++mDropped;
+            return;
+        }
+    }
+
+    char* pLine = mCurrent.mpData + mCurrent.mUsed;
+    memcpy(pLine, prefix, prefixSize);
+    memcpy(pLine + prefixSize, stream.data(), textSize);
+    pLine[prefixSize + textSize] = '\n';
+    mCurrent.mUsed += lineSize;
+}
+
+
+} // namespace Log
+
+#endif // __unix__
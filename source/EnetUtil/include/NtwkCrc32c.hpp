@@ -0,0 +1,72 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <sys/types.h>
+#include <stdint.h>
+
+namespace EnetUtil
+{
+
+// CRC-32C (Castagnoli) checksums for data sent over the network.
+//
+// The checksum is computed incrementally: start with crc = 0 and pass the result of each
+// update() call to the next one, one chunk of data at a time.  The result is the same as
+// computing it over all the data at once.
+//
+// On x86_64 processors with SSE 4.2 the crc32 instruction is used (three interleaved
+// streams, so it runs at close to memory speed).  Where VPCLMULQDQ (AVX-512) is there
+// as well, buffers of 1 KB and more are first folded with carry-less multiplies, which
+// is more than twice as fast on data in the cache.  Otherwise a table driven software
+// version (slicing-by-8) is used.  The choice is made once at run time.
+class Crc32c
+{
+public:
+    // Returns the crc updated with len bytes of data.
+    static uint32_t update(uint32_t crc, const void *data, size_t len);
+
+    // Always uses the software version. For testing and comparison.
+    static uint32_t update_software(uint32_t crc, const void *data, size_t len);
+
+    // Checksum of len bytes of an open file starting at offset. The file is mapped
+    // into memory (it does not have to be opened for writing). Returns false on error.
+    static bool file_range(int fd, off_t offset, size_t len, uint32_t& crc);
+
+    // true if the hardware (SSE 4.2) version is used by update().
+    static bool is_hardware_accelerated();
+
+    // 8 hex digits, lower case. This is how checksums appear in network messages.
+    static std::string to_hex(uint32_t crc);
+
+private:
+    // Not allowed:
+    Crc32c(void) = delete;
+    Crc32c(const Crc32c &) = delete;
+    Crc32c &operator=(Crc32c const &) = delete;
+};
+
+}  // end of namespace EnetUtil
+
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <memory>
+#include <array>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -82,6 +83,14 @@ static const uint16_t base_simple_server_port_number =  57314;
 // Make sure to rebuild all clients when connecting to a server using this if it changes.
 static const uint16_t simple_server_port_number = base_simple_server_port_number;
 
+// Framed messages (see NtwkUtil::send_framed_message()) start with a 4 byte length in
+// network byte order. This is the largest message length accepted from the remote end.
+static const size_t NtwkUtilFrameHeaderSize = sizeof(uint32_t);
+static const size_t NtwkUtilMaxFramedMessageSize = NtwkUtilBufferSize;
+
+// Framed messages up to this size (header included) are sent from a buffer on the stack.
+static const size_t NtwkUtilFramedStackBufferSize = NtwkUtilTinyBufferSize;
+
 // This is the actual type of the data being handled
 typedef std::array<uint8_t,NtwkUtilBufferSize> arrayUint8;
 
@@ -140,6 +149,64 @@ public:
                             // requestsize can be smaller than the array<>::size()
                             size_t requestsize);
 
+    // Moves bytecount bytes from the socket to the file without copying them through
+    // user space: socket -> pipe -> file, using splice(2).  (copy_file_range(2) does not
+    // apply here - it only works file to file.)  If file_offset is NULL the data is written
+    // at the file's current offset.  Otherwise it is written at *file_offset (like pwrite(2))
+    // and *file_offset is advanced past the data written.
+    // Returns the number of bytes written to the file (less than bytecount if the remote
+    // end closed the connection early), or -1 on error.
+    static ssize_t splice_to_file(Util::LoggerSPtr loggerp,
+                                  int socket_fd,
+                                  int file_fd,
+                                  size_t bytecount,
+                                  off_t *file_offset = NULL);
+
+    // Sends bytecount bytes of the file starting at offset to the socket with sendfile(2).
+    // The data goes from the page cache to the socket without a user space copy.
+    // Returns the number of bytes sent (less than bytecount if the file is shorter than
+    // expected), or -1 on error.
+    static ssize_t enet_sendfile(Util::LoggerSPtr loggerp,
+                                 int socket_fd,
+                                 int file_fd,
+                                 off_t offset,
+                                 size_t bytecount);
+
+    // Sends the buffer with MSG_ZEROCOPY: the kernel pins the pages of the buffer instead of
+    // copying them into socket buffers.  Only worth it for large payloads (the completion
+    // notifications cost more than copying a small buffer).  The buffer must not be modified
+    // until the function returns - it waits for all completions from the socket error queue
+    // before returning.  Falls back to a regular send() if the socket does not support
+    // SO_ZEROCOPY.  Returns the number of bytes sent, or -1 on error.
+    static ssize_t enet_send_zerocopy(Util::LoggerSPtr loggerp,
+                                      int socket_fd,
+                                      const uint8_t *buffer,
+                                      size_t bytecount);
+
+    // Receives exactly bytecount bytes into buffer, calling recv() as many times as it takes
+    // (a single recv() can return any part of what was sent).
+    // Returns bytecount if successful, less than bytecount if the remote end closed the
+    // connection first (0 if it was closed before anything came in), or -1 on error.
+    static ssize_t enet_receive_exact(Util::LoggerSPtr loggerp,
+                                      int fd,
+                                      void *buffer,
+                                      size_t bytecount);
+
+    // Framed messages: a 4 byte message length (network byte order) followed by exactly
+    // that many bytes of message.  Only the actual message goes out on the wire, and the
+    // receiving end knows exactly where the message ends (unlike get_ntwk_message() below,
+    // which assumes that one recv() returns one whole message).  Both ends of a connection
+    // have to use the framed versions.
+
+    // Get a framed message from a remote network connection.
+    // retstring is an existing std::string - contents overwritten
+    // Returns true if successful - restring contains the message from the remote connection.
+    // Returns false if failure - retstring contains text about the error.
+    static bool get_framed_message(Util::LoggerSPtr loggerp, int socket_fd, std::string& retstring);
+
+    // Send the string message as a framed message to remote connection socket_fd (already open).
+    static bool send_framed_message(Util::LoggerSPtr loggerp, int socket_fd, const std::string& message);
+
     // Get a string message from a remote network connection.
     // retstring is an existing std::string - contents overwritten
     // socket_fd - open connection to the remote system
@@ -0,0 +1,456 @@
+
+#include "NtwkCrc32c.hpp"
+#include <Format.hpp>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <string.h>
+#include <stdio.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <immintrin.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////
+
+// The hardware version (three crc32 instruction streams combined with "shift by
+// zeros" tables) follows Mark Adler's crc32c.c, posted on stackoverflow.com.
+//
+// On processors with VPCLMULQDQ (AVX-512), large buffers are first folded 256
+// bytes at a time with carry-less multiplies (as in Intel's "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ Instruction"), down to 16 bytes whose
+// crc is the same as that of all the data folded. The crc32 instruction then
+// finishes those and the rest.
+
+using namespace EnetUtil;
+
+namespace {
+
+// CRC-32C polynomial, bit reversed
+const uint32_t crc32c_poly = 0x82f63b78;
+
+// Block sizes for the three interleaved hardware streams
+const size_t crc32c_long_block = 8192;
+const size_t crc32c_short_block = 256;
+
+// Buffers from this size up are folded with carry-less multiplies, if the
+// processor has them (below it, the setup costs more than it saves).
+const size_t crc32c_fold_min = 1024;
+
+// Multiplies the 32x32 GF(2) matrix mat by the vector vec
+uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+    while (vec)
+    {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+void gf2_matrix_square(uint32_t *square, const uint32_t *mat)
+{
+    for (int n = 0; n < 32; n++)
+    {
+        square[n] = gf2_matrix_times(mat, mat[n]);
+    }
+}
+
+// Builds the operator that applies len zero bytes to a crc
+void crc32c_zeros_op(uint32_t *even, size_t len)
+{
+    uint32_t odd[32];
+
+    odd[0] = crc32c_poly;   // operator for one zero bit
+    uint32_t row = 1;
+    for (int n = 1; n < 32; n++)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    gf2_matrix_square(even, odd);   // two zero bits
+    gf2_matrix_square(odd, even);   // four zero bits
+
+    // The first square puts the operator for one zero byte (eight zero bits) in even.
+    do
+    {
+        gf2_matrix_square(even, odd);
+        len >>= 1;
+        if (len == 0) return;
+        gf2_matrix_square(odd, even);
+        len >>= 1;
+    } while (len);
+
+    for (int n = 0; n < 32; n++)
+    {
+        even[n] = odd[n];
+    }
+}
+
+// x^n mod P, P being the CRC-32C polynomial (not bit reversed)
+uint32_t crc32c_xpow_mod(size_t n)
+{
+    uint32_t rem = 1;
+    while (n--)
+    {
+        rem = (rem & 0x80000000)? (rem << 1) ^ 0x1edc6f41 : rem << 1;
+    }
+    return rem;
+}
+
+// Bit reversed, as the crc and data are
+uint32_t reverse32(uint32_t value)
+{
+    uint32_t reversed = 0;
+    for (int n = 0; n < 32; n++)
+    {
+        reversed |= ((value >> n) & 1) << (31 - n);
+    }
+    return reversed;
+}
+
+// Multipliers that move 16 bytes of data forward by bits bits, modulo P: the first
+// (lower) 8 bytes are multiplied by x^(64 + bits), the last 8 by x^bits. Both are
+// one power lower, as a carry-less multiply of bit reversed values is one bit short.
+struct crc32c_fold
+{
+    uint64_t first;
+    uint64_t last;
+
+    void set(size_t bits)
+    {
+        first = (uint64_t) reverse32(crc32c_xpow_mod(64 + bits - 1)) << 32;
+        last = (uint64_t) reverse32(crc32c_xpow_mod(bits - 1)) << 32;
+    }
+};
+
+struct crc32c_tables
+{
+    uint32_t sw[8][256];        // slicing-by-8
+    uint32_t longz[4][256];     // shift a crc by crc32c_long_block zero bytes
+    uint32_t shortz[4][256];    // shift a crc by crc32c_short_block zero bytes
+    crc32c_fold fold[4];        // by 128, 256, 384 and 512 bits
+    crc32c_fold fold2048;       // by 2048 bits (256 bytes)
+    bool hardware;
+    bool folding;               // VPCLMULQDQ (AVX-512) as well
+
+    static void make_zeros(uint32_t zeros[][256], size_t len)
+    {
+        uint32_t op[32];
+        crc32c_zeros_op(op, len);
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            zeros[0][n] = gf2_matrix_times(op, n);
+            zeros[1][n] = gf2_matrix_times(op, n << 8);
+            zeros[2][n] = gf2_matrix_times(op, n << 16);
+            zeros[3][n] = gf2_matrix_times(op, n << 24);
+        }
+    }
+
+    crc32c_tables()
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t crc = n;
+            for (int k = 0; k < 8; k++)
+            {
+                crc = (crc & 1)? (crc >> 1) ^ crc32c_poly : crc >> 1;
+            }
+            sw[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t crc = sw[0][n];
+            for (int k = 1; k < 8; k++)
+            {
+                crc = sw[0][crc & 0xff] ^ (crc >> 8);
+                sw[k][n] = crc;
+            }
+        }
+
+        make_zeros(longz, crc32c_long_block);
+        make_zeros(shortz, crc32c_short_block);
+
+        for (size_t n = 0; n < 4; n++)
+        {
+            fold[n].set(128 * (n + 1));
+        }
+        fold2048.set(2048);
+
+#if defined(__x86_64__)
+        hardware = __builtin_cpu_supports("sse4.2");
+        folding = hardware && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("vpclmulqdq");
+#else
+        hardware = false;
+        folding = false;
+#endif
+    }
+};
+
+const crc32c_tables& tables()
+{
+    // Built once, the first time it is used (thread safe).
+    static const crc32c_tables s_tables;
+    return s_tables;
+}
+
+inline uint32_t crc32c_shift(const uint32_t zeros[][256], uint32_t crc)
+{
+    return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+           zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+inline uint64_t load64(const unsigned char *p)
+{
+    uint64_t word;
+    ::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+uint32_t crc32c_sw(const crc32c_tables& t, uint32_t crc, const unsigned char *next, size_t len)
+{
+    uint64_t crc0 = crc ^ 0xffffffff;
+
+    while (len && ((uintptr_t) next & 7) != 0)
+    {
+        crc0 = t.sw[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        len--;
+    }
+
+    // Little endian only (like the rest of this project)
+    while (len >= 8)
+    {
+        crc0 ^= load64(next);
+        crc0 = t.sw[7][crc0 & 0xff] ^
+               t.sw[6][(crc0 >> 8) & 0xff] ^
+               t.sw[5][(crc0 >> 16) & 0xff] ^
+               t.sw[4][(crc0 >> 24) & 0xff] ^
+               t.sw[3][(crc0 >> 32) & 0xff] ^
+               t.sw[2][(crc0 >> 40) & 0xff] ^
+               t.sw[1][(crc0 >> 48) & 0xff] ^
+               t.sw[0][crc0 >> 56];
+        next += 8;
+        len -= 8;
+    }
+
+    while (len)
+    {
+        crc0 = t.sw[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        len--;
+    }
+    return (uint32_t) crc0 ^ 0xffffffff;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw(const crc32c_tables& t, uint32_t crc, const unsigned char *next, size_t len)
+{
+    uint64_t crc0 = crc ^ 0xffffffff;
+    uint64_t crc1, crc2;
+    const unsigned char *end;
+
+    while (len && ((uintptr_t) next & 7) != 0)
+    {
+        crc0 = _mm_crc32_u8((uint32_t) crc0, *next);
+        next++;
+        len--;
+    }
+
+    // Three independent streams keep the crc32 instruction pipeline full. The
+    // second and third stream crc's are merged into the first one at the end of
+    // each block by shifting the first one over the other two blocks.
+    while (len >= crc32c_long_block * 3)
+    {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + crc32c_long_block;
+        do
+        {
+            crc0 = _mm_crc32_u64(crc0, load64(next));
+            crc1 = _mm_crc32_u64(crc1, load64(next + crc32c_long_block));
+            crc2 = _mm_crc32_u64(crc2, load64(next + crc32c_long_block * 2));
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(t.longz, (uint32_t) crc0) ^ crc1;
+        crc0 = crc32c_shift(t.longz, (uint32_t) crc0) ^ crc2;
+        next += crc32c_long_block * 2;
+        len -= crc32c_long_block * 3;
+    }
+
+    while (len >= crc32c_short_block * 3)
+    {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + crc32c_short_block;
+        do
+        {
+            crc0 = _mm_crc32_u64(crc0, load64(next));
+            crc1 = _mm_crc32_u64(crc1, load64(next + crc32c_short_block));
+            crc2 = _mm_crc32_u64(crc2, load64(next + crc32c_short_block * 2));
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(t.shortz, (uint32_t) crc0) ^ crc1;
+        crc0 = crc32c_shift(t.shortz, (uint32_t) crc0) ^ crc2;
+        next += crc32c_short_block * 2;
+        len -= crc32c_short_block * 3;
+    }
+
+    end = next + (len - (len & 7));
+    while (next < end)
+    {
+        crc0 = _mm_crc32_u64(crc0, load64(next));
+        next += 8;
+    }
+    len &= 7;
+
+    while (len)
+    {
+        crc0 = _mm_crc32_u8((uint32_t) crc0, *next);
+        next++;
+        len--;
+    }
+    return (uint32_t) crc0 ^ 0xffffffff;
+}
+
+// Each 16 byte lane of data folded forward onto next (the lane's constants in k)
+__attribute__((target("avx512f,vpclmulqdq")))
+inline __m512i crc32c_fold_onto(__m512i data, __m512i k, __m512i next)
+{
+    return _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(data, k, 0x00),
+                                     _mm512_clmulepi64_epi128(data, k, 0x11), next, 0x96);
+}
+
+__attribute__((target("avx512f,vpclmulqdq")))
+inline __m512i crc32c_fold_constants(const crc32c_fold& lane0, const crc32c_fold& lane1,
+                                     const crc32c_fold& lane2, const crc32c_fold& lane3)
+{
+    return _mm512_set_epi64((long long) lane3.last, (long long) lane3.first, (long long) lane2.last, (long long) lane2.first,
+                            (long long) lane1.last, (long long) lane1.first, (long long) lane0.last, (long long) lane0.first);
+}
+
+// len has to be at least 256.
+__attribute__((target("sse4.2,avx512f,vpclmulqdq")))
+uint32_t crc32c_folded(const crc32c_tables& t, uint32_t crc, const unsigned char *next, size_t len)
+{
+    // The crc is the same as the crc (from 0) of the data with the crc xor'ed
+    // into its first four bytes.
+    __m512i x0 = _mm512_xor_si512(_mm512_loadu_si512(next), _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, (int) (crc ^ 0xffffffff)));
+    __m512i x1 = _mm512_loadu_si512(next + 64);
+    __m512i x2 = _mm512_loadu_si512(next + 128);
+    __m512i x3 = _mm512_loadu_si512(next + 192);
+    next += 256;
+    len -= 256;
+
+    __m512i k = crc32c_fold_constants(t.fold2048, t.fold2048, t.fold2048, t.fold2048);
+    while (len >= 256)
+    {
+        x0 = crc32c_fold_onto(x0, k, _mm512_loadu_si512(next));
+        x1 = crc32c_fold_onto(x1, k, _mm512_loadu_si512(next + 64));
+        x2 = crc32c_fold_onto(x2, k, _mm512_loadu_si512(next + 128));
+        x3 = crc32c_fold_onto(x3, k, _mm512_loadu_si512(next + 192));
+        next += 256;
+        len -= 256;
+    }
+
+    k = crc32c_fold_constants(t.fold[3], t.fold[3], t.fold[3], t.fold[3]);
+    x1 = crc32c_fold_onto(x0, k, x1);
+    x2 = crc32c_fold_onto(x1, k, x2);
+    x3 = crc32c_fold_onto(x2, k, x3);
+    while (len >= 64)
+    {
+        x3 = crc32c_fold_onto(x3, k, _mm512_loadu_si512(next));
+        next += 64;
+        len -= 64;
+    }
+
+    // The first three lanes onto the last one (its own constants are 0: it is
+    // blended back in as it is)
+    k = crc32c_fold_constants(t.fold[2], t.fold[1], t.fold[0], crc32c_fold{ 0, 0 });
+    x0 = crc32c_fold_onto(x3, k, _mm512_setzero_si512());
+    x0 = _mm512_mask_blend_epi64(0xc0, x0, x3);
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, x0);
+
+    uint64_t crc0 = _mm_crc32_u64(0, lanes[0] ^ lanes[2] ^ lanes[4] ^ lanes[6]);
+    crc0 = _mm_crc32_u64(crc0, lanes[1] ^ lanes[3] ^ lanes[5] ^ lanes[7]);
+    return crc32c_hw(t, (uint32_t) crc0 ^ 0xffffffff, next, len);
+}
+#endif
+
+} // end of anonymous namespace
+
+uint32_t Crc32c::update(uint32_t crc, const void *data, size_t len)
+{
+    const crc32c_tables& t = tables();
+#if defined(__x86_64__)
+    if (t.folding && len >= crc32c_fold_min)
+    {
+        return crc32c_folded(t, crc, (const unsigned char *) data, len);
+    }
+    if (t.hardware)
+    {
+        return crc32c_hw(t, crc, (const unsigned char *) data, len);
+    }
+#endif
+    return crc32c_sw(t, crc, (const unsigned char *) data, len);
+}
+
+uint32_t Crc32c::update_software(uint32_t crc, const void *data, size_t len)
+{
+    return crc32c_sw(tables(), crc, (const unsigned char *) data, len);
+}
+
+bool Crc32c::file_range(int fd, off_t offset, size_t len, uint32_t& crc)
+{
+    crc = 0;
+    if (len == 0) return true;
+
+    // mmap() offsets have to be page aligned
+    off_t pagesize = (off_t) ::sysconf(_SC_PAGESIZE);
+    off_t mapoffset = offset & ~(pagesize - 1);
+    size_t maplength = len + (size_t) (offset - mapoffset);
+
+    void *mapped = ::mmap(NULL, maplength, PROT_READ, MAP_SHARED, fd, mapoffset);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+    ::madvise(mapped, maplength, MADV_SEQUENTIAL);
+    crc = Crc32c::update(0, (const unsigned char *) mapped + (offset - mapoffset), len);
+    ::munmap(mapped, maplength);
+    return true;
+}
+
+bool Crc32c::is_hardware_accelerated()
+{
+    return tables().hardware;
+}
+
+std::string Crc32c::to_hex(uint32_t crc)
+{
+    return Util::format(UTIL_FMT("{:08x}"), crc);
+}
@@ -2,8 +2,13 @@
 #include "Utility.hpp"
 #include <MainLogger.hpp>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <linux/errqueue.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -211,7 +216,7 @@ int NtwkUtil::enet_send(Util::LoggerSPtr loggerp,
     }
     else
     {
-        loggerp->error() << "NtwkUtil::enet_send: Failed to write to socket: " <<
+        UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "NtwkUtil::enet_send: Failed to write to socket: " <<
                           Utility::get_errno_message(errnocopy) <<
                           ", socket fd = " << fd;
     }
@@ -263,7 +268,7 @@ int NtwkUtil::enet_receive( Util::LoggerSPtr loggerp,
         }
         else if (num < 0)
         {
-            loggerp->error() << "NtwkUtil::enet_receive: socket read error: " << Utility::get_errno_message(errnocopy);
+            UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "NtwkUtil::enet_receive: socket read error: " << Utility::get_errno_message(errnocopy);
             throw std::runtime_error(
                     std::string("NtwkUtil::enet_receive: socket read error: ") + Utility::get_errno_message(errnocopy));
             return -1;  // Should never even get here....
@@ -281,6 +286,381 @@ int NtwkUtil::enet_receive( Util::LoggerSPtr loggerp,
     return -1;
 }
 
+// Moves bytecount bytes from the socket to the file through a pipe with splice(2).
+// The data pages are moved between kernel buffers - they never get copied into (or out of)
+// a user space buffer the way enet_receive() followed by fwrite() does.
+ssize_t NtwkUtil::splice_to_file(Util::LoggerSPtr loggerp,
+                                 int socket_fd,
+                                 int file_fd,
+                                 size_t bytecount,
+                                 off_t *file_offset)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    int pipefd[2];
+
+    if (::pipe2(pipefd, O_CLOEXEC) < 0)
+    {
+        errnocopy = errno;
+        loggerp->error() << "NtwkUtil::splice_to_file: pipe2() failed: " << Utility::get_errno_message(errnocopy);
+        return -1;
+    }
+
+    // Try to size the pipe to match the regular receive buffer. If it fails we
+    // just use the default pipe size (which is usually the same 64K anyway).
+    ssize_t pipesize = ::fcntl(pipefd[1], F_SETPIPE_SZ, NtwkUtilBufferSize);
+    if (pipesize <= 0)
+    {
+        pipesize = ::fcntl(pipefd[1], F_GETPIPE_SZ);
+    }
+    if (pipesize <= 0)
+    {
+        pipesize = NtwkUtilRegularBufferSize;
+    }
+
+    size_t bytesremaining = bytecount;
+    ssize_t totalbyteswritten = 0;
+    bool failed = false;
+
+    while (bytesremaining > 0 && !failed)
+    {
+        size_t request = (bytesremaining > (size_t) pipesize? (size_t) pipesize : bytesremaining);
+
+        // socket -> pipe
+        ssize_t inpipe = ::splice(socket_fd, NULL, pipefd[1], NULL, request, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (inpipe < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::splice_to_file: splice() from socket fd " << socket_fd <<
+                                " failed: " << Utility::get_errno_message(errnocopy);
+            failed = true;
+            continue;
+        }
+        else if (inpipe == 0)
+        {
+            // EOF - the remote end closed the connection before all bytecount bytes came in.
+            LOGGER_DEBUG(*loggerp) << "NtwkUtil::splice_to_file: EOF on socket fd " << socket_fd <<
+                                " with " << bytesremaining << " bytes remaining";
+            break;
+        }
+
+        // pipe -> file. Everything that went into the pipe has to come out of it.
+        while (inpipe > 0)
+        {
+            // splice() advances the offset (loff_t) for us when one is given.
+            ssize_t infile = ::splice(pipefd[0], NULL, file_fd, (loff_t *) file_offset, inpipe, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (infile < 0)
+            {
+                errnocopy = errno;
+                if (errnocopy == EINTR) continue;
+                loggerp->error() << "NtwkUtil::splice_to_file: splice() to file fd " << file_fd <<
+                                    " failed: " << Utility::get_errno_message(errnocopy);
+                failed = true;
+                break;
+            }
+            else if (infile == 0)
+            {
+                loggerp->error() << "NtwkUtil::splice_to_file: splice() to file fd " << file_fd << " wrote no data";
+                failed = true;
+                break;
+            }
+            inpipe -= infile;
+            bytesremaining -= infile;
+            totalbyteswritten += infile;
+        }
+    }
+
+    ::close(pipefd[0]);
+    ::close(pipefd[1]);
+
+    return (failed? -1 : totalbyteswritten);
+}
+
+// Sends the file range with sendfile(2). sendfile() may send less than requested
+// (socket buffer full, signal) so it is called in a loop until the range is done.
+ssize_t NtwkUtil::enet_sendfile(Util::LoggerSPtr loggerp,
+                                int socket_fd,
+                                int file_fd,
+                                off_t offset,
+                                size_t bytecount)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    size_t bytesremaining = bytecount;
+    ssize_t totalbytessent = 0;
+
+    while (bytesremaining > 0)
+    {
+        // sendfile() advances offset by the number of bytes sent.
+        ssize_t num = ::sendfile(socket_fd, file_fd, &offset, bytesremaining);
+        if (num < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::enet_sendfile: sendfile() to socket fd " << socket_fd <<
+                                " failed: " << Utility::get_errno_message(errnocopy);
+            return -1;
+        }
+        else if (num == 0)
+        {
+            // EOF on the input file - it is shorter than the caller expected.
+            loggerp->error() << "NtwkUtil::enet_sendfile: Got EOF from file fd " << file_fd <<
+                                " with " << bytesremaining << " bytes remaining";
+            break;
+        }
+        bytesremaining -= num;
+        totalbytessent += num;
+    }
+    return totalbytessent;
+}
+
+// Waits for zero copy completion notifications on the socket error queue until
+// num_completed (the running count of acknowledged sends) reaches num_sends.
+// Returns false on error.
+static bool reap_zerocopy_completions(Util::LoggerSPtr loggerp, int socket_fd, uint32_t num_sends, uint32_t& num_completed)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+
+    while (num_completed < num_sends)
+    {
+        // POLLERR is always reported - it does not have to be requested in events.
+        struct ::pollfd pfd = { socket_fd, 0, 0 };
+        if (::poll(&pfd, 1, -1) < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::enet_send_zerocopy: poll() failed: " << Utility::get_errno_message(errnocopy);
+            return false;
+        }
+
+        char control[128];
+        struct ::msghdr msg = {};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (::recvmsg(socket_fd, &msg, MSG_ERRQUEUE) < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EAGAIN || errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::enet_send_zerocopy: recvmsg(MSG_ERRQUEUE) failed: " << Utility::get_errno_message(errnocopy);
+            return false;
+        }
+
+        for (struct ::cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != NULL; cm = CMSG_NXTHDR(&msg, cm))
+        {
+            struct ::sock_extended_err *serr = (struct ::sock_extended_err *) CMSG_DATA(cm);
+            if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+            {
+                continue;
+            }
+            // Completions come in as the range [ee_info, ee_data] of send() numbers.
+            num_completed += (serr->ee_data - serr->ee_info + 1);
+        }
+    }
+    return true;
+}
+
+ssize_t NtwkUtil::enet_send_zerocopy(Util::LoggerSPtr loggerp,
+                                     int socket_fd,
+                                     const uint8_t *buffer,
+                                     size_t bytecount)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    int optval = 1;
+    int flags = MSG_NOSIGNAL | MSG_ZEROCOPY;
+
+    if (::setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof(optval)) < 0)
+    {
+        errnocopy = errno;
+        LOGGER_DEBUG(*loggerp) << "NtwkUtil::enet_send_zerocopy: SO_ZEROCOPY not available (using regular send()): " <<
+                            Utility::get_errno_message(errnocopy);
+        flags = MSG_NOSIGNAL;
+    }
+
+    size_t bytesremaining = bytecount;
+    ssize_t totalbytessent = 0;
+    uint32_t num_sends = 0;
+    uint32_t num_completed = 0;
+
+    while (bytesremaining > 0)
+    {
+        ssize_t num = ::send(socket_fd, buffer + totalbytessent, bytesremaining, flags);
+        if (num < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            if (errnocopy == ENOBUFS && (flags & MSG_ZEROCOPY))
+            {
+                // Too many pages pinned (optmem limit) - wait for what is already out there.
+                // If nothing is outstanding, zero copy is not going to work on this socket.
+                if (num_completed == num_sends) flags = MSG_NOSIGNAL;
+                if (! reap_zerocopy_completions(loggerp, socket_fd, num_sends, num_completed)) return -1;
+                continue;
+            }
+            loggerp->error() << "NtwkUtil::enet_send_zerocopy: Failed to write to socket: " <<
+                                Utility::get_errno_message(errnocopy) << ", socket fd = " << socket_fd;
+            return -1;
+        }
+        if (flags & MSG_ZEROCOPY) num_sends++;
+        bytesremaining -= num;
+        totalbytessent += num;
+    }
+
+    if ((flags & MSG_ZEROCOPY) && ! reap_zerocopy_completions(loggerp, socket_fd, num_sends, num_completed))
+    {
+        return -1;
+    }
+    return totalbytessent;
+}
+
+ssize_t NtwkUtil::enet_receive_exact(Util::LoggerSPtr loggerp,
+                                     int fd,
+                                     void *buffer,
+                                     size_t bytecount)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    size_t bytesreceived = 0;
+
+    while (bytesreceived < bytecount)
+    {
+        ssize_t num = ::recv(fd, (uint8_t *) buffer + bytesreceived, bytecount - bytesreceived, 0);
+        if (num < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::enet_receive_exact: socket read error: " << Utility::get_errno_message(errnocopy);
+            return -1;
+        }
+        else if (num == 0)
+        {
+            break;  // EOF
+        }
+        bytesreceived += num;
+    }
+    return (ssize_t) bytesreceived;
+}
+
+bool NtwkUtil::get_framed_message(Util::LoggerSPtr loggerp, int socket_fd, std::string& retstring)
+{
+    uint32_t netlength = 0;
+
+    ssize_t ret = NtwkUtil::enet_receive_exact(loggerp, socket_fd, &netlength, NtwkUtilFrameHeaderSize);
+    if (ret < 0)
+    {
+        retstring =  "NtwkUtil::get_framed_message Error: trying to get remote connection message. Socket fd = ";
+        retstring += std::to_string(socket_fd);
+        return false;
+    }
+    else if (ret < (ssize_t) NtwkUtilFrameHeaderSize)
+    {
+        retstring = "NtwkUtil::get_framed_message Error: Got EOF from remote connection. Socket fd = ";
+        retstring += std::to_string(socket_fd);
+        return false;
+    }
+
+    size_t length = ntohl(netlength);
+    if (length > NtwkUtilMaxFramedMessageSize)
+    {
+        retstring = "NtwkUtil::get_framed_message Error: message length " + std::to_string(length) +
+                    " is larger than the maximum (" + std::to_string(NtwkUtilMaxFramedMessageSize) + "). Socket fd = ";
+        retstring += std::to_string(socket_fd);
+        return false;
+    }
+
+    // Received straight into the string: a caller that reuses it for each
+    // message reuses its capacity too.
+    retstring.resize(length);
+    ret = NtwkUtil::enet_receive_exact(loggerp, socket_fd, &retstring[0], length);
+
+    if (ret != (ssize_t) length)
+    {
+        retstring = "NtwkUtil::get_framed_message Error: Got EOF or error before the end of the message. Socket fd = ";
+        retstring += std::to_string(socket_fd);
+        return false;
+    }
+    return true;
+}
+
+bool NtwkUtil::send_framed_message(Util::LoggerSPtr loggerp, int socket_fd, const std::string& message)
+{
+    using Util::Utility;
+
+    if (message.size() > NtwkUtilMaxFramedMessageSize)
+    {
+        loggerp->error() << "NtwkUtil::send_framed_message: message length " << message.size() <<
+                            " is larger than the maximum (" << NtwkUtilMaxFramedMessageSize << ")";
+        return false;
+    }
+
+    uint32_t netlength = htonl((uint32_t) message.size());
+    size_t framesize = NtwkUtilFrameHeaderSize + message.size();
+    char stackbuf[NtwkUtilFramedStackBufferSize];
+    struct ::iovec iov[2];
+    struct ::msghdr msg = {};
+
+    // Short messages are put together on the stack and go out from a single buffer.
+    // Longer ones are sent straight from the string (header and message in one sendmsg()).
+    if (framesize <= NtwkUtilFramedStackBufferSize)
+    {
+        ::memcpy(stackbuf, &netlength, NtwkUtilFrameHeaderSize);
+        ::memcpy(stackbuf + NtwkUtilFrameHeaderSize, message.data(), message.size());
+        iov[0].iov_base = stackbuf;
+        iov[0].iov_len = framesize;
+        msg.msg_iovlen = 1;
+    }
+    else
+    {
+        iov[0].iov_base = &netlength;
+        iov[0].iov_len = NtwkUtilFrameHeaderSize;
+        iov[1].iov_base = const_cast<char *>(message.data());
+        iov[1].iov_len = message.size();
+        msg.msg_iovlen = 2;
+    }
+    msg.msg_iov = iov;
+
+    int errnocopy = 0;
+    size_t bytessent = 0;
+    while (bytessent < framesize)
+    {
+        ssize_t num = ::sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+        if (num < 0)
+        {
+            errnocopy = errno;
+            if (errnocopy == EINTR) continue;
+            loggerp->error() << "NtwkUtil::send_framed_message: Error sending message to connection fd " << socket_fd <<
+                                ": " << Utility::get_errno_message(errnocopy);
+            return false;
+        }
+        bytessent += num;
+
+        // Partial send: skip over what went out already.
+        while (num > 0 && msg.msg_iovlen > 0)
+        {
+            size_t skip = ((size_t) num < msg.msg_iov[0].iov_len? (size_t) num : msg.msg_iov[0].iov_len);
+            msg.msg_iov[0].iov_base = (uint8_t *) msg.msg_iov[0].iov_base + skip;
+            msg.msg_iov[0].iov_len -= skip;
+            num -= skip;
+            if (msg.msg_iov[0].iov_len == 0)
+            {
+                msg.msg_iov++;
+                msg.msg_iovlen--;
+            }
+        }
+    }
+
+    LOGGER_DEBUG(*loggerp) << "NtwkUtil::send_framed_message: Message sent to connection fd " << socket_fd << ": \"" << message << "\"";
+    return true;
+}
+
 // Get a string message from the network
 // retstring is an existing std::string - contents overwritten
 // socket_fd - open connection to the remote system
@@ -339,7 +719,7 @@ bool NtwkUtil::send_ntwk_message(Util::LoggerSPtr loggerp, int socket_fd, std::s
         return false;
     }
 
-    loggerp->debug() << "NtwkUtil::send_ntwk_message: Message sent to connection fd " << socket_fd << ": \"" << message << "\"";
+    LOGGER_DEBUG(*loggerp) << "NtwkUtil::send_ntwk_message: Message sent to connection fd " << socket_fd << ": \"" << message << "\"";
     return true;
 }
 
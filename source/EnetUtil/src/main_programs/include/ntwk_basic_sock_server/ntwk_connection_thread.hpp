@@ -45,8 +45,29 @@ namespace EnetUtil {
     class socket_connection_thread
     {
     public:
+        // How the file data coming in on a connection is written to the output file.
+        enum receive_mode
+        {
+            copy_receive = 0,       // enet_receive() into a fixed_size_array, then fwrite() (default)
+            splice_receive          // splice() from the socket to the file - no user space copy
+        };
+
+        // Checksums (CRC-32C, see NtwkCrc32c.hpp) of the file data received on a connection.
+        enum checksum_mode
+        {
+            no_checksum = 0,        // No checksum in the "OK|..." responses
+            crc32c_checksum,        // Checksum added to the "OK|..." responses (default)
+            crc32c_sidecar          // Same, and also written to a "<output file>.crc32c" file
+        };
+
         static std::string get_seq_num_string(long num);    // utility function
 
+        // Converts "copy" or "splice" to the enum value. Returns false if the string is invalid.
+        static bool string_to_receive_mode(const std::string& modestr, receive_mode& mode);
+
+        // Converts "none", "crc32c" or "sidecar" to the enum value. Returns false if the string is invalid.
+        static bool string_to_checksum_mode(const std::string& modestr, checksum_mode& mode);
+
         // This member function (static) runs in the main thread.
         static void start (int socket, int threadno, Util::LoggerSPtr loggerp);
 
@@ -66,6 +87,10 @@ namespace EnetUtil {
         // vector of std::thread objects, each handling its own connection
         static std::vector<std::thread> s_connection_workers;
 
+        // Set (once) before the first call to start(). Applies to all connections.
+        static receive_mode s_receive_mode;
+        static checksum_mode s_checksum_mode;
+
     };  // end of class socket_connection_thread
 
 } // end of namespace EnetUtil
@@ -25,10 +25,12 @@
 
 #include <ntwk_basic_sock_server/ntwk_connection_thread.hpp>
 #include <Utility.hpp>
+#include <Format.hpp>
 #include <MainLogger.hpp>
 #include <commandline.hpp>
 #include <NtwkUtil.hpp>
 #include <NtwkFixedArray.hpp>
+#include <NtwkCrc32c.hpp>
 #include <LoggerCpp/LoggerCpp.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,7 +45,13 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <fstream>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <time.h>
 using namespace EnetUtil;
 
@@ -64,18 +72,56 @@ std::string log_level = Util::UtilLogger::getLoggerLevelEnumString(loglevel);
 // fixed size of the std::array<> used for the data
 const int server_buffer_size = NtwkUtilBufferSize;
 
+const char *default_send_mode = "copy";         // how the file data is sent (see Usage())
+std::string send_mode(default_send_mode);       // can be modified from the command line
+
+const int default_parallel_connections = 1;     // number of connections used to send the file
+int parallel_connections = default_parallel_connections;    // can be modified from the command line
+const int max_parallel_connections = 64;
+
+std::string session_list_filename = "";         // list of files sent over one connection (see Usage())
+
+const int default_ack_batch_size = 32;          // session mode: the server responds once per this many files
+int ack_batch_size = default_ack_batch_size;    // can be modified from the command line
+
+const int default_verify_checksums = 1;         // check the CRC-32C checksums sent back by the server
+int verify_checksums = default_verify_checksums;            // can be modified from the command line
+
 void Usage(std::ostream &strm, std::string command)
 {
     strm << "\nUsage:    " << command << " --help (or -h or help)" << std::endl;
     strm << "Or:       " << command
             << "\n"
-            << "              -fn file-name             (MANDATORY: both the \"-fn\" flag and the name of the \n"
-            << "                                        existing file containing the data to be transmitted \n"
-            << "                                        have to be specified on the command line)\n"
+            << "              -fn file-name             (MANDATORY unless -fl is used: both the \"-fn\" flag and the\n"
+            << "                                        name of the existing file containing the data to be\n"
+            << "                                        transmitted have to be specified on the command line)\n"
+            << "              -fl list-file             (instead of -fn: name of a file listing the files to be\n"
+            << "                                        transmitted, one per line - see below)\n"
             << "              [ -ip server-ip-address ] (default is \"IADDR_ANY\" same as \"\")\n"
             << "              [ -pn port-number ]       (port num to connect to, default is the port number \n"
             << "                                        used by the server - see NOTE below)\n"
             << "              [ -lg log-level ]         (see below, default is \"NOTE\"\n"
+            << "              [ -sm send-mode ]         (\"copy\", \"sendfile\" or \"zerocopy\", default is \"copy\": see below)\n"
+            << "              [ -pc connections ]       (number of parallel connections used to send the file,\n"
+            << "                                        default is 1: see below)\n"
+            << "              [ -ab ack-batch-size ]    (with -fl: the server responds once per this many files,\n"
+            << "                                        default is 32)\n"
+            << "              [ -ck 0|1 ]               (1: check the checksums returned by the server, default is 1)\n"
+            << "\n"
+            << "send-mode \"copy\" reads the file into a buffer and sends the buffer.  \"sendfile\" sends the file\n"
+            << "with sendfile(2) - the data goes from the page cache to the socket without a user space copy.\n"
+            << "\"zerocopy\" maps the file into memory and sends it with MSG_ZEROCOPY (only worth it for large files).\n"
+            << "\n"
+            << "With more than one connection, the file is split into that many ranges, and each range is\n"
+            << "sent on its own connection. The server puts the ranges together in one output file.\n"
+            << "\n"
+            << "With -fl, all the files in the list are sent back to back over a single connection (a session)\n"
+            << "without waiting for the server to respond to each file.  Empty lines and lines starting with\n"
+            << "'#' in the list file are ignored.  -fl cannot be used with -fn or with -pc.\n"
+            << "\n"
+            << "With -ck 1 the client computes the CRC-32C checksum of the data it sends, and compares it with\n"
+            << "the checksum at the end of the server's \"OK|...\" response (see the server's -ck flag).\n"
+            << "A mismatch is an error.\n"
             << "\n"
             << "log-level can be one of: {\"DBUG\", \"INFO\", \"NOTE\", \"WARN\", \"EROR\", \"CRIT\"}\n"
             << "\n"
@@ -120,6 +166,438 @@ bool check_input_file(std::ostream &strm, std::string input_filename, struct sta
     return true;
 }
 
+// Compares the checksum at the end of a server response ("OK|thread|file|bytes|crc")
+// with the checksum of the data sent.  Returns false on a mismatch.
+bool check_response_checksum(Util::LoggerSPtr loggerp, const std::string& response, uint32_t crc)
+{
+    using namespace Util;
+
+    if (! verify_checksums)
+    {
+        return true;
+    }
+
+    std::vector<std::string> fields = Utility::split(response, "|");
+    if (fields.size() < 5)
+    {
+        loggerp->notice() << "Server did not return a checksum (" << response << ")";
+        return true;
+    }
+
+    if (fields[4] != Crc32c::to_hex(crc))
+    {
+        loggerp->error() << "Checksum mismatch for " << fields[2] << ": sent " << Crc32c::to_hex(crc) <<
+                            ", server received " << fields[4];
+        return false;
+    }
+
+    LOGGER_DEBUG(*loggerp) << "Checksum " << fields[4] << " verified for " << fields[2];
+    return true;
+}
+
+// Sends bytecount bytes of the input file starting at offset on the (already connected)
+// socket, using the send mode from the command line.  Returns the number of bytes sent,
+// or -1 on error.  If crc is not NULL it is set to the CRC-32C checksum of the data.
+ssize_t send_file_data(Util::LoggerSPtr loggerp,
+                       int socket_fd,
+                       int input_fd,
+                       const std::string& filename,
+                       off_t offset,
+                       size_t bytecount,
+                       uint32_t *crc = NULL)
+{
+    using namespace Util;
+
+    ssize_t totalbytes_sent = 0;
+    if (crc != NULL) *crc = 0;
+
+    if (send_mode == "sendfile")
+    {
+        // The data never comes through user space, so it is read once more from the
+        // page cache for the checksum (it was most likely cached by then anyway).
+        if (crc != NULL && ! Crc32c::file_range(input_fd, offset, bytecount, *crc))
+        {
+            loggerp->error() << "Cannot compute the checksum of " << filename;
+            return -1;
+        }
+        totalbytes_sent = NtwkUtil::enet_sendfile(loggerp, socket_fd, input_fd, offset, bytecount);
+    }
+    else if (send_mode == "zerocopy")
+    {
+        if (bytecount > 0)
+        {
+            // mmap() offsets have to be page aligned
+            off_t pagesize = (off_t) ::sysconf(_SC_PAGESIZE);
+            off_t mapoffset = offset & ~(pagesize - 1);
+            size_t maplength = bytecount + (size_t) (offset - mapoffset);
+
+            void *mapped = ::mmap(NULL, maplength, PROT_READ, MAP_PRIVATE, input_fd, mapoffset);
+            if (mapped == MAP_FAILED)
+            {
+                int errnocopy = errno;
+                loggerp->error() << "Cannot mmap() " << filename << ": " << Utility::get_errno_message(errnocopy);
+                return -1;
+            }
+            ::madvise(mapped, maplength, MADV_SEQUENTIAL);
+            const uint8_t *data = (const uint8_t *) mapped + (offset - mapoffset);
+            if (crc != NULL) *crc = Crc32c::update(0, data, bytecount);
+            totalbytes_sent = NtwkUtil::enet_send_zerocopy(loggerp, socket_fd, data, bytecount);
+            ::munmap(mapped, maplength);
+        }
+    }
+    else
+    {
+        arrayUint8 array_element_buffer;
+        while ((size_t) totalbytes_sent < bytecount)
+        {
+            size_t request = bytecount - totalbytes_sent;
+            request = (request > array_element_buffer.size()? array_element_buffer.size() : request);
+
+            ssize_t numread = ::pread(input_fd, array_element_buffer.data(), request, offset + totalbytes_sent);
+            if (numread <= 0)
+            {
+                loggerp->error() << "Error in reading " << filename;
+                totalbytes_sent = -1;
+                break;
+            }
+            if (crc != NULL) *crc = Crc32c::update(*crc, array_element_buffer.data(), numread);
+
+            // On a blocking socket send() only returns early on a signal or an error.
+            int ret = NtwkUtil::enet_send(loggerp, socket_fd, array_element_buffer, numread, MSG_NOSIGNAL);
+            if (ret != numread)
+            {
+                totalbytes_sent = -1;
+                break;      // error message logged from inside enet_send()
+            }
+            totalbytes_sent += ret;
+        }
+    }
+
+    return totalbytes_sent;
+}
+
+// A new id for the server to name the output files of an upload after: random, as
+// process ids are reused, and clash between hosts.
+std::string new_upload_id()
+{
+    return Util::format(UTIL_FMT("{:016x}"), Util::Utility::thread_rng()());
+}
+
+// Sends bytecount bytes of the input file starting at offset on a new connection to
+// the server, using the send mode from the command line.  If uploadid is not empty, the
+// initial message tells the server where the range goes in the file, and which upload it
+// is part of (see thread_connection_handler()).
+// Returns 0 on success, 1 on failure.
+int send_file_range(Util::LoggerSPtr loggerp,
+                    struct ::sockaddr_in sin_addr,
+                    int input_fd,
+                    const std::string& file_basename,
+                    off_t offset,
+                    size_t bytecount,
+                    size_t numbytesinfile,
+                    const std::string& uploadid)
+{
+    using namespace Util;
+
+    int socket_fd = -1;
+    if ((socket_fd = NtwkUtil::client_socket_connect(loggerp, (sockaddr*) &sin_addr)) < 0)
+    {
+        loggerp->error()
+                << "Error returned from client_socket_connect(): Connection to "
+                << connection_ip << ":" << connection_port_number
+                << " failed. Aborting...";
+        return 1;
+    }
+
+    // All ranges of the same upload carry the same upload id
+    std::string initialMessage = file_basename + "|" + std::to_string(bytecount);
+    if (! uploadid.empty())
+    {
+        initialMessage += "|" + std::to_string(offset) + "|" + std::to_string(numbytesinfile) + "|" + uploadid;
+    }
+
+    // Log output has been written already
+    if (!NtwkUtil::send_framed_message(loggerp, socket_fd, initialMessage))
+    {
+        ::close(socket_fd);
+        return 1;
+    }
+
+    uint32_t crc = 0;
+    ssize_t totalbytes_sent = send_file_data(loggerp, socket_fd, input_fd, input_filename, offset, bytecount,
+                                             verify_checksums? &crc : NULL);
+
+    if (totalbytes_sent < 0 || (size_t) totalbytes_sent != bytecount)
+    {
+        loggerp->error() << "Failed to send " << bytecount << " bytes at offset " << offset << " of \"" <<
+                            input_filename << "\" to " << connection_ip << ":" << connection_port_number;
+        ::close(socket_fd);
+        return 1;
+    }
+
+    loggerp->notice() << "Successfully sent " << totalbytes_sent << " bytes at offset " << offset << " of \"" <<
+                         input_filename << "\" to " << connection_ip << ":" << connection_port_number <<
+                         " (" << send_mode << ")";
+
+    // get server response in a string
+    int ret = 0;
+    std::string response;
+    if (NtwkUtil::get_framed_message(loggerp, socket_fd, response))
+    {
+        loggerp->notice() << "Server response (for file \"" << input_filename << "\"): " << response;
+        if (! check_response_checksum(loggerp, response, crc)) ret = 1;
+    }
+    else
+    {
+        loggerp->error() << response;
+        ret = 1;
+    }
+
+    ::close(socket_fd);
+    return ret;
+}
+
+// Splits the file into parallel_connections ranges and sends each range
+// on its own connection (thread).  Returns 0 if all ranges were sent.
+int send_file_ranges(Util::LoggerSPtr loggerp,
+                     struct ::sockaddr_in sin_addr,
+                     int input_fd,
+                     const std::string& file_basename,
+                     size_t numbytesinfile)
+{
+    if (parallel_connections <= 1)
+    {
+        return send_file_range(loggerp, sin_addr, input_fd, file_basename, 0, numbytesinfile, numbytesinfile, std::string());
+    }
+
+    // Keep the ranges a multiple of the network buffer size (and so page aligned for zerocopy)
+    size_t rangesize = (numbytesinfile + parallel_connections - 1) / parallel_connections;
+    rangesize = ((rangesize + NtwkUtilBufferSize - 1) / NtwkUtilBufferSize) * NtwkUtilBufferSize;
+    if (rangesize == 0) rangesize = NtwkUtilBufferSize;
+
+    std::vector<std::thread> range_threads;
+    std::vector<int> range_results(parallel_connections, 0);
+    const std::string uploadid = new_upload_id();
+
+    size_t offset = 0;
+    for (int i = 0; i < parallel_connections && (offset < numbytesinfile || i == 0); i++)
+    {
+        size_t bytecount = (numbytesinfile - offset > rangesize? rangesize : numbytesinfile - offset);
+        range_threads.push_back(std::thread([&, i, offset, bytecount]()
+        {
+            range_results[i] = send_file_range(loggerp, sin_addr, input_fd, file_basename,
+                                               (off_t) offset, bytecount, numbytesinfile, uploadid);
+        }));
+        offset += bytecount;
+    }
+
+    for (auto& t : range_threads)
+    {
+        if (t.joinable()) t.join();
+    }
+
+    int ret = 0;
+    std::for_each(range_results.begin(), range_results.end(), [&ret](int r) { if (r != 0) ret = 1; });
+    return ret;
+}
+
+// Session mode (-fl): all the files in the list go over one connection, back to back,
+// without waiting for the server's response to each file.  The server responds in batches
+// (see session_connection_handler() in ntwk_connection_thread.cpp) which are read by a
+// separate thread while the files are being sent.  Returns 0 if all files were received.
+int send_session(Util::LoggerSPtr loggerp,
+                 struct ::sockaddr_in sin_addr,
+                 const std::vector<std::string>& filenames)
+{
+    using namespace Util;
+
+    int socket_fd = -1;
+    if ((socket_fd = NtwkUtil::client_socket_connect(loggerp, (sockaddr*) &sin_addr)) < 0)
+    {
+        loggerp->error()
+                << "Error returned from client_socket_connect(): Connection to "
+                << connection_ip << ":" << connection_port_number
+                << " failed. Aborting...";
+        return 1;
+    }
+
+    std::string sessionMessage = std::string("SESSION|") + std::to_string(ack_batch_size) + "|" + new_upload_id();
+    if (!NtwkUtil::send_framed_message(loggerp, socket_fd, sessionMessage))
+    {
+        ::close(socket_fd);
+        return 1;
+    }
+
+    // Checksums of the files sent, in the order the server responds to them. A
+    // file's checksum is computed while it is sent, so the server's response to
+    // it can come in first: response_reader waits for the checksum then.
+    std::vector<uint32_t> file_crcs(filenames.size());
+    size_t num_crcs = 0;
+    bool sending_done = false;
+    std::mutex crc_mutex;
+    std::condition_variable crc_stored;
+
+    // Responses are read as they come in, so the server never blocks
+    // on a full socket while the files are still being sent.
+    size_t num_ok = 0;
+    size_t num_failed = 0;
+    bool ended = false;
+    std::thread response_reader([&]()
+    {
+        while (!ended)
+        {
+            std::string response;
+            if (! NtwkUtil::get_framed_message(loggerp, socket_fd, response))
+            {
+                loggerp->error() << response;
+                break;
+            }
+
+            for (auto& line : Utility::split(response, "\n"))
+            {
+                if (Utility::string_starts_with(line, "END|"))
+                {
+                    loggerp->notice() << "Server ended session: " << line;
+                    ended = true;
+                }
+                else if (Utility::string_starts_with(line, "OK|"))
+                {
+                    loggerp->notice() << "Server response: " << line;
+                    size_t fileno = num_ok + num_failed;
+                    uint32_t crc = 0;
+                    {
+                        std::unique_lock<std::mutex> lock(crc_mutex);
+                        crc_stored.wait(lock, [&]() { return num_crcs > fileno || sending_done; });
+                        if (fileno < num_crcs) crc = file_crcs[fileno];
+                    }
+                    if (fileno < file_crcs.size() && ! check_response_checksum(loggerp, line, crc))
+                        num_failed++;
+                    else
+                        num_ok++;
+                }
+                else
+                {
+                    loggerp->error() << "Server response: " << line;
+                    num_failed++;
+                }
+            }
+        }
+    });
+
+    size_t num_sent = 0;
+    bool send_failed = false;
+    for (auto& filename : filenames)
+    {
+        int input_fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (input_fd < 0)
+        {
+            int errnocopy = errno;
+            loggerp->error() << "Cannot open input file \"" << filename << "\": " << Utility::get_errno_message(errnocopy);
+            break;
+        }
+
+        struct stat sb;
+        if (::fstat(input_fd, &sb) < 0)
+        {
+            int errnocopy = errno;
+            loggerp->error() << "Cannot fstat() input file \"" << filename << "\": " << Utility::get_errno_message(errnocopy);
+            ::close(input_fd);
+            break;
+        }
+        size_t numbytesinfile = (size_t) sb.st_size;
+
+        std::vector<std::string> path = Utility::split(filename, "/");
+        std::string transferMessage = path.back() + "|" + std::to_string(numbytesinfile);
+
+        uint32_t crc = 0;
+        bool sent = NtwkUtil::send_framed_message(loggerp, socket_fd, transferMessage) &&
+                    send_file_data(loggerp, socket_fd, input_fd, filename, 0, numbytesinfile,
+                                   verify_checksums? &crc : NULL) == (ssize_t) numbytesinfile;
+        ::close(input_fd);
+        {
+            std::lock_guard<std::mutex> lock(crc_mutex);
+            file_crcs[num_sent] = crc;
+            num_crcs = num_sent + 1;
+        }
+        crc_stored.notify_one();
+
+        if (! sent)
+        {
+            loggerp->error() << "Failed to send \"" << filename << "\" to " << connection_ip << ":" << connection_port_number;
+            send_failed = true;
+            break;
+        }
+        num_sent++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(crc_mutex);
+        sending_done = true;
+    }
+    crc_stored.notify_one();
+
+    if (send_failed)
+    {
+        // The server is still reading the file that failed, and would take "END" for its
+        // data: closing our side ends that read, and then the session.
+        ::shutdown(socket_fd, SHUT_WR);
+    }
+    else
+    {
+        std::string endMessage("END");
+        NtwkUtil::send_framed_message(loggerp, socket_fd, endMessage);
+    }
+
+    // The reader is done when it gets the "END|..." line, or when the server closes the connection.
+    response_reader.join();
+    ::close(socket_fd);
+
+    loggerp->notice() << "Session: sent " << num_sent << " of " << filenames.size() << " files, " <<
+                         num_ok << " received by the server, " << num_failed << " failed";
+    if (send_failed)
+    {
+        loggerp->error() << "Session failed: the transfer of file " << num_sent + 1 << " (" << filenames[num_sent] <<
+                            ") did not complete";
+    }
+
+    return ((ended && ! send_failed && num_ok == filenames.size())? 0 : 1);
+}
+
+// Reads the list of files for session mode (-fl). Returns false on error (written to strm).
+bool read_session_list(std::ostream &strm, std::vector<std::string>& filenames)
+{
+    using Util::Utility;
+
+    std::ifstream listfile(session_list_filename);
+    if (! listfile.is_open())
+    {
+        strm << "\nCannot open list file \"" << session_list_filename << "\"\n" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(listfile, line))
+    {
+        line = Utility::trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        struct stat sb;
+        size_t numbytesinfile = 0;
+        if (! check_input_file(strm, line, &sb, numbytesinfile))
+        {
+            return false;
+        }
+        filenames.push_back(line);
+    }
+
+    if (filenames.empty())
+    {
+        strm << "\nList file \"" << session_list_filename << "\" has no file names in it.\n" << std::endl;
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, const char *argv[])
 {
     using namespace Util;
@@ -130,7 +608,7 @@ int main(int argc, const char *argv[])
 
     std::string argv0 = argv[0];
 
-    const std::vector<std::string> allowedFlags ={ "-fn", "-ip", "-pn", "-lg" };
+    const std::vector<std::string> allowedFlags ={ "-fn", "-ip", "-pn", "-lg", "-sm", "-pc", "-fl", "-ab", "-ck" };
     CommandLine cmdline(argc, argv, allowedFlags);
 
     if(cmdline.isError())
@@ -160,6 +638,43 @@ int main(int argc, const char *argv[])
         return EXIT_FAILURE;
     }
 
+    if (! session_list_filename.empty())
+    {
+        std::vector<std::string> session_filenames;
+        if (! read_session_list(std::cerr, session_filenames))
+        {
+            Usage(std::cerr, argv0);
+            return 1;
+        }
+
+        Util::LoggerOptions localopt = Util::UtilLogger::setLocalLoggerOptions(
+                                                            logChannelName,
+                                                            loglevel,
+                                                            Util::MainLogger::enableConsole,
+                                                            Util::MainLogger::disableLogFile
+                                                        );
+        Util::UtilLogger::create(localopt);
+        std::shared_ptr<Log::Logger> loggerp = Util::UtilLogger::getLoggerPtr();
+
+        struct ::sockaddr_in sin_addr;
+        if (!NtwkUtil::setup_sockaddr_in(std::string(connection_ip),
+                (uint16_t) connection_port_number, (sockaddr*) &sin_addr))
+        {
+            loggerp->error()
+                    << "Error returned from setup_sockaddr_in(): Setup connection for "
+                    << connection_ip << ":" << connection_port_number
+                    << " failed. Aborting...";
+            return 1;
+        }
+
+        int ret = send_session(loggerp, sin_addr, session_filenames);
+
+        // Terminate the Log Manager (destroy the Output objects)
+        Util::LogRateLimiter::report_suppressed();
+        Log::Manager::terminate();
+        return ret;
+    }
+
     /////////////////
     // Open input file
     /////////////////
@@ -202,7 +717,7 @@ int main(int argc, const char *argv[])
     Util::UtilLogger::create(localopt);
     std::shared_ptr<Log::Logger> loggerp = Util::UtilLogger::getLoggerPtr();
 
-    loggerp->debug() << "Using " << input_filename << " for input. Size is " << numbytesinfile << " bytes.";
+    LOGGER_DEBUG(*loggerp) << "Using " << input_filename << " for input. Size is " << numbytesinfile << " bytes.";
 
     /////////////////
     // Set up connection to server
@@ -211,11 +726,11 @@ int main(int argc, const char *argv[])
     if (connection_ip.empty() || connection_ip == "INADDR_ANY")
     {
         connection_ip = "";
-        loggerp->debug() << "    Client connecting to ip: INADDR_ANY:" << connection_port_number;
+        LOGGER_DEBUG(*loggerp) << "    Client connecting to ip: INADDR_ANY:" << connection_port_number;
     }
     else
     {
-        loggerp->debug() << "    Client connecting to ip: " << connection_ip << ":" << connection_port_number;
+        LOGGER_DEBUG(*loggerp) << "    Client connecting to ip: " << connection_ip << ":" << connection_port_number;
     }
 
     struct ::sockaddr_in sin_addr;
@@ -230,6 +745,27 @@ int main(int argc, const char *argv[])
         return 1;
     }
 
+    std::vector<std::string> path = Utility::split(input_filename, "/");
+    std::string file_basename = path.back();
+
+    if (send_mode != "copy" || parallel_connections > 1)
+    {
+        int ret = send_file_ranges(loggerp, sin_addr, ::fileno(input_stream), file_basename, numbytesinfile);
+        if (ret == 0)
+        {
+            loggerp->notice() << argv0 << ": Successfully sent file \"" << input_filename
+                    << "\" with " << numbytesinfile << " bytes to " << connection_ip
+                    << ":" << connection_port_number << " on " << parallel_connections << " connection(s)";
+        }
+
+        ::fclose(input_stream);
+
+        // Terminate the Log Manager (destroy the Output objects)
+        Util::LogRateLimiter::report_suppressed();
+        Log::Manager::terminate();
+        return ret;
+    }
+
     int socket_fd = -1;
     if ((socket_fd = NtwkUtil::client_socket_connect(loggerp, (sockaddr*) &sin_addr)) < 0)
     {
@@ -245,12 +781,10 @@ int main(int argc, const char *argv[])
             << connection_port_number << " Successfully.";
 
 
-    std::vector<std::string> path = Utility::split(input_filename, "/");
-    std::string file_basename = path.back();
     std::string initialMessage = file_basename + "|" + std::to_string(numbytesinfile);
 
     // Log output has been written already
-    if (!NtwkUtil::send_ntwk_message(loggerp, socket_fd, initialMessage))
+    if (!NtwkUtil::send_framed_message(loggerp, socket_fd, initialMessage))
     {
         if (input_stream != NULL) ::fclose(input_stream);
         if (socket_fd >= 0) ::close(socket_fd);
@@ -263,6 +797,7 @@ int main(int argc, const char *argv[])
 
     arrayUint8 array_element_buffer;
     size_t totalbytes_sent = 0;
+    uint32_t crc = 0;
     int ret = 0;
     while (!std::feof(input_stream))
     {
@@ -280,13 +815,14 @@ int main(int argc, const char *argv[])
 
         if (numread > 0)
         {
+            if (verify_checksums) crc = Crc32c::update(crc, array_element_buffer.data(), numread);
             ret = NtwkUtil::enet_send(loggerp, socket_fd, array_element_buffer,
                     numread, MSG_NOSIGNAL);
             if (ret < 0)
                 break;  // error message logged from inside enet_send()
             else if (ret == 0)
             {
-                loggerp->debug() << argv0 << ": No data was sent to "
+                LOGGER_DEBUG(*loggerp) << argv0 << ": No data was sent to "
                         << connection_ip << ":" << connection_port_number
                         << ", size requested: " << array_element_buffer.size();
                 ret = 1;
@@ -306,9 +842,10 @@ int main(int argc, const char *argv[])
 
     // get server response in a string
     std::string response;
-    if (NtwkUtil::get_ntwk_message(loggerp, socket_fd, response))
+    if (NtwkUtil::get_framed_message(loggerp, socket_fd, response))
     {
         loggerp->notice() << "Server response (for file \"" << input_filename << "\"): " << response;
+        if (! check_response_checksum(loggerp, response, crc)) ret = 1;
     }
     else
     {
@@ -326,6 +863,7 @@ int main(int argc, const char *argv[])
         ::close(socket_fd);
 
     // Terminate the Log Manager (destroy the Output objects)
+    Util::LogRateLimiter::report_suppressed();
     Log::Manager::terminate();
 
     return ret;
@@ -368,14 +906,32 @@ bool parse(std::ostream &strm, Util::CommandLine& cmdline)
             assert (fail_int == -667);   // Bug encountered. Will cause abnormal termination
     }
 
-    // this flag (-fn) and an existing readable regular file name are MANDATORY
+    switch(cmdline.get_template_arg("-fl", session_list_filename))
+    {
+        case Util::ParameterStatus::FlagNotProvided:
+        case Util::ParameterStatus::FlagPresentParameterPresent:
+            break;
+        case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
+            strm << "ERROR: \"-fl\" flag is missing its parameter." << std::endl;
+            return false;
+        default:
+            assert (fail_int == -672);   // Bug encountered. Will cause abnormal termination
+    }
+
+    // this flag (-fn) and an existing readable regular file name are MANDATORY (unless -fl is used)
     switch(cmdline.get_template_arg("-fn", input_filename))
     {
         case Util::ParameterStatus::FlagNotProvided:
+            if (! session_list_filename.empty()) break;
             strm << "ERROR: the \"-fn\" flag is missing. Specifying input file name with the -fn flag is mandatory." << std::endl;
             return false;
         case Util::ParameterStatus::FlagPresentParameterPresent:
             // for debugging:  strm << "-fn flag provided. Using " << input_filename << std::endl;
+            if (! session_list_filename.empty())
+            {
+                strm << "ERROR: the \"-fn\" and \"-fl\" flags cannot be used together." << std::endl;
+                return false;
+            }
             break;
         case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
             strm << "ERROR: \"-fn\" flag is missing its parameter." << std::endl;
@@ -399,6 +955,85 @@ bool parse(std::ostream &strm, Util::CommandLine& cmdline)
             assert (fail_int == -669);   // Bug encountered. Will cause abnormal termination
     }
 
+    switch(cmdline.get_template_arg("-sm", send_mode))
+    {
+        case Util::ParameterStatus::FlagNotProvided:
+        case Util::ParameterStatus::FlagPresentParameterPresent:
+            break;
+        case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
+            strm << "ERROR: \"-sm\" flag is missing its parameter." << std::endl;
+            return false;
+        default:
+            assert (fail_int == -670);   // Bug encountered. Will cause abnormal termination
+    }
+
+    if (send_mode != "copy" && send_mode != "sendfile" && send_mode != "zerocopy")
+    {
+        strm << "ERROR: Invalid send mode (" << send_mode << ")." << std::endl;
+        return false;
+    }
+
+    switch(cmdline.get_template_arg("-pc", parallel_connections))
+    {
+        case Util::ParameterStatus::FlagNotProvided:
+        case Util::ParameterStatus::FlagPresentParameterPresent:
+            break;
+        case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
+            strm << "ERROR: \"-pc\" flag is missing its parameter." << std::endl;
+            return false;
+        default:
+            assert (fail_int == -671);   // Bug encountered. Will cause abnormal termination
+    }
+
+    if (parallel_connections < 1 || parallel_connections > max_parallel_connections)
+    {
+        strm << "ERROR: Invalid number of parallel connections (" << parallel_connections <<
+                "). Has to be between 1 and " << max_parallel_connections << "." << std::endl;
+        return false;
+    }
+
+    switch(cmdline.get_template_arg("-ab", ack_batch_size))
+    {
+        case Util::ParameterStatus::FlagNotProvided:
+        case Util::ParameterStatus::FlagPresentParameterPresent:
+            break;
+        case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
+            strm << "ERROR: \"-ab\" flag is missing its parameter." << std::endl;
+            return false;
+        default:
+            assert (fail_int == -673);   // Bug encountered. Will cause abnormal termination
+    }
+
+    if (ack_batch_size < 1)
+    {
+        strm << "ERROR: Invalid ack batch size (" << ack_batch_size << ")." << std::endl;
+        return false;
+    }
+
+    switch(cmdline.get_template_arg("-ck", verify_checksums))
+    {
+        case Util::ParameterStatus::FlagNotProvided:
+        case Util::ParameterStatus::FlagPresentParameterPresent:
+            break;
+        case Util::ParameterStatus::FlagProvidedWithEmptyParameter:
+            strm << "ERROR: \"-ck\" flag is missing its parameter." << std::endl;
+            return false;
+        default:
+            assert (fail_int == -674);   // Bug encountered. Will cause abnormal termination
+    }
+
+    if (verify_checksums != 0 && verify_checksums != 1)
+    {
+        strm << "ERROR: Invalid -ck value (" << verify_checksums << "). Has to be 0 or 1." << std::endl;
+        return false;
+    }
+
+    if (! session_list_filename.empty() && parallel_connections > 1)
+    {
+        strm << "ERROR: the \"-pc\" and \"-fl\" flags cannot be used together." << std::endl;
+        return false;
+    }
+
     /////////////////
     // Check out specified log level
     /////////////////
@@ -29,6 +29,7 @@
 #include <commandline.hpp>
 #include <NtwkUtil.hpp>
 #include <NtwkFixedArray.hpp>
+#include <NtwkCrc32c.hpp>
 #include <LoggerCpp/LoggerCpp.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -60,6 +61,12 @@ uint16_t server_listen_port_number = default_server_listen_port_number; // can b
 const int default_server_listen_max_backlog = 50;       // Maximum number of connection requests queued
 int server_listen_max_backlog = 50;                     // can be modified from the command line
 
+const char *default_receive_mode = "copy";              // how file data is written (see Usage())
+std::string receive_mode(default_receive_mode);         // can be modified from the command line
+
+const char *default_checksum_mode = "crc32c";           // checksums of the file data (see Usage())
+std::string checksum_mode(default_checksum_mode);       // can be modified from the command line
+
 // fixed size of the std::vector<> used for the data
 const int server_buffer_size = NtwkUtilBufferSize;
 
@@ -74,6 +81,16 @@ void Usage(std::ostream& strm, std::string command)
             "                  [ -bl connections ]       (maximum number of connection requests queued before \n" <<
             "                                            requests are dropped - default is 50) \n" <<
             "                  [ -lg log-level ]         (see below, default is \"NOTE\"\n" <<
+            "                  [ -rm receive-mode ]      (\"copy\" or \"splice\", default is \"copy\": see below)\n" <<
+            "                  [ -ck checksum-mode ]     (\"none\", \"crc32c\" or \"sidecar\", default is \"crc32c\": see below)\n" <<
+            "\n" <<
+            "receive-mode \"copy\" reads the file data from the connection into a buffer and writes it out to\n" <<
+            "the output file.  \"splice\" moves the data from the connection to the (preallocated) output file\n" <<
+            "inside the kernel using splice(2), without copying it through the server's memory.\n" <<
+            "\n" <<
+            "checksum-mode \"crc32c\" adds the CRC-32C checksum of the data received to the end of each\n" <<
+            "\"OK|...\" response, so the client can check it.  \"sidecar\" does the same, and also writes the\n" <<
+            "checksum of each whole file to \"<output file>.crc32c\".  \"none\" turns checksums off.\n" <<
             "\n" <<
             "log-level can be one of: {\"DBUG\", \"INFO\", \"NOTE\", \"WARN\", \"EROR\", \"CRIT\"}\n" <<
             "\n"
@@ -109,6 +126,8 @@ bool parse(int argc, const char *argv[], Util::CommandLine& cmdline )
     specified["-pn"] = cmdline.get_template_arg("-pn", server_listen_port_number);
     specified["-bl"] = cmdline.get_template_arg("-bl", server_listen_max_backlog);
     specified["-lg"] = cmdline.get_template_arg("-lg", log_level);
+    specified["-rm"] = cmdline.get_template_arg("-rm", receive_mode);
+    specified["-ck"] = cmdline.get_template_arg("-ck", checksum_mode);
 
     if (UtilLogger::stringToEnumLoglevel(log_level) < 0)
     {
@@ -116,6 +135,20 @@ bool parse(int argc, const char *argv[], Util::CommandLine& cmdline )
         return false;
     }
 
+    if (! EnetUtil::socket_connection_thread::string_to_receive_mode(receive_mode,
+                                                                     EnetUtil::socket_connection_thread::s_receive_mode))
+    {
+        std::cerr << "\nERROR: Invalid receive mode (" << receive_mode << ").  Exiting...\n" << std::endl;
+        return false;
+    }
+
+    if (! EnetUtil::socket_connection_thread::string_to_checksum_mode(checksum_mode,
+                                                                      EnetUtil::socket_connection_thread::s_checksum_mode))
+    {
+        std::cerr << "\nERROR: Invalid checksum mode (" << checksum_mode << ").  Exiting...\n" << std::endl;
+        return false;
+    }
+
     bool ret = true;  // Currently all flags have default values, so it's always good.
     std::for_each(specified.begin(), specified.end(), [&ret](auto member) { if (member.second) { ret = true; }});
     return ret;
@@ -126,7 +159,7 @@ int main(int argc, const char *argv[])
     using namespace Util;
 
     std::string argv0 = argv[0];
-    const StringVector allowedFlags ={ "-ip", "-pn", "-bl", "-lg" };
+    const StringVector allowedFlags ={ "-ip", "-pn", "-bl", "-lg", "-rm", "-ck" };
     CommandLine cmdline(argc, argv, allowedFlags);
 
     if(cmdline.isError())
@@ -186,6 +219,9 @@ int main(int argc, const char *argv[])
 
     loggerp->notice() << "    port number: " << server_listen_port_number;
     loggerp->notice() << "    max backlog connection requests: " << server_listen_max_backlog;
+    loggerp->notice() << "    receive mode: " << receive_mode;
+    loggerp->notice() << "    checksum mode: " << checksum_mode <<
+                         (Crc32c::is_hardware_accelerated()? " (hardware)" : " (software)");
     loggerp->notice() << "======================================================================";
 
     /////////////////
@@ -227,7 +263,7 @@ int main(int argc, const char *argv[])
             continue;
         }
 
-        loggerp->debug() << "In main(): Connection " << i << " accepted: fd = " << accept_socket_fd;
+        LOGGER_DEBUG(*loggerp) << "In main(): Connection " << i << " accepted: fd = " << accept_socket_fd;
 
         // Start a thread to handle the connection. Each one of these threads, once
         // they're started (in sequence), gets all the data from the connection and
@@ -242,6 +278,7 @@ int main(int argc, const char *argv[])
     /////////////////
 
     // Terminate the Log Manager (destroy the Output objects)
+    Util::LogRateLimiter::report_suppressed();
     Log::Manager::terminate();
     socket_connection_thread::terminate_all_threads();
 
@@ -0,0 +1,280 @@
+#include "Utility.hpp"
+#include "MainLogger.hpp"
+#include "NtwkUtil.hpp"
+#include "NtwkCrc32c.hpp"
+#include "Random.hpp"
+#include <LoggerCpp/LoggerCpp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////
+
+// Measures the cost of the CRC-32C checksums used on network transfers (see
+// NtwkCrc32c.hpp and the -ck flags of main_ntwk_basic_sock_server and
+// main_client_for_basic_server):
+//
+//   1) Checksum throughput of the hardware and the software versions, for
+//      a few buffer sizes, and what that costs on a 10 Gb/s link.
+//   2) A TCP transfer over loopback with and without a checksum of each
+//      chunk received, the way the server does it: as fast as it goes, and
+//      paced to 10 Gb/s. The paced one shows what the checksum adds to the
+//      time of a transfer on a 10 Gb/s link, and the cpu time it takes.
+//
+// Usage: main_ntwk_checksum [ megabytes ]     (amount of data, default is 256)
+
+using namespace EnetUtil;
+
+std::string logChannelName = "ntwk_checksum";
+Log::Log::Level logLevel = Log::Log::Level::eNotice;
+
+const double ten_gigabit_bytes_per_second = 10.0e9 / 8.0;
+
+typedef uint32_t (*crc_function)(uint32_t crc, const void *data, size_t len);
+
+// Returns GB/s for checksumming totalbytes in chunks of chunksize bytes.
+double checksum_throughput(crc_function fn, const std::vector<uint8_t>& data, size_t chunksize,
+                           size_t totalbytes, uint32_t& crc)
+{
+    crc = 0;
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0;
+    size_t pos = 0;
+    while (done < totalbytes)
+    {
+        if (pos + chunksize > data.size()) pos = 0;
+        crc = fn(crc, data.data() + pos, chunksize);
+        pos += chunksize;
+        done += chunksize;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return (double) done / elapsed.count() / 1.0e9;
+}
+
+// Sends totalbytes over a TCP loopback connection, at up to pace bytes per second
+// (0: as fast as it goes). The receiver computes the checksum of each chunk if
+// checksum is true, and its cpu time is set in cpu_seconds. Returns GB/s, or a
+// negative value on error.
+double loopback_transfer(Util::LoggerSPtr loggerp, size_t totalbytes, bool checksum, double pace,
+                         uint32_t& crc, double& cpu_seconds)
+{
+    using Util::Utility;
+
+    crc = 0;
+    cpu_seconds = 0.0;
+
+    int listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct ::sockaddr_in addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;          // any free port
+    socklen_t addrlen = sizeof(addr);
+    if (listen_fd < 0 ||
+        ::bind(listen_fd, (struct ::sockaddr *) &addr, sizeof(addr)) < 0 ||
+        ::listen(listen_fd, 1) < 0 ||
+        ::getsockname(listen_fd, (struct ::sockaddr *) &addr, &addrlen) < 0)
+    {
+        int errnocopy = errno;
+        loggerp->error() << "Cannot set up the loopback listener: " << Utility::get_errno_message(errnocopy);
+        if (listen_fd >= 0) ::close(listen_fd);
+        return -1.0;
+    }
+
+    std::thread sender([&]()
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || ::connect(fd, (struct ::sockaddr *) &addr, sizeof(addr)) < 0)
+        {
+            int errnocopy = errno;
+            loggerp->error() << "Cannot connect over loopback: " << Utility::get_errno_message(errnocopy);
+            if (fd >= 0) ::close(fd);
+            return;
+        }
+        std::vector<uint8_t> buffer(NtwkUtilBufferSize, 0x5a);
+        size_t sent = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (sent < totalbytes)
+        {
+            size_t request = (totalbytes - sent > buffer.size()? buffer.size() : totalbytes - sent);
+            ssize_t ret = ::send(fd, buffer.data(), request, MSG_NOSIGNAL);
+            if (ret <= 0) break;
+            sent += ret;
+            if (pace > 0.0)
+            {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                          std::chrono::duration<double>(sent / pace)));
+            }
+        }
+        ::close(fd);
+    });
+
+    int conn_fd = ::accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    ::close(listen_fd);
+    if (conn_fd < 0)
+    {
+        int errnocopy = errno;
+        loggerp->error() << "accept() failed: " << Utility::get_errno_message(errnocopy);
+        sender.join();
+        return -1.0;
+    }
+
+    std::vector<uint8_t> buffer(NtwkUtilBufferSize);
+    size_t received = 0;
+    struct timespec cpu_start, cpu_end;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+    auto start = std::chrono::steady_clock::now();
+    while (received < totalbytes)
+    {
+        ssize_t ret = ::recv(conn_fd, buffer.data(), buffer.size(), 0);
+        if (ret <= 0) break;
+        if (checksum) crc = Crc32c::update(crc, buffer.data(), ret);
+        received += ret;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+    cpu_seconds = (double) (cpu_end.tv_sec - cpu_start.tv_sec) + (double) (cpu_end.tv_nsec - cpu_start.tv_nsec) / 1.0e9;
+
+    ::close(conn_fd);
+    sender.join();
+
+    if (received != totalbytes)
+    {
+        loggerp->error() << "Loopback transfer received " << received << " of " << totalbytes << " bytes";
+        return -1.0;
+    }
+    return (double) received / elapsed.count() / 1.0e9;
+}
+
+int main(int argc, char *argv[])
+{
+    using namespace Util;
+
+    LoggerOptions localopt = UtilLogger::setLocalLoggerOptions(
+                                                    logChannelName,
+                                                    logLevel,
+                                                    MainLogger::enableConsole,
+                                                    MainLogger::disableLogFile
+                                                );
+    Util::UtilLogger::create(localopt);
+    std::shared_ptr<Log::Logger> loggerp = Util::UtilLogger::getLoggerPtr();
+
+    size_t megabytes = 256;
+    if (argc > 1)
+    {
+        megabytes = (size_t) ::strtoul(argv[1], NULL, 10);
+        if (megabytes == 0)
+        {
+            std::cerr << "\nUsage: " << argv[0] << " [ megabytes ]\n" << std::endl;
+            Log::Manager::terminate();
+            return 1;
+        }
+    }
+    size_t totalbytes = megabytes * 1024 * 1024;
+
+    // Random data, larger than the L2 cache so the large buffers are not all cache hits.
+    std::vector<uint8_t> data(16 * 1024 * 1024);
+    Util::xoshiro256ss gen(12345);
+    gen.fill(data.data(), data.size());
+
+    int ret = 0;
+
+    // The standard check value for CRC-32C
+    const char *check = "123456789";
+    if (Crc32c::update(0, check, 9) != 0xe3069283 || Crc32c::update_software(0, check, 9) != 0xe3069283)
+    {
+        loggerp->error() << "CRC-32C check value is wrong";
+        ret = 1;
+    }
+
+    loggerp->notice() << "CRC-32C: " << (Crc32c::is_hardware_accelerated()? "hardware (SSE 4.2)" : "software only") <<
+                         ", " << megabytes << " MB per measurement";
+
+    const size_t chunksizes[] = { 256, NtwkUtilRegularBufferSize, NtwkUtilBufferSize, 1024 * 1024 };
+    for (size_t chunksize : chunksizes)
+    {
+        uint32_t hwcrc = 0;
+        uint32_t swcrc = 0;
+        double hw = checksum_throughput(Crc32c::update, data, chunksize, totalbytes, hwcrc);
+        double sw = checksum_throughput(Crc32c::update_software, data, chunksize, totalbytes, swcrc);
+        if (hwcrc != swcrc)
+        {
+            loggerp->error() << "Hardware and software checksums differ: " << Crc32c::to_hex(hwcrc) << " " << Crc32c::to_hex(swcrc);
+            ret = 1;
+        }
+
+        // CPU time spent on the checksum per second of a saturated 10 Gb/s link
+        loggerp->notice() << "  chunk " << chunksize << " bytes: update() " << hw << " GB/s, software " << sw <<
+                             " GB/s, 10 Gb/s link costs " << (ten_gigabit_bytes_per_second / (hw * 1.0e9)) * 100.0 <<
+                             "% of one core";
+    }
+
+    uint32_t crc = 0;
+    double plain_cpu = 0.0;
+    double checked_cpu = 0.0;
+    double plain = loopback_transfer(loggerp, totalbytes, false, 0.0, crc, plain_cpu);
+    double checked = loopback_transfer(loggerp, totalbytes, true, 0.0, crc, checked_cpu);
+    if (plain < 0.0 || checked < 0.0)
+    {
+        ret = 1;
+    }
+    else
+    {
+        loggerp->notice() << "TCP loopback: " << plain << " GB/s without checksum, " << checked <<
+                             " GB/s with checksum (" << (plain - checked) / plain * 100.0 << "% slower)";
+    }
+
+    // The time a 10 Gb/s transfer takes, and the receiver's cpu time for it
+    plain = loopback_transfer(loggerp, totalbytes, false, ten_gigabit_bytes_per_second, crc, plain_cpu);
+    checked = loopback_transfer(loggerp, totalbytes, true, ten_gigabit_bytes_per_second, crc, checked_cpu);
+    if (plain < 0.0 || checked < 0.0)
+    {
+        ret = 1;
+    }
+    else
+    {
+        double plain_seconds = (double) totalbytes / (plain * 1.0e9);
+        double checked_seconds = (double) totalbytes / (checked * 1.0e9);
+        loggerp->notice() << "TCP loopback at 10 Gb/s: " << plain_seconds << " s without checksum, " << checked_seconds <<
+                             " s with checksum (" << (checked_seconds - plain_seconds) / plain_seconds * 100.0 <<
+                             "% of the transfer time); receiver cpu " << plain_cpu << " s, " << checked_cpu << " s with checksum (" <<
+                             (checked_cpu - plain_cpu) / plain_seconds * 100.0 << "% of one core)";
+    }
+
+    // Terminate the Log Manager (destroy the Output objects)
+    Log::Manager::terminate();
+
+    return ret;
+}
@@ -123,7 +123,7 @@ int main(int argc, char *argv[])
     }
     catch (std::exception& e)
     {
-        loggerp->debug() << e.what();
+        LOGGER_DEBUG(*loggerp) << e.what();
     }
     return 0;
 }
@@ -1,7 +1,9 @@
 #include <ntwk_basic_sock_server/ntwk_connection_thread.hpp>
 #include <Utility.hpp>
+#include <Format.hpp>
 #include <NtwkUtil.hpp>
 #include <NtwkFixedArray.hpp>
+#include <NtwkCrc32c.hpp>
 #include <LoggerCpp/LoggerCpp.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,8 +12,13 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <assert.h>
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -44,6 +51,314 @@ using namespace EnetUtil;
 
 std::mutex socket_connection_thread::s_vector_mutex;
 std::vector<std::thread> socket_connection_thread::s_connection_workers;
+socket_connection_thread::receive_mode socket_connection_thread::s_receive_mode = socket_connection_thread::copy_receive;
+socket_connection_thread::checksum_mode socket_connection_thread::s_checksum_mode = socket_connection_thread::crc32c_checksum;
+
+// The number in a field of a client message, like strtoul() (0 if there is none)
+template <typename T>
+static T field_number(std::string_view field)
+{
+    T value = 0;
+    std::from_chars(field.data(), field.data() + field.size(), value);
+    return value;
+}
+
+// The client's upload id (up to 16 hex digits) names the output files of the upload,
+// so anything else is refused.
+static bool valid_upload_id(std::string_view uploadid)
+{
+    return ! uploadid.empty() && uploadid.size() <= 16 &&
+           uploadid.find_first_not_of("0123456789abcdef") == std::string_view::npos;
+}
+
+// Appends the checksum field to the end of an "OK|..." response
+// (nothing if checksums are turned off).
+static void append_checksum_field(std::string& response, uint32_t crc)
+{
+    if (socket_connection_thread::s_checksum_mode != socket_connection_thread::no_checksum)
+    {
+        Util::format_append(response, UTIL_FMT("|{:08x}"), crc);
+    }
+}
+
+// In the sidecar checksum mode, writes the checksum of a whole output file to
+// "<output file>.crc32c" - same layout as the output of md5sum and friends.
+static void write_checksum_sidecar(Util::LoggerSPtr loggerp, const std::string& output_filename, uint32_t crc)
+{
+    using Util::Utility;
+
+    if (socket_connection_thread::s_checksum_mode != socket_connection_thread::crc32c_sidecar)
+    {
+        return;
+    }
+
+    std::string sidecar_filename = output_filename + ".crc32c";
+    FILE *sidecar_stream = ::fopen(sidecar_filename.c_str(), "w");
+    if (sidecar_stream == NULL)
+    {
+        int errnocopy = errno;
+        loggerp->error() << "Cannot create checksum file \"" << sidecar_filename << "\": " << Utility::get_errno_message(errnocopy);
+        return;
+    }
+
+    std::vector<std::string> path = Utility::split(output_filename, "/");
+    ::fprintf(sidecar_stream, "%s  %s\n", Crc32c::to_hex(crc).c_str(), path.back().c_str());
+    ::fclose(sidecar_stream);
+}
+
+// Checksum of data that was written to the output file with splice() (it never
+// came through a user space buffer). Reads it back from the page cache.
+static uint32_t output_file_checksum(Util::LoggerSPtr loggerp, int output_fd, const std::string& output_filename,
+                                     off_t offset, size_t bytecount)
+{
+    uint32_t crc = 0;
+    if (socket_connection_thread::s_checksum_mode != socket_connection_thread::no_checksum &&
+        ! Crc32c::file_range(output_fd, offset, bytecount, crc))
+    {
+        loggerp->error() << "Cannot compute the checksum of \"" << output_filename << "\"";
+    }
+    return crc;
+}
+
+// Used by thread_connection_handler() when the receive mode is splice_receive.
+// The output file is preallocated to the byte count sent by the client, and the data is
+// moved from the socket into the file by NtwkUtil::splice_to_file(). Returns the number
+// of bytes written to the output file, and their checksum in crc.
+static size_t splice_connection_data(Util::LoggerSPtr loggerp,
+                                     int socketfd,
+                                     int threadno,
+                                     const std::string& output_filename,
+                                     size_t remote_bytecount,
+                                     uint32_t& crc)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    crc = 0;
+
+    // Opened for reading as well - the checksum is computed from the file.
+    int output_fd = ::open(output_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (output_fd < 0)
+    {
+        errnocopy = errno;
+        loggerp->error() << "Cannot create/truncate output file (thread " << threadno << ") \"" <<
+        output_filename << "\": " << Utility::get_errno_message(errnocopy);
+        return 0;
+    }
+
+    // Preallocating is an optimization only. Some file systems do not support it.
+    if (remote_bytecount > 0 && ::fallocate(output_fd, 0, 0, (off_t) remote_bytecount) < 0)
+    {
+        errnocopy = errno;
+        LOGGER_DEBUG(*loggerp) << "thread_connection_handler: fallocate() on \"" << output_filename <<
+                            "\" failed (continuing without it): " << Utility::get_errno_message(errnocopy);
+    }
+
+    ssize_t byteswritten = NtwkUtil::splice_to_file(loggerp, socketfd, output_fd, remote_bytecount);
+    if (byteswritten < 0)
+    {
+        UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "Error writing output file (thread " << threadno << ") \"" << output_filename << "\"";
+        byteswritten = 0;
+    }
+
+    // fallocate() sets the file size up front - make sure a short transfer
+    // does not leave a tail of zeroes at the end of the file.
+    if ((size_t) byteswritten < remote_bytecount && ::ftruncate(output_fd, (off_t) byteswritten) < 0)
+    {
+        errnocopy = errno;
+        loggerp->error() << "Cannot truncate output file (thread " << threadno << ") \"" <<
+        output_filename << "\": " << Utility::get_errno_message(errnocopy);
+    }
+
+    crc = output_file_checksum(loggerp, output_fd, output_filename, 0, (size_t) byteswritten);
+
+    ::close(output_fd);
+    return (size_t) byteswritten;
+}
+
+// Used by thread_connection_handler() for one range of a file uploaded over several
+// parallel connections (see main_client_for_basic_server -pc). All the connections for
+// the same upload write into the same output file, each one at its own offset, so the file
+// is never truncated here - it is only sized to the full file size. The data is written with
+// splice() or pwrite() depending on the receive mode. Returns the number of bytes written,
+// and the checksum of the range in crc.
+static size_t receive_range_data(Util::LoggerSPtr loggerp,
+                                 int socketfd,
+                                 int threadno,
+                                 const std::string& output_filename,
+                                 off_t range_offset,
+                                 size_t range_bytecount,
+                                 size_t file_size,
+                                 uint32_t& crc)
+{
+    using Util::Utility;
+
+    int errnocopy = 0;
+    crc = 0;
+
+    // Opened for reading as well - in splice mode the checksum is computed from the file.
+    int output_fd = ::open(output_filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (output_fd < 0)
+    {
+        errnocopy = errno;
+        loggerp->error() << "Cannot create output file (thread " << threadno << ") \"" <<
+        output_filename << "\": " << Utility::get_errno_message(errnocopy);
+        return 0;
+    }
+
+    // Every connection of the upload does this - the result is the same no matter which one is first.
+    if (::ftruncate(output_fd, (off_t) file_size) < 0)
+    {
+        errnocopy = errno;
+        loggerp->error() << "Cannot set the size of output file (thread " << threadno << ") \"" <<
+        output_filename << "\": " << Utility::get_errno_message(errnocopy);
+        ::close(output_fd);
+        return 0;
+    }
+
+    if (range_bytecount > 0 && ::fallocate(output_fd, 0, range_offset, (off_t) range_bytecount) < 0)
+    {
+        errnocopy = errno;
+        LOGGER_DEBUG(*loggerp) << "thread_connection_handler: fallocate() on \"" << output_filename <<
+                            "\" failed (continuing without it): " << Utility::get_errno_message(errnocopy);
+    }
+
+    size_t totalbyteswritten = 0;
+
+    if (socket_connection_thread::s_receive_mode == socket_connection_thread::splice_receive)
+    {
+        off_t offset = range_offset;
+        ssize_t byteswritten = NtwkUtil::splice_to_file(loggerp, socketfd, output_fd, range_bytecount, &offset);
+        if (byteswritten < 0)
+        {
+            UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "Error writing output file (thread " << threadno << ") \"" << output_filename << "\"";
+            byteswritten = 0;
+        }
+        totalbyteswritten = (size_t) byteswritten;
+        crc = output_file_checksum(loggerp, output_fd, output_filename, range_offset, totalbyteswritten);
+    }
+    else
+    {
+        bool checksum = (socket_connection_thread::s_checksum_mode != socket_connection_thread::no_checksum);
+        std::shared_ptr<fixed_uint8_array_t> sp_data = fixed_uint8_array_t::create();
+
+        while (totalbyteswritten < range_bytecount)
+        {
+            size_t request = range_bytecount - totalbyteswritten;
+            int num_elements_received = NtwkUtil::enet_receive(loggerp, socketfd, sp_data->data(), request);
+            if (num_elements_received <= 0)
+            {
+                break;      // EOF, or the error was logged by enet_receive()
+            }
+
+            ssize_t byteswritten = ::pwrite(output_fd, sp_data->data().data(), num_elements_received,
+                                            range_offset + (off_t) totalbyteswritten);
+            if (byteswritten != num_elements_received)
+            {
+                errnocopy = errno;
+                UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "Error writing output file (thread " << threadno << ") \"" <<
+                output_filename << "\": " << Utility::get_errno_message(errnocopy);
+                break;
+            }
+            if (checksum) crc = Crc32c::update(crc, sp_data->data().data(), byteswritten);
+            totalbyteswritten += byteswritten;
+        }
+    }
+
+    ::close(output_fd);
+    return totalbyteswritten;
+}
+
+// Handles a session connection (see main_client_for_basic_server -fl).  The initial
+// message was "SESSION|ack-batch-size|uploadid".  After that the client sends any number
+// of transfers back to back without waiting for responses - each one is a framed
+// "filename|bytecount" message followed by exactly bytecount bytes of file data - and ends
+// the session with a framed "END" message.  The responses ("OK|threadno|file|bytes", one
+// per line, with the checksum at the end if checksums are on) are sent in batches of ack_batch_size, and the last batch ends with an
+// "END|number-of-transfers" line.
+static void session_connection_handler(int socketfd,
+                                       int threadno,
+                                       Util::LoggerSPtr loggerp,
+                                       size_t ack_batch_size,
+                                       const std::string& uploadid)
+{
+    using Util::Utility;
+
+    std::string acks;
+    size_t num_acks = 0;
+    long num_transfers = 0;
+    bool finished = false;
+
+    while (!finished)
+    {
+        std::string message;
+        if (! NtwkUtil::get_framed_message(loggerp, socketfd, message))
+        {
+            loggerp->error() << message;
+            break;
+        }
+
+        if (message == "END")
+        {
+            finished = true;
+            continue;
+        }
+
+        std::array<std::string_view, 2> fields;
+        size_t num_fields = Utility::split_to(message, '|', fields);
+        if (num_fields != 2)
+        {
+            loggerp->error() << "session_connection_handler: ERROR: Transfer message expects two fields.  Received " <<
+                              num_fields << ". Terminating session...";
+            break;
+        }
+
+        num_transfers++;
+        size_t remote_bytecount = field_number<size_t>(fields[1]);
+        std::string output_filename = std::string("tests/output_") + uploadid + "_" +
+                                      socket_connection_thread::get_seq_num_string(num_transfers) + "." +
+                                      std::string(fields[0]);
+
+        uint32_t crc = 0;
+        size_t totalbyteswritten = receive_range_data(loggerp, socketfd, threadno, output_filename,
+                                                      0, remote_bytecount, remote_bytecount, crc);
+        bool transfer_ok = (totalbyteswritten == remote_bytecount);
+        if (transfer_ok) write_checksum_sidecar(loggerp, output_filename, crc);
+
+        if (! acks.empty()) acks += "\n";
+        Util::format_append(acks, UTIL_FMT("{}|{}|{}|{}"), transfer_ok? "OK" : "ERROR", threadno, output_filename,
+                            totalbyteswritten);
+        append_checksum_field(acks, crc);
+        num_acks++;
+
+        if (! transfer_ok)
+        {
+            // The rest of the data on the connection can not be trusted to line up anymore.
+            loggerp->error() << "session_connection_handler: Transfer of \"" << output_filename <<
+                                "\" failed. Terminating session...";
+            break;
+        }
+
+        if (num_acks >= ack_batch_size || acks.size() > NtwkUtilMaxFramedMessageSize / 2)
+        {
+            if (! NtwkUtil::send_framed_message(loggerp, socketfd, acks))
+            {
+                acks.clear();
+                break;
+            }
+            acks.clear();
+            num_acks = 0;
+        }
+    }
+
+    if (! acks.empty()) acks += "\n";
+    Util::format_append(acks, UTIL_FMT("END|{}"), num_transfers);
+
+    // No need to check return - the function writes to the
+    // log file, and we are done anyways.
+    NtwkUtil::send_framed_message(loggerp, socketfd, acks);
+    ::close(socketfd);
+}
 
 // This function is in a new thread which is started for every accepted connection
 // from start() below.
@@ -66,9 +381,9 @@ void thread_connection_handler(int socketfd, int threadno, Util::LoggerSPtr logg
 
     // get initial client message in a string
     std::string message;
-    if (NtwkUtil::get_ntwk_message(loggerp, socketfd, message))
+    if (NtwkUtil::get_framed_message(loggerp, socketfd, message))
     {
-        loggerp->debug() << "thread_connection_handler: Initial client message: " << message;
+        LOGGER_DEBUG(*loggerp) << "thread_connection_handler: Initial client message: " << message;
     }
     else
     {
@@ -77,31 +392,58 @@ void thread_connection_handler(int socketfd, int threadno, Util::LoggerSPtr logg
         return;
     }
 
-    std::vector<std::string> remote_message_vector = Utility::split(message, "|");
+    std::array<std::string_view, 5> fields;
+    size_t num_fields = Utility::split_to(message, '|', fields);
 
-    // for (std::string const& str: remote_message_vector)
+    // for (std::string_view str: Utility::split_view(message, '|'))
     // {
     //     loggerp->debug() << str;
     // }
 
-    if (remote_message_vector.size() != 2)
+    // The initial message is either "filename|bytecount" for a whole file,
+    // "filename|bytecount|offset|filesize|uploadid" for one range of a file
+    // uploaded over several parallel connections, or "SESSION|ack-batch-size|uploadid"
+    // for a connection carrying many files.
+    if (num_fields == 3 && fields[0] == "SESSION")
+    {
+        size_t ack_batch_size = field_number<size_t>(fields[1]);
+        if (! valid_upload_id(fields[2]))
+        {
+            loggerp->error() << "thread_connection_handler: ERROR: Invalid upload id \"" << fields[2] << "\". Terminating connection...";
+            if (socketfd >= 0) ::close(socketfd);
+            return;
+        }
+        session_connection_handler(socketfd, threadno, loggerp, (ack_batch_size > 0? ack_batch_size : 1), std::string(fields[2]));
+        return;
+    }
+
+    if (num_fields != 2 && num_fields != 5)
     {
-        loggerp->error() << "thread_connection_handler: ERROR: Initial client message expects two fields.  Received " <<
-                          remote_message_vector.size() << ". Terminating connection...";
+        loggerp->error() << "thread_connection_handler: ERROR: Initial client message expects two or five fields (or a SESSION message).  Received " <<
+                          num_fields << ". Terminating connection...";
         if (socketfd >= 0) ::close(socketfd);
         return;
     }
 
-    std::string remote_filename = remote_message_vector[0];
-    std::string remote_bytecount_string = remote_message_vector[1];
-    size_t remote_bytecount = strtoul(remote_bytecount_string.c_str(), NULL, 10);
+    bool ranged = (num_fields == 5);
+    if (ranged && ! valid_upload_id(fields[4]))
+    {
+        loggerp->error() << "thread_connection_handler: ERROR: Invalid upload id \"" << fields[4] << "\". Terminating connection...";
+        if (socketfd >= 0) ::close(socketfd);
+        return;
+    }
+    std::string remote_filename(fields[0]);
+    size_t remote_bytecount = field_number<size_t>(fields[1]);
 
+    // All the connections of a ranged upload share the output file, which is named
+    // after the client's upload id instead of the thread number.
     std::string output_filename = std::string("tests/output_") +
-                                  socket_connection_thread::get_seq_num_string(threadno) +
+                                  (ranged? std::string(fields[4]) :
+                                           socket_connection_thread::get_seq_num_string(threadno)) +
                                   "." +
                                   remote_filename;
 
-    loggerp->debug() << "thread_connection_handler: byte count from remote = " <<
+    LOGGER_DEBUG(*loggerp) << "thread_connection_handler: byte count from remote = " <<
                        std::to_string(remote_bytecount) << ", local server output to \"" <<
                        output_filename << "\"";
 
@@ -110,6 +452,25 @@ void thread_connection_handler(int socketfd, int threadno, Util::LoggerSPtr logg
     size_t totalbyteswritten = 0;
     int errnocopy = 0;
     bool finished = false;
+    uint32_t crc = 0;
+    bool checksum = (socket_connection_thread::s_checksum_mode != socket_connection_thread::no_checksum);
+
+    if (ranged)
+    {
+        // The whole transfer is done here - the copy loop below is skipped.
+        off_t range_offset = (off_t) field_number<unsigned long long>(fields[2]);
+        size_t file_size = field_number<size_t>(fields[3]);
+        totalbyteswritten = receive_range_data(loggerp, socketfd, threadno, output_filename,
+                                               range_offset, remote_bytecount, file_size, crc);
+        finished = true;
+    }
+    else if (socket_connection_thread::s_receive_mode == socket_connection_thread::splice_receive)
+    {
+        // The whole transfer is done here - the copy loop below is skipped.
+        totalbyteswritten = splice_connection_data(loggerp, socketfd, threadno, output_filename, remote_bytecount, crc);
+        finished = true;
+    }
+
     while (!finished)
     {
         std::shared_ptr<fixed_uint8_array_t> sp_data = fixed_uint8_array_t::create();
@@ -160,12 +521,13 @@ void thread_connection_handler(int socketfd, int threadno, Util::LoggerSPtr logg
             errnocopy = errno;
             size_t byteswritten = (elementswritten * sizeof(uint8_t));
             totalbyteswritten += byteswritten;
+            if (checksum) crc = Crc32c::update(crc, sp_data->data().data(), byteswritten);
             fflush(output_stream);
 
             if (elementswritten != sp_data->num_valid_elements())
             {
                 errnocopy = errno;
-                loggerp->error() << "Error writing output file (thread " << threadno << ") \"" <<
+                UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "Error writing output file (thread " << threadno << ") \"" <<
                 output_filename << "\": " << Utility::get_errno_message(errnocopy);
                 finished = true;
                 continue;
@@ -186,13 +548,19 @@ void thread_connection_handler(int socketfd, int threadno, Util::LoggerSPtr logg
         fflush(output_stream);
     }
 
+    // Ranges are only part of the output file - no sidecar for those.
+    if (! ranged)
+    {
+        write_checksum_sidecar(loggerp, output_filename, crc);
+    }
+
     // Respond to the file transfer
-    std::string response =
-        std::string("OK|") + std::to_string(threadno) + std::string("|") + output_filename + std::string("|") + std::to_string(totalbyteswritten);
+    std::string response = Util::format(UTIL_FMT("OK|{}|{}|{}"), threadno, output_filename, totalbyteswritten);
+    append_checksum_field(response, crc);
 
     // No need to check return - the function writes to the
     // log file, and we are done anyways.
-    NtwkUtil::send_ntwk_message(loggerp, socketfd, response);
+    NtwkUtil::send_framed_message(loggerp, socketfd, response);
 
     // CLEANUP.
 
@@ -239,6 +607,41 @@ void socket_connection_thread::start(int accpt_socket, int threadno,  Util::Logg
     //                       threadno << " for socket fd " << accpt_socket;
 }
 
+bool socket_connection_thread::string_to_receive_mode(const std::string& modestr, receive_mode& mode)
+{
+    if (modestr == "copy")
+    {
+        mode = copy_receive;
+        return true;
+    }
+    else if (modestr == "splice")
+    {
+        mode = splice_receive;
+        return true;
+    }
+    return false;
+}
+
+bool socket_connection_thread::string_to_checksum_mode(const std::string& modestr, checksum_mode& mode)
+{
+    if (modestr == "none")
+    {
+        mode = no_checksum;
+        return true;
+    }
+    else if (modestr == "crc32c")
+    {
+        mode = crc32c_checksum;
+        return true;
+    }
+    else if (modestr == "sidecar")
+    {
+        mode = crc32c_sidecar;
+        return true;
+    }
+    return false;
+}
+
 std::string socket_connection_thread::get_seq_num_string(long num)
 {
     std::ostringstream lstr;
@@ -58,7 +58,8 @@ void VideoCapture::stream2qt_video_capture::run()
 
     while (!m_terminated)
     {
-        m_condvar.wait_for_ready();
+        // One post for each frame put in the ring buffer
+        m_event.wait_for_ready();
         static int count = 0;
 
         // Allow the ring buffer to fill up until the main window
@@ -87,18 +88,20 @@ void VideoCapture::stream2qt_video_capture::run()
             return;
         }
 
-        while (!m_terminated && !m_ringbuf.empty())
+        // This shared_ptr serves all consumers of this particular video data buffer
+        auto sp_frame = m_ringbuf.get();
+        if (!sp_frame)
         {
-            // This shared_ptr serves all consumers of this particular video data buffer
-            auto sp_frame = m_ringbuf.get();
-            nqUtil::mwp->getPlayer()->receiveFrameBuffer(sp_frame);
-
-            //////////////////////////////////////////////////////////////////////
-            // Used in the code for DEBUG purposes only to simulate a heavy load.
-            // Do not un-comment it lightly.
-            // std::this_thread::sleep_for(std::chrono::milliseconds(40));
-            //////////////////////////////////////////////////////////////////////
+            // Posted by set_terminated(), or the frame was dropped by a full ring buffer
+            continue;
         }
+        nqUtil::mwp->getPlayer()->receiveFrameBuffer(sp_frame);
+
+        //////////////////////////////////////////////////////////////////////
+        // Used in the code for DEBUG purposes only to simulate a heavy load.
+        // Do not un-comment it lightly.
+        // std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        //////////////////////////////////////////////////////////////////////
     }
     finish();
 }
@@ -135,9 +138,9 @@ void VideoCapture::stream2qt_video_capture::set_terminated(bool t)
     m_terminated = t;
     video_capture_queue::set_terminated(t);
 
-    // Free up a potential wait on the condition variable
+    // Free up a potential wait on the event
     // so that the thread can be terminated (otherwise it may hang).
-    m_condvar.flush(0, Util::condition_data<int>::NotifyEnum::All);
+    m_event.post();
     if (t)
     {
         splogger->debug() << "stream2qt_video_capture: terminating...";
@@ -150,5 +153,5 @@ void VideoCapture::stream2qt_video_capture::set_terminated(bool t)
 
 void VideoCapture::stream2qt_video_capture::add_buffer_to_queue(Util::shared_ptr_uint8_data_t sp)
 {
-    m_ringbuf.put(sp, m_condvar);
+    m_ringbuf.put(sp, m_event);
 }
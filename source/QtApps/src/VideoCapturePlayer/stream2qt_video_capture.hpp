@@ -25,7 +25,6 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <Utility.hpp>
-#include <condition_data.hpp>
 #include <shared_data_items.hpp>
 #include <stream2qt_video_capture.hpp>
 #include <vidcap_profiler_thread.hpp>
@@ -227,6 +227,17 @@ int control_main(int argc, const char *argv[])
     // Finally, get to work
     /////////////////
 
+    // Before any capture thread is started: they inherit the NUMA binding.
+    std::string frame_buffers_info;
+    if (video_capture_queue::setup_frame_buffers(frame_buffers_info))
+    {
+        uloggerp->info() << "Frame buffers: " << frame_buffers_info;
+    }
+    else
+    {
+        uloggerp->warning() << "Frame buffers: " << frame_buffers_info;
+    }
+
     std::thread queuethread;
     std::thread profilingthread;
     std::thread videocapturethread;
@@ -242,6 +253,7 @@ int control_main(int argc, const char *argv[])
         {
             VideoCapture::vidcap_profiler::set_terminated(false);
             profilingthread = std::thread(VideoCapture::video_profiler);
+            vcGlobals::place_thread(profilingthread, "profiler", "vc_profiler");
             uloggerp->debug() << argv0 << ":  started video profiler thread";
             profilingthread.detach();
             uloggerp->debug() << argv0 << ":  the video capture thread will kick-start the video_profiler operations.";
@@ -253,6 +265,7 @@ int control_main(int argc, const char *argv[])
 
         // Start the thread which handles the queue of raw buffers that obtained from the video hardware.
         queuethread = std::thread(VideoCapture::raw_buffer_queue_handler);
+        vcGlobals::place_thread(queuethread, "queue", "vc_queue");
 
         /////////////////////////////////////////////////////////////////////////
         // Set up the queue thread consumer objects needed in this run.
@@ -264,6 +277,7 @@ int control_main(int argc, const char *argv[])
         // start the thread
         ff = new stream2qt_video_capture(100);
         std::thread fileworkerthread(&stream2qt_video_capture::run, std::ref(*ff));
+        vcGlobals::place_thread(fileworkerthread, "workers", "vc_qt_worker");
         fileworkerthread.detach();
         video_capture_queue::register_worker_thread( &fileworkerthread );
 
@@ -277,6 +291,7 @@ int control_main(int argc, const char *argv[])
         uloggerp->debug() << argv0 << ":  starting the video capture thread.";
 
         videocapturethread = std::thread(VideoCapture::video_capture, command_line_string);
+        vcGlobals::place_thread(videocapturethread, "capture", "vc_capture");
         videocapturethread.detach();
         uloggerp->debug() << argv0 << ":  kick-starting the video capture operations.";
 
@@ -365,6 +380,7 @@ int control_main(int argc, const char *argv[])
     s_condvar.send_ready(0, Util::condition_data<int>::NotifyEnum::All);
 
     // Terminate the Log Manager (destroy the Output objects)
+    Util::LogRateLimiter::report_suppressed();
     uloggerp->info() << "Terminating the logger.";
 
     // Give the rest of this thread a chance to truly be finished.
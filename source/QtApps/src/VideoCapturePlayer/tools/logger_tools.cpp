@@ -25,6 +25,7 @@
 
 #include <logger_tools.hpp>
 #include <video_capture_globals.hpp>
+#include <LoggerCpp/BinaryLog.h>
 
 void Video::setup_video_capture_logger(const std::string& cmdline, std::vector<std::string>& delayedLinesForLogger)
 {
@@ -40,14 +41,27 @@ void Video::setup_video_capture_logger(const std::string& cmdline, std::vector<s
                                                 vcGlobals::logChannelName,
                                                 vcGlobals::loglevel,
                                                 Util::MainLogger::disableConsole,
-                                                Util::MainLogger::enableLogFile
+                                                Util::MainLogger::enableLogFile,
+                                                vcGlobals::log_async? Util::MainLogger::enableAsync : Util::MainLogger::disableAsync
                                         );
 
+    // Per-frame and per-chunk log lines (UTIL_LOG_RATE_LIMITED/UTIL_LOG_SAMPLED)
+    Util::MainLogger::rate_limit_per_sec = vcGlobals::log_rate_limit;
+    Util::MainLogger::sample_one_in = vcGlobals::log_sample_one_in;
+
     //////////////////////////////////////////////////////////////
     // Initialize the UtilLogger object
     //////////////////////////////////////////////////////////////
     Util::UtilLogger::create(localopt);
 
+    //////////////////////////////////////////////////////////////
+    // Per-frame logs (LOGGER_BINARY) are formatted by a background
+    // thread, or written as they are to the binary log file.
+    //////////////////////////////////////////////////////////////
+    bool binary_log_started = vcGlobals::log_binary_file.empty()?
+                                    Log::BinaryLog::start(Log::BinaryLog::eText) :
+                                    Log::BinaryLog::start(Log::BinaryLog::eFile, vcGlobals::log_binary_file.c_str());
+
     //////////////////////////////////////////////////////////////
     // Reference to THE logger object
     //////////////////////////////////////////////////////////////
@@ -60,6 +74,12 @@ void Video::setup_video_capture_logger(const std::string& cmdline, std::vector<s
     uloggerp->info() << "START OF NEW VIDEO CAPTURE RUN";
     uloggerp->info() << "Command line: " << cmdline << "\n";
 
+    if (!binary_log_started)
+    {
+        uloggerp->error() << "Could not create the binary log file " << Util::Utility::string_enquote(vcGlobals::log_binary_file)
+                          << ": per-frame logs are written directly to the log file.";
+    }
+
     if (vcGlobals::log_initialization_info)     // -loginit flag
     {
         Util::LoggerOptions logopt;
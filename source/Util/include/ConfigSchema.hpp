@@ -0,0 +1,286 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <json/json.h>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Config
+{
+
+// Problems found by ConfigSchema<T>::load().
+struct SchemaReport
+{
+    std::vector<std::string> errors;            // Wrong types, values out of range, missing required values
+    std::vector<std::string> unknown_keys;      // Keys that no field is bound to (misspelled?)
+
+    bool ok() const { return errors.empty(); }
+};
+
+std::ostream& operator<<(std::ostream& strm, const SchemaReport& report);
+
+// The non-template parts of ConfigSchema<T>
+namespace schema_detail
+{
+    // ".Config.Video.frame-count" -> { "Config", "Video", "frame-count" }
+    std::vector<std::string> split_path(const std::string& path);
+
+    // The value at keys below root, or nullptr if a key is missing.
+    const Json::Value* find(const Json::Value& root, const std::vector<std::string>& keys);
+
+    // Compact json for error messages
+    std::string describe(const Json::Value& value);
+
+    // Each returns false if the json value does not have the type.
+    bool convert(const Json::Value& value, bool& out);
+    bool convert(const Json::Value& value, int& out);
+    bool convert(const Json::Value& value, unsigned& out);
+    bool convert(const Json::Value& value, int64_t& out);
+    bool convert(const Json::Value& value, uint64_t& out);
+    bool convert(const Json::Value& value, double& out);
+    bool convert(const Json::Value& value, std::string& out);
+
+    const char* type_name(const bool*);
+    const char* type_name(const int*);
+    const char* type_name(const unsigned*);
+    const char* type_name(const int64_t*);
+    const char* type_name(const uint64_t*);
+    const char* type_name(const double*);
+    const char* type_name(const std::string*);
+
+    // The keys below an object that the schema's fields are bound to.
+    class KeySet
+    {
+    public:
+        void add(const std::vector<std::string>& keys);
+
+        // Adds the path of each member of the json object which is not a key
+        // of the set (or on the way to one) to unknown.
+        void find_unknown(const Json::Value& value, const std::string& prefix, std::vector<std::string>& unknown) const;
+
+    private:
+        std::set<std::string> m_fields;     // ".a.b" for a field bound to .a.b
+        std::set<std::string> m_branches;   // ".a" for the same field
+    };
+}
+
+// Binds json paths (in Json::Path form: ".Config.Video.frame-count") to the
+// fields of a plain struct T. load() then walks the json tree once, checks
+// the type and range of each value, and fills in a T which the app reads
+// directly, instead of looking values up in the Json::Value when needed.
+// Keys that are in the json but not in the schema are reported, so that a
+// misspelled key is not silently replaced by its default.
+//
+//      struct logger_config { std::string level; unsigned rate_limit = 10; };
+//
+//      ConfigSchema<logger_config> schema;
+//      schema.required(".Logger.level", &logger_config::level)
+//            .optional(".Logger.rate-limit", &logger_config::rate_limit, 0U, 1000U);
+//
+//      logger_config cfg;
+//      SchemaReport report = schema.load(root, cfg);
+//      if (! report.ok()) ...
+//
+// Build the schema once: it can be used for any number of loads.
+template <typename T>
+class ConfigSchema
+{
+public:
+    // A value that has to be in the json file.
+    template <typename V>
+    ConfigSchema& required(const std::string& path, V T::* member)
+    {
+        return bind<V>(path, true, member, [](const V&) { return std::string(); });
+    }
+
+    // A value that has to be in the json file, within [min, max].
+    template <typename V>
+    ConfigSchema& required(const std::string& path, V T::* member, V min, V max)
+    {
+        return bind<V>(path, true, member, range_check<V>(min, max));
+    }
+
+    // A value that may be left out: the field keeps the value it had before load().
+    template <typename V>
+    ConfigSchema& optional(const std::string& path, V T::* member)
+    {
+        return bind<V>(path, false, member, [](const V&) { return std::string(); });
+    }
+
+    template <typename V>
+    ConfigSchema& optional(const std::string& path, V T::* member, V min, V max)
+    {
+        return bind<V>(path, false, member, range_check<V>(min, max));
+    }
+
+    // A string from a fixed set, stored as the matching V (i.e. an enum).
+    template <typename V>
+    ConfigSchema& choice(const std::string& path, V T::* member, std::vector<std::pair<std::string, V>> choices, bool is_required = true)
+    {
+        std::vector<std::string> keys = schema_detail::split_path(path);
+        m_keys.add(keys);
+        m_fields.push_back(Field{ path, keys,
+            [=](const Json::Value* value, T& out, SchemaReport& report, const std::string& prefix)
+            {
+                if (value == nullptr)
+                {
+                    if (is_required) report.errors.push_back(prefix + path + ": missing");
+                    return;
+                }
+                std::string name;
+                if (schema_detail::convert(*value, name))
+                {
+                    for (const auto& choice : choices)
+                    {
+                        if (choice.first == name)
+                        {
+                            out.*member = choice.second;
+                            return;
+                        }
+                    }
+                }
+                std::string error = prefix + path + ": " + schema_detail::describe(*value) + " is not one of";
+                for (const auto& choice : choices)
+                {
+                    error += " \"" + choice.first + "\"";
+                }
+                report.errors.push_back(error);
+            } });
+        return *this;
+    }
+
+    // An object whose members all have the layout of schema: each member is
+    // loaded into a U, stored under the member's name.
+    template <typename U>
+    ConfigSchema& each(const std::string& path, std::map<std::string, U> T::* member, ConfigSchema<U> schema, bool is_required = true)
+    {
+        std::vector<std::string> keys = schema_detail::split_path(path);
+        m_keys.add(keys);
+        m_fields.push_back(Field{ path, keys,
+            [=](const Json::Value* value, T& out, SchemaReport& report, const std::string& prefix)
+            {
+                if (value == nullptr)
+                {
+                    if (is_required) report.errors.push_back(prefix + path + ": missing");
+                    return;
+                }
+                if (! value->isObject())
+                {
+                    report.errors.push_back(prefix + path + ": expected an object, found " + schema_detail::describe(*value));
+                    return;
+                }
+                for (auto itr = value->begin(); itr != value->end(); ++itr)
+                {
+                    std::string name = itr.name();
+                    U item = U();
+                    schema.load(*itr, item, report, prefix + path + "." + name);
+                    (out.*member)[name] = std::move(item);
+                }
+            } });
+        return *this;
+    }
+
+    SchemaReport load(const Json::Value& root, T& out) const
+    {
+        SchemaReport report;
+        load(root, out, report, std::string());
+        return report;
+    }
+
+    // Adds to report, with the paths prefixed (for nested schemas).
+    void load(const Json::Value& root, T& out, SchemaReport& report, const std::string& prefix) const
+    {
+        for (const Field& field : m_fields)
+        {
+            field.read(schema_detail::find(root, field.keys), out, report, prefix);
+        }
+        m_keys.find_unknown(root, prefix, report.unknown_keys);
+    }
+
+private:
+    struct Field
+    {
+        std::string path;
+        std::vector<std::string> keys;
+        std::function<void(const Json::Value*, T&, SchemaReport&, const std::string&)> read;
+    };
+
+    // Returns an error message for values out of [min, max] (empty if none).
+    template <typename V>
+    static std::function<std::string(const V&)> range_check(V min, V max)
+    {
+        return [min, max](const V& value)
+        {
+            if (value < min || max < value)
+            {
+                return std::to_string(value) + " is out of range [" + std::to_string(min) + ", " + std::to_string(max) + "]";
+            }
+            return std::string();
+        };
+    }
+
+    template <typename V>
+    ConfigSchema& bind(const std::string& path, bool is_required, V T::* member, std::function<std::string(const V&)> check)
+    {
+        std::vector<std::string> keys = schema_detail::split_path(path);
+        m_keys.add(keys);
+        m_fields.push_back(Field{ path, keys,
+            [=](const Json::Value* value, T& out, SchemaReport& report, const std::string& prefix)
+            {
+                if (value == nullptr)
+                {
+                    if (is_required) report.errors.push_back(prefix + path + ": missing");
+                    return;
+                }
+                V converted = V();
+                if (! schema_detail::convert(*value, converted))
+                {
+                    report.errors.push_back(prefix + path + ": expected " + schema_detail::type_name(&converted) +
+                                            ", found " + schema_detail::describe(*value));
+                    return;
+                }
+                std::string error = check(converted);
+                if (! error.empty())
+                {
+                    report.errors.push_back(prefix + path + ": " + error);
+                    return;
+                }
+                out.*member = std::move(converted);
+            } });
+        return *this;
+    }
+
+    std::vector<Field> m_fields;
+    schema_detail::KeySet m_keys;
+};
+
+} // end of namespace Config
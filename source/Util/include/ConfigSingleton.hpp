@@ -25,9 +25,14 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <json/json.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Config
 {
@@ -35,6 +40,11 @@ namespace Config
     using ConfigSingletonShrdPtr = std::shared_ptr<ConfigSingleton>;
     using IfsreamShrdPtr = std::shared_ptr<std::ifstream>;
 
+    // An immutable, complete configuration. A reload publishes a new one rather
+    // than changing the current one, so a snapshot can be used for as long as it
+    // is held (and is released, with its arena, by its last holder).
+    using JsonSnapshot = std::shared_ptr<const Json::Value>;
+
     class ConfigSingleton : public std::enable_shared_from_this<ConfigSingleton>
     {
     private:
@@ -68,6 +78,47 @@ namespace Config
         // the new values can take effect.
         bool UpdateJsonConfigFile(std::ostream& logstream, std::string UseTempFileName = std::string("tmp_") + s_jsonfilename);
 
+    public:
+        ////////////////////////////////////////////////////////////////////////
+        // Live configuration changes
+        //
+        // JsonRoot() and GetJsonRootCopyRef() are set up once, by create().
+        // Values that may change while the app runs are read from Snapshot()
+        // instead, or are pushed to the app by Subscribe() callbacks.
+        ////////////////////////////////////////////////////////////////////////
+
+        // Called with the new value found at the subscribed path, and the
+        // snapshot that it belongs to. Runs on the thread doing the reload.
+        using ChangeCallback = std::function<void(const Json::Value& newValue, const JsonSnapshot& snapshot)>;
+
+        // Checks a newly parsed root before it is published. Returns false, and
+        // explains why on logstream, to reject it (the current snapshot stays).
+        using Validator = std::function<bool(const Json::Value& root, std::ostream& logstream)>;
+
+        // Called by the watcher thread after each reload attempt, with its log.
+        using ReloadCallback = std::function<void(bool published, const std::string& messages)>;
+
+        // The current snapshot (nullptr before create()). Lock-free: a thread
+        // only takes the publishing path's atomics when the snapshot it saw
+        // last has been replaced since.
+        static JsonSnapshot Snapshot();
+
+        // Parse, validate and publish the json file now, then call the
+        // subscribers whose values changed. Returns true if it was published.
+        static bool Reload(std::ostream& logstream);
+
+        // Reload() on a background thread each time the json file is written
+        // or replaced (inotify on its directory, so editors which save by
+        // renaming and UpdateJsonConfigFile() are both seen).
+        static bool StartWatching(std::ostream& logstream, ReloadCallback onReload = nullptr);
+        static void StopWatching();
+
+        // path is a Json::Path, i.e. ".Config.Logger.log-level". Returns an
+        // id for Unsubscribe().
+        static int Subscribe(const std::string& path, ChangeCallback callback);
+        static void Unsubscribe(int id);
+        static void SetValidator(Validator validator);
+
     private:
         // static members
         static Json::Value s_configRoot;
@@ -85,6 +136,32 @@ namespace Config
         // to allow for their new values to take effect.
         static Json::Value s_editRoot;
 
+        // s_configRoot is built in this arena by initialize(): parsing, copying
+        // and destroying the configuration take a few large blocks instead of an
+        // allocation per member and string. It must be released after the root
+        // (see the order of the definitions). s_editRoot is on the heap, as it
+        // is edited for as long as the app runs.
+        static std::unique_ptr<Json::ValueArena> s_arena;
+
+        // Live configuration: the published snapshot is replaced with
+        // std::atomic_store(), and s_generation is bumped after each one so that
+        // Snapshot() can keep a per-thread copy until the next one.
+        struct Subscription
+        {
+            int id;
+            std::string path;
+            ChangeCallback callback;
+        };
+        static JsonSnapshot s_snapshot;
+        static std::atomic<std::uint64_t> s_generation;
+        static std::mutex s_reload_mutex;          // one Reload() at a time
+        static std::mutex s_subscription_mutex;    // s_subscriptions, s_validator, s_next_subscription_id
+        static std::vector<Subscription> s_subscriptions;
+        static Validator s_validator;
+        static int s_next_subscription_id;
+
+        static void publish(JsonSnapshot snapshot, std::ostream& logstream);
+
     private:
         // This caller is requesting for this object to be done.
         // TODO: This member might go away if there are no child threads.
@@ -0,0 +1,60 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <json/json.h>
+#include <iostream>
+
+namespace Config
+{
+
+// Expands the templates of a json config, in place.
+//
+// The root's "Templates" object holds named objects. Any object in the rest of
+// the file that has an "extends" member is replaced by a deep copy of the named
+// template, with the object's own members merged on top of it (objects are
+// merged key by key, everything else replaces the template's value). A
+// template can extend another one.
+//
+// In the strings of an expanded object, ${var} is replaced by:
+//      ${key}      the object's key in its parent (or its position, in an array)
+//      ${index}    the object's position in its parent (in key order for objects)
+//      ${member}   any number, string or bool member of the expanded object,
+//                  i.e. ${device-name} (these replace ${key} and ${index})
+// Members may use ${key} and ${index} themselves: "device-name": "/dev/video${index}".
+// Other ${...} are left as they are, so shell variables in commands go through.
+//
+//      "Templates": {
+//          "camera": { "device-name": "/dev/video${index}",
+//                      "output-process": "ffmpeg -i pipe:0 ${key}.mp4" }
+//      },
+//      ... "cam0": { "extends": "camera" }, "cam1": { "extends": "camera" } ...
+//
+// The "Templates" object is removed once expanded. Returns false, after
+// writing each problem to logstream, on unknown templates, cycles and
+// non-object templates.
+bool expandTemplates(Json::Value& root, std::ostream& logstream);
+
+} // end of namespace Config
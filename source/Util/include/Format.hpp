@@ -0,0 +1,535 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// "{}" formatting, with the format string parsed and checked at compile time:
+//
+//      char buf[64];
+//      size_t len = Util::format_to(buf, sizeof(buf), UTIL_FMT("frame {} of {}: {:.2f} ms"), n, total, ms);
+//      std::string ack = Util::format(UTIL_FMT("OK|{}|{}|{:08x}"), threadno, filename, crc);
+//      logger.info() << Util::format_buffer<128>(UTIL_FMT("{} fps"), fps);
+//
+// A placeholder is "{}" or "{:spec}", with spec = [0][width][.precision][type]:
+//      0           pad numbers with zeros instead of spaces (to width)
+//      width       minimum width: numbers are aligned right, everything else left
+//      .precision  digits after the point (floating point only)
+//      type        d, x, X (integers), f, e, g (floating point), s (strings, bool), c (char), p (pointers)
+// "{{" and "}}" are literal braces.
+//
+// The number of arguments, and the types that the specs are used with, are
+// checked by static_assert. Nothing is parsed at run time: each literal piece
+// and argument is written out in turn, straight into the destination buffer.
+#define UTIL_FMT(str)                                                           \
+    [] {                                                                        \
+        struct format_string : Util::format_detail::format_string_base          \
+        {                                                                       \
+            constexpr operator std::string_view() const { return str; }         \
+        };                                                                      \
+        return format_string{};                                                 \
+    }()
+
+namespace Util
+{
+
+namespace format_detail
+{
+    // The type made by UTIL_FMT() derives from this.
+    struct format_string_base {};
+
+    struct spec
+    {
+        bool zero_pad = false;
+        unsigned width = 0;
+        int precision = -1;
+        char type = '\0';
+    };
+
+    // A literal part of the format, followed by an argument (unless it is the
+    // last piece, or it ends with a brace of a "{{" or "}}").
+    struct piece
+    {
+        std::size_t literal_begin = 0;
+        std::size_t literal_size = 0;
+        bool has_arg = false;
+        std::size_t arg = 0;
+        spec arg_spec;
+    };
+
+    // Parses one piece from pos: returns the position after it. Invalid
+    // format strings throw, which stops the compilation (constexpr).
+    constexpr std::size_t parse_piece(std::string_view str, std::size_t pos, piece& out)
+    {
+        out.literal_begin = pos;
+        for (std::size_t i = pos; i < str.size(); i++)
+        {
+            if (str[i] == '}')
+            {
+                if (i + 1 >= str.size() || str[i + 1] != '}')
+                {
+                    throw "UTIL_FMT: single '}' in format string (\"}}\" is a literal '}')";
+                }
+                out.literal_size = i + 1 - pos;     // Keeps one '}', skips the other
+                return i + 2;
+            }
+            if (str[i] != '{')
+            {
+                continue;
+            }
+            if (i + 1 < str.size() && str[i + 1] == '{')
+            {
+                out.literal_size = i + 1 - pos;
+                return i + 2;
+            }
+
+            out.literal_size = i - pos;
+            out.has_arg = true;
+            std::size_t p = i + 1;
+            if (p < str.size() && str[p] == ':')
+            {
+                p++;
+                if (p < str.size() && str[p] == '0')
+                {
+                    out.arg_spec.zero_pad = true;
+                    p++;
+                }
+                while (p < str.size() && str[p] >= '0' && str[p] <= '9')
+                {
+                    out.arg_spec.width = out.arg_spec.width * 10 + (str[p++] - '0');
+                }
+                if (p < str.size() && str[p] == '.')
+                {
+                    p++;
+                    out.arg_spec.precision = 0;
+                    if (p >= str.size() || str[p] < '0' || str[p] > '9')
+                    {
+                        throw "UTIL_FMT: '.' has to be followed by a precision";
+                    }
+                    while (p < str.size() && str[p] >= '0' && str[p] <= '9')
+                    {
+                        out.arg_spec.precision = out.arg_spec.precision * 10 + (str[p++] - '0');
+                    }
+                    if (out.arg_spec.precision > 100)
+                    {
+                        throw "UTIL_FMT: the precision is at most 100";
+                    }
+                }
+                if (p < str.size() && str[p] != '}')
+                {
+                    out.arg_spec.type = str[p++];
+                }
+            }
+            if (p >= str.size() || str[p] != '}')
+            {
+                throw "UTIL_FMT: invalid placeholder in format string (\"{}\" or \"{:[0][width][.precision][type]}\")";
+            }
+            return p + 1;
+        }
+        out.literal_size = str.size() - pos;
+        return str.size();
+    }
+
+    constexpr std::size_t count_pieces(std::string_view str)
+    {
+        std::size_t count = 0;
+        std::size_t pos = 0;
+        do
+        {
+            piece p;
+            pos = parse_piece(str, pos, p);
+            count++;
+        } while (pos < str.size());
+        return count;
+    }
+
+    template <std::size_t N>
+    constexpr std::array<piece, N> parse(std::string_view str)
+    {
+        std::array<piece, N> pieces{};
+        std::size_t pos = 0;
+        std::size_t arg = 0;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            pos = parse_piece(str, pos, pieces[i]);
+            if (pieces[i].has_arg)
+            {
+                pieces[i].arg = arg++;
+            }
+        }
+        return pieces;
+    }
+
+    template <std::size_t N>
+    constexpr std::size_t count_args(const std::array<piece, N>& pieces)
+    {
+        std::size_t count = 0;
+        for (const piece& p : pieces)
+        {
+            count += p.has_arg? 1 : 0;
+        }
+        return count;
+    }
+
+    // The spec of each argument
+    template <std::size_t NumArgs, std::size_t N>
+    constexpr std::array<spec, NumArgs> arg_specs(const std::array<piece, N>& pieces)
+    {
+        std::array<spec, NumArgs> specs{};
+        for (const piece& p : pieces)
+        {
+            if (p.has_arg)
+            {
+                specs[p.arg] = p.arg_spec;
+            }
+        }
+        return specs;
+    }
+
+    // Everything about a format string, computed once per UTIL_FMT() string
+    template <typename S>
+    struct compiled
+    {
+        static constexpr std::string_view str = S{};
+        static constexpr std::size_t num_pieces = count_pieces(str);
+        static constexpr std::array<piece, num_pieces> pieces = parse<num_pieces>(str);
+        static constexpr std::size_t num_args = count_args(pieces);
+        static constexpr std::array<spec, num_args> specs = arg_specs<num_args>(pieces);
+    };
+
+    template <typename T>
+    constexpr bool is_string_v = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                                 std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+    // Whether an argument of type T can be formatted with spec s
+    template <typename T>
+    constexpr bool accepts(const spec& s)
+    {
+        using U = std::decay_t<T>;
+        const char t = s.type;
+        if constexpr (std::is_same_v<U, bool>)
+            return (t == '\0' || t == 's') && s.precision < 0;
+        else if constexpr (std::is_same_v<U, char>)
+            return (t == '\0' || t == 'c' || t == 'd' || t == 'x' || t == 'X') && s.precision < 0;
+        else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>)
+            return (t == '\0' || t == 'd' || t == 'x' || t == 'X') && s.precision < 0;
+        else if constexpr (std::is_floating_point_v<U>)
+            return t == '\0' || t == 'f' || t == 'e' || t == 'g';
+        else if constexpr (is_string_v<U>)
+            return (t == '\0' || t == 's') && s.precision < 0 && ! s.zero_pad;
+        else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>)
+            return (t == '\0' || t == 'p') && s.precision < 0;
+        else
+            return false;   // Not a type that can be formatted
+    }
+
+    template <typename S, typename... Args, std::size_t... I>
+    constexpr bool all_args_accepted(std::index_sequence<I...>)
+    {
+        return (accepts<Args>(compiled<S>::specs[I]) && ...);
+    }
+
+    // "00" to "99"
+    extern const char digit_pairs[201];
+    extern const char hex_digits_lower[17];
+    extern const char hex_digits_upper[17];
+
+    // Writes the digits of value so that they end at end, returns where they start.
+    inline char* write_decimal(char* end, std::uint64_t value)
+    {
+        while (value >= 100)
+        {
+            const char* pair = digit_pairs + (value % 100) * 2;
+            value /= 100;
+            *--end = pair[1];
+            *--end = pair[0];
+        }
+        if (value >= 10)
+        {
+            const char* pair = digit_pairs + value * 2;
+            *--end = pair[1];
+            *--end = pair[0];
+        }
+        else
+        {
+            *--end = static_cast<char>('0' + value);
+        }
+        return end;
+    }
+
+    inline char* write_hex(char* end, std::uint64_t value, bool upper)
+    {
+        const char* digits = upper? hex_digits_upper : hex_digits_lower;
+        do
+        {
+            *--end = digits[value & 0xf];
+            value >>= 4;
+        } while (value != 0);
+        return end;
+    }
+
+    // Output to a fixed buffer. Keeps counting past its end, so that the
+    // caller can find the size that the whole text needs (as snprintf() does).
+    class writer
+    {
+    public:
+        writer(char* buf, std::size_t size) : m_pos(buf), m_end(buf + size) {}
+
+        std::size_t needed() const { return m_needed; }
+
+        void put(const char* str, std::size_t size)
+        {
+            std::size_t room = static_cast<std::size_t>(m_end - m_pos);
+            std::size_t n = size < room? size : room;
+            std::memcpy(m_pos, str, n);
+            m_pos += n;
+            m_needed += size;
+        }
+
+        void fill(char c, std::size_t count)
+        {
+            std::size_t room = static_cast<std::size_t>(m_end - m_pos);
+            std::size_t n = count < room? count : room;
+            std::memset(m_pos, c, n);
+            m_pos += n;
+            m_needed += count;
+        }
+
+        // Numbers: sign, then padding, then digits
+        void put_number(bool negative, const char* digits, std::size_t size, const spec& s)
+        {
+            std::size_t total = size + (negative? 1 : 0);
+            std::size_t pad = s.width > total? s.width - total : 0;
+            if (! s.zero_pad) fill(' ', pad);
+            if (negative) put("-", 1);
+            if (s.zero_pad) fill('0', pad);
+            put(digits, size);
+        }
+
+        // Everything else: aligned left
+        void put_text(const char* str, std::size_t size, const spec& s)
+        {
+            put(str, size);
+            if (s.width > size) fill(' ', s.width - size);
+        }
+
+    private:
+        char* m_pos;
+        char* m_end;
+        std::size_t m_needed = 0;
+    };
+
+    template <typename T>
+    void write_integer(writer& out, T value, const spec& s)
+    {
+        using U = std::make_unsigned_t<T>;
+        char buf[24];
+        char* end = buf + sizeof(buf);
+        bool negative = false;
+        U magnitude = static_cast<U>(value);
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value < 0 && s.type != 'x' && s.type != 'X')
+            {
+                negative = true;
+                magnitude = static_cast<U>(U(0) - magnitude);
+            }
+        }
+        char* start = (s.type == 'x' || s.type == 'X')? write_hex(end, magnitude, s.type == 'X') : write_decimal(end, magnitude);
+        out.put_number(negative, start, static_cast<std::size_t>(end - start), s);
+    }
+
+    // is_float: the shortest text is the one of the float, not of the double.
+    void write_floating(writer& out, double value, bool is_float, const spec& s);
+
+    inline void write_arg(writer& out, bool value, const spec& s)
+    {
+        if (value) out.put_text("true", 4, s);
+        else       out.put_text("false", 5, s);
+    }
+
+    inline void write_arg(writer& out, char value, const spec& s)
+    {
+        if (s.type == 'd' || s.type == 'x' || s.type == 'X') write_integer(out, static_cast<int>(value), s);
+        else out.put_text(&value, 1, s);
+    }
+
+    inline void write_arg(writer& out, const char* value, const spec& s)
+    {
+        if (value == nullptr) value = "(null)";
+        out.put_text(value, std::strlen(value), s);
+    }
+
+    inline void write_arg(writer& out, std::string_view value, const spec& s)
+    {
+        out.put_text(value.data(), value.size(), s);
+    }
+
+    inline void write_arg(writer& out, const std::string& value, const spec& s)
+    {
+        out.put_text(value.data(), value.size(), s);
+    }
+
+    template <typename T>
+    void write_arg(writer& out, const T& value, const spec& s)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            write_integer(out, static_cast<std::underlying_type_t<T>>(value), s);
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            write_integer(out, value, s);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            write_floating(out, static_cast<double>(value), std::is_same_v<T, float>, s);
+        }
+        else if constexpr (std::is_same_v<T, char*>)
+        {
+            write_arg(out, static_cast<const char*>(value), s);
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<T> || std::is_null_pointer_v<T>, "UTIL_FMT: type cannot be formatted");
+            char buf[20];
+            char* end = buf + sizeof(buf);
+            char* start = write_hex(end, reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)), false);
+            *--start = 'x';
+            *--start = '0';
+            out.put_text(start, static_cast<std::size_t>(end - start), s);
+        }
+    }
+
+    template <typename S, std::size_t I, typename Tuple>
+    void write_piece(writer& out, const Tuple& args)
+    {
+        constexpr piece p = compiled<S>::pieces[I];
+        if constexpr (p.literal_size > 0)
+        {
+            out.put(compiled<S>::str.data() + p.literal_begin, p.literal_size);
+        }
+        if constexpr (p.has_arg)
+        {
+            write_arg(out, std::get<p.arg>(args), p.arg_spec);
+        }
+    }
+
+    template <typename S, typename Tuple, std::size_t... I>
+    void write_pieces(writer& out, const Tuple& args, std::index_sequence<I...>)
+    {
+        (write_piece<S, I>(out, args), ...);
+    }
+
+    template <typename S, typename... Args>
+    std::size_t format_to(char* buf, std::size_t size, const Args&... args)
+    {
+        using format = compiled<S>;
+        static_assert(std::is_base_of_v<format_string_base, S>, "UTIL_FMT: the format string has to be a UTIL_FMT(\"...\")");
+        static_assert(format::num_args == sizeof...(Args), "UTIL_FMT: the number of {} and of arguments differ");
+        static_assert(all_args_accepted<S, Args...>(std::make_index_sequence<sizeof...(Args)>()),
+                      "UTIL_FMT: an argument cannot be formatted with its {:spec} (or at all)");
+
+        writer out(buf, size);
+        write_pieces<S>(out, std::forward_as_tuple(args...), std::make_index_sequence<format::num_pieces>());
+        return out.needed();
+    }
+
+} // end of namespace format_detail
+
+// Formats into buf, writing at most size chars (and no terminating '\0').
+// Returns the size of the whole text: if it is more than size, the text was cut.
+template <typename S, typename... Args>
+std::size_t format_to(char* buf, std::size_t size, S, const Args&... args)
+{
+    return format_detail::format_to<S>(buf, size, args...);
+}
+
+// Appends to str (i.e. a network message being put together).
+template <typename S, typename... Args>
+void format_append(std::string& str, S, const Args&... args)
+{
+    char buf[256];
+    std::size_t size = format_detail::format_to<S>(buf, sizeof(buf), args...);
+    if (size <= sizeof(buf))
+    {
+        str.append(buf, size);
+        return;
+    }
+    std::size_t start = str.size();
+    str.resize(start + size);
+    format_detail::format_to<S>(&str[start], size, args...);
+}
+
+template <typename S, typename... Args>
+std::string format(S fmt, const Args&... args)
+{
+    std::string str;
+    format_append(str, fmt, args...);
+    return str;
+}
+
+// Formats into a buffer of its own (on the stack), cut to N - 1 chars.
+// It can be written to any std::ostream, which includes the logger's.
+template <std::size_t N>
+class format_buffer
+{
+public:
+    template <typename S, typename... Args>
+    format_buffer(S fmt, const Args&... args)
+    {
+        std::size_t size = Util::format_to(m_buf, N - 1, fmt, args...);
+        m_size = size < N - 1? size : N - 1;
+        m_buf[m_size] = '\0';
+    }
+
+    const char* c_str() const           { return m_buf; }
+    const char* data() const            { return m_buf; }
+    std::size_t size() const            { return m_size; }
+    std::string_view view() const       { return std::string_view(m_buf, m_size); }
+    operator std::string_view() const   { return view(); }
+
+private:
+    char m_buf[N];
+    std::size_t m_size;
+};
+
+template <std::size_t N>
+std::ostream& operator<<(std::ostream& strm, const format_buffer<N>& buf)
+{
+    return strm.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+} // end of namespace Util
@@ -29,6 +29,9 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <ostream>
+#include <cstdint>
 
 namespace Util
 {
@@ -44,7 +47,19 @@ namespace Util
         enum UseLogFile          // flag for initializeLogManager() method
         {
             disableLogFile = 0,
-            enableLogFile
+            enableLogFile,
+            // Log lines are copied to a memory mapped file (Log::OutputMmapFile, unix only):
+            // no system call per line, and the rotation is done by a background thread.
+            enableMmapLogFile
+        };
+
+        // Asynchronous logging: threads only queue their log lines, and a writer thread
+        // writes them to the console/file (see Log::Manager::startAsync()). When the queue
+        // is full, log lines are dropped (and counted) rather than blocking the thread.
+        enum AsyncLogging
+        {
+            disableAsync = 0,
+            enableAsync
         };
     public:
         static void initialize( Log::Config::Vector& configList,
@@ -64,6 +79,10 @@ namespace Util
         static void configureLogManager( Log::Config::Vector& configList, std::string channelName );
 
         static std::mutex s_logger_mutex;
+        static size_t async_queue_size;     // number of log lines the async queue can hold
+        static size_t mmap_segment_size;    // size of each segment of a memory mapped log file
+        static std::atomic<unsigned> rate_limit_per_sec;    // UTIL_LOG_RATE_LIMITED() lines per second and call site (0: no limit)
+        static std::atomic<unsigned> sample_one_in;         // UTIL_LOG_SAMPLED() outputs 1 line in this many (0 or 1: all of them)
 
         static std::string logChannelName;
         static std::string logFilelName;
@@ -97,6 +116,7 @@ namespace Util
         std::string logFilelName;
         MainLogger::ConsoleOutput useConsole;
         MainLogger::UseLogFile useLogFile;
+        MainLogger::AsyncLogging useAsync;
     };
 
     // class UtilLogger -- geared for being operated using shared_ptr<>'s.
@@ -104,6 +124,13 @@ namespace Util
     // using the ::create(...) method.  The object's constructors must not (cannot)
     // be used directly.  Past the point of the initial ::create() call, subsequent
     // shared_ptr<>'s are obtained by calling the static ::getLoggerPtr() method.
+    // The same Log::Logger can be used by any number of threads at once: the
+    // Log::Manager takes no lock to output a log line, and each Output writes
+    // a whole line at a time.
+    // Prefer LOGGER_DEBUG(*UtilLogger::getLoggerPtr()) << ... (and LOGGER_INFO() and so on)
+    // to getLoggerPtr()->debug() << ...: the macros skip the evaluation of the streamed
+    // values when the log level filters the line out, and the lines below the compile
+    // time minimum level (LOGGER_MIN_LEVEL, see LoggerCpp/Logger.h) are removed entirely.
 
     class UtilLogger
     {
@@ -134,7 +161,8 @@ namespace Util
                         std::string                     logChannelNameString,
                         Log::Log::Level                 logLevelEnum,
                         Util::MainLogger::ConsoleOutput consoleOutputEnum,
-                        Util::MainLogger::UseLogFile    useLogFileEnum
+                        Util::MainLogger::UseLogFile    useLogFileEnum,
+                        Util::MainLogger::AsyncLogging  asyncLoggingEnum = Util::MainLogger::disableAsync
                     );
 
         static Util::LoggerOptions& setLoggerOptions(Util::LoggerOptions& logopt);
@@ -155,5 +183,95 @@ namespace Util
         static Util::LoggerOptions m_runtimeLogOpt;
     };
 
+    //////////////////////////////////////////////////////////////////////
+    // Rate limited and sampled logging
+    //
+    // For log lines that can be produced once per frame or once per chunk of data,
+    // where the logger itself would become the bottleneck.
+    //
+    // Each call site of UTIL_LOG_RATE_LIMITED() outputs at most
+    // MainLogger::rate_limit_per_sec lines per second (a token bucket holding one
+    // second's worth of lines). The lines it drops are counted, and the next line it
+    // outputs starts with "[N similar log lines suppressed] ". The counts still pending
+    // are output on their own about once a second (by the next rate limited call of any
+    // site), and by LogRateLimiter::report_suppressed(), which apps call before
+    // Log::Manager::terminate(): a burst at the end of a run is reported too.
+    //
+    // Each call site of UTIL_LOG_SAMPLED() outputs the first line, then one line out
+    // of MainLogger::sample_one_in. No log line uses it yet: "sample-one-in" is
+    // reserved for it in the json config.
+    //
+    // Both values can be set from the "Logger" section of the app json config. The
+    // level is tested first, as with LOGGER_DEBUG() (see LoggerCpp/Logger.h):
+    //
+    //     UTIL_LOG_RATE_LIMITED(*loggerp, Log::Log::eError) << "Error writing " << filename;
+    //     UTIL_LOG_SAMPLED(*loggerp, Log::Log::eDebug) << "Wrote " << count << " bytes";
+    //////////////////////////////////////////////////////////////////////
+
+    class LogRateLimiter
+    {
+    public:
+        LogRateLimiter(const char* file, int line) : m_file(file), m_line(line) {}
+        ~LogRateLimiter();
+
+        // true if the line is to be output: 'suppressed' is then set to the
+        // number of lines dropped since the previous one output.
+        bool allow(unsigned long& suppressed, const Log::Logger& logger, Log::Log::Level level);
+
+        // Outputs the count of the lines dropped since the last line output, for each
+        // call site that has some.
+        static void report_suppressed();
+
+    private:
+        void register_site(const Log::Logger& logger, Log::Log::Level level);
+
+        std::atomic<int64_t> m_next_ns{0};          // theoretical arrival time of the next line (steady_clock)
+        std::atomic<unsigned long> m_suppressed{0};
+        std::atomic<bool> m_registered{false};      // set on the first line dropped
+        const char* m_file;
+        int m_line;
+        std::unique_ptr<Log::Logger> m_logger;      // used by report_suppressed(): set with m_registered
+        Log::Log::Level m_level = Log::Log::eDebug;
+    };
+
+    class LogSampler
+    {
+    public:
+        bool allow();
+
+    private:
+        std::atomic<unsigned long> m_count{0};
+    };
+
+    // Streamed at the start of a rate limited line (nothing when no line was suppressed)
+    struct LogSuppressed
+    {
+        unsigned long count;
+    };
+    std::ostream& operator<<(std::ostream& strm, const LogSuppressed& suppressed);
+
+    // Log of the given level (Log::Logger only has one method per level)
+    Log::Log logAtLevel(const Log::Logger& logger, Log::Log::Level level);
+
 } // end of namespace Util
 
+// Same single pass "for" form as LOGGER_STREAM(), with a static object per call site
+// (each lambda expression has its own type). The limiter only counts the lines that
+// pass the level test.
+#define UTIL_LOG_RATE_LIMITED(aLogger, aSeverity)                                                               \
+    for (unsigned long util_log_suppressed_ = 0,                                                                \
+             util_log_once_ = (static_cast<int>(aSeverity) >= LOGGER_MIN_LEVEL) &&                              \
+                              ((aSeverity) >= (aLogger).getLevel()) &&                                          \
+                              []() -> Util::LogRateLimiter& {                                                   \
+                                  static Util::LogRateLimiter s(__FILE__, __LINE__); return s; }()              \
+                                  .allow(util_log_suppressed_, (aLogger), (aSeverity));                         \
+         util_log_once_; util_log_once_ = 0)                                                                    \
+        Util::logAtLevel((aLogger), (aSeverity)) << Util::LogSuppressed{util_log_suppressed_}
+
+#define UTIL_LOG_SAMPLED(aLogger, aSeverity)                                                                    \
+    for (bool util_log_once_ = (static_cast<int>(aSeverity) >= LOGGER_MIN_LEVEL) &&                             \
+                               ((aSeverity) >= (aLogger).getLevel()) &&                                         \
+                               []() -> Util::LogSampler& { static Util::LogSampler s; return s; }().allow();    \
+         util_log_once_; util_log_once_ = false)                                                                \
+        Util::logAtLevel((aLogger), (aSeverity))
+
@@ -0,0 +1,132 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace Util
+{
+
+// xoshiro256** (Blackman and Vigna): a small, fast generator of 64 bit
+// random numbers. Not for cryptography. It is a UniformRandomBitGenerator,
+// so it can also be used with the std:: distributions.
+//
+// Utility::thread_rng() has one for each thread (see Utility.hpp).
+class xoshiro256ss
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit xoshiro256ss(std::uint64_t seed_value = 0) { seed(seed_value); }
+
+    // The same seed always gives the same sequence.
+    void seed(std::uint64_t seed_value)
+    {
+        // splitmix64 spreads the seed over the state (which cannot be all zeros)
+        for (std::uint64_t& word : m_state)
+        {
+            seed_value += 0x9e3779b97f4a7c15ULL;
+            word = mix(seed_value);
+        }
+    }
+
+    // The splitmix64 output function: turns seeds that differ by little (or by
+    // the per-word step of seed()) into unrelated ones.
+    static std::uint64_t mix(std::uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound) - without the bias of "% bound" (Lemire's
+    // multiply and reject: a division only in the rare rejection case).
+    // Returns 0 if bound is 0.
+    std::uint64_t below(std::uint64_t bound)
+    {
+        __uint128_t m = static_cast<__uint128_t>((*this)()) * bound;
+        std::uint64_t low = static_cast<std::uint64_t>(m);
+        if (low < bound)
+        {
+            const std::uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold)
+            {
+                m = static_cast<__uint128_t>((*this)()) * bound;
+                low = static_cast<std::uint64_t>(m);
+            }
+        }
+        return static_cast<std::uint64_t>(m >> 64);
+    }
+
+    // Uniform in [0, 1)
+    double uniform()
+    {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    // Random bytes (i.e. test payloads), 8 at a time.
+    void fill(void* buf, std::size_t size)
+    {
+        unsigned char* out = static_cast<unsigned char*>(buf);
+        while (size >= sizeof(std::uint64_t))
+        {
+            const std::uint64_t value = (*this)();
+            std::memcpy(out, &value, sizeof(value));
+            out += sizeof(value);
+            size -= sizeof(value);
+        }
+        if (size > 0)
+        {
+            const std::uint64_t value = (*this)();
+            std::memcpy(out, &value, size);
+        }
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::uint64_t m_state[4];
+};
+
+} // end of namespace Util
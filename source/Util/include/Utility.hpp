@@ -25,13 +25,101 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <LoggerCpp/LoggerCpp.h>
+#include <Random.hpp>
 
 namespace Util {
 
+    // The fields of a string, as views into it, found one at a time while
+    // iterating (nothing is copied or allocated). See Utility::split_view().
+    // The string (and a delimiter of more than one char) has to outlive it.
+    class split_range
+    {
+    public:
+        split_range(std::string_view str, std::string_view delim) : m_str(str), m_delim(delim), m_char(delim.empty()? '\0' : delim[0]) {}
+        split_range(std::string_view str, char delim) : m_str(str), m_delim(&m_char, 1), m_char(delim) {}
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = const std::string_view&;
+
+            iterator() = default;
+
+            reference operator*() const { return m_field; }
+            pointer operator->() const { return &m_field; }
+            iterator& operator++() { next(); return *this; }
+            iterator operator++(int) { iterator prev = *this; next(); return prev; }
+
+            bool operator==(const iterator& rhs) const { return m_done == rhs.m_done && (m_done || m_field.data() == rhs.m_field.data()); }
+            bool operator!=(const iterator& rhs) const { return ! (*this == rhs); }
+
+        private:
+            friend class split_range;
+
+            iterator(const split_range& range)
+                : m_end(range.m_str.data() + range.m_str.size()), m_delim(range.m_delim), m_char(range.m_char), m_done(false)
+            {
+                const char* start = range.m_str.data();
+                m_field = std::string_view(start, find(start) - start);
+            }
+
+            // The next delimiter at or after from, or m_end
+            const char* find(const char* from) const
+            {
+                if (from == m_end || m_delim.empty())
+                {
+                    return m_end;
+                }
+                if (m_delim.size() == 1)
+                {
+                    // memchr() is vectorized by the C library
+                    const void* found = std::memchr(from, m_char, m_end - from);
+                    return found == nullptr? m_end : static_cast<const char*>(found);
+                }
+                std::string_view::size_type pos = std::string_view(from, m_end - from).find(m_delim);
+                return pos == std::string_view::npos? m_end : from + pos;
+            }
+
+            void next()
+            {
+                const char* field_end = m_field.data() + m_field.size();
+                if (field_end == m_end)
+                {
+                    m_done = true;
+                    return;
+                }
+                const char* start = field_end + m_delim.size();
+                m_field = std::string_view(start, find(start) - start);
+            }
+
+            std::string_view m_field;
+            const char* m_end = nullptr;
+            std::string_view m_delim;       // Only its size is used for a single char: that one is m_char
+            char m_char = '\0';
+            bool m_done = true;
+        };
+
+        iterator begin() const { return iterator(*this); }
+        iterator end() const { return iterator(); }
+
+    private:
+        std::string_view m_str;
+        std::string_view m_delim;
+        char m_char;
+    };
+
     // This is where odds and ends go
     class Utility {
     private:
@@ -50,16 +138,53 @@ namespace Util {
         // Get a random int from within a range starting at "low", and
         // "low" + "range".  If no "low" number is specified, 0 is used.
         // For example, get_rand(10,3) gets you a random number between
-        // 3 and 12 (inclusive).
+        // 3 and 12 (inclusive).  Returns low if range is not positive.
         static int get_rand(int range, int low = 0);
-        static bool string_starts_with(std::string mainStr, std::string toMatch);
-        static std::string trim(std::string str, std::string whitespace = " \t");
-        static std::string stringFormat(const std::string& format, ...);
-        static std::vector<std::string> split(const std::string& str, const std::string& delim);
-        static std::vector<std::string> split_and_trim(const std::string& str, const std::string& delim);
+
+        // The random numbers come from a generator of the calling thread: no locks,
+        // and no bias in the ranges. Each thread's generator starts from a different
+        // seed, unless seed_rand() is called (in each thread) for reproducible runs.
+        static xoshiro256ss& thread_rng();
+        static void seed_rand(uint64_t seed)                { thread_rng().seed(seed); }
+        static uint64_t rand_below(uint64_t bound)          { return thread_rng().below(bound); }
+        static void fill_random(void* buf, size_t size)     { thread_rng().fill(buf, size); }
+        static bool string_starts_with(std::string_view mainStr, std::string_view toMatch);
+        static std::string trim(std::string_view str, std::string_view whitespace = " \t");
+        // printf() style. See Format.hpp for a type-safe "{}" one which does not allocate.
+        static std::string stringFormat(const char *format, ...) __attribute__((format(printf, 1, 2)));
+        static std::vector<std::string> split(std::string_view str, std::string_view delim);
+        static std::vector<std::string> split_and_trim(std::string_view str, std::string_view delim);
+
+        // No copies: the results are views into str (or str itself, modified in place)
+        static std::string_view trim_view(std::string_view str, std::string_view whitespace = " \t");
+        static void trim_in_place(std::string& str, std::string_view whitespace = " \t");
+
+        // Lazy split: for (std::string_view field : Utility::split_view(message, '|')) ...
+        // Gives the same fields as split(), but does not allocate.
+        static split_range split_view(std::string_view str, char delim)                { return split_range(str, delim); }
+        static split_range split_view(std::string_view str, std::string_view delim)    { return split_range(str, delim); }
+
+        // Puts the first N fields of str into fields, and returns the number of
+        // fields in str (which is more than N when they do not all fit).
+        template <std::size_t N>
+        static std::size_t split_to(std::string_view str, char delim, std::array<std::string_view, N>& fields)
+        {
+            std::size_t count = 0;
+            for (std::string_view field : split_range(str, delim))
+            {
+                if (count < N)
+                {
+                    fields[count] = field;
+                }
+                count++;
+            }
+            return count;
+        }
 
         // Replace all occurences in ------------ haystack of -------- needle with -------- replacement
-        static std::string replace_all(const std::string &, const std::string &, const std::string &);
+        static std::string replace_all(std::string_view, std::string_view, std::string_view);
+        // find and replace may be views of str (they are copied first, then)
+        static void replace_all_in_place(std::string& str, std::string_view find, std::string_view replace);
 
         // Converts all chars in str parameter to uppercase (modifies string parameter)
         static void to_upper(std::string &str);
@@ -0,0 +1,139 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <shared_data_items.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+
+// How the memory of large buffers (i.e. video frames) is backed.
+enum class huge_pages
+{
+    off,                // normal (4 KB) pages
+    transparent,        // 2 MB aligned, madvise(MADV_HUGEPAGE): huge pages when the kernel has them
+    explicit_pages      // MAP_HUGETLB (reserved in /proc/sys/vm/nr_hugepages); falls back to transparent
+};
+
+struct buffer_policy
+{
+    huge_pages pages = huge_pages::off;
+    int numa_node = -1;         // prefer this node for the memory (-1: no preference)
+};
+
+// Memory straight from mmap(), following policy. Returns nullptr if there is
+// none. If backing is not null, it is set to how the memory is really backed
+// (after a fallback from explicit huge pages, i.e.).
+void* allocate_pages(size_t bytes, const buffer_policy& policy, std::string* backing = nullptr);
+
+// bytes and policy have to be the ones allocate_pages() was called with.
+void free_pages(void* pages, size_t bytes, const buffer_policy& policy);
+
+// The size allocate_pages() really maps for bytes (a multiple of the page size).
+size_t pages_size(size_t bytes, const buffer_policy& policy);
+
+// The NUMA node of the controller (PCIe) of a device file, i.e. /dev/video0.
+// -1 if it is unknown, or the system has one node.
+int numa_device_node(const std::string& device);
+
+// Runs the calling thread on the cpus of node only, and allocates its memory
+// there if possible. Threads it starts afterwards inherit both. Returns false,
+// with the reason in error, if it cannot.
+bool numa_bind_current_thread(int node, std::string& error);
+
+////////////////////////////////////////////////////////////////////////////
+// Class buffer_pool - frame buffers allocated with a buffer_policy, reused
+// instead of being freed: a new huge page mapping for every frame would cost
+// more (system calls and page faults) than the TLB misses it saves.
+//
+//      std::shared_ptr<buffer_pool> pool = buffer_pool::create(policy);
+//      shared_ptr_uint8_data_t frame = pool->copy(driver_buffer, size);
+//
+// A buffer goes back to the pool when the last shared_ptr<> to it (or to a
+// slice() of it) goes away, on any thread. The pool itself is only destroyed
+// once all of its buffers are back.
+//
+// With huge pages, buffers of up to half a huge page (compressed frames, i.e.)
+// are slots of shared huge pages (slabs) instead of a 2 MB mapping each. Slots
+// are sized in powers of two; slabs stay mapped until the pool is destroyed.
+////////////////////////////////////////////////////////////////////////////
+
+class buffer_pool : public std::enable_shared_from_this<buffer_pool>
+{
+public:
+    // Up to max_free buffers are kept for reuse: more are unmapped.
+    [[nodiscard]] static std::shared_ptr<buffer_pool> create(const buffer_policy& policy, size_t max_free = 8);
+
+    // Keeps count more buffers for reuse, i.e. for the frames another ring
+    // buffer can hold.
+    void add_max_free(size_t count);
+
+    ~buffer_pool();
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    // nbytes of uninitialized memory. nullptr if there is no memory.
+    shared_ptr_uint8_data_t get(size_t nbytes);
+
+    // nbytes copied from data. nullptr if there is no memory.
+    shared_ptr_uint8_data_t copy(const void* data, size_t nbytes);
+
+    const buffer_policy& policy() const { return m_policy; }
+
+    // How the memory of the last buffer mapped is backed
+    std::string backing() const;
+
+private:
+    buffer_pool(const buffer_policy& policy, size_t max_free);
+
+    struct block
+    {
+        uint8_t* data;
+        size_t capacity;
+    };
+
+    void put_back(block blk);
+    shared_ptr_uint8_data_t get_slot(size_t nbytes);
+    void put_back_slot(uint8_t* slot, size_t slot_size);
+
+    const buffer_policy m_policy;
+    const size_t m_slab_size;
+    size_t m_max_free;
+    mutable std::mutex m_mutex;
+    std::vector<block> m_free;
+    std::vector<block> m_slabs;
+    std::map<size_t, std::vector<uint8_t*>> m_free_slots;   // by slot size
+    std::string m_backing;
+};
+
+} // end of namespace Util
@@ -20,6 +20,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <condition_data.hpp>
+#include <counting_event.hpp>
 #include <cstdio>
 #include <iostream>
 #include <memory>
@@ -58,6 +59,15 @@ public:
         condvar.send_ready (size(), condition_data<int>::All);
     }
 
+    // Call put() with a counting_event to post one count per item:
+    // the waiting thread can get() one item per wait_for_ready().
+    // (If the buffer was full, the oldest item was dropped, so there
+    // may be fewer items than posts: get() returns T() then.)
+    void put(T item, counting_event& event) {
+        put(item);
+        event.post();
+    }
+
     T get() {
         std::lock_guard<std::mutex> lock(mutex_);
 
@@ -0,0 +1,188 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// For example of use, see the main program in main_programs/main_condition_data.cpp
+//
+namespace Util {
+
+class event_group;
+
+/////////////////////////////////////////////////////////////////////////////////
+// Class counting_event - a semaphore-like replacement for condition_data<T>
+// when no data has to be passed along with the signal.
+//
+// Each post() adds to a count, and each wait_for_ready() takes one off it, so
+// several posts before the waiter wakes up are not merged into one wakeup
+// (as they are with condition_data's "ready" flag): a consumer can take
+// exactly one item from its queue per wait.
+//
+// post() and a wait_for_ready() that finds a count do not make a system call
+// (there is no mutex). A waiter that finds no count spins for a while (not on
+// a single cpu), then sleeps on a futex (Linux). Only the post() that raises
+// the count from 0 makes the system call that wakes it up.
+/////////////////////////////////////////////////////////////////////////////////
+
+class counting_event {
+public:
+    // Spin this many times before sleeping in the kernel.
+    static constexpr unsigned default_spin = 200;
+
+    explicit counting_event(std::uint32_t count = 0, unsigned spin = default_spin)
+        : m_count(count), m_waiters(0), m_group(nullptr), m_spin(spin_limit(spin))
+    {
+    }
+
+    counting_event(const counting_event &) = delete;
+    counting_event &operator=(const counting_event &) = delete;
+
+    // Adds n to the count, and wakes up to n waiting threads.
+    void post(std::uint32_t n = 1)
+    {
+        // If the count was not 0, the waiters have been woken up already
+        // (and a waiter that takes a count wakes up the next one: see park()).
+        if (m_count.fetch_add(n, std::memory_order_seq_cst) == 0 &&
+            m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake(n);
+        }
+        event_group *group = m_group.load(std::memory_order_acquire);
+        if (group != nullptr)
+        {
+            notify_group(group);
+        }
+    }
+
+    // Takes one off the count if it is not 0.  Never blocks.
+    bool try_wait(void)
+    {
+        std::uint32_t count = m_count.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Waits until the count is not 0, and takes one off it.
+    void wait_for_ready(void)
+    {
+        if (! try_wait() && ! spin_wait())
+        {
+            park(nullptr);
+        }
+    }
+
+    // As above, but gives up after timeout. Returns false if it did.
+    bool wait_for_ready(std::chrono::nanoseconds timeout)
+    {
+        if (try_wait() || spin_wait())
+        {
+            return true;
+        }
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        return park(&deadline);
+    }
+
+    // The posts not yet taken (can be out of date by the time it returns).
+    std::uint32_t count(void) const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class event_group;
+
+    static unsigned spin_limit(unsigned spin);
+    bool spin_wait(void);
+    bool park(const std::chrono::steady_clock::time_point *deadline);
+    void wake(std::uint32_t n);
+    static void notify_group(event_group *group);
+
+    // The futex word: has to be 32 bits.
+    std::atomic<std::uint32_t> m_count;
+    std::atomic<std::uint32_t> m_waiters;
+    std::atomic<event_group *> m_group;
+    const unsigned m_spin;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// Class event_group - wait on several counting_events at once.
+//
+//      counting_event frames, commands;
+//      event_group group;
+//      size_t frames_index = group.add(frames);
+//      size_t commands_index = group.add(commands);
+//      ...
+//      size_t index = group.wait_for_any();    // took one off frames or commands
+//
+// An event can be in one group only. The events have to outlive the group,
+// and all of them have to be added before the first wait.
+/////////////////////////////////////////////////////////////////////////////////
+
+class event_group {
+public:
+    event_group(void) : m_sequence(0), m_waiters(0), m_next(0) { }
+    ~event_group(void);
+
+    event_group(const event_group &) = delete;
+    event_group &operator=(const event_group &) = delete;
+
+    // Returns the index wait_for_any() returns when it takes from the event.
+    size_t add(counting_event &event);
+
+    // Waits until any of the events has a count, takes one off it and returns
+    // its index. The events are checked round robin, so that a busy event
+    // does not starve the others.
+    size_t wait_for_any(void);
+
+    // As above, but gives up after timeout. Returns false if it did.
+    bool wait_for_any(std::chrono::nanoseconds timeout, size_t &index);
+
+private:
+    friend class counting_event;
+
+    bool try_any(size_t &index);
+    bool wait(const std::chrono::steady_clock::time_point *deadline, size_t &index);
+    void notify(void);
+
+    // Bumped by every post() to one of the events: the futex word the waiters sleep on.
+    std::atomic<std::uint32_t> m_sequence;
+    std::atomic<std::uint32_t> m_waiters;
+    std::vector<counting_event *> m_events;
+    std::atomic<size_t> m_next;
+};
+
+} // namespace Util
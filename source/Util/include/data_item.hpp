@@ -26,10 +26,12 @@
 
 #include <Utility.hpp>
 #include <circular_buffer.hpp>
+#include <data_span.hpp>
 #include <LoggerCpp/LoggerCpp.h>
 #include <mutex>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,19 +44,32 @@
 namespace Util
 {
 
+    // Selects the borrowing constructor of data_item_container (see below).
+    struct borrow_data_t { explicit borrow_data_t() = default; };
+    constexpr borrow_data_t borrow_data{};
+
     ////////////////////////////////////////////////////////////////////////////
     // Template class data_item_container definition
+    //
+    // A container either owns its data (new T[], copied in), or borrows data
+    // that lives elsewhere (a driver buffer, a slice of another container).
+    // A borrowing container calls its release function, if any, with data()
+    // when it is destroyed - to give the buffer back, or to drop a reference
+    // to whatever owns the memory. Copies are always owning (they copy the data).
     ////////////////////////////////////////////////////////////////////////////
 
     template<typename T>
     class data_item_container
     {
     public:
+        using release_function = std::function<void(T*)>;
+
         // Default constructor creates an empty object or a
         // valid object (with at least one member).
         data_item_container(size_t num_items = 0)
             : m_numitems(0)
             , mp_data(nullptr)
+            , m_owner(true)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             m_numitems = num_items;
@@ -64,17 +79,14 @@ namespace Util
         // Destructor
         virtual ~data_item_container()
         {
-            if (mp_data != nullptr)
-            {
-                delete[] mp_data;
-                mp_data = nullptr;
-            }
+            free_data();
         }
 
         // Copy constructor
         data_item_container(data_item_container& obj)
             : m_numitems(0)
             , mp_data(nullptr)
+            , m_owner(true)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -89,6 +101,7 @@ namespace Util
         data_item_container(T* rawdata, size_t nelements)
             : m_numitems(0)
             , mp_data(nullptr)
+            , m_owner(true)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -99,16 +112,26 @@ namespace Util
             if (nelements > 0) std::copy(rawdata, rawdata + nelements, data());
         }
 
+        // Borrowing constructor: no copy, the container uses rawdata as is.
+        // rawdata has to stay valid until release(rawdata) is called by the
+        // destructor (or, with no release function, for the container's lifetime).
+        data_item_container(T* rawdata, size_t nelements, borrow_data_t, release_function release = nullptr)
+            : m_numitems(nelements)
+            , mp_data(rawdata)
+            , m_owner(false)
+            , m_release(std::move(release))
+        {
+        }
+
         // Move constructor
         data_item_container(data_item_container&& obj)
             : m_numitems(0)
             , mp_data(nullptr)
+            , m_owner(true)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
 
-            mp_data = obj.data();
-            m_numitems = obj.num_items();
-            obj.set_invalid();
+            take(obj);
         }
 
         // Copy = (assignment)
@@ -118,9 +141,10 @@ namespace Util
 
             if (this != &obj)
             {
-                if (mp_data != nullptr) delete[] mp_data;
+                free_data();
                 m_numitems = obj.num_items();
                 mp_data = new T[m_numitems];
+                m_owner = true;
                 // copy from _begin() to (not including) _end, to data().
                 std::copy( obj._begin(), obj._end(), data());
             }
@@ -134,18 +158,25 @@ namespace Util
 
             if (this != &obj)
             {
-                if (mp_data != nullptr) delete[] mp_data;
-                mp_data = obj.data();
-                m_numitems = obj.num_items();
-                obj.set_invalid();
+                free_data();
+                take(obj);
             }
             return *this;
         }
 
+        // The data is left alone: it now belongs to someone else.
         void set_invalid()
         {
             m_numitems = 0;
             mp_data = nullptr;
+            m_owner = true;
+            m_release = nullptr;
+        }
+
+        // false if the data is borrowed
+        bool is_owner()
+        {
+            return m_owner;
         }
 
         bool is_valid()
@@ -167,9 +198,39 @@ namespace Util
         T* _begin()     { return mp_data; }
         T* _end()       { return _begin() + num_items(); }
 
+        data_span<T> span()     { return data_span<T>(mp_data, m_numitems); }
+
     private:
+        // Takes over the data of obj (which becomes invalid).
+        void take(data_item_container& obj)
+        {
+            mp_data = obj.mp_data;
+            m_numitems = obj.m_numitems;
+            m_owner = obj.m_owner;
+            m_release = std::move(obj.m_release);
+            obj.set_invalid();
+        }
+
+        void free_data()
+        {
+            if (m_owner)
+            {
+                delete[] mp_data;
+            }
+            else if (m_release)
+            {
+                m_release(mp_data);
+            }
+            mp_data = nullptr;
+            m_numitems = 0;
+            m_owner = true;
+            m_release = nullptr;
+        }
+
         size_t m_numitems;
         T *mp_data;
+        bool m_owner;                   // mp_data was new[]'ed by this object
+        release_function m_release;     // for borrowed data (can be empty)
         mutable std::mutex m_mutex;
     };
 
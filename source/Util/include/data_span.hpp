@@ -0,0 +1,141 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Util
+{
+
+////////////////////////////////////////////////////////////////////////////
+// Template class data_span - a pointer and a number of items: a view of
+// data that someone else owns (a frame, one plane or tile of it, a network
+// chunk). Copying a data_span copies neither the data nor its ownership,
+// so the data has to outlive the span.
+//
+// A data_span<T> converts to a data_span<const T>, and one can be made from
+// any container with data() and size() (std::vector, std::array, std::string).
+// To share the data itself, see data_item_container's borrowing constructor
+// and shared_data_items<T>::slice().
+////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+class data_span
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr data_span() noexcept
+        : mp_data(nullptr), m_numitems(0)
+    {
+    }
+
+    constexpr data_span(T* data, size_t num_items) noexcept
+        : mp_data(data), m_numitems(num_items)
+    {
+    }
+
+    constexpr data_span(T* first, T* last) noexcept
+        : mp_data(first), m_numitems(static_cast<size_t>(last - first))
+    {
+    }
+
+    template<size_t N>
+    constexpr data_span(T (&array)[N]) noexcept
+        : mp_data(array), m_numitems(N)
+    {
+    }
+
+    // data_span<uint8_t> -> data_span<const uint8_t>
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr data_span(const data_span<U>& other) noexcept
+        : mp_data(other.data()), m_numitems(other.size())
+    {
+    }
+
+    // std::vector, std::array, std::string...
+    template<typename C, typename = std::enable_if_t<
+                 ! std::is_same_v<std::remove_cv_t<C>, data_span> &&
+                 std::is_convertible_v<std::remove_pointer_t<decltype(std::data(std::declval<C&>()))>(*)[], T(*)[]>>>
+    constexpr data_span(C& container) noexcept
+        : mp_data(std::data(container)), m_numitems(std::size(container))
+    {
+    }
+
+    constexpr T* data() const noexcept          { return mp_data; }
+    constexpr size_t size() const noexcept      { return m_numitems; }
+    constexpr size_t bytelength() const noexcept { return m_numitems * sizeof(T); }
+    constexpr bool empty() const noexcept       { return m_numitems == 0; }
+    constexpr T* begin() const noexcept         { return mp_data; }
+    constexpr T* end() const noexcept           { return mp_data + m_numitems; }
+
+    // Not checked (see at())
+    constexpr T& operator[](size_t n) const     { return mp_data[n]; }
+
+    T& at(size_t n) const
+    {
+        if (n >= m_numitems)
+        {
+            throw std::out_of_range("data_span: out of bounds " + std::to_string(n) +
+                                    " (out of " + std::to_string(m_numitems) + ").");
+        }
+        return mp_data[n];
+    }
+
+    // count items from offset (up to the end if count is npos or too large).
+    data_span subspan(size_t offset, size_t count = npos) const
+    {
+        if (offset > m_numitems)
+        {
+            throw std::out_of_range("data_span: subspan offset " + std::to_string(offset) +
+                                    " is past the end (" + std::to_string(m_numitems) + ").");
+        }
+        size_t left = m_numitems - offset;
+        return data_span(mp_data + offset, count < left ? count : left);
+    }
+
+    data_span first(size_t count) const         { return subspan(0, count); }
+    data_span last(size_t count) const          { return subspan(count < m_numitems ? m_numitems - count : 0); }
+
+    // The same memory, as bytes (i.e. to write it to a socket or file).
+    data_span<const uint8_t> as_bytes() const noexcept
+    {
+        return data_span<const uint8_t>(reinterpret_cast<const uint8_t*>(mp_data), bytelength());
+    }
+
+private:
+    T* mp_data;
+    size_t m_numitems;
+};
+
+} // end of namespace Util
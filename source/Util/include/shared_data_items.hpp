@@ -98,6 +98,13 @@ public:
         return 0;
     }
 
+    // A view of all the items (no copy)
+    data_span<T> span(void)
+    {
+        if(p_shared_data) return p_shared_data->span();
+        return data_span<T>();
+    }
+
     T& operator[](size_t n)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -131,16 +138,13 @@ private:
 private:
     // private in order to prevent make_shared<> from being called
     // (see create() functions below).
-    // This private constructor creates either an empty (and invalid)
-    // object, or a valid one, with at least one T object.
-    shared_data_items(size_t numitems = 0)
+    // Takes over the data of dobj (owned or borrowed) without copying it.
+    shared_data_items(data_item_container<T>&& dobj)
         : p_shared_data(nullptr)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
-        // if numitems is 0, this creates an empty and
-        // invalid object, which is what we want.
-        p_shared_data = new data_item_container<T>(numitems);
+        p_shared_data = new data_item_container<T>(std::move(dobj));
     }
 
     // private in order to prevent make_shared<> from being called
@@ -165,16 +169,6 @@ private:
         p_shared_data = new data_item_container<T>(dobj);
     }
 
-    // private in order to prevent make_shared<> from being called
-    // (see create() functions below)
-    shared_data_items(T *databuffer, size_t nelements)
-        : p_shared_data(nullptr)
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-
-        // this data_item_container constructor copies the data:
-        p_shared_data = new data_item_container<T>(databuffer, nelements);
-    }
 
     ////////////////////////////////////////////////////////////////////////////
     // The following is the "public" section of object creation, construction, and deletion.
@@ -192,9 +186,10 @@ public:
     // This method HAS to be called the first time the object is created (instead of
     // the equivalent constructor). Subsequent shared_ptr<>'s can be had by calling the
     // get_shared_ptr() method declared/defined below.
+    // If numitems is 0, this creates an empty and invalid object.
     [[nodiscard]] static std::shared_ptr<Util::shared_data_items<T>> create(size_t numitems = 0)
     {
-        return std::shared_ptr<Util::shared_data_items<T>>(new Util::shared_data_items<T>(numitems));
+        return create(data_item_container<T>(numitems));
     }
 
     // This method HAS to be called the first time the object is created (instead of
@@ -216,9 +211,47 @@ public:
     // This method HAS to be called the first time the object is created (instead of
     // the equivalent constructor). Subsequent shared_ptr<>'s can be had by calling the
     // get_shared_ptr() method declared/defined below.
+    // (copies the data)
     [[nodiscard]] static std::shared_ptr<Util::shared_data_items<T>> create(T *databuffer, size_t nelements)
     {
-        return std::shared_ptr<Util::shared_data_items<T>>(new Util::shared_data_items<T>(databuffer, nelements));
+        return create(data_item_container<T>(databuffer, nelements));
+    }
+
+    // Takes over the data of dobj (owned or borrowed) without copying it.
+    [[nodiscard]] static std::shared_ptr<Util::shared_data_items<T>> create(data_item_container<T>&& dobj)
+    {
+        return std::shared_ptr<Util::shared_data_items<T>>(new Util::shared_data_items<T>(std::move(dobj)));
+    }
+
+    // No copy: the object borrows databuffer, which has to stay valid until
+    // release(databuffer) is called - when the last shared_ptr<> to the
+    // object (or to a slice() of it) goes away.
+    [[nodiscard]] static std::shared_ptr<Util::shared_data_items<T>> create_borrowed(T *databuffer, size_t nelements,
+                                            typename data_item_container<T>::release_function release = nullptr)
+    {
+        return create(data_item_container<T>(databuffer, nelements, borrow_data, std::move(release)));
+    }
+
+    // A new object for count items from offset (up to the end if count is too
+    // large), sharing this object's data: no copy. The slice keeps this object
+    // alive for as long as it exists - i.e. one plane or tile of a frame can be
+    // queued on its own.
+    [[nodiscard]] std::shared_ptr<Util::shared_data_items<T>> slice(size_t offset, size_t count = data_span<T>::npos)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t nitems = p_shared_data ? p_shared_data->num_items() : 0;
+        if (offset > nitems)
+        {
+            std::stringstream ostr;
+            ostr << "shared_data_items: slice offset " << std::to_string(offset) << " is out of bounds (out of "
+                 << std::to_string(nitems) << ").";
+            throw std::runtime_error(ostr.str());
+        }
+        data_span<T> items = p_shared_data->span().subspan(offset, count);
+
+        // The release function holds the reference to this object.
+        std::shared_ptr<Util::shared_data_items<T>> owner = this->shared_from_this();
+        return create_borrowed(items.data(), items.size(), [owner](T*) { ; });
     }
 
 public:
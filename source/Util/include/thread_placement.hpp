@@ -0,0 +1,64 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Util
+{
+
+// Where a thread runs, and how it is scheduled.
+struct thread_placement
+{
+    std::string cpus;           // "2", "2-3,6": the cpus it may run on ("": no change)
+    int fifo_priority = 0;      // 1..99: SCHED_FIFO at this priority (0: no change)
+};
+
+// "0-3,8-11" -> cpus. Returns false if the list is malformed (or empty).
+bool parse_cpu_list(const std::string& list, cpu_set_t& cpus);
+
+// cpus -> "0-3,8-11"
+std::string format_cpu_list(const cpu_set_t& cpus);
+
+// The cpus the calling thread may run on, less the ones in the lists
+// (i.e. to keep a thread off the cores given to others). "" if none are left.
+std::string cpus_except(const std::vector<std::string>& lists);
+
+// Names thread (up to 15 characters, shown by top -H, ps -L, gdb and perf),
+// then applies placement. Returns false, with the reasons in error, if a part
+// fails: the others are still applied. SCHED_FIFO takes CAP_SYS_NICE, or an
+// rtprio limit (ulimit -r).
+bool place_thread(pthread_t thread, const std::string& name, const thread_placement& placement, std::string& error);
+
+inline bool place_thread(std::thread& thread, const std::string& name, const thread_placement& placement, std::string& error)
+{
+    return place_thread(thread.native_handle(), name, placement, error);
+}
+
+} // end of namespace Util
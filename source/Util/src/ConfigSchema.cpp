@@ -0,0 +1,210 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <ConfigSchema.hpp>
+#include <sstream>
+
+using namespace Config;
+
+std::ostream& Config::operator<<(std::ostream& strm, const SchemaReport& report)
+{
+    for (const auto& error : report.errors)
+    {
+        strm << "ERROR in json config: " << error << "\n";
+    }
+    for (const auto& key : report.unknown_keys)
+    {
+        strm << "WARNING: unknown key in json config (misspelled?): " << key << "\n";
+    }
+    return strm;
+}
+
+////////////////////////////////////////////////////
+// schema_detail
+////////////////////////////////////////////////////
+
+std::vector<std::string> schema_detail::split_path(const std::string& path)
+{
+    if (path.size() < 2 || path[0] != '.')
+    {
+        throw std::runtime_error("ConfigSchema: invalid path \"" + path + "\": has to be like \".Config.Video.frame-count\"");
+    }
+
+    std::vector<std::string> keys;
+    std::string::size_type start = 1;
+    for (;;)
+    {
+        std::string::size_type dot = path.find('.', start);
+        std::string key = path.substr(start, dot == std::string::npos? std::string::npos : dot - start);
+        if (key.empty())
+        {
+            throw std::runtime_error("ConfigSchema: invalid path \"" + path + "\": empty key");
+        }
+        keys.push_back(key);
+        if (dot == std::string::npos) break;
+        start = dot + 1;
+    }
+    return keys;
+}
+
+const Json::Value* schema_detail::find(const Json::Value& root, const std::vector<std::string>& keys)
+{
+    const Json::Value* value = &root;
+    for (const auto& key : keys)
+    {
+        if (! value->isObject())
+        {
+            return nullptr;
+        }
+        value = value->find(key.data(), key.data() + key.size());
+        if (value == nullptr)
+        {
+            return nullptr;
+        }
+    }
+    return value;
+}
+
+std::string schema_detail::describe(const Json::Value& value)
+{
+    std::ostringstream strm;
+    Json::BufferedWriter writer(Json::BufferedWriter::compact, 256);
+    writer.write(value, &strm);
+    std::string str = strm.str();
+    if (str.size() > 60)
+    {
+        str.resize(57);
+        str += "...";
+    }
+    return str;
+}
+
+// Flags are often 0 or 1 in the json files: any integer is accepted.
+bool schema_detail::convert(const Json::Value& value, bool& out)
+{
+    if (value.isBool())
+    {
+        out = value.asBool();
+        return true;
+    }
+    if (value.isIntegral())
+    {
+        out = value.asLargestInt() != 0;
+        return true;
+    }
+    return false;
+}
+
+bool schema_detail::convert(const Json::Value& value, int& out)
+{
+    if (! value.isInt()) return false;
+    out = value.asInt();
+    return true;
+}
+
+bool schema_detail::convert(const Json::Value& value, unsigned& out)
+{
+    if (! value.isUInt()) return false;
+    out = value.asUInt();
+    return true;
+}
+
+bool schema_detail::convert(const Json::Value& value, int64_t& out)
+{
+    if (! value.isInt64()) return false;
+    out = value.asInt64();
+    return true;
+}
+
+bool schema_detail::convert(const Json::Value& value, uint64_t& out)
+{
+    if (! value.isUInt64()) return false;
+    out = value.asUInt64();
+    return true;
+}
+
+bool schema_detail::convert(const Json::Value& value, double& out)
+{
+    if (! value.isNumeric()) return false;
+    out = value.asDouble();
+    return true;
+}
+
+bool schema_detail::convert(const Json::Value& value, std::string& out)
+{
+    if (! value.isString()) return false;
+    out = value.asString();
+    return true;
+}
+
+const char* schema_detail::type_name(const bool*)         { return "a boolean (or 0/1)"; }
+const char* schema_detail::type_name(const int*)          { return "an integer"; }
+const char* schema_detail::type_name(const unsigned*)     { return "an unsigned integer"; }
+const char* schema_detail::type_name(const int64_t*)      { return "a 64 bit integer"; }
+const char* schema_detail::type_name(const uint64_t*)     { return "an unsigned 64 bit integer"; }
+const char* schema_detail::type_name(const double*)       { return "a number"; }
+const char* schema_detail::type_name(const std::string*)  { return "a string"; }
+
+void schema_detail::KeySet::add(const std::vector<std::string>& keys)
+{
+    std::string path;
+    for (const auto& key : keys)
+    {
+        if (! path.empty())
+        {
+            m_branches.insert(path);
+        }
+        path += "." + key;
+    }
+    m_fields.insert(path);
+}
+
+void schema_detail::KeySet::find_unknown(const Json::Value& value, const std::string& prefix, std::vector<std::string>& unknown) const
+{
+    // Walks the json object and the set side by side: path is relative to
+    // the object that the schema was loaded from.
+    std::function<void(const Json::Value&, const std::string&)> walk = [&](const Json::Value& object, const std::string& path)
+    {
+        for (auto itr = object.begin(); itr != object.end(); ++itr)
+        {
+            std::string member = path + "." + itr.name();
+            if (m_fields.count(member) != 0)
+            {
+                continue;
+            }
+            if (m_branches.count(member) != 0)
+            {
+                // Not an object: its fields are reported missing instead
+                if (itr->isObject()) walk(*itr, member);
+                continue;
+            }
+            unknown.push_back(prefix + member);
+        }
+    };
+
+    if (value.isObject())
+    {
+        walk(value, std::string());
+    }
+}
@@ -24,14 +24,22 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <ConfigSingleton.hpp>
+#include <ConfigTemplates.hpp>
 #include <JsonCppUtil.hpp>
 #include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
 
 using namespace Config;
 
@@ -62,12 +70,189 @@ bool checkFileIsNotEmpty(std::string fname)
 ////////////////////////////////////////////////////
 
 // statics
+std::unique_ptr<Json::ValueArena> ConfigSingleton::s_arena;   // Destroyed after the roots
 Json::Value ConfigSingleton::s_configRoot;    // THE root JSON node
 Json::Value ConfigSingleton::s_editRoot;      // Editable copy of the root JSON node
 ConfigSingletonShrdPtr ConfigSingleton::sp_Instance;
 std::mutex ConfigSingleton::s_mutex;
 bool ConfigSingleton::s_enabled = false;
 std::string ConfigSingleton::s_jsonfilename = std::string("default_config_filename.json");
+JsonSnapshot ConfigSingleton::s_snapshot;
+std::atomic<std::uint64_t> ConfigSingleton::s_generation(0);
+std::mutex ConfigSingleton::s_reload_mutex;
+std::mutex ConfigSingleton::s_subscription_mutex;
+std::vector<ConfigSingleton::Subscription> ConfigSingleton::s_subscriptions;
+ConfigSingleton::Validator ConfigSingleton::s_validator;
+int ConfigSingleton::s_next_subscription_id = 0;
+
+namespace
+{
+    // A snapshot's root and the arena that it was built in, released
+    // together by the snapshot's last holder.
+    struct ArenaRoot
+    {
+        std::unique_ptr<Json::ValueArena> arena = std::make_unique<Json::ValueArena>();  // Released after root
+        Json::Value root;
+    };
+
+    // Parse a json file into a new snapshot (nullptr on errors)
+    JsonSnapshot parseSnapshot(const std::string& filename, std::ostream& logstream)
+    {
+        std::ifstream ifs(filename);
+        if (! ifs.is_open())
+        {
+            logstream << "Could not open json file " << filename << ": " << strerror(errno) << "\n";
+            return nullptr;
+        }
+
+        Json::CharReaderBuilder builder;
+        builder["collectComments"] = false;
+        auto holder = std::make_shared<ArenaRoot>();
+        try
+        {
+            Json::ValueArena::Scope scope(*holder->arena);
+            Json::Value root;
+            JSONCPP_STRING errs;
+            if (! Json::parseFromStream(builder, ifs, &root, &errs))
+            {
+                logstream << "JsonCpp parse errors in " << filename << ": " << errs << "\n";
+                return nullptr;
+            }
+            if (! Config::expandTemplates(root, logstream))
+            {
+                return nullptr;
+            }
+            holder->root.swap(root);
+        }
+        catch (const std::exception& e)
+        {
+            logstream << "JsonCpp could not parse " << filename << ": " << e.what() << "\n";
+            return nullptr;
+        }
+
+        return JsonSnapshot(holder, &holder->root);
+    }
+
+    // Runs ConfigSingleton::Reload() each time the json file is written or
+    // replaced. It is defined after the ConfigSingleton statics, so that it
+    // is stopped before they are destroyed.
+    class ConfigWatcher
+    {
+    public:
+        ~ConfigWatcher() { stop(); }
+
+        bool start(const std::string& filename, ConfigSingleton::ReloadCallback onReload, std::ostream& logstream);
+        void stop();
+
+    private:
+        void run(std::string name, ConfigSingleton::ReloadCallback onReload);
+
+        std::mutex m_mutex;
+        std::thread m_thread;
+        int m_inotify_fd = -1;
+        int m_stop_fd = -1;
+    };
+
+    ConfigWatcher s_watcher;
+
+    bool ConfigWatcher::start(const std::string& filename, ConfigSingleton::ReloadCallback onReload, std::ostream& logstream)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_thread.joinable())
+        {
+            return true;
+        }
+
+        // Watch the directory rather than the file: saving often replaces the
+        // file (a rename by editors, unlink() and link() by UpdateJsonConfigFile()),
+        // which would leave a watch on the file itself with the old inode.
+        std::string::size_type slash = filename.rfind('/');
+        std::string directory = slash == std::string::npos? std::string(".") :
+                                slash == 0? std::string("/") : filename.substr(0, slash);
+        std::string name = slash == std::string::npos? filename : filename.substr(slash + 1);
+
+        m_inotify_fd = ::inotify_init1(IN_CLOEXEC);
+        m_stop_fd = ::eventfd(0, EFD_CLOEXEC);
+        if (m_inotify_fd < 0 || m_stop_fd < 0 ||
+            ::inotify_add_watch(m_inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+        {
+            int errnocopy = errno;
+            logstream << "ERROR: StartWatching() could not watch directory " << directory
+                      << ": " << strerror(errnocopy) << "\n";
+            if (m_inotify_fd >= 0) ::close(m_inotify_fd);
+            if (m_stop_fd >= 0) ::close(m_stop_fd);
+            m_inotify_fd = m_stop_fd = -1;
+            return false;
+        }
+
+        m_thread = std::thread(&ConfigWatcher::run, this, name, std::move(onReload));
+        return true;
+    }
+
+    void ConfigWatcher::stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (! m_thread.joinable())
+        {
+            return;
+        }
+
+        // Wakes up the thread's poll()
+        std::uint64_t one = 1;
+        while (::write(m_stop_fd, &one, sizeof(one)) < 0 && errno == EINTR)
+        {
+        }
+        m_thread.join();
+        ::close(m_inotify_fd);
+        ::close(m_stop_fd);
+        m_inotify_fd = m_stop_fd = -1;
+    }
+
+    void ConfigWatcher::run(std::string name, ConfigSingleton::ReloadCallback onReload)
+    {
+        // Saving a file is often several events (create, writes, rename):
+        // reload once they have stopped for this long.
+        constexpr int settle_ms = 100;
+
+        alignas(struct inotify_event) char buffer[4096];
+        struct pollfd fds[2] = { { m_inotify_fd, POLLIN, 0 }, { m_stop_fd, POLLIN, 0 } };
+        bool pending = false;
+
+        for (;;)
+        {
+            int ready = ::poll(fds, 2, pending? settle_ms : -1);
+            if (ready < 0)
+            {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[1].revents != 0)
+            {
+                break;
+            }
+            if (ready == 0)
+            {
+                pending = false;
+                std::stringstream strm;
+                bool published = ConfigSingleton::Reload(strm);
+                if (onReload) onReload(published, strm.str());
+                continue;
+            }
+
+            ssize_t length = ::read(m_inotify_fd, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < length; )
+            {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                if (event->len > 0 && name == event->name)
+                {
+                    pending = true;
+                }
+                offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            }
+        }
+    }
+
+} // end of anonymous namespace
 
 ConfigSingletonShrdPtr ConfigSingleton::create(const std::string& filename, std::ostream& logstream)
 {
@@ -125,9 +310,6 @@ ConfigSingletonShrdPtr ConfigSingleton::instance()
 
 bool ConfigSingleton::initialize(std::ostream& logstream)
 {
-    // temporary root
-    Json::Value root;
-
     std::ifstream ifs(ConfigSingleton::s_jsonfilename);
     if (! ifs.is_open())
     {
@@ -138,17 +320,50 @@ bool ConfigSingleton::initialize(std::ostream& logstream)
         // and exit()
     }
 
-    if (UtilJsonCpp::checkjsonsyntax(logstream, ifs, root) == EXIT_FAILURE)
+    // The root is built in a new arena. The previous one (if any) is released
+    // only once the roots no longer use it.
+    std::unique_ptr<Json::ValueArena> arena = std::make_unique<Json::ValueArena>();
     {
-        ifs.close();
-        return false;
+        // temporary root
+        Json::Value root;
+        {
+            Json::ValueArena::Scope scope(*arena);
+            if (UtilJsonCpp::checkjsonsyntax(logstream, ifs, root) == EXIT_FAILURE)
+            {
+                ifs.close();
+                return false;
+            }
+        }
+
+        // Make the initial copy of the JSON root object to make the editable copy.
+        // It keeps the templates as they are written, for UpdateJsonConfigFile().
+        // It is copied outside of the arena's scope, so to the heap: the arena would
+        // never give back what each edit allocates (see GetJsonRootCopyRef()).
+        Json::Value editroot(root);
+        ConfigSingleton::s_editRoot.swap(editroot);
+
+        {
+            Json::ValueArena::Scope scope(*arena);
+            if (! Config::expandTemplates(root, logstream))
+            {
+                ifs.close();
+                return false;
+            }
+        }
+
+        // store the temporary root into the real one
+        ConfigSingleton::s_configRoot.swap(root);
     }
+    ConfigSingleton::s_arena = std::move(arena);
 
-    // store the temporary root into the real one
-    ConfigSingleton::s_configRoot = root;
-
-    // Make the initial copy of the JSON root object to make the editable copy.
-    ConfigSingleton::s_editRoot = Config::ConfigSingleton::s_configRoot;
+    // The first snapshot is a copy with its own arena, since s_configRoot stays
+    // with this arena while snapshots are released as they are replaced.
+    auto holder = std::make_shared<ArenaRoot>();
+    {
+        Json::ValueArena::Scope scope(*holder->arena);
+        holder->root = ConfigSingleton::s_configRoot;
+    }
+    ConfigSingleton::publish(JsonSnapshot(holder, &holder->root), logstream);
 
     ifs.close();
     return true;
@@ -180,7 +395,16 @@ bool ConfigSingleton::UpdateJsonConfigFile(std::ostream& logstream, std::string
         return false;
     }
 
-    tmpcfgfile << ConfigSingleton::s_editRoot;
+    // Same layout as operator<<, but streamed through a fixed buffer instead of
+    // being built up as one string first, and with shortest round-trip doubles.
+    Json::BufferedWriter writer(Json::BufferedWriter::pretty);
+    if (writer.write(ConfigSingleton::s_editRoot, &tmpcfgfile) != 0)
+    {
+        logstream << "ERROR: UpdateJsonConfigFile() could not write the new json file " << tempfilename
+                       << ", aborted...\n";
+        tmpcfgfile.close();
+        return false;
+    }
     tmpcfgfile.close();
 
     // At this point, the modified json has been written into tempfilename.
@@ -263,3 +487,132 @@ bool ConfigSingleton::UpdateJsonConfigFile(std::ostream& logstream, std::string
 
 
 
+
+JsonSnapshot ConfigSingleton::Snapshot()
+{
+    // Each thread keeps the snapshot that it saw last, and only takes it again
+    // (std::atomic_load()) after a publish() has bumped the generation.
+    thread_local JsonSnapshot t_snapshot;
+    thread_local std::uint64_t t_generation = 0;
+
+    std::uint64_t generation = ConfigSingleton::s_generation.load(std::memory_order_acquire);
+    if (generation != t_generation)
+    {
+        t_snapshot = std::atomic_load(&ConfigSingleton::s_snapshot);
+        t_generation = generation;
+    }
+    return t_snapshot;
+}
+
+bool ConfigSingleton::Reload(std::ostream& logstream)
+{
+    std::lock_guard<std::mutex> lock(ConfigSingleton::s_reload_mutex);
+
+    JsonSnapshot snapshot = parseSnapshot(ConfigSingleton::s_jsonfilename, logstream);
+    if (! snapshot)
+    {
+        return false;
+    }
+
+    if (! snapshot->isObject())
+    {
+        logstream << "Rejected the new contents of " << ConfigSingleton::s_jsonfilename << ": the root is not an object.\n";
+        return false;
+    }
+
+    Validator validator;
+    {
+        std::lock_guard<std::mutex> sublock(ConfigSingleton::s_subscription_mutex);
+        validator = ConfigSingleton::s_validator;
+    }
+    bool valid = true;
+    try
+    {
+        valid = ! validator || validator(*snapshot, logstream);
+    }
+    catch (const std::exception& e)
+    {
+        logstream << e.what() << "\n";
+        valid = false;
+    }
+    if (! valid)
+    {
+        logstream << "Rejected the new contents of " << ConfigSingleton::s_jsonfilename << ".\n";
+        return false;
+    }
+
+    ConfigSingleton::publish(snapshot, logstream);
+    logstream << "Published the new contents of " << ConfigSingleton::s_jsonfilename << ".\n";
+    return true;
+}
+
+void ConfigSingleton::publish(JsonSnapshot snapshot, std::ostream& logstream)
+{
+    JsonSnapshot previous = std::atomic_exchange(&ConfigSingleton::s_snapshot, snapshot);
+    ConfigSingleton::s_generation.fetch_add(1, std::memory_order_release);
+
+    if (! previous)
+    {
+        return;     // The first snapshot: nothing has changed yet
+    }
+
+    // The callbacks run without the lock, so they may (un)subscribe.
+    std::vector<Subscription> subscriptions;
+    {
+        std::lock_guard<std::mutex> sublock(ConfigSingleton::s_subscription_mutex);
+        subscriptions = ConfigSingleton::s_subscriptions;
+    }
+
+    for (const auto& subscription : subscriptions)
+    {
+        Json::Path path(subscription.path);
+        const Json::Value& newValue = path.resolve(*snapshot);
+        if (newValue == path.resolve(*previous))
+        {
+            continue;
+        }
+
+        try
+        {
+            subscription.callback(newValue, snapshot);
+        }
+        catch (const std::exception& e)
+        {
+            logstream << "ERROR: change callback for " << subscription.path << " failed: " << e.what() << "\n";
+        }
+    }
+}
+
+bool ConfigSingleton::StartWatching(std::ostream& logstream, ReloadCallback onReload)
+{
+    return s_watcher.start(ConfigSingleton::s_jsonfilename, std::move(onReload), logstream);
+}
+
+void ConfigSingleton::StopWatching()
+{
+    s_watcher.stop();
+}
+
+int ConfigSingleton::Subscribe(const std::string& path, ChangeCallback callback)
+{
+    std::lock_guard<std::mutex> lock(ConfigSingleton::s_subscription_mutex);
+    int id = ++ConfigSingleton::s_next_subscription_id;
+    ConfigSingleton::s_subscriptions.push_back(Subscription{ id, path, std::move(callback) });
+    return id;
+}
+
+// A reload which is already calling back may still call this subscriber once.
+void ConfigSingleton::Unsubscribe(int id)
+{
+    std::lock_guard<std::mutex> lock(ConfigSingleton::s_subscription_mutex);
+    auto& subscriptions = ConfigSingleton::s_subscriptions;
+    subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                       [id](const Subscription& subscription) { return subscription.id == id; }),
+                        subscriptions.end());
+}
+
+void ConfigSingleton::SetValidator(Validator validator)
+{
+    std::lock_guard<std::mutex> lock(ConfigSingleton::s_subscription_mutex);
+    ConfigSingleton::s_validator = std::move(validator);
+}
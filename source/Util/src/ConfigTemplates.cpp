@@ -0,0 +1,282 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <ConfigTemplates.hpp>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+
+namespace
+{
+    const char* const s_templates_key = "Templates";
+    const char* const s_extends_key = "extends";
+
+    class TemplateExpander
+    {
+    public:
+        TemplateExpander(const Json::Value& templates, std::ostream& logstream)
+            : m_templates(templates), m_logstream(logstream)
+        {
+        }
+
+        bool ok() const { return m_ok; }
+
+        void expand(Json::Value& node, const std::string& key, Json::ArrayIndex index, const std::string& path);
+
+    private:
+        using Variables = std::map<std::string, std::string>;
+
+        const Json::Value* resolve(const std::string& name, const std::string& path);
+        void error(const std::string& path, const std::string& message);
+
+        static void merge(Json::Value& base, const Json::Value& over);
+        static void addScalars(const Json::Value& node, Variables& vars);
+        static std::string substitute(const std::string& str, const Variables& vars);
+        static void substituteAll(Json::Value& node, const Variables& vars);
+
+        const Json::Value& m_templates;
+        std::ostream& m_logstream;
+        std::map<std::string, Json::Value> m_resolved;      // Templates with their own "extends" merged in
+        std::set<std::string> m_resolving;                  // To catch cycles
+        bool m_ok = true;
+    };
+
+    void TemplateExpander::error(const std::string& path, const std::string& message)
+    {
+        m_logstream << "ERROR in json config templates: " << path << ": " << message << "\n";
+        m_ok = false;
+    }
+
+    // A template, with what it extends merged in. nullptr on errors.
+    const Json::Value* TemplateExpander::resolve(const std::string& name, const std::string& path)
+    {
+        auto found = m_resolved.find(name);
+        if (found != m_resolved.end())
+        {
+            return &found->second;
+        }
+
+        const Json::Value* tmpl = m_templates.find(name.data(), name.data() + name.size());
+        if (tmpl == nullptr)
+        {
+            error(path, "there is no template \"" + name + "\" in ." + s_templates_key);
+            return nullptr;
+        }
+        if (! tmpl->isObject())
+        {
+            error(path, "template \"" + name + "\" is not an object");
+            return nullptr;
+        }
+        if (! m_resolving.insert(name).second)
+        {
+            error(path, "template \"" + name + "\" is part of an \"extends\" cycle");
+            return nullptr;
+        }
+
+        Json::Value resolved;
+        const Json::Value* base_name = tmpl->find(s_extends_key, s_extends_key + strlen(s_extends_key));
+        if (base_name == nullptr)
+        {
+            resolved = *tmpl;
+        }
+        else
+        {
+            const std::string tmpl_path = std::string(".") + s_templates_key + "." + name;
+            const Json::Value* base = nullptr;
+            if (! base_name->isString())
+            {
+                error(tmpl_path, "\"extends\" has to be a template name");
+            }
+            else
+            {
+                base = resolve(base_name->asString(), tmpl_path);
+            }
+            if (base == nullptr)
+            {
+                m_resolving.erase(name);
+                return nullptr;
+            }
+            resolved = *base;
+            Json::Value own = *tmpl;
+            own.removeMember(s_extends_key);
+            merge(resolved, own);
+        }
+        m_resolving.erase(name);
+
+        return &(m_resolved[name] = std::move(resolved));
+    }
+
+    // Members of over replace those of base, except objects, which are merged.
+    void TemplateExpander::merge(Json::Value& base, const Json::Value& over)
+    {
+        for (auto itr = over.begin(); itr != over.end(); ++itr)
+        {
+            const std::string name = itr.name();
+            Json::Value& target = base[name];
+            if (target.isObject() && itr->isObject())
+            {
+                merge(target, *itr);
+            }
+            else
+            {
+                target = *itr;
+            }
+        }
+    }
+
+    void TemplateExpander::addScalars(const Json::Value& node, Variables& vars)
+    {
+        for (auto itr = node.begin(); itr != node.end(); ++itr)
+        {
+            if (itr->isString() || itr->isNumeric() || itr->isBool())
+            {
+                vars[itr.name()] = itr->asString();
+            }
+        }
+    }
+
+    // Replaces the known ${var}. The replacements are not scanned again.
+    std::string TemplateExpander::substitute(const std::string& str, const Variables& vars)
+    {
+        std::string::size_type start = str.find("${");
+        if (start == std::string::npos)
+        {
+            return str;
+        }
+
+        std::string result;
+        std::string::size_type done = 0;
+        while (start != std::string::npos)
+        {
+            std::string::size_type end = str.find('}', start + 2);
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            auto var = vars.find(str.substr(start + 2, end - start - 2));
+            if (var != vars.end())
+            {
+                result.append(str, done, start - done);
+                result += var->second;
+                done = end + 1;
+            }
+            start = str.find("${", var != vars.end()? done : start + 2);
+        }
+        result.append(str, done, std::string::npos);
+        return result;
+    }
+
+    void TemplateExpander::substituteAll(Json::Value& node, const Variables& vars)
+    {
+        if (node.isString())
+        {
+            node = substitute(node.asString(), vars);
+        }
+        else if (node.isObject() || node.isArray())
+        {
+            for (auto& child : node)
+            {
+                substituteAll(child, vars);
+            }
+        }
+    }
+
+    void TemplateExpander::expand(Json::Value& node, const std::string& key, Json::ArrayIndex index, const std::string& path)
+    {
+        if (node.isObject())
+        {
+            const Json::Value* base_name = node.find(s_extends_key, s_extends_key + strlen(s_extends_key));
+            if (base_name != nullptr)
+            {
+                const Json::Value* base = nullptr;
+                if (! base_name->isString())
+                {
+                    error(path, "\"extends\" has to be a template name");
+                }
+                else
+                {
+                    base = resolve(base_name->asString(), path);
+                }
+                node.removeMember(s_extends_key);
+
+                if (base != nullptr)
+                {
+                    Json::Value expanded = *base;
+                    merge(expanded, node);
+
+                    // The members first, so that they can be used with their ${key} and ${index} replaced
+                    Variables vars{ { "key", key }, { "index", std::to_string(index) } };
+                    for (auto& member : expanded)
+                    {
+                        if (member.isString())
+                        {
+                            member = substitute(member.asString(), vars);
+                        }
+                    }
+                    addScalars(expanded, vars);
+                    substituteAll(expanded, vars);
+
+                    node.swap(expanded);
+                }
+            }
+
+            Json::ArrayIndex position = 0;
+            for (auto itr = node.begin(); itr != node.end(); ++itr, ++position)
+            {
+                const std::string name = itr.name();
+                expand(*itr, name, position, path + "." + name);
+            }
+        }
+        else if (node.isArray())
+        {
+            for (Json::ArrayIndex i = 0; i < node.size(); ++i)
+            {
+                expand(node[i], std::to_string(i), i, path + "[" + std::to_string(i) + "]");
+            }
+        }
+    }
+
+} // end of anonymous namespace
+
+bool Config::expandTemplates(Json::Value& root, std::ostream& logstream)
+{
+    if (! root.isObject())
+    {
+        return true;
+    }
+
+    Json::Value templates;
+    root.removeMember(s_templates_key, &templates);
+    if (! templates.isNull() && ! templates.isObject())
+    {
+        logstream << "ERROR in json config templates: ." << s_templates_key << " has to be an object\n";
+        return false;
+    }
+
+    TemplateExpander expander(templates, logstream);
+    expander.expand(root, std::string(), 0, std::string());
+    return expander.ok();
+}
@@ -0,0 +1,84 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <Format.hpp>
+#include <charconv>     // Floating point std::to_chars() if __cpp_lib_to_chars is defined
+
+using namespace Util;
+
+const char format_detail::digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+const char format_detail::hex_digits_lower[17] = "0123456789abcdef";
+const char format_detail::hex_digits_upper[17] = "0123456789ABCDEF";
+
+void format_detail::write_floating(writer& out, double value, bool is_float, const spec& s)
+{
+    // Room for DBL_MAX in fixed notation, with the maximum precision (100)
+    char buf[512];
+    char* end = buf;
+
+#if defined(__cpp_lib_to_chars)
+    std::to_chars_result result;
+    if (s.type == 'e')
+    {
+        result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific, s.precision < 0? 6 : s.precision);
+    }
+    else if (s.type == 'g')
+    {
+        result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, s.precision < 0? 6 : s.precision);
+    }
+    else if (s.type == 'f' || s.precision >= 0)
+    {
+        result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, s.precision < 0? 6 : s.precision);
+    }
+    else
+    {
+        // Shortest text that reads back as the same value
+        result = is_float? std::to_chars(buf, buf + sizeof(buf), static_cast<float>(value)) :
+                           std::to_chars(buf, buf + sizeof(buf), value);
+    }
+    end = result.ptr;
+#else
+    char conversion = (s.type == 'e' || s.type == 'g')? s.type : (s.type == 'f' || s.precision >= 0)? 'f' : 'g';
+    int precision = (s.precision >= 0)? s.precision : (s.type != '\0')? 6 : is_float? 9 : 17;
+    char format[8] = { '%', '.', '*', conversion, '\0' };
+    int size = std::snprintf(buf, sizeof(buf), format, precision, value);
+    end = buf + (size < 0? 0 : size);
+#endif
+
+    bool negative = (end > buf && buf[0] == '-');
+    const char* digits = negative? buf + 1 : buf;
+    out.put_number(negative, digits, static_cast<std::size_t>(end - digits), s);
+}
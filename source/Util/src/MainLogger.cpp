@@ -2,6 +2,10 @@
 #include <MainLogger.hpp>
 #include <iostream>
 #include <stdexcept>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 /////////////////////////////////////////////////////////////////////////////////
 // MIT License
@@ -36,6 +40,10 @@ Log::Log::Level MainLogger::loglevel = Log::Log::Level::eDebug;
 std::string MainLogger::default_log_level = Log::Log::toString(MainLogger::loglevel);
 std::string MainLogger::log_level = default_log_level;
 std::mutex MainLogger::s_logger_mutex;
+size_t MainLogger::async_queue_size = 8192;
+size_t MainLogger::mmap_segment_size = 64*1024*1024;
+std::atomic<unsigned> MainLogger::rate_limit_per_sec(10);
+std::atomic<unsigned> MainLogger::sample_one_in(100);
 
 void Util::MainLogger::initialize(  Log::Config::Vector& configList,
                                     const std::string& channel_name,
@@ -86,11 +94,20 @@ void Util::MainLogger::initializeLogManager( Log::Config::Vector& configList,
         Log::Config::setOption(configList, "filename",          logfilename.c_str());
         std::string oldlogfilename = std::string("old.")+logfilename;
         Log::Config::setOption(configList, "filename_old",      oldlogfilename.c_str());
+        Log::Config::setOption(configList, "max_startup_size",  "0");
+        Log::Config::setOption(configList, "max_size",          "100000000");
         std::cerr << "Log file: " << logfilename.c_str() << std::endl;
     }
-
-    Log::Config::setOption(configList, "max_startup_size",  "0");
-    Log::Config::setOption(configList, "max_size",          "100000000");
+#ifdef __unix__
+    else if (useLogFile == MainLogger::enableMmapLogFile)
+    {
+        Log::Config::addOutput(configList, "OutputMmapFile");
+        Log::Config::setOption(configList, "filename",          logfilename.c_str());
+        Log::Config::setOption(configList, "segment_size",      std::to_string(mmap_segment_size).c_str());
+        Log::Config::setOption(configList, "max_segments",      "4");
+        std::cerr << "Log file (memory mapped): " << logfilename.c_str() << std::endl;
+    }
+#endif
 #ifdef WIN32
     Log::Config::addOutput(configList, "OutputDebug");
 #endif
@@ -139,7 +156,10 @@ LoggerOptions UtilLogger::s_defaultLogOpt = {
                                         MainLogger::enableConsole,
 
                                         // useLogFile (in LoggerOptions)
-                                        MainLogger::enableLogFile
+                                        MainLogger::enableLogFile,
+
+                                        // useAsync (in LoggerOptions)
+                                        MainLogger::disableAsync
                                     };
 
 LoggerSPtr Util::UtilLogger::sp_Logger;
@@ -167,6 +187,10 @@ Util::UtilLoggerSPtr UtilLogger::create(Util::LoggerOptions& logopt)
                                           );
 
     Util::MainLogger::configureLogManager( configList, logopt.logChannelName);
+    if (logopt.useAsync == MainLogger::enableAsync)
+    {
+        Log::Manager::startAsync(MainLogger::async_queue_size, Log::Manager::eDropIfFull);
+    }
     Util::UtilLogger::setLoggerOptions(logopt);
     Util::UtilLogger::sp_Logger = std::make_shared<Log::Logger>(*(new Log::Logger(logopt.logChannelName.c_str())));
     UtilLoggerSPtr spu_logger = std::make_shared<UtilLogger>(Util::UtilLogger());
@@ -182,7 +206,8 @@ Util::LoggerOptions UtilLogger::setLocalLoggerOptions(
                 std::string                     logChannelNameString,
                 Log::Log::Level                 logLevelEnum,
                 Util::MainLogger::ConsoleOutput consoleOutputEnum,
-                Util::MainLogger::UseLogFile    useLogFileEnum
+                Util::MainLogger::UseLogFile    useLogFileEnum,
+                Util::MainLogger::AsyncLogging  asyncLoggingEnum
             )
 {
     using namespace Util;
@@ -194,6 +219,7 @@ Util::LoggerOptions UtilLogger::setLocalLoggerOptions(
     localopt.logFilelName = logChannelNameString + "_log.txt";
     localopt.useConsole = consoleOutputEnum;
     localopt.useLogFile = useLogFileEnum;
+    localopt.useAsync = asyncLoggingEnum;
 
     setLoggerOptions(localopt);
     return localopt;
@@ -216,7 +242,9 @@ void UtilLogger::streamLoggerOptions(std::ostream& strm, Util::LoggerOptions log
           << "     Log channel name " << logopt.logChannelName << "\n"
           << "     Log file name " << logopt.logFilelName << "\n"
           << "     Output to console " << (logopt.useConsole == Util::MainLogger::enableConsole? "enabled": "disabled")  << "\n"
-          << "     Output to log file " << (logopt.useLogFile == Util::MainLogger::enableLogFile? "enabled": "disabled") << "\n";
+          << "     Output to log file " << (logopt.useLogFile == Util::MainLogger::enableLogFile? "enabled":
+                                          (logopt.useLogFile == Util::MainLogger::enableMmapLogFile? "enabled (memory mapped)": "disabled")) << "\n"
+          << "     Asynchronous logging " << (logopt.useAsync == Util::MainLogger::enableAsync? "enabled": "disabled") << "\n";
 }
 
 // returns -1 on error, or (>= 0) value for enum value
@@ -232,3 +260,150 @@ int UtilLogger::stringToEnumLoglevel(const std::string& slog_level)
     return ret;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Rate limited and sampled logging - please see the comment in MainLogger.hpp.
+//////////////////////////////////////////////////////////////////////
+
+namespace
+{
+    // The call sites that dropped lines (never destroyed: sites may be destroyed later)
+    struct RateLimitedSites
+    {
+        std::mutex mutex;
+        std::vector<LogRateLimiter*> sites;
+    };
+
+    RateLimitedSites& rate_limited_sites()
+    {
+        static RateLimitedSites* p_sites = new RateLimitedSites;
+        return *p_sites;
+    }
+
+    // Next time (steady_clock) allow() outputs the pending counts of all the sites
+    std::atomic<int64_t> s_next_report_ns{0};
+}
+
+LogRateLimiter::~LogRateLimiter()
+{
+    RateLimitedSites& registry = rate_limited_sites();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.sites.erase(std::remove(registry.sites.begin(), registry.sites.end(), this), registry.sites.end());
+}
+
+void LogRateLimiter::register_site(const Log::Logger& logger, Log::Log::Level level)
+{
+    RateLimitedSites& registry = rate_limited_sites();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (! m_registered.load(std::memory_order_relaxed))
+    {
+        m_logger = std::make_unique<Log::Logger>(logger);
+        m_level = level;
+        registry.sites.push_back(this);
+        m_registered.store(true, std::memory_order_release);
+    }
+}
+
+void LogRateLimiter::report_suppressed()
+{
+    struct Pending
+    {
+        const LogRateLimiter* site;
+        unsigned long count;
+    };
+    std::vector<Pending> pending;
+
+    // Output after the lock is released: an Output could log through a rate limited site
+    RateLimitedSites& registry = rate_limited_sites();
+    std::unique_lock<std::mutex> lock(registry.mutex);
+    for (LogRateLimiter* site : registry.sites)
+    {
+        unsigned long count = site->m_suppressed.exchange(0, std::memory_order_relaxed);
+        if (count != 0)
+        {
+            pending.push_back({site, count});
+        }
+    }
+    lock.unlock();
+
+    for (const Pending& entry : pending)
+    {
+        const char* file = std::strrchr(entry.site->m_file, '/');
+        Util::logAtLevel(*entry.site->m_logger, entry.site->m_level) << LogSuppressed{entry.count}
+                << "(" << (file? file + 1 : entry.site->m_file) << ":" << entry.site->m_line << ")";
+    }
+}
+
+// Token bucket in its "virtual scheduling" form: a single atomic holds the time at
+// which the bucket would be full again, so concurrent callers need no lock.
+bool LogRateLimiter::allow(unsigned long& suppressed, const Log::Logger& logger, Log::Log::Level level)
+{
+    unsigned rate = MainLogger::rate_limit_per_sec.load(std::memory_order_relaxed);
+    if (rate == 0)
+    {
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    const int64_t interval_ns = 1000000000LL / rate;
+    const int64_t burst_ns = 1000000000LL;      // one second's worth of lines
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // Once a second, the counts of the sites that have gone quiet since they dropped lines
+    int64_t report_ns = s_next_report_ns.load(std::memory_order_relaxed);
+    if (now_ns >= report_ns &&
+        s_next_report_ns.compare_exchange_strong(report_ns, now_ns + burst_ns, std::memory_order_relaxed))
+    {
+        LogRateLimiter::report_suppressed();
+    }
+
+    int64_t next_ns = m_next_ns.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        int64_t start_ns = (next_ns > now_ns)? next_ns : now_ns;
+        if (start_ns + interval_ns - now_ns > burst_ns)
+        {
+            if (! m_registered.load(std::memory_order_acquire))
+            {
+                register_site(logger, level);
+            }
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (m_next_ns.compare_exchange_weak(next_ns, start_ns + interval_ns, std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+    suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool LogSampler::allow()
+{
+    unsigned one_in = MainLogger::sample_one_in.load(std::memory_order_relaxed);
+    unsigned long count = m_count.fetch_add(1, std::memory_order_relaxed);
+    return (one_in <= 1) || (count % one_in == 0);
+}
+
+std::ostream& Util::operator<<(std::ostream& strm, const LogSuppressed& suppressed)
+{
+    if (suppressed.count != 0)
+    {
+        strm << "[" << suppressed.count << " similar log lines suppressed] ";
+    }
+    return strm;
+}
+
+Log::Log Util::logAtLevel(const Log::Logger& logger, Log::Log::Level level)
+{
+    switch (level)
+    {
+        case Log::Log::eDebug:      return logger.debug();
+        case Log::Log::eInfo:       return logger.info();
+        case Log::Log::eNotice:     return logger.notice();
+        case Log::Log::eWarning:    return logger.warning();
+        case Log::Log::eError:      return logger.error();
+        default:                    return logger.critic();
+    }
+}
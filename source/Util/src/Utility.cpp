@@ -12,6 +12,9 @@
 #include <stdio.h>
 #include <iostream>
 #include <algorithm>
+#include <functional>
+#include <atomic>
+#include <random>
 #include <vector>
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -62,31 +65,42 @@ std::string Utility::get_UTC_time_as_string(const char *format)
 // 3 and 12 (inclusive).
 int Utility::get_rand(int range, int low)
 {
-    static bool srand_called = false;
-    if (srand_called)
+    if (range <= 0)
     {
-        return (rand() % range) + low;
+        return low;
     }
+    return static_cast<int>(Utility::thread_rng().below(static_cast<uint64_t>(range))) + low;
+}
+
+xoshiro256ss& Utility::thread_rng()
+{
+    // One random seed per process, and a different sequence number per thread
+    static const uint64_t s_process_seed = (static_cast<uint64_t>(std::random_device()()) << 32) ^
+                                           static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    static std::atomic<uint64_t> s_thread_count(0);
 
-    srand(time(NULL));
-    srand_called = true;
-    return (rand() % range) + low;
+    // The thread number is mixed in: seeds a multiple of seed()'s own step apart
+    // would give threads the same state words, shifted by one.
+    thread_local xoshiro256ss t_rng(xoshiro256ss::mix(s_process_seed + ++s_thread_count));
+    return t_rng;
 }
 
-bool Utility::string_starts_with(std::string mainStr, std::string toMatch)
+bool Utility::string_starts_with(std::string_view mainStr, std::string_view toMatch)
 {
-    // std::string::find returns 0 if toMatch is found at starting
-    if (mainStr.find(toMatch) == 0)
-        return true;
-    else
-        return false;
+    // Only compares the start (find() would search all of mainStr)
+    return mainStr.substr(0, toMatch.size()) == toMatch;
 }
 
-std::string Utility::trim(std::string str, std::string whitespace)
+std::string Utility::trim(std::string_view str, std::string_view whitespace)
+{
+    return std::string(Utility::trim_view(str, whitespace));
+}
+
+std::string_view Utility::trim_view(std::string_view str, std::string_view whitespace)
 {
     const auto strBegin = str.find_first_not_of(whitespace);
-    if (strBegin == std::string::npos)
-        return ""; // no content
+    if (strBegin == std::string_view::npos)
+        return std::string_view(); // no content
 
     const auto strEnd = str.find_last_not_of(whitespace);
     const auto strRange = strEnd - strBegin + 1;
@@ -94,43 +108,66 @@ std::string Utility::trim(std::string str, std::string whitespace)
     return str.substr(strBegin, strRange);
 }
 
-std::string Utility::stringFormat(const std::string &format, ...)
+void Utility::trim_in_place(std::string& str, std::string_view whitespace)
+{
+    const auto strEnd = str.find_last_not_of(whitespace);
+    if (strEnd == std::string::npos)
+    {
+        str.clear(); // no content
+        return;
+    }
+    str.erase(strEnd + 1);
+    str.erase(0, str.find_first_not_of(whitespace));
+}
+
+// The format can not be a reference (const std::string&): va_start() is undefined
+// for those. Short results need a single vsnprintf() into a stack buffer.
+std::string Utility::stringFormat(const char *format, ...)
 {
     va_list args;
     va_start(args, format);
-    size_t len = std::vsnprintf(NULL, 0, format.c_str(), args);
-    va_end(args);
-    std::vector<char> vec(len + 1);
-    va_start(args, format);
-    std::vsnprintf(&vec[0], len + 1, format.c_str(), args);
+    va_list args_copy;
+    va_copy(args_copy, args);
+
+    char buf[256];
+    int len = std::vsnprintf(buf, sizeof(buf), format, args);
     va_end(args);
-    return &vec[0];
+
+    std::string result;
+    if (len >= static_cast<int>(sizeof(buf)))
+    {
+        result.resize(len);
+        std::vsnprintf(&result[0], len + 1, format, args_copy);
+    }
+    else if (len > 0)
+    {
+        result.assign(buf, len);
+    }
+    va_end(args_copy);
+    return result;
 }
 
-std::vector<std::string> Utility::split(const std::string& str, const std::string& delim)
+std::vector<std::string> Utility::split(std::string_view str, std::string_view delim)
 {
     std::vector<std::string> vs;
-    size_t pos {};
 
-    for (size_t fdelim = 0; (fdelim = str.find(delim, pos)) != std::string::npos; pos = fdelim + delim.size())
-        vs.emplace_back(str.data() + pos, str.data() + fdelim);
+    for (std::string_view field : Utility::split_view(str, delim))
+        vs.emplace_back(field);
 
-    vs.emplace_back(str.data() + pos, str.data() + str.size());
     return vs;
 }
 
 // All blank/empty vector members are removed, and all members are trimmed (left and right).
-std::vector<std::string> Utility::split_and_trim(const std::string& str, const std::string& delim)
+std::vector<std::string> Utility::split_and_trim(std::string_view str, std::string_view delim)
 {
-    std::vector<std::string> vs = Utility::split(str,delim);
     std::vector<std::string> result;
 
-    for (auto& e : vs)
+    for (std::string_view field : Utility::split_view(str, delim))
     {
-        e = Utility::trim(e);
-        if (e.size() > 0)
+        field = Utility::trim_view(field);
+        if (field.size() > 0)
         {
-            result.push_back(e);
+            result.emplace_back(field);
         }
     }
 
@@ -138,24 +175,76 @@ std::vector<std::string> Utility::split_and_trim(const std::string& str, const s
 }
 
 std::string Utility::replace_all(   // Replace all occurences
-        const std::string & str ,   // in haystack
-        const std::string & find ,  // of needle
-        const std::string & replace // with replacement
+        std::string_view str ,      // in haystack
+        std::string_view find ,     // of needle
+        std::string_view replace    // with replacement
     )
 {
-    using namespace std;
-    string result;
-    size_t find_len = find.size();
-    size_t pos,from=0;
-    while ( string::npos != ( pos=str.find(find,from) ) ) {
-        result.append( str, from, pos-from );
-        result.append( replace );
-        from = pos + find_len;
-    }
-    result.append( str, from , string::npos );
+    std::string result(str);
+    Utility::replace_all_in_place(result, find, replace);
     return result;
 }
 
+void Utility::replace_all_in_place(std::string& str, std::string_view find, std::string_view replace)
+{
+    if (find.empty())
+        return;
+
+    // A find or replace that is a view of str would be overwritten as str is
+    // edited: work with copies of them.
+    std::less<const char*> before;
+    auto is_in_str = [&](std::string_view v) {
+        return ! before(v.data(), str.data()) && before(v.data(), str.data() + str.size());
+    };
+    if (is_in_str(find) || is_in_str(replace))
+    {
+        const std::string findcopy(find), replacecopy(replace);
+        Utility::replace_all_in_place(str, findcopy, replacecopy);
+        return;
+    }
+
+    if (replace.size() <= find.size())
+    {
+        // The result is not longer: compact it in a single pass, without a second buffer
+        size_t to = str.find(find.data(), 0, find.size());
+        if (to == std::string::npos)
+            return;
+        size_t from = to;
+        while (from < str.size())
+        {
+            size_t pos = str.find(find.data(), from, find.size());
+            if (pos == from)
+            {
+                std::copy(replace.begin(), replace.end(), str.begin() + to);
+                to += replace.size();
+                from += find.size();
+                continue;
+            }
+            size_t end = (pos == std::string::npos)? str.size() : pos;
+            if (to != from)     // to < from: a forward copy never overwrites what it has still to read
+                std::copy(str.begin() + from, str.begin() + end, str.begin() + to);
+            to += end - from;
+            from = end;
+        }
+        str.resize(to);
+        return;
+    }
+
+    std::string result;
+    size_t pos, from = 0;
+    while (std::string::npos != (pos = str.find(find.data(), from, find.size()))) {
+        if (from == 0)
+            result.reserve(str.size() + replace.size() - find.size());
+        result.append(str, from, pos - from);
+        result.append(replace.data(), replace.size());
+        from = pos + find.size();
+    }
+    if (from == 0)
+        return;
+    result.append(str, from, std::string::npos);
+    str.swap(result);
+}
+
 // Converts all chars in str parameter to uppercase (modifies string parameter)
 void Utility::to_upper(std::string &str)
 {
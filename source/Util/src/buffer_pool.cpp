@@ -0,0 +1,374 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <buffer_pool.hpp>
+#include <thread_placement.hpp>
+#include <errno.h>
+#include <limits.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+
+using namespace Util;
+
+namespace
+{
+    const size_t huge_page_size = 2 * 1024 * 1024;
+
+    // Node masks for the mbind() and set_mempolicy() system calls
+    // (called directly: libnuma is not needed for this much).
+    const int max_numa_nodes = 1024;
+    using node_mask = unsigned long[max_numa_nodes / (8 * sizeof(unsigned long))];
+
+    void set_node(node_mask& mask, int node)
+    {
+        memset(mask, 0, sizeof(node_mask));
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    }
+
+    size_t round_up(size_t bytes, size_t unit)
+    {
+        return (bytes + unit - 1) / unit * unit;
+    }
+
+    // Anonymous memory aligned to a huge page: the kernel can only back
+    // whole aligned 2 MB ranges with transparent huge pages.
+    void* map_aligned(size_t length)
+    {
+        size_t padded = length + huge_page_size;
+        void* p = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = round_up(start, huge_page_size);
+        if (aligned > start)
+        {
+            ::munmap(p, aligned - start);
+        }
+        size_t tail = (start + padded) - (aligned + length);
+        if (tail > 0)
+        {
+            ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+}
+
+size_t Util::pages_size(size_t bytes, const buffer_policy& policy)
+{
+    if (policy.pages == huge_pages::off)
+    {
+        return round_up(bytes, static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+    }
+    return round_up(bytes, huge_page_size);
+}
+
+void* Util::allocate_pages(size_t bytes, const buffer_policy& policy, std::string* backing)
+{
+    size_t length = pages_size(bytes == 0 ? 1 : bytes, policy);
+    void* p = nullptr;
+    std::string how;
+
+    if (policy.pages == huge_pages::explicit_pages)
+    {
+        p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);   // 2^21: 2 MB pages
+        if (p == MAP_FAILED)
+        {
+            p = nullptr;
+            how = "transparent huge pages (no explicit huge pages available: see /proc/sys/vm/nr_hugepages)";
+        }
+        else
+        {
+            how = "explicit 2 MB huge pages";
+        }
+    }
+    if (p == nullptr && policy.pages != huge_pages::off)
+    {
+        p = map_aligned(length);
+        if (p != nullptr)
+        {
+            // Not an error if THP is disabled: the memory is just backed by normal pages.
+            ::madvise(p, length, MADV_HUGEPAGE);
+            if (how.empty()) how = "transparent huge pages";
+        }
+    }
+    if (policy.pages == huge_pages::off)
+    {
+        p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        p = (p == MAP_FAILED) ? nullptr : p;
+        how = "4 KB pages";
+    }
+    if (p == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Before the first touch: that is when the pages are placed.
+    if (policy.numa_node >= 0 && policy.numa_node < max_numa_nodes)
+    {
+        node_mask mask;
+        set_node(mask, policy.numa_node);
+        if (::syscall(SYS_mbind, p, length, MPOL_PREFERRED, mask, max_numa_nodes, 0) == 0)
+        {
+            how += ", on NUMA node " + std::to_string(policy.numa_node);
+        }
+        else
+        {
+            how += ", NOT on NUMA node " + std::to_string(policy.numa_node) + " (mbind: " + strerror(errno) + ")";
+        }
+    }
+
+    if (backing != nullptr)
+    {
+        *backing = how;
+    }
+    return p;
+}
+
+void Util::free_pages(void* pages, size_t bytes, const buffer_policy& policy)
+{
+    if (pages != nullptr)
+    {
+        ::munmap(pages, pages_size(bytes == 0 ? 1 : bytes, policy));
+    }
+}
+
+int Util::numa_device_node(const std::string& device)
+{
+    // /dev/video0 -> /sys/class/video4linux/video0/device: the first device up
+    // the tree (the USB interface, its hub, ...) with a numa_node is the controller.
+    std::string name = device.substr(device.find_last_of('/') + 1);
+    std::string sysclass = "/sys/class/video4linux/" + name + "/device";
+    char resolved[PATH_MAX];
+    if (::realpath(sysclass.c_str(), resolved) == nullptr)
+    {
+        return -1;
+    }
+    for (std::string path(resolved); path.size() > std::string("/sys/devices").size(); path.erase(path.find_last_of('/')))
+    {
+        std::ifstream file(path + "/numa_node");
+        int node = -1;
+        if (file >> node)
+        {
+            return node;        // -1 on machines with one node
+        }
+    }
+    return -1;
+}
+
+bool Util::numa_bind_current_thread(int node, std::string& error)
+{
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string cpulist;
+    if (node < 0 || node >= max_numa_nodes || ! std::getline(file, cpulist))
+    {
+        error = "there is no NUMA node " + std::to_string(node);
+        return false;
+    }
+
+    cpu_set_t cpus;
+    if (! parse_cpu_list(cpulist, cpus))
+    {
+        error = "NUMA node " + std::to_string(node) + " has no cpus";
+        return false;
+    }
+    int ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+    if (ret != 0)
+    {
+        error = std::string("pthread_setaffinity_np: ") + strerror(ret);
+        return false;
+    }
+
+    node_mask mask;
+    set_node(mask, node);
+    if (::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, max_numa_nodes) != 0)
+    {
+        error = std::string("set_mempolicy: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// buffer_pool
+/////////////////////////////////////////////////////////////////////////////////
+
+buffer_pool::buffer_pool(const buffer_policy& policy, size_t max_free)
+    : m_policy(policy)
+    , m_slab_size(policy.pages == huge_pages::off ? 0 : huge_page_size)
+    , m_max_free(max_free)
+{
+}
+
+std::shared_ptr<buffer_pool> buffer_pool::create(const buffer_policy& policy, size_t max_free)
+{
+    return std::shared_ptr<buffer_pool>(new buffer_pool(policy, max_free));
+}
+
+buffer_pool::~buffer_pool()
+{
+    for (const block& blk : m_free)
+    {
+        free_pages(blk.data, blk.capacity, m_policy);
+    }
+    for (const block& slab : m_slabs)
+    {
+        free_pages(slab.data, slab.capacity, m_policy);
+    }
+}
+
+void buffer_pool::add_max_free(size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_free += count;
+}
+
+shared_ptr_uint8_data_t buffer_pool::get(size_t nbytes)
+{
+    if (m_slab_size != 0 && nbytes <= m_slab_size / 2)
+    {
+        return get_slot(nbytes);
+    }
+
+    block blk = { nullptr, 0 };
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto itr = m_free.begin(); itr != m_free.end(); itr++)
+        {
+            if (itr->capacity >= nbytes)
+            {
+                blk = *itr;
+                m_free.erase(itr);
+                break;
+            }
+        }
+    }
+
+    if (blk.data == nullptr)
+    {
+        std::string backing;
+        blk.capacity = pages_size(nbytes == 0 ? 1 : nbytes, m_policy);
+        blk.data = static_cast<uint8_t*>(allocate_pages(blk.capacity, m_policy, &backing));
+        if (blk.data == nullptr)
+        {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backing = backing;
+    }
+
+    // The release function keeps the pool alive until the buffer is back.
+    std::shared_ptr<buffer_pool> pool = shared_from_this();
+    return shared_uint8_data_t::create_borrowed(blk.data, nbytes, [pool, blk](uint8_t*) { pool->put_back(blk); });
+}
+
+shared_ptr_uint8_data_t buffer_pool::get_slot(size_t nbytes)
+{
+    size_t slot_size = 4096;
+    while (slot_size < nbytes)
+    {
+        slot_size *= 2;
+    }
+
+    uint8_t* slot = nullptr;
+    while (slot == nullptr)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<uint8_t*>& free_slots = m_free_slots[slot_size];
+            if (!free_slots.empty())
+            {
+                slot = free_slots.back();
+                free_slots.pop_back();
+                break;
+            }
+        }
+
+        // No free slot of this size: cut a new slab into slots (mapped
+        // without the lock, the other threads carry on meanwhile).
+        std::string backing;
+        uint8_t* slab = static_cast<uint8_t*>(allocate_pages(m_slab_size, m_policy, &backing));
+        if (slab == nullptr)
+        {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backing = backing;
+        m_slabs.push_back({ slab, m_slab_size });
+        std::vector<uint8_t*>& free_slots = m_free_slots[slot_size];
+        for (size_t offset = m_slab_size; offset >= slot_size; offset -= slot_size)
+        {
+            free_slots.push_back(slab + offset - slot_size);
+        }
+    }
+
+    std::shared_ptr<buffer_pool> pool = shared_from_this();
+    return shared_uint8_data_t::create_borrowed(slot, nbytes, [pool, slot, slot_size](uint8_t*) { pool->put_back_slot(slot, slot_size); });
+}
+
+shared_ptr_uint8_data_t buffer_pool::copy(const void* data, size_t nbytes)
+{
+    shared_ptr_uint8_data_t sp = get(nbytes);
+    if (sp && nbytes > 0)
+    {
+        ::memcpy(sp->data(), data, nbytes);
+    }
+    return sp;
+}
+
+std::string buffer_pool::backing() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_backing;
+}
+
+void buffer_pool::put_back(block blk)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_free.size() < m_max_free)
+        {
+            m_free.push_back(blk);
+            return;
+        }
+    }
+    free_pages(blk.data, blk.capacity, m_policy);
+}
+
+void buffer_pool::put_back_slot(uint8_t* slot, size_t slot_size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free_slots[slot_size].push_back(slot);
+}
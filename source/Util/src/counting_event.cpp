@@ -0,0 +1,244 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <counting_event.hpp>
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <thread>
+
+using namespace Util;
+
+namespace
+{
+    // The kernel works on the 32 bit word inside the atomic.
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word has to be 32 bits");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "futex word has to be lock free");
+
+    // Sleeps while *word == expected, until woken up or the deadline (if any).
+    // Returns 0 when woken up (or spuriously), EAGAIN if *word was not expected,
+    // ETIMEDOUT if the deadline passed.
+    int futex_wait(std::atomic<std::uint32_t> *word, std::uint32_t expected,
+                   const std::chrono::steady_clock::time_point *deadline)
+    {
+        struct timespec timeout;
+        struct timespec *timeoutp = nullptr;
+        if (deadline != nullptr)
+        {
+            auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0)
+            {
+                return ETIMEDOUT;
+            }
+            timeout.tv_sec = static_cast<time_t>(left / 1000000000);
+            timeout.tv_nsec = static_cast<long>(left % 1000000000);
+            timeoutp = &timeout;
+        }
+        // FUTEX_WAIT's timeout is relative (to CLOCK_MONOTONIC, as steady_clock is)
+        if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(word), FUTEX_WAIT_PRIVATE,
+                      expected, timeoutp, nullptr, 0) == 0)
+        {
+            return 0;
+        }
+        return errno == EINTR ? 0 : errno;
+    }
+
+    void futex_wake(std::atomic<std::uint32_t> *word, std::uint32_t n)
+    {
+        int count = static_cast<int>(std::min<std::uint32_t>(n, INT_MAX));
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+    // Tells the cpu (and a hyperthreaded sibling) that this is a spin loop.
+    inline void cpu_relax(void)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield" ::: "memory");
+#else
+        asm volatile("" ::: "memory");
+#endif
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// counting_event
+/////////////////////////////////////////////////////////////////////////////////
+
+// Spinning only helps when the thread that posts runs on another cpu.
+unsigned counting_event::spin_limit(unsigned spin)
+{
+    static const bool single_cpu = std::thread::hardware_concurrency() == 1;
+    return single_cpu ? 0 : spin;
+}
+
+bool counting_event::spin_wait(void)
+{
+    for (unsigned i = 0; i < m_spin; i++)
+    {
+        cpu_relax();
+        if (m_count.load(std::memory_order_relaxed) != 0 && try_wait())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The waiter count is raised before the count is read again, and post()
+// raises the count before it reads the waiter count: either post() sees the
+// waiter and wakes it, or the kernel sees the new count and does not sleep.
+//
+// post() only wakes waiters when the count goes up from 0. Posts that come
+// before the woken waiter has taken its count do not wake anyone, so the
+// woken waiter passes the wakeup on when it leaves a count behind.
+bool counting_event::park(const std::chrono::steady_clock::time_point *deadline)
+{
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool taken = false;
+    while (! (taken = try_wait()))
+    {
+        if (futex_wait(&m_count, 0, deadline) == ETIMEDOUT)
+        {
+            taken = try_wait();
+            break;
+        }
+    }
+    if (m_waiters.fetch_sub(1, std::memory_order_seq_cst) > 1 &&
+        m_count.load(std::memory_order_seq_cst) != 0)
+    {
+        wake(1);
+    }
+    return taken;
+}
+
+void counting_event::wake(std::uint32_t n)
+{
+    futex_wake(&m_count, n);
+}
+
+void counting_event::notify_group(event_group *group)
+{
+    group->notify();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// event_group
+/////////////////////////////////////////////////////////////////////////////////
+
+event_group::~event_group(void)
+{
+    for (counting_event *event : m_events)
+    {
+        event->m_group.store(nullptr, std::memory_order_release);
+    }
+}
+
+size_t event_group::add(counting_event &event)
+{
+    m_events.push_back(&event);
+    event.m_group.store(this, std::memory_order_release);
+    return m_events.size() - 1;
+}
+
+size_t event_group::wait_for_any(void)
+{
+    size_t index = 0;
+    wait(nullptr, index);
+    return index;
+}
+
+bool event_group::wait_for_any(std::chrono::nanoseconds timeout, size_t &index)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    return wait(&deadline, index);
+}
+
+bool event_group::try_any(size_t &index)
+{
+    size_t size = m_events.size();
+    size_t start = m_next.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t candidate = (start + i) % size;
+        if (m_events[candidate]->try_wait())
+        {
+            m_next.store((candidate + 1) % size, std::memory_order_relaxed);
+            index = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Same scheme as counting_event::park(), on the sequence number: a post()
+// after the sequence was read changes it, so the kernel does not sleep.
+bool event_group::wait(const std::chrono::steady_clock::time_point *deadline, size_t &index)
+{
+    if (try_any(index))
+    {
+        return true;
+    }
+    for (unsigned i = 0; i < counting_event::default_spin; i++)
+    {
+        cpu_relax();
+        if (try_any(index))
+        {
+            return true;
+        }
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool taken = false;
+    for (;;)
+    {
+        std::uint32_t sequence = m_sequence.load(std::memory_order_seq_cst);
+        if ((taken = try_any(index)))
+        {
+            break;
+        }
+        if (futex_wait(&m_sequence, sequence, deadline) == ETIMEDOUT)
+        {
+            taken = try_any(index);
+            break;
+        }
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return taken;
+}
+
+void event_group::notify(void)
+{
+    m_sequence.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) != 0)
+    {
+        futex_wake(&m_sequence, INT_MAX);
+    }
+}
@@ -0,0 +1,209 @@
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <Utility.hpp>
+#include <MainLogger.hpp>
+#include <LoggerCpp/LoggerCpp.h>
+#include <LoggerCpp/BinaryLog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// Compares the cost of a log line at the call site, on the hot path, for:
+//
+//   1) A normal stream Log (loggerp->debug() << ...), formatted and written out
+//      by the calling thread.
+//   2) LOGGER_BINARY with the BinaryLog in text mode: the calling thread only
+//      copies the arguments into its buffer, a background thread formats them and
+//      writes them to the same log file.
+//   3) LOGGER_BINARY with the BinaryLog in file mode: the records go, still in
+//      binary, to main_LoggerCpp_binary_log.bin, which is then decoded into
+//      main_LoggerCpp_binary_log_decoded.txt.
+//
+// Usage: main_LoggerCpp_binary_log [ num_lines [ num_threads ] ]
+//        main_LoggerCpp_binary_log -decode binary_file       (text goes to stdout)
+//
+// num_lines is per thread (default is 100000), num_threads defaults to 1. The ns per
+// line is the wall time of the timed loops divided by all the lines of all the threads.
+
+std::string logChannelName = "main_LoggerCpp_binary_log";
+const char *binaryFileName = "main_LoggerCpp_binary_log.bin";
+const char *decodedFileName = "main_LoggerCpp_binary_log_decoded.txt";
+
+// Room for all the lines of a run, so the comparison is not about dropped records
+const size_t threadBufferSize = 16 * 1024 * 1024;
+
+void Usage(std::ostream& strm, std::string command)
+{
+    strm << "Usage:    " << command << " [ num_lines [ num_threads ] ]\n" <<
+            "          " << command << " -decode binary_file\n\n" <<
+            "num_lines is per thread, and defaults to 100000. num_threads defaults to 1.\n" << std::endl;
+}
+
+enum RunType { streamLog, binaryLog };
+
+// Logs one line, of the same layout for both types
+void logLine(RunType type, Log::Logger& logger, int t, int i, const std::string& camera)
+{
+    if (type == streamLog)
+    {
+        logger.debug() << "thread " << t << " frame " << i << " from " << camera
+                       << " fps " << 29.97 << " queued " << true;
+    }
+    else
+    {
+        LOGGER_BINARY(logger, Log::Log::eDebug, "thread {} frame {} from {} fps {} queued {}",
+                      t, i, camera, 29.97, true);
+    }
+}
+
+// Runs num_threads threads each logging num_lines lines, returns the average ns per line.
+// The clock starts once every thread is running and has logged one warm-up line, so
+// thread creation and the allocation of the thread's 16 MB ring are not timed.
+double run(RunType type, Log::Logger& logger, int num_lines, int num_threads)
+{
+    std::vector<std::thread> workers;
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+
+    for (int t = 0; t < num_threads; t++)
+    {
+        workers.push_back(std::thread([type, &logger, num_lines, t, &ready, &go]()
+        {
+            std::string camera("/dev/video0");
+            logLine(type, logger, t, -1, camera);
+            ready++;
+            while (! go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            for (int i = 0; i < num_lines; i++)
+            {
+                logLine(type, logger, t, i, camera);
+            }
+        }));
+    }
+    while (ready.load() < num_threads)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(num_lines) * num_threads);
+}
+
+int main(int argc, const char *argv[])
+{
+    using namespace Util;
+
+    if (argc > 1 && (std::string(argv[1]) == "--help" ||
+                     std::string(argv[1]) == "-h" ||
+                     std::string(argv[1]) == "help"))
+    {
+        Usage(std::cerr, argv[0]);
+        return 1;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "-decode")
+    {
+        if (argc != 3)
+        {
+            Usage(std::cerr, argv[0]);
+            return 1;
+        }
+        long count = Log::BinaryLog::decodeFile(argv[2], stdout);
+        if (count < 0)
+        {
+            std::cerr << "Could not read binary log file " << argv[2] << std::endl;
+            return 1;
+        }
+        std::cerr << count << " records decoded" << std::endl;
+        return 0;
+    }
+
+    int num_lines = (argc > 1) ? strtol(argv[1], NULL, 10) : 100000;
+    int num_threads = (argc > 2) ? strtol(argv[2], NULL, 10) : 1;
+    if (num_lines <= 0 || num_threads <= 0)
+    {
+        Usage(std::cerr, argv[0]);
+        return 1;
+    }
+
+    LoggerOptions localopt = UtilLogger::setLocalLoggerOptions(
+                                                logChannelName,
+                                                Log::Log::Level::eDebug,
+                                                MainLogger::disableConsole,
+                                                MainLogger::enableLogFile
+                                        );
+    UtilLogger::create(localopt);
+    Log::Logger& logger = *(UtilLogger::getLoggerPtr());
+
+    std::cerr << num_threads << " thread(s), " << num_lines << " lines each" << std::endl;
+
+    double stream_ns = run(streamLog, logger, num_lines, num_threads);
+    std::cerr << "stream log:              " << stream_ns << " ns per line" << std::endl;
+
+    Log::BinaryLog::start(Log::BinaryLog::eText, NULL, threadBufferSize);
+    double text_ns = run(binaryLog, logger, num_lines, num_threads);
+    Log::BinaryLog::stop();
+    std::cerr << "binary log (text mode):  " << text_ns << " ns per line" << std::endl;
+
+    if (!Log::BinaryLog::start(Log::BinaryLog::eFile, binaryFileName, threadBufferSize))
+    {
+        std::cerr << "Could not create " << binaryFileName << std::endl;
+        return 1;
+    }
+    double file_ns = run(binaryLog, logger, num_lines, num_threads);
+    Log::BinaryLog::stop();
+    std::cerr << "binary log (file mode):  " << file_ns << " ns per line" << std::endl;
+
+    std::cerr << "records dropped (thread buffer full): " << Log::BinaryLog::getDroppedCount() << std::endl;
+
+    FILE *decoded = fopen(decodedFileName, "w");
+    if (decoded == NULL)
+    {
+        std::cerr << "Could not create " << decodedFileName << std::endl;
+        return 1;
+    }
+    long count = Log::BinaryLog::decodeFile(binaryFileName, decoded);
+    fclose(decoded);
+    std::cerr << count << " records decoded from " << binaryFileName << " into " << decodedFileName << std::endl;
+
+    Log::Manager::terminate();
+
+    return 0;
+}
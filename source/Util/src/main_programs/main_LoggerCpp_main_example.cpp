@@ -11,6 +11,11 @@
 #include <LoggerCpp/LoggerCpp.h>
 
 #include <iostream> // used for cerr messages
+#include <thread>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
 
 
 /**
@@ -34,9 +39,143 @@ private:
 
 
 /**
- * @brief Simple example program
+ * @brief Cost of DateTime::make() and DateTime::format() alone, in nanoseconds per call
  */
-int main ()
+static void timestampCost(double& aMakeNs, double& aFormatNs)
+{
+    const int       count = 1000000;
+    Log::DateTime   time;
+    char            buffer[Log::DateTime::kFormatSize];
+    size_t          check = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        time.make();
+        check += time.ms;
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        time.ms = i % 1000;
+        check += time.format(buffer)[22];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    aMakeNs = std::chrono::duration<double, std::nano>(middle - start).count() / count;
+    aFormatNs = std::chrono::duration<double, std::nano>(end - middle).count() / count;
+    if (check == 0) {
+        std::cerr << "";    // keeps the loops from being optimized away
+    }
+}
+
+/**
+ * @brief Log aRecords records from each of aThreads threads to the output file, return the records per second
+ */
+static double throughput(int aThreads, int aRecords)
+{
+    std::vector<Log::Logger>    loggers;
+    std::vector<std::thread>    threads;
+
+    // Loggers are created here: the Manager does not create Channel objects concurrently
+    for (int t = 0; t < aThreads; ++t) {
+        loggers.push_back(Log::Logger("Bench.Throughput"));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < aThreads; ++t) {
+        const Log::Logger& logger = loggers[t];
+        threads.push_back(std::thread([&logger, t, aRecords]() {
+            for (int i = 0; i < aRecords; ++i) {
+                logger.info() << "thread " << t << " record " << i << " of " << aRecords;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return (static_cast<double>(aThreads) * aRecords) / seconds;
+}
+
+/**
+ * @brief Logging throughput (records/sec) with each clock of DateTime, with 1 and 8 threads
+ */
+static void benchmark(int aRecords)
+{
+    const char*             names[] = { "CLOCK_REALTIME", "CLOCK_REALTIME_COARSE", "TSC" };
+    Log::DateTime::Clock    clocks[] = { Log::DateTime::eRealtime, Log::DateTime::eRealtimeCoarse, Log::DateTime::eTsc };
+
+    // Only a file: the console would be the bottleneck
+    Log::Config::Vector configList;
+    Log::Config::addOutput(configList, "OutputFile");
+    Log::Config::setOption(configList, "filename",          "throughput_log.txt");
+    Log::Config::setOption(configList, "filename_old",      "throughput_log.old.txt");
+    Log::Config::setOption(configList, "max_startup_size",  "0");
+    Log::Config::setOption(configList, "max_size",          "100000000");
+    Log::Manager::configure(configList);
+
+    std::cout << "\nLogging throughput, " << aRecords << " records per thread:\n";
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); ++c) {
+        if (!Log::DateTime::setClock(clocks[c])) {
+            std::cout << "  " << names[c] << ": not available\n";
+            continue;
+        }
+        double makeNs, formatNs;
+        timestampCost(makeNs, formatNs);
+        double single = throughput(1, aRecords);
+        double multi  = throughput(8, aRecords);
+        std::cout << "  " << names[c] << ": make() " << makeNs << " ns, format() " << formatNs << " ns, "
+                  << static_cast<long>(single) << " records/sec with 1 thread, "
+                  << static_cast<long>(multi) << " records/sec with 8 threads\n";
+    }
+    Log::DateTime::setClock(Log::DateTime::eRealtime);
+
+    Log::Manager::terminate();
+}
+
+#ifdef __unix__
+/**
+ * @brief Logging throughput (records/sec) of OutputFile compared to OutputMmapFile, with 1 and 8 threads
+ */
+static void compareOutputs(int aRecords)
+{
+    const char* names[] = { "OutputFile", "OutputMmapFile" };
+
+    std::cout << "\nOutput throughput, " << aRecords << " records per thread:\n";
+    for (size_t o = 0; o < sizeof(names) / sizeof(names[0]); ++o) {
+        // Both rotate every 16 MB, so that the rotation cost is part of the measure
+        Log::Config::Vector configList;
+        Log::Config::addOutput(configList, names[o]);
+        if (0 == o) {
+            Log::Config::setOption(configList, "filename",          "output_file_log.txt");
+            Log::Config::setOption(configList, "filename_old",      "output_file_log.old.txt");
+            Log::Config::setOption(configList, "max_startup_size",  "0");
+            Log::Config::setOption(configList, "max_size",          "16777216");
+        } else {
+            Log::Config::setOption(configList, "filename",          "output_mmap_log.txt");
+            Log::Config::setOption(configList, "segment_size",      "16777216");
+            Log::Config::setOption(configList, "max_segments",      "1");
+        }
+        Log::Manager::configure(configList);
+
+        double single = throughput(1, aRecords);
+        double multi  = throughput(8, aRecords);
+        std::cout << "  " << names[o] << ": "
+                  << static_cast<long>(single) << " records/sec with 1 thread, "
+                  << static_cast<long>(multi) << " records/sec with 8 threads\n";
+
+        Log::Manager::terminate();
+    }
+}
+#endif
+
+
+/**
+ * @brief Simple example program, optionally followed by logging throughput benchmarks
+ *
+ * Usage: main_LoggerCpp_main_example [ --benchmark [ records_per_thread ] ]     (default is 100000)
+ */
+int main (int argc, char* argv[])
 {
     // Configure the default severity Level of new Channel objects
 #ifndef NDEBUG
@@ -131,5 +270,16 @@ int main ()
     Log::Manager::terminate();
     logger.warning() << "NO more logs after terminate()";
 
+    if ((argc > 1) && (std::string(argv[1]) == "--benchmark")) {
+        int records = (argc > 2) ? atoi(argv[2]) : 0;
+        if (records <= 0) {
+            records = 100000;
+        }
+        benchmark(records);
+#ifdef __unix__
+        compareOutputs(records);
+#endif
+    }
+
     return 0;
 }
@@ -49,6 +49,9 @@ int main()
     localopt.useConsole = MainLogger::disableConsole;
     localopt.useLogFile = MainLogger::enableLogFile;
 
+    // Log lines are queued, and written to the log file by a separate thread.
+    localopt.useAsync = MainLogger::enableAsync;
+
     // Initialise the UtilLogger object
     UtilLogger::create(localopt);
 
@@ -87,5 +90,8 @@ int main()
     std::cerr << sret << std::endl;
     ulogger.info() << sret;
 
+    // Writes out the queued log lines and stops the writer thread
+    Log::Manager::terminate();
+
     return 0;
 }
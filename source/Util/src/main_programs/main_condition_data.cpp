@@ -33,8 +33,12 @@
 #include <ostream>
 #include <iostream>
 #include <chrono>
+#include <atomic>
+#include <iomanip>
 #include <stdlib.h>
 #include <condition_data.hpp>
+#include <counting_event.hpp>
+#include <circular_buffer.hpp>
 #include <Utility.hpp>
 #include <MainLogger.hpp>
 #include <LoggerCpp/LoggerCpp.h>
@@ -66,6 +70,12 @@
 // If num_threads is specified, it has to be numerical and greater than 0. If not, it
 // defaults to 20.
 //
+// To compare the wakeup latency of condition_data with counting_event instead, use:
+//
+//         main_condition_data --latency [iterations]
+//
+// (see run_latency_benchmarks() below; build with optimization for meaningful numbers).
+//
 // FOR A SAMPLE RUN SHOWING THE RESULTS SEE THE #ifdef'ed SECTION AT THE VERY END OF THIS FILE
 //
 // NOTE FROM THE AUTHOR:  I got the program to fail on a std::bad_alloc at somewhere between
@@ -82,9 +92,12 @@
 
 void Usage(std::ostream& strm, std::string command)
 {
-    strm << "Usage:    " << command << " [ num_threads ]\n\n" <<
+    strm << "Usage:    " << command << " [ num_threads ]\n" <<
+            "          " << command << " --latency [ iterations ]\n\n" <<
                  "If num_threads is specified, it has to be numerical and greater than 0. ]\n" <<
-                 "If it is not specified, it defaults to 20.\n" << std::endl;
+                 "If it is not specified, it defaults to 20.\n" <<
+                 "--latency compares the wakeup latency of condition_data and counting_event\n" <<
+                 "(iterations defaults to 100000).\n" << std::endl;
 }
 
 // Returns the number of threads requested, or 0 if no parameters.
@@ -118,6 +131,167 @@ void initializeSleeptimes(int numthreads, std::vector<int>& sleeptimes)
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+// Wakeup latency: condition_data vs. counting_event
+/////////////////////////////////////////////////////////////////////////////////
+
+// Prints the mean and percentiles of the round trip times (nanoseconds).
+void report(const char *name, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples)
+    {
+        total += sample;
+    }
+    auto percentile = [&samples](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+    std::string label(name);
+    label.resize(std::max<size_t>(label.size(), 52), ' ');
+    std::cout << label << " mean " << std::setw(8) << static_cast<long>(total / samples.size())
+              << "  p50 " << std::setw(8) << static_cast<long>(percentile(0.50))
+              << "  p99 " << std::setw(8) << static_cast<long>(percentile(0.99))
+              << "  max " << std::setw(9) << static_cast<long>(samples.back()) << " ns\n";
+}
+
+// Two threads pass a token back and forth: ping() signals the other thread
+// and waits for its answer, pong() waits and answers. Returns the round trip
+// time of each iteration.
+template<typename Ping, typename Pong>
+std::vector<double> ping_pong(int iterations, Ping ping, Pong pong)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    std::thread other([iterations, &pong]()
+    {
+        for (int i = 0; i < iterations; i++)
+        {
+            pong();
+        }
+    });
+    for (int i = 0; i < iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ping();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(elapsed.count());
+    }
+    other.join();
+    return samples;
+}
+
+// The producer puts a burst of items into a circular_buffer, the consumer
+// takes them out: with condition_data it has to loop over empty() after each
+// wakeup; with counting_event, it takes one item per wait. Returns ns per item.
+template<typename Event, typename Consume>
+double burst(int iterations, Event& event, Consume consume)
+{
+    const int burst_size = 64;
+    Util::circular_buffer<int> ringbuf(burst_size * 2);
+    std::atomic<int> consumed(0);
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]()
+    {
+        while (consumed.load(std::memory_order_relaxed) < iterations)
+        {
+            consumed.fetch_add(consume(ringbuf, event), std::memory_order_relaxed);
+        }
+    });
+    for (int i = 0; i < iterations; i += burst_size)
+    {
+        for (int j = 0; j < burst_size && i + j < iterations; j++)
+        {
+            ringbuf.put(i + j, event);
+        }
+        // Do not let the ring buffer drop items
+        while (ringbuf.size() > burst_size)
+        {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+int run_latency_benchmarks(int iterations)
+{
+    using Util::condition_data;
+    using Util::counting_event;
+
+    std::cout << "Round trip between two threads, " << iterations << " iterations:\n";
+    {
+        condition_data<int> ping(0), pong(0);
+        auto samples = ping_pong(iterations,
+                                 [&]() { ping.send_ready(1); pong.wait_for_ready(); },
+                                 [&]() { ping.wait_for_ready(); pong.send_ready(1); });
+        report("condition_data (mutex + condition variable)", samples);
+    }
+    {
+        counting_event ping(0, 0), pong(0, 0);
+        auto samples = ping_pong(iterations,
+                                 [&]() { ping.post(); pong.wait_for_ready(); },
+                                 [&]() { ping.wait_for_ready(); pong.post(); });
+        report("counting_event, no spinning (futex only)", samples);
+    }
+    {
+        counting_event ping, pong;
+        auto samples = ping_pong(iterations,
+                                 [&]() { ping.post(); pong.wait_for_ready(); },
+                                 [&]() { ping.wait_for_ready(); pong.post(); });
+        report("counting_event, spin then futex", samples);
+    }
+    {
+        // The answer comes on one of two events, waited on together
+        counting_event ping, pong, other;
+        Util::event_group group;
+        group.add(other);
+        group.add(pong);
+        auto samples = ping_pong(iterations,
+                                 [&]() { ping.post(); group.wait_for_any(); },
+                                 [&]() { ping.wait_for_ready(); pong.post(); });
+        report("event_group::wait_for_any() on two events", samples);
+    }
+
+    std::cout << "\nBursts of 64 items through a circular_buffer, " << iterations << " items:\n";
+    {
+        condition_data<int> event(0);
+        double ns = burst(iterations, event, [](Util::circular_buffer<int>& ringbuf, condition_data<int>& condvar)
+        {
+            // Puts can be merged into one wakeup: take all there is.
+            condvar.wait_for_ready();
+            int n = 0;
+            while (!ringbuf.empty())
+            {
+                ringbuf.get();
+                n++;
+            }
+            return n;
+        });
+        std::cout << "condition_data                                        " << std::setw(8) << ns << " ns per item\n";
+    }
+    {
+        counting_event event;
+        double ns = burst(iterations, event, [](Util::circular_buffer<int>& ringbuf, counting_event& countev)
+        {
+            countev.wait_for_ready();
+            ringbuf.get();
+            return 1;
+        });
+        std::cout << "counting_event                                        " << std::setw(8) << ns << " ns per item\n";
+    }
+
+    // wait_for_ready() with a timeout, with nothing posted
+    {
+        counting_event event;
+        auto start = std::chrono::steady_clock::now();
+        bool taken = event.wait_for_ready(std::chrono::milliseconds(20));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "\ncounting_event::wait_for_ready(20ms) with no post: returned " << std::boolalpha << taken
+                  << " after " << elapsed.count() << " ms\n";
+    }
+    return 0;
+}
+
 // All threads, including main, output to this channel
 const char *logChannelName = "main_condition_data";
 
@@ -125,6 +299,12 @@ int main(int argc, const char *argv[])
 {
     using namespace Util;
 
+    if (argc > 1 && std::string(argv[1]) == "--latency")
+    {
+        int iterations = argc > 2 ? strtol(argv[2], NULL, 10) : 0;
+        return run_latency_benchmarks(iterations > 0 ? iterations : 100000);
+    }
+
     int numthreads = parse(argc, argv);
     // DEBUG   std::cerr << "Parse returned: " << numthreads << std::endl;
 
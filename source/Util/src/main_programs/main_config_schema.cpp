@@ -0,0 +1,227 @@
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <ConfigSchema.hpp>
+#include <ConfigTemplates.hpp>
+#include <json/json.h>
+#include <stdlib.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+
+// Checks of the json config layer that the apps' configs go through:
+//
+//   1) ConfigSchema<T>: required, optional and ranged values, choice() and
+//      each(), and the errors (missing, wrong type, out of range, not one of
+//      the choices) and unknown keys it reports.
+//   2) expandTemplates(): "extends" (also of a template by another one),
+//      ${key}, ${index} and ${member}, and the errors for unknown templates
+//      and cycles.
+//
+// Usage: main_config_schema
+//
+// Each check is listed with "ok" or "FAILED"; the exit code is EXIT_FAILURE
+// if any one failed.
+
+static int s_failures = 0;
+
+void check(bool passed, const std::string& what)
+{
+    std::cerr << (passed? "    ok      " : "    FAILED  ") << what << std::endl;
+    if (! passed)
+    {
+        s_failures++;
+    }
+}
+
+Json::Value parse(const std::string& text)
+{
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    std::string errors;
+    if (! reader->parse(text.data(), text.data() + text.size(), &root, &errors))
+    {
+        std::cerr << "Cannot parse the json of a check: " << errors << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return root;
+}
+
+// true if one of the strings contains part
+bool contains(const std::vector<std::string>& strings, const std::string& part)
+{
+    for (const auto& str : strings)
+    {
+        if (str.find(part) != std::string::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+enum class mode { slow, fast };
+
+struct camera_config
+{
+    std::string device;
+    int fps = 30;
+};
+
+struct app_config
+{
+    std::string level;
+    unsigned rate_limit = 10;
+    mode speed = mode::slow;
+    std::map<std::string, camera_config> cameras;
+};
+
+Config::ConfigSchema<app_config> make_schema()
+{
+    Config::ConfigSchema<camera_config> camera;
+    camera.required(".device", &camera_config::device)
+          .optional(".fps", &camera_config::fps, 1, 120);
+
+    Config::ConfigSchema<app_config> schema;
+    schema.required(".Logger.level", &app_config::level)
+          .optional(".Logger.rate-limit", &app_config::rate_limit, 0U, 1000U)
+          .choice(".Logger.speed", &app_config::speed, { { "slow", mode::slow }, { "fast", mode::fast } }, false)
+          .each(".Cameras", &app_config::cameras, camera);
+    return schema;
+}
+
+void check_schema()
+{
+    const Config::ConfigSchema<app_config> schema = make_schema();
+
+    std::cerr << "\nConfigSchema:" << std::endl;
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({
+            "Logger": { "level": "INFO", "rate-limit": 20, "speed": "fast" },
+            "Cameras": { "cam0": { "device": "/dev/video0", "fps": 60 }, "cam1": { "device": "/dev/video1" } } })"), cfg);
+        check(report.ok() && report.unknown_keys.empty(), "a valid config loads without errors");
+        check(cfg.level == "INFO" && cfg.rate_limit == 20 && cfg.speed == mode::fast, "values are stored in the fields");
+        check(cfg.cameras.size() == 2 && cfg.cameras["cam0"].fps == 60 && cfg.cameras["cam1"].device == "/dev/video1",
+              "each() loads every member of the object");
+        check(cfg.cameras["cam1"].fps == 30, "a missing optional value keeps its default");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "rate-limit": 5 }, "Cameras": {} })"), cfg);
+        check(! report.ok() && contains(report.errors, ".Logger.level: missing"), "a missing required value is an error");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "level": "INFO", "rate-limit": "ten" }, "Cameras": {} })"), cfg);
+        check(! report.ok() && contains(report.errors, ".Logger.rate-limit: expected"), "a value of the wrong type is an error");
+        check(cfg.rate_limit == 10, "a value in error leaves the field as it was");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "level": "INFO", "rate-limit": 5000 }, "Cameras": {} })"), cfg);
+        check(! report.ok() && contains(report.errors, "out of range [0, 1000]"), "a value out of range is an error");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "level": "INFO", "speed": "warp" }, "Cameras": {} })"), cfg);
+        check(! report.ok() && contains(report.errors, ".Logger.speed: \"warp\" is not one of \"slow\" \"fast\""),
+              "a choice() value which is not one of the choices is an error");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "level": "INFO" }, "Cameras": { "cam0": { "fps": 500 } } })"), cfg);
+        check(contains(report.errors, ".Cameras.cam0.device: missing") && contains(report.errors, ".Cameras.cam0.fps: 500 is out of range"),
+              "errors in each() members have the member's path");
+    }
+    {
+        app_config cfg;
+        Config::SchemaReport report = schema.load(parse(R"({ "Logger": { "level": "INFO", "levle": "DBUG" },
+            "Cameras": { "cam0": { "device": "/dev/video0", "fsp": 25 } } })"), cfg);
+        check(report.ok(), "unknown keys are not errors");
+        check(report.unknown_keys.size() == 2 && contains(report.unknown_keys, ".Logger.levle") && contains(report.unknown_keys, ".Cameras.cam0.fsp"),
+              "unknown keys are reported, in nested objects too");
+    }
+}
+
+void check_templates()
+{
+    std::cerr << "\nexpandTemplates:" << std::endl;
+    {
+        Json::Value root = parse(R"({
+            "Templates": {
+                "camera": { "device-name": "/dev/video${index}", "fps": 30,
+                            "output-process": "ffmpeg -i pipe:0 ${key}.mp4 # ${device-name} $HOME ${unknown}" },
+                "fast-camera": { "extends": "camera", "fps": 60 }
+            },
+            "Cameras": {
+                "cam0": { "extends": "camera" },
+                "cam1": { "extends": "fast-camera", "device-name": "/dev/video7" }
+            } })");
+        std::stringstream logstream;
+        bool expanded = Config::expandTemplates(root, logstream);
+        check(expanded && logstream.str().empty(), "templates expand without errors");
+        check(! root.isMember("Templates"), "the Templates object is removed");
+        check(! root["Cameras"]["cam0"].isMember("extends"), "the extends member is removed");
+
+        const Json::Value& cam0 = root["Cameras"]["cam0"];
+        const Json::Value& cam1 = root["Cameras"]["cam1"];
+        check(cam0["device-name"].asString() == "/dev/video0" && cam0["fps"].asInt() == 30, "${index} is the position of the object");
+        check(cam0["output-process"].asString() == "ffmpeg -i pipe:0 cam0.mp4 # /dev/video0 $HOME ${unknown}",
+              "${key} and ${member} expand, other variables are left as they are");
+        check(cam1["fps"].asInt() == 60, "a template can extend another one");
+        check(cam1["device-name"].asString() == "/dev/video7" && cam1["output-process"].asString() == "ffmpeg -i pipe:0 cam1.mp4 # /dev/video7 $HOME ${unknown}",
+              "the object's own members replace the template's, also in ${member}");
+    }
+    {
+        Json::Value root = parse(R"({ "Templates": {}, "Cameras": { "cam0": { "extends": "kamera" } } })");
+        std::stringstream logstream;
+        check(! Config::expandTemplates(root, logstream) && logstream.str().find("kamera") != std::string::npos,
+              "an unknown template is an error");
+    }
+    {
+        Json::Value root = parse(R"({ "Templates": { "a": { "extends": "b" }, "b": { "extends": "a" } },
+            "Cameras": { "cam0": { "extends": "a" } } })");
+        std::stringstream logstream;
+        check(! Config::expandTemplates(root, logstream) && ! logstream.str().empty(), "templates which extend each other are an error");
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc > 1)
+    {
+        std::cerr << "Usage:    " << argv[0] << "\n\nChecks ConfigSchema and the json config templates." << std::endl;
+        return 1;
+    }
+
+    check_schema();
+    check_templates();
+
+    std::cerr << "\n" << (s_failures == 0? "All checks passed" : std::to_string(s_failures) + " check(s) FAILED") << std::endl;
+    return s_failures == 0? EXIT_SUCCESS : EXIT_FAILURE;
+}
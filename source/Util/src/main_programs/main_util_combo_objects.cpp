@@ -234,6 +234,38 @@ int main(int argc, const char *argv[])
     shared_ptr_uint8_data_t sp_alt_reference2 = shared_uint8_data_t::create(sp_alt_reference->_begin(), sp_alt_reference->num_items());
     checkDataItem(sp_alt_reference2);
 
+    printHeader("Checking create_borrowed() and slice() - no copies of the data");
+    {
+        // i.e. a buffer that belongs to a driver, given back when the last user is done
+        bool released = false;
+        shared_ptr_uint8_data_t sp_borrowed = shared_uint8_data_t::create_borrowed(reference_item.data(), reference_item.num_items(),
+                                                                [&released](uint8_t *) { released = true; });
+        std::cout << "borrowed object shares the reference data: "
+                  << Utility::stringify_bool(sp_borrowed->data() == reference_item.data()) << std::endl;
+
+        // i.e. the planes of a frame: each can be queued and dropped on its own
+        size_t half = sp_borrowed->num_items() / 2;
+        shared_ptr_uint8_data_t sp_first = sp_borrowed->slice(0, half);
+        shared_ptr_uint8_data_t sp_second = sp_borrowed->slice(half);
+        sp_borrowed.reset();
+        std::cout << "released after the borrowed object is dropped (slices still exist): "
+                  << Utility::stringify_bool(released) << std::endl;
+
+        printdata("first half (slice)", *sp_first->get_data_item_container());
+        printdata("second half (slice)", *sp_second->get_data_item_container());
+
+        size_t sum = 0;
+        for (uint8_t item : sp_second->span().subspan(1))
+        {
+            sum += item;
+        }
+        std::cout << "sum of the second half, but for its first item: " << sum << std::endl;
+
+        sp_first.reset();
+        sp_second.reset();
+        std::cout << "released after the slices are dropped: " << Utility::stringify_bool(released) << std::endl;
+    }
+
 
 /////////////////////////////////////////////////////////
 #if 0
@@ -0,0 +1,224 @@
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <Utility.hpp>
+#include <Format.hpp>
+#include <stdlib.h>
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares the Utility string functions which copy their results into new
+// std::strings with the std::string_view ones, on the kind of strings that
+// they see at run time:
+//
+//   1) Splitting a control message of the server ("filename|bytecount|...")
+//      with split() (a std::vector of std::string), split_view() (lazy, no
+//      allocation) and split_to() (into a std::array of views).
+//   2) Splitting a longer line, against a plain byte by byte search.
+//   3) trim() against trim_view() and trim_in_place().
+//   4) replace_all() against replace_all_in_place().
+//   5) Putting together a response of the server ("OK|3|tests/output...|1234|crc"),
+//      with std::to_string() and operator+, std::ostringstream, stringFormat()
+//      and Util::format() (Format.hpp), and Util::format_to() into a stack buffer.
+//
+// Usage: main_util_strings [ iterations ]     (default is 1000000)
+
+void Usage(std::ostream& strm, std::string command)
+{
+    strm << "Usage:    " << command << " [ iterations ]\n\n" <<
+            "iterations defaults to 1000000.\n" << std::endl;
+}
+
+// Keeps the compiler from dropping the work being measured
+static volatile size_t s_sink = 0;
+
+// Runs fn iterations times, returns the average ns per call
+template <typename Fn>
+double run(int iterations, Fn fn)
+{
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        sink += fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    s_sink = s_sink + sink;
+    return elapsed.count() / iterations;
+}
+
+void report(const char* name, double ns)
+{
+    std::string label(name);
+    label.resize(std::max<size_t>(label.size() + 1, 48), ' ');
+    std::cerr << "    " << label << ns << " ns" << std::endl;
+}
+
+int main(int argc, const char *argv[])
+{
+    using namespace Util;
+
+    if (argc > 1 && (std::string(argv[1]) == "--help" ||
+                     std::string(argv[1]) == "-h" ||
+                     std::string(argv[1]) == "help"))
+    {
+        Usage(std::cerr, argv[0]);
+        return 1;
+    }
+
+    int iterations = (argc > 1) ? strtol(argv[1], NULL, 10) : 1000000;
+    if (iterations <= 0)
+    {
+        Usage(std::cerr, argv[0]);
+        return 1;
+    }
+
+    // The first message of a ranged upload, and a line with many fields
+    const std::string message("video_capture_cam0_20230412.data|268435456|134217728|536870912|17");
+    std::string line;
+    for (int i = 0; i < 64; i++)
+    {
+        line += "field_" + std::to_string(i) + (i < 63? "|" : "");
+    }
+    const std::string padded("   \t  /dev/video0   \t ");
+    const std::string command("ffmpeg -nostdin -y -f h264 -i  pipe:0 -vcodec copy video_capture.mp4");
+
+    std::cerr << iterations << " iterations, average per call:" << std::endl;
+
+    std::cerr << "\nsplit() of a control message (" << message.size() << " bytes, 5 fields):" << std::endl;
+    report("split() (vector of strings)", run(iterations, [&]()
+    {
+        return Utility::split(message, "|")[1].size();
+    }));
+    report("split_view()", run(iterations, [&]()
+    {
+        size_t size = 0;
+        for (std::string_view field : Utility::split_view(message, '|'))
+        {
+            size += field.size();
+        }
+        return size;
+    }));
+    report("split_to()", run(iterations, [&]()
+    {
+        std::array<std::string_view, 5> fields;
+        return Utility::split_to(message, '|', fields) + fields[1].size();
+    }));
+
+    std::cerr << "\nsplit() of a line (" << line.size() << " bytes, 64 fields):" << std::endl;
+    report("split() (vector of strings)", run(iterations / 10, [&]()
+    {
+        return Utility::split(line, "|").size();
+    }));
+    report("byte by byte search (for comparison)", run(iterations / 10, [&]()
+    {
+        size_t count = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            if (line[i] == '|')
+            {
+                count += i - start;
+                start = i + 1;
+            }
+        }
+        return count + line.size() - start;
+    }));
+    report("split_view(), char delimiter", run(iterations / 10, [&]()
+    {
+        size_t count = 0;
+        for (std::string_view field : Utility::split_view(line, '|'))
+        {
+            count += field.size();
+        }
+        return count;
+    }));
+
+    std::cerr << "\ntrim() of \"" << padded << "\":" << std::endl;
+    report("trim()", run(iterations, [&]()
+    {
+        return Utility::trim(padded).size();
+    }));
+    report("trim_view()", run(iterations, [&]()
+    {
+        return Utility::trim_view(padded).size();
+    }));
+    std::string trimmed;
+    report("trim_in_place() (includes the copy)", run(iterations, [&]()
+    {
+        trimmed = padded;
+        Utility::trim_in_place(trimmed);
+        return trimmed.size();
+    }));
+
+    std::cerr << "\nreplace_all() of \"video_capture\" in \"" << command << "\":" << std::endl;
+    report("replace_all()", run(iterations, [&]()
+    {
+        return Utility::replace_all(command, "video_capture", "cam0").size();
+    }));
+    std::string replaced;
+    report("replace_all_in_place() (includes the copy)", run(iterations, [&]()
+    {
+        replaced = command;
+        Utility::replace_all_in_place(replaced, "video_capture", "cam0");
+        return replaced.size();
+    }));
+
+    std::cerr << "\nA server response, \"" << Util::format(UTIL_FMT("OK|{}|{}|{}|{:08x}"), 3, message, 268435456, 0xbadcafeU)
+              << "\":" << std::endl;
+    report("std::to_string() and operator+", run(iterations, [&]()
+    {
+        char hex[16];
+        snprintf(hex, sizeof(hex), "%08x", 0xbadcafeU);
+        return (std::string("OK|") + std::to_string(3) + "|" + message + "|" + std::to_string(268435456) + "|" + hex).size();
+    }));
+    report("std::ostringstream", run(iterations, [&]()
+    {
+        std::ostringstream strm;
+        strm << "OK|" << 3 << "|" << message << "|" << 268435456 << "|" << std::hex << std::setw(8) << std::setfill('0') << 0xbadcafeU;
+        return strm.str().size();
+    }));
+    report("Utility::stringFormat()", run(iterations, [&]()
+    {
+        return Utility::stringFormat("OK|%d|%s|%d|%08x", 3, message.c_str(), 268435456, 0xbadcafeU).size();
+    }));
+    report("Util::format()", run(iterations, [&]()
+    {
+        return Util::format(UTIL_FMT("OK|{}|{}|{}|{:08x}"), 3, message, 268435456, 0xbadcafeU).size();
+    }));
+    report("Util::format_to() (stack buffer)", run(iterations, [&]()
+    {
+        char buf[128];
+        return Util::format_to(buf, sizeof(buf), UTIL_FMT("OK|{}|{}|{}|{:08x}"), 3, message, 268435456, 0xbadcafeU);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+
+/////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2023 Andrew Kelly
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <thread_placement.hpp>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sstream>
+
+using namespace Util;
+
+bool Util::parse_cpu_list(const std::string& list, cpu_set_t& cpus)
+{
+    CPU_ZERO(&cpus);
+    std::stringstream strm(list);
+    std::string range;
+    while (std::getline(strm, range, ','))
+    {
+        const char* start = range.c_str();
+        char* end = nullptr;
+        long first = strtol(start, &end, 10);
+        if (end == start)
+        {
+            return false;
+        }
+        long last = first;
+        if (*end == '-')
+        {
+            start = end + 1;
+            last = strtol(start, &end, 10);
+            if (end == start)
+            {
+                return false;
+            }
+        }
+        while (*end == ' ' || *end == '\n')
+        {
+            end++;
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    return CPU_COUNT(&cpus) > 0;
+}
+
+std::string Util::format_cpu_list(const cpu_set_t& cpus)
+{
+    std::string list;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (! CPU_ISSET(cpu, &cpus))
+        {
+            continue;
+        }
+        int last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &cpus))
+        {
+            last++;
+        }
+        if (! list.empty())
+        {
+            list += ',';
+        }
+        list += std::to_string(cpu);
+        if (last > cpu)
+        {
+            list += '-' + std::to_string(last);
+        }
+        cpu = last;
+    }
+    return list;
+}
+
+std::string Util::cpus_except(const std::vector<std::string>& lists)
+{
+    cpu_set_t cpus;
+    if (::pthread_getaffinity_np(::pthread_self(), sizeof(cpus), &cpus) != 0)
+    {
+        return std::string();
+    }
+    for (const std::string& list : lists)
+    {
+        cpu_set_t excluded;
+        if (parse_cpu_list(list, excluded))
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            {
+                if (CPU_ISSET(cpu, &excluded)) CPU_CLR(cpu, &cpus);
+            }
+        }
+    }
+    return format_cpu_list(cpus);
+}
+
+bool Util::place_thread(pthread_t thread, const std::string& name, const thread_placement& placement, std::string& error)
+{
+    std::ostringstream errors;
+    int ret = 0;
+
+    if (! name.empty())
+    {
+        // The kernel keeps 15 characters (and the terminating 0)
+        if ((ret = ::pthread_setname_np(thread, name.substr(0, 15).c_str())) != 0)
+        {
+            errors << "pthread_setname_np: " << strerror(ret) << "; ";
+        }
+    }
+
+    if (! placement.cpus.empty())
+    {
+        cpu_set_t cpus;
+        if (! parse_cpu_list(placement.cpus, cpus))
+        {
+            errors << "\"" << placement.cpus << "\" is not a list of cpus; ";
+        }
+        else if ((ret = ::pthread_setaffinity_np(thread, sizeof(cpus), &cpus)) != 0)
+        {
+            errors << "pthread_setaffinity_np(" << placement.cpus << "): " << strerror(ret) << "; ";
+        }
+    }
+
+    if (placement.fifo_priority > 0)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = placement.fifo_priority;
+        if ((ret = ::pthread_setschedparam(thread, SCHED_FIFO, &param)) != 0)
+        {
+            errors << "SCHED_FIFO priority " << placement.fifo_priority << ": " << strerror(ret)
+                   << (ret == EPERM ? " (needs CAP_SYS_NICE or ulimit -r)" : "") << "; ";
+        }
+    }
+
+    error = errors.str();
+    if (! error.empty())
+    {
+        error.erase(error.size() - 2);      // the last "; "
+    }
+    return error.empty();
+}
@@ -25,7 +25,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <Utility.hpp>
-#include <condition_data.hpp>
+#include <counting_event.hpp>
+#include <buffer_pool.hpp>
 #include <shared_data_items.hpp>
 #include <vidcap_profiler_thread.hpp>
 #include <LoggerCpp/LoggerCpp.h>
@@ -46,8 +47,7 @@ namespace VideoCapture {
     {
     public:
         frame_worker_thread_base(std::string label, size_t elements_in_ring_buffer = 100)
-            : m_condvar(0)
-            , m_ringbuf(elements_in_ring_buffer)
+            : m_ringbuf(elements_in_ring_buffer)
             , m_label(label)
             , m_terminated(false)
             , splogger(Util::UtilLogger::getLoggerPtr())
@@ -61,7 +61,7 @@ namespace VideoCapture {
         virtual void add_buffer_to_queue(Util::shared_ptr_uint8_data_t) = 0;
 
     public:
-        Util::condition_data<int> m_condvar;
+        Util::counting_event m_event;            // one post per buffer in m_ringbuf
         Util::circular_buffer<Util::shared_ptr_uint8_data_t> m_ringbuf;
         std::string m_label;
         bool m_terminated;
@@ -81,13 +81,20 @@ namespace VideoCapture {
 
         static void add_buffer_to_raw_queue(void *p, size_t bsize);
 
+        // Applies vcGlobals::frame_buffer_policy: resolves the NUMA node, binds the
+        // calling thread to it (main calls this before it starts the capture threads,
+        // which inherit the binding) and sets up s_pool. Returns false if the NUMA
+        // binding failed. What was done is described in info.
+        static bool setup_frame_buffers(std::string& info);
+
         static void register_worker_thread(std::thread *workerthread);
         static void register_worker(frame_worker_thread_base *worker);
 
         static std::mutex capture_queue_mutex;
         static bool s_terminated;
-        static Util::condition_data<int> s_condvar;
+        static Util::counting_event s_event;     // kick-start, then one post per buffer in s_ringbuf
         static Util::circular_buffer<Util::shared_ptr_uint8_data_t> s_ringbuf;
+        static std::shared_ptr<Util::buffer_pool> s_pool;   // null: the frames are new[]'ed
 
         // pointers to all std::threads started by the raw queue object (this->)
         static std::vector<std::thread *> s_workerthreads;
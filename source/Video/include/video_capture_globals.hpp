@@ -27,12 +27,18 @@
 #include <json/json.h>
 #include <Utility.hpp>
 #include <MainLogger.hpp>
+#include <buffer_pool.hpp>
+#include <thread_placement.hpp>
 #include <unistd.h>
 #include <stdio.h>
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 namespace Video
 {
@@ -54,8 +60,12 @@ namespace Video
         static bool use_other_proc;
         static Log::Log::Level loglevel;
         static std::string log_level;
+        static bool log_async;
+        static std::string log_binary_file;
+        static unsigned log_rate_limit;
+        static unsigned log_sample_one_in;
         static bool profiling_enabled;
-        static int  profile_timeslice_ms;
+        static std::atomic<int> profile_timeslice_ms;     // Changes with the json file while running (see setup_config_hot_reload())
         static bool profile_logprint_enabled;
         static bool capture_finished;
         static std::string config_file_name;
@@ -74,6 +84,20 @@ namespace Video
         static std::string redir_filename;
         static bool test_suspend_resume;
 
+        // Frame buffer memory of the interface in use ("buffers" in its json frame-capture section)
+        static Util::buffer_policy frame_buffer_policy;
+        static std::string frame_buffer_numa;       // "none", "device", or a node number
+
+        // Thread placement ("Threads" in the json file), by role: "capture", "queue", "workers", "profiler"
+        static std::map<std::string, Util::thread_placement> thread_placements;
+        static const std::vector<std::string> thread_roles;
+
+        // Names thread (for top -H, perf and gdb), and applies the placement of its
+        // role. The workers stay off the capture and queue cpus unless they have cpus
+        // of their own. The placement is logged, as a warning if a part could not be
+        // applied (returns false): the thread runs anyway.
+        static bool place_thread(std::thread& thread, const std::string& role, const std::string& name);
+
         // Indexed by enum pxl_formats values
         // has a string description for each enum value
         // See /usr/include/linux/videodev2.h
@@ -84,21 +108,81 @@ namespace Video
         // set, and after the plugin has been loaded.
         static void print_globals(std::ostream&);
 
+        // "off", "transparent" or "explicit" (as in the json file)
+        static const char* huge_pages_name(Util::huge_pages pages);
+
         static FILE * create_runtime_conf_output_file(const std::string& cmdline);
         static size_t write_to_runtime_conf_file(FILE *filestream, const std::string& infostring);
     };
 
+    struct video_config;
+
     struct pixel_format
     {
+        // Add the pixel formats the json config describes for its preferred
+        // interface: the config updateInternalConfigsWithJsonValues() loaded
+        // (false if there is none yet), or cfg.
         static bool pixfmt_setup(void);
-        static bool pixfmt_setup(const Json::Value& cfg_root);
+        static bool pixfmt_setup(const video_config& cfg);
         static std::string pixfmt_description(std::string pixfmtname);
         static void displayPixelFormatConfig(std::ostream& ostrm);
         static std::map<std::string, std::string> s_pixformat;
         static bool s_pix_initialized;
         static std::string s_video_interface;
+        static std::shared_ptr<const video_config> s_config;
+    };
+
+    // The json config file, as bound by the schema in loadVideoConfig().
+    // Optional values default to the ones in vcGlobals.
+    struct video_config
+    {
+        struct pixel_format_config
+        {
+            std::string format_description;
+            std::string output_process;
+        };
+
+        struct frame_capture_config
+        {
+            std::string name;
+            std::string device_name;
+            std::string preferred_pixel_format;
+            std::string plugin_file_name;
+            std::map<std::string, pixel_format_config> pixel_formats;
+            Util::huge_pages huge_pages = Util::huge_pages::off;
+            std::string numa_node = "none";
+        };
+
+        // "Logger"
+        std::string log_channel_name;
+        std::string log_file_name;
+        std::string log_level;
+        bool log_async = false;
+        std::string log_binary_file;
+        unsigned log_rate_limit = 10;
+        unsigned log_sample_one_in = 100;
+
+        // "App-options"
+        std::string output_file;
+        bool write_to_file = false;
+        bool write_to_process = false;
+        bool profiling = false;
+        int profile_timeslice_ms = 800;
+
+        // "Video"
+        std::string preferred_interface;
+        int frame_count = 0;
+        std::map<std::string, frame_capture_config> frame_capture;
+
+        // "Threads"
+        std::map<std::string, Util::thread_placement> threads;
     };
 
+    // Loads and checks the json config: types, ranges, the selected interface
+    // and pixel format, and unknown keys (which are only reported). Returns
+    // false, with the errors written to strm, if the config cannot be used.
+    bool loadVideoConfig(std::ostream& strm, const Json::Value& cfg_root, video_config& cfg);
+
     // This function overwrites values in Video::vcGlobals with content from
     // the json config file.
     bool updateInternalConfigsWithJsonValues(std::ostream& strm, const Json::Value& cfg_root);
@@ -44,7 +44,7 @@ void VideoCapture::test_raw_capture_ctl(std::string argv0)
     int i = 0;
 
     std::shared_ptr<Log::Logger> uloggerp = Util::UtilLogger::getLoggerPtr();
-    uloggerp->debug() << argv0 << ": In test_raw_capture_ctl: thread running";
+    LOGGER_DEBUG(*uloggerp) << argv0 << ": In test_raw_capture_ctl: thread running";
 
     VideoCapture::video_plugin_base *ifptr = VideoCapture::video_plugin_base::interface_ptr;
 
@@ -68,14 +68,14 @@ void VideoCapture::test_raw_capture_ctl(std::string argv0)
     int slp = suspend_resume_test::sleep_seconds;
     for (i = 1; i <= 10 && !ifptr->isterminated() && !suspend_resume_test::s_terminated; i++)
     {
-        uloggerp->debug() << "test_raw_capture_ctl: RESUMED/RUNNING: waiting " << slp << " seconds before pausing. Pass # " << i;
+        LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: RESUMED/RUNNING: waiting " << slp << " seconds before pausing. Pass # " << i;
         ::sleep(slp);  if (ifptr->isterminated()) { break; }
-        uloggerp->debug() << "test_raw_capture_ctl: PAUSING CAPTURE: " << i;
+        LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: PAUSING CAPTURE: " << i;
         if (ifptr) ifptr->set_paused(true);
 
-        uloggerp->debug() << "test_raw_capture_ctl: PAUSED: waiting " << slp << " seconds before resuming. Pass # " << i;
+        LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: PAUSED: waiting " << slp << " seconds before resuming. Pass # " << i;
         ::sleep(slp);  if (ifptr->isterminated()) { break; }
-        uloggerp->debug() << "test_raw_capture_ctl: RESUMING CAPTURE: " << i;
+        LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: RESUMING CAPTURE: " << i;
         if (ifptr) ifptr->set_paused(false);
     }
 
@@ -86,11 +86,11 @@ void VideoCapture::test_raw_capture_ctl(std::string argv0)
     else
     {
         suspend_resume_test::set_terminated(true);
-        uloggerp->debug() << "test_raw_capture_ctl: other threads terminated. TERMINATING AFTER " << i << " PASSES...";
+        LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: other threads terminated. TERMINATING AFTER " << i << " PASSES...";
         return;
     }
 
-    uloggerp->debug() << "test_raw_capture_ctl: FINISH CAPTURE REQUEST...";
+    LOGGER_DEBUG(*uloggerp) << "test_raw_capture_ctl: FINISH CAPTURE REQUEST...";
     suspend_resume_test::set_terminated(true);
     if (ifptr) ifptr->set_terminated(true);
 }
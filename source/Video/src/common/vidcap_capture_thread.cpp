@@ -71,7 +71,7 @@ void VideoCapture::video_capture(std::string cmdline)
 
         if (video_plugin_base::s_terminated)
         {
-            loggerp->info() << "Video Capture thread: Terminated before start of streaming...";
+            LOGGER_INFO(*loggerp) << "Video Capture thread: Terminated before start of streaming...";
             return;
         }
         else
@@ -82,7 +82,7 @@ void VideoCapture::video_capture(std::string cmdline)
         }
     }
 
-    loggerp->debug() << "VideoCapture::video_capture: Running.";
+    LOGGER_DEBUG(*loggerp) << "VideoCapture::video_capture: Running.";
 
     // Find out which interface is configured (v4l2 or opencv)
     Json::Value& ref_root_copy = Config::ConfigSingleton::instance()->GetJsonRootCopyRef();
@@ -104,7 +104,7 @@ void VideoCapture::video_capture(std::string cmdline)
         }
         interfaceList += (itrkey + " ");
     }
-    loggerp->info() << interfaceList;
+    LOGGER_INFO(*loggerp) << interfaceList;
 
     // The above loop is equivalent to this:
     //
@@ -123,10 +123,10 @@ void VideoCapture::video_capture(std::string cmdline)
     }
     else
     {
-        loggerp->info() << "Video Capture thread: Using the " << interfaceName << " frame-grabber.";
+        LOGGER_INFO(*loggerp) << "Video Capture thread: Using the " << interfaceName << " frame-grabber.";
     }
 
-    loggerp->info() << "Video Capture thread: Running the " << videoInterface << " frame-grabber.";
+    LOGGER_INFO(*loggerp) << "Video Capture thread: Running the " << videoInterface << " frame-grabber.";
 
     // A pointer to the "new"ly created plugin exists here: video_plugin_base::interface_ptr
     // The new object was created in the plugin factory with new() of the default constructor.
@@ -137,8 +137,8 @@ void VideoCapture::video_capture(std::string cmdline)
         throw std::runtime_error(str);
     }
 
-    loggerp->debug() << "video_capture: kick-starting the queue operations.";
-    VideoCapture::video_capture_queue::s_condvar.send_ready(0, Util::condition_data<int>::NotifyEnum::All);
+    LOGGER_DEBUG(*loggerp) << "video_capture: kick-starting the queue operations.";
+    VideoCapture::video_capture_queue::s_event.post();
 
     ////////////////////////////////////////////////////////////////////
     // We have to wait until the plugin is loaded and initialized, and the
@@ -159,7 +159,7 @@ void VideoCapture::video_capture(std::string cmdline)
             throw std::runtime_error("video_capture(): Error creating runtime config detail output file. ");
         }
 
-        loggerp->info() << "\n\nDETAILED CURRENT RUNTIME CONFIGURATION DETAILS are written to " << Utility::string_enquote(Video::vcGlobals::runtime_config_output_file) << "\n\n";
+        LOGGER_INFO(*loggerp) << "\n\nDETAILED CURRENT RUNTIME CONFIGURATION DETAILS are written to " << Utility::string_enquote(Video::vcGlobals::runtime_config_output_file) << "\n\n";
         std::cerr << "\nDETAILED CURRENT RUNTIME CONFIGURATION DETAILS are written to " << Utility::string_enquote(Video::vcGlobals::runtime_config_output_file) << std::endl;
         Video::vcGlobals::write_to_runtime_conf_file(filestream, sstr.str());
     }
@@ -172,7 +172,7 @@ void VideoCapture::video_capture(std::string cmdline)
     ////////////////////////////////////////////////////////////////////
     if (Video::vcGlobals::test_suspend_resume)
     {
-        loggerp->debug() << "video_capture() thread: kick-starting the suspend_resume_tests operations.";
+        LOGGER_DEBUG(*loggerp) << "video_capture() thread: kick-starting the suspend_resume_tests operations.";
         suspend_resume_test::s_condvar.send_ready(0, Util::condition_data<int>::NotifyEnum::All);
     }
     // Start the video interface:
@@ -229,7 +229,7 @@ void VideoCapture::video_plugin_base::set_terminated(bool t)
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        if (loggerp) loggerp->debug() << "Setting profiler termination from video_plugin_base.";
+        if (loggerp) LOGGER_DEBUG(*loggerp) << "Setting profiler termination from video_plugin_base.";
         vidcap_profiler::set_terminated(true);
     }
 
@@ -254,7 +254,7 @@ void VideoCapture::video_plugin_base::set_base_paused(bool t)
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        if (loggerp) loggerp->debug() << "Setting profiler base pause to " << Utility::stringify_bool(t);
+        if (loggerp) LOGGER_DEBUG(*loggerp) << "Setting profiler base pause to " << Utility::stringify_bool(t);
         video_plugin_base::s_paused = t;
     }
 }
@@ -268,7 +268,7 @@ void VideoCapture::video_plugin_base::base_start_streaming(int framecount)
     std::lock_guard<std::mutex> lock(video_plugin_base::p_video_capture_mutex);
 
     Video::vcGlobals::set_framecount(framecount);
-    if (loggerp) loggerp->debug() << "Setting base start_streaming to " << framecount;
+    if (loggerp) LOGGER_DEBUG(*loggerp) << "Setting base start_streaming to " << framecount;
     video_plugin_base::s_start_streaming_frame_count = framecount;
 }
 
@@ -70,10 +70,9 @@ void VideoCapture::video_profiler()
 {
     Log::Logger logger = *(Util::UtilLogger::getLoggerPtr());
 
-    int slp = Video::vcGlobals::profile_timeslice_ms;   //milliseconds
     // TODO: I think this is a mistake:    profiler_frame::initialize();
 
-    logger.debug() << "video_profiler(): Profiler thread started...";
+    LOGGER_DEBUG(logger) << "video_profiler(): Profiler thread started...";
 
     // TODO: Get rid of the condition_data mechanism for the profiler.
 
@@ -83,18 +82,18 @@ void VideoCapture::video_profiler()
         std::lock_guard<std::mutex> lock(vidcap_profiler::profiler_mutex);
         if ((wt++ % 4) == 0)
         {
-            logger.debug() << "video_profiler(): Waiting for initialization...";
+            LOGGER_DEBUG(logger) << "video_profiler(): Waiting for initialization...";
         }
 
         if (profiler_frame::initialized) break;
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
-    logger.info() << "video_profiler(): Profiler thread: Done waiting for initialization: skipping first frame to establish a duration baseline.";
+    LOGGER_INFO(logger) << "video_profiler(): Profiler thread: Done waiting for initialization: skipping first frame to establish a duration baseline.";
 
     if (Video::vcGlobals::framecount < 100)
     {
-        logger.info() << "\n\nCAUTION: Profiling information for fewer than 100 frames is not logged.\n";
+        LOGGER_INFO(logger) << "\n\nCAUTION: Profiling information for fewer than 100 frames is not logged.\n";
     }
 
     while (!vidcap_profiler::s_terminated)
@@ -103,23 +102,25 @@ void VideoCapture::video_profiler()
         {
             if (profiler_frame::get_total_num_frames() < 100)
             {
-                logger.info() << "  ---  Profiler info not logged. Current count frames received is "
+                LOGGER_INFO(logger) << "  ---  Profiler info not logged. Current count frames received is "
                               << profiler_frame::get_total_num_frames();
             }
             else
             {
-                logger.info() << "  ---  Profiler info...";
-                logger.info() << "Shared pointers in the ring buffer: " << video_capture_queue::s_ringbuf.size();
-                logger.info() << "Total number of frames received: " << profiler_frame::get_total_num_frames();
-                logger.info() << "Number of frames received while paused: " << profiler_frame::get_paused_num_frames();
-                logger.info() << "Current avg frame rate (per second): " << profiler_frame::frames_per_second();
+                LOGGER_INFO(logger) << "  ---  Profiler info...";
+                LOGGER_INFO(logger) << "Shared pointers in the ring buffer: " << video_capture_queue::s_ringbuf.size();
+                LOGGER_INFO(logger) << "Total number of frames received: " << profiler_frame::get_total_num_frames();
+                LOGGER_INFO(logger) << "Number of frames received while paused: " << profiler_frame::get_paused_num_frames();
+                LOGGER_INFO(logger) << "Current avg frame rate (per second): " << profiler_frame::frames_per_second();
             }
         }
 
+        // Read on every pass: it follows changes to the json config file
+        int slp = Video::vcGlobals::profile_timeslice_ms.load(std::memory_order_relaxed);   //milliseconds
         std::this_thread::sleep_for(std::chrono::milliseconds(slp));
     }
 
-    logger.debug() << "Profiler thread terminating ...";
+    LOGGER_DEBUG(logger) << "Profiler thread terminating ...";
 }
 
 ///////////////////////////////////////////////////////////////////
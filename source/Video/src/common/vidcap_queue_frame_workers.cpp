@@ -24,6 +24,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <vidcap_queue_frame_workers.hpp>
+#include <LoggerCpp/BinaryLog.h>
 
 ///////////////////////////////////////////////////////////////////////
 // Member functions for the write-to-process class are in the
@@ -50,38 +51,41 @@ void VideoCapture::write2file_frame_worker::setup()
         set_terminated(true);
         return;
     }
-    splogger->debug() << "In write2file_frame_worker::setup(): Successfully opened file \"" << Video::vcGlobals::output_file << "\".";
+    LOGGER_DEBUG(*splogger) << "In write2file_frame_worker::setup(): Successfully opened file \"" << Video::vcGlobals::output_file << "\".";
 }
 
 void VideoCapture::write2file_frame_worker::run()
 {
-    splogger->debug() << "write2file_frame_worker::run(): thread is running....";
+    LOGGER_DEBUG(*splogger) << "write2file_frame_worker::run(): thread is running....";
 
     if (!initialized)
     {
         setup();
         initialized = true;
-        splogger->debug() << "write2file_frame_worker::run(): setup completed.";
+        LOGGER_DEBUG(*splogger) << "write2file_frame_worker::run(): setup completed.";
     }
 
     while (!m_terminated)
     {
-        m_condvar.wait_for_ready();
+        // One post for each frame put in the ring buffer
+        m_event.wait_for_ready();
 
-        while (!m_terminated && !m_ringbuf.empty())
+        // This shared_ptr serves all consumers of this particular video data buffer
+        auto sp_frame = m_ringbuf.get();
+        if (!sp_frame)
         {
-            // This shared_ptr serves all consumers of this particular video data buffer
-            auto sp_frame = m_ringbuf.get();
+            // Posted by set_terminated(), or the frame was dropped by a full ring buffer
+            continue;
+        }
 
-            size_t nbytes = write_frame_to_file(filestream, sp_frame);
-            assert (nbytes == sp_frame->num_items());
+        size_t nbytes = write_frame_to_file(filestream, sp_frame);
+        assert (nbytes == sp_frame->num_items());
 
-            //////////////////////////////////////////////////////////////////////
-            // Used in the code for DEBUG purposes only to simulate a heavy load.
-            // Do not un-comment it lightly.
-            // std::this_thread::sleep_for(std::chrono::milliseconds(40));
-            //////////////////////////////////////////////////////////////////////
-        }
+        //////////////////////////////////////////////////////////////////////
+        // Used in the code for DEBUG purposes only to simulate a heavy load.
+        // Do not un-comment it lightly.
+        // std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        //////////////////////////////////////////////////////////////////////
     }
     finish();
 }
@@ -93,13 +97,13 @@ void VideoCapture::write2file_frame_worker::finish()
 {
     using Util::Utility;
 
-    splogger->debug() << "write2file_frame_worker thread terminating ...";
+    LOGGER_DEBUG(*splogger) << "write2file_frame_worker thread terminating ...";
 
     // terminating: clear out the circular buffer queue
     while (!m_ringbuf.empty())
     {
         auto sp_frame = m_ringbuf.get();
-        splogger->debug() << "From queue (after terminate): Got buffer with " << sp_frame->num_items() << " bytes ";
+        LOGGER_BINARY(*splogger, Log::Log::eDebug, "From queue (after terminate): Got buffer with {} bytes ", sp_frame->num_items());
         size_t nbytes = write_frame_to_file(filestream, sp_frame);
         assert (nbytes == sp_frame->num_items());
 
@@ -121,22 +125,22 @@ void VideoCapture::write2file_frame_worker::set_terminated(bool t)
     m_terminated = t;
     video_capture_queue::set_terminated(t);
 
-    // Free up a potential wait on the condition variable
+    // Free up a potential wait on the event
     // so that the thread can be terminated (otherwise it may hang).
-    m_condvar.flush(0, Util::condition_data<int>::NotifyEnum::All);
+    m_event.post();
     if (t)
     {
-        splogger->debug() << "write2file_frame_worker: terminating...";
+        LOGGER_DEBUG(*splogger) << "write2file_frame_worker: terminating...";
     }
     else
     {
-        splogger->debug() << "write2file_frame_worker: termination set to FALSE...";
+        LOGGER_DEBUG(*splogger) << "write2file_frame_worker: termination set to FALSE...";
     }
 }
 
 void VideoCapture::write2file_frame_worker::add_buffer_to_queue(Util::shared_ptr_uint8_data_t sp)
 {
-    m_ringbuf.put(sp, m_condvar);
+    m_ringbuf.put(sp, m_event);
 }
 
 // Start up the process that will receive video frames in it's std input
@@ -155,7 +159,7 @@ FILE * VideoCapture::write2file_frame_worker::create_output_file()
     }
     else
     {
-        splogger->debug() << "Created/truncated output file \"" << Video::vcGlobals::output_file << "\"";
+        LOGGER_DEBUG(*splogger) << "Created/truncated output file \"" << Video::vcGlobals::output_file << "\"";
     }
     return output_stream;
 }
@@ -171,7 +175,7 @@ size_t VideoCapture::write2file_frame_worker
 
     if (byteswritten != sp_frame->num_items())
     {
-        splogger->error() << "VideoCapture::write_frame_to_file: fwrite returned a short count or 0 bytes written. Requested: " <<
+        UTIL_LOG_RATE_LIMITED(*splogger, Log::Log::eError) << "VideoCapture::write_frame_to_file: fwrite returned a short count or 0 bytes written. Requested: " <<
                              sp_frame->num_items() << ", got " << byteswritten << " bytes: " <<
                              Utility::get_errno_message(errnocopy);
     }
@@ -202,38 +206,41 @@ void VideoCapture::write2process_frame_worker::setup()
         set_terminated(true);
         return;
     }
-    splogger->debug() << "In write2process_frame_worker::setup(): Successfully started \"" << Video::vcGlobals::output_process << "\".";
+    LOGGER_DEBUG(*splogger) << "In write2process_frame_worker::setup(): Successfully started \"" << Video::vcGlobals::output_process << "\".";
 }
 
 void VideoCapture::write2process_frame_worker::run()
 {
-    splogger->debug() << "write2process_frame_worker::run(): thread is running....";
+    LOGGER_DEBUG(*splogger) << "write2process_frame_worker::run(): thread is running....";
 
     if (!initialized)
     {
         setup();
         initialized = true;
-        splogger->debug() << "write2process_frame_worker::run(): setup completed.";
+        LOGGER_DEBUG(*splogger) << "write2process_frame_worker::run(): setup completed.";
     }
 
     while (!m_terminated)
     {
-        m_condvar.wait_for_ready();
+        // One post for each frame put in the ring buffer
+        m_event.wait_for_ready();
 
-        while (!m_terminated && !m_ringbuf.empty())
+        // This shared_ptr serves all consumers of this particular video data buffer
+        auto sp_frame = m_ringbuf.get();
+        if (!sp_frame)
         {
-            // This shared_ptr serves all consumers of this particular video data buffer
-            auto sp_frame = m_ringbuf.get();
+            // Posted by set_terminated(), or the frame was dropped by a full ring buffer
+            continue;
+        }
 
-            size_t nbytes = write_frame_to_process(processstream, sp_frame);
-            assert (nbytes == sp_frame->num_items());
+        size_t nbytes = write_frame_to_process(processstream, sp_frame);
+        assert (nbytes == sp_frame->num_items());
 
-            //////////////////////////////////////////////////////////////////////
-            // Used in the code for DEBUG purposes only to simulate a heavy load.
-            // Do not un-comment it lightly.
-            // std::this_thread::sleep_for(std::chrono::milliseconds(40));
-            //////////////////////////////////////////////////////////////////////
-        }
+        //////////////////////////////////////////////////////////////////////
+        // Used in the code for DEBUG purposes only to simulate a heavy load.
+        // Do not un-comment it lightly.
+        // std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        //////////////////////////////////////////////////////////////////////
     }
     finish();
 }
@@ -245,13 +252,14 @@ void VideoCapture::write2process_frame_worker::finish()
 {
     using Util::Utility;
 
-    splogger->debug() << "write2process_frame_worker thread terminating ...";
+    LOGGER_DEBUG(*splogger) << "write2process_frame_worker thread terminating ...";
 
     // terminating: clear out the circular buffer queue
     while (!m_ringbuf.empty())
     {
         auto sp_frame = m_ringbuf.get();
-        splogger->debug() << "write2process_frame_worker::finish(): From queue (after terminate): Got buffer with " << sp_frame->num_items() << " bytes ";
+        LOGGER_BINARY(*splogger, Log::Log::eDebug, "write2process_frame_worker::finish(): From queue (after terminate): Got buffer with {} bytes ",
+                      sp_frame->num_items());
 
         size_t nbytes = write_frame_to_process(processstream, sp_frame);
         assert (nbytes == sp_frame->num_items());
@@ -263,7 +271,7 @@ void VideoCapture::write2process_frame_worker::finish()
         //////////////////////////////////////////////////////////////////////
     }
 
-    splogger->debug() << "Shutting down the process \""
+    LOGGER_DEBUG(*splogger) << "Shutting down the process \""
                    << Video::vcGlobals::output_process << "\" (fflush, pclose()): ";
     fflush(processstream);
     int errnocopy = 0;
@@ -283,23 +291,23 @@ void VideoCapture::write2process_frame_worker::set_terminated(bool t)
     m_terminated = t;
     video_capture_queue::set_terminated(t);
 
-    // Free up a potential wait on the condition variable
+    // Free up a potential wait on the event
     // so that the thread can be terminated (otherwise it may hang).
-    m_condvar.flush(0, Util::condition_data<int>::NotifyEnum::All);
+    m_event.post();
     if (t)
     {
-        splogger->debug() << "write2process_frame_worker: terminating...";
+        LOGGER_DEBUG(*splogger) << "write2process_frame_worker: terminating...";
     }
     else
     {
-        splogger->debug() << "write2process_frame_worker: termination set to FALSE...";
+        LOGGER_DEBUG(*splogger) << "write2process_frame_worker: termination set to FALSE...";
     }
 
 }
 
 void VideoCapture::write2process_frame_worker::add_buffer_to_queue(Util::shared_ptr_uint8_data_t sp)
 {
-    m_ringbuf.put(sp, m_condvar);
+    m_ringbuf.put(sp, m_event);
 }
 
 // Start up the process that will receive video frames in it's std input
@@ -324,7 +332,7 @@ FILE * VideoCapture::write2process_frame_worker::create_output_process()
         throw std::runtime_error("create_output_process: Got an empty process string.");
     }
 
-    splogger->debug() << "create_output_process: Starting output process:  " << Utility::string_enquote(actual_process);
+    LOGGER_DEBUG(*splogger) << "create_output_process: Starting output process:  " << Utility::string_enquote(actual_process);
 
     if ((output_stream = ::popen (actual_process.c_str(), "w")) == NULL)
     {
@@ -334,7 +342,7 @@ FILE * VideoCapture::write2process_frame_worker::create_output_process()
     }
     else
     {
-        splogger->debug() << "create_output_process: Started the process " << Utility::string_enquote(actual_process) << ".";
+        LOGGER_DEBUG(*splogger) << "create_output_process: Started the process " << Utility::string_enquote(actual_process) << ".";
     }
     return output_stream;
 }
@@ -350,7 +358,7 @@ size_t VideoCapture::write2process_frame_worker
 
     if (byteswritten != sp_frame->num_items())
     {
-        splogger->error() << "write_frame_to_process: fwrite returned a short count or 0 bytes written. Requested: " <<
+        UTIL_LOG_RATE_LIMITED(*splogger, Log::Log::eError) << "write_frame_to_process: fwrite returned a short count or 0 bytes written. Requested: " <<
                         sp_frame->num_items() << ", got " << byteswritten << " bytes: " <<
                         Utility::get_errno_message(errnocopy);
     }
@@ -31,12 +31,14 @@
 #include <ConfigSingleton.hpp>
 #include <Utility.hpp>
 #include <MainLogger.hpp>
+#include <LoggerCpp/BinaryLog.h>
 #include <thread>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <iostream>
+#include <sstream>
 #include <chrono>
 #include <vector>
 #include <algorithm>
@@ -56,8 +58,9 @@ using namespace VideoCapture;
 
 std::mutex video_capture_queue::capture_queue_mutex;
 bool video_capture_queue::s_terminated = false;
-Util::condition_data<int> video_capture_queue::s_condvar(0);
+Util::counting_event video_capture_queue::s_event;
 Util::circular_buffer<Util::shared_ptr_uint8_data_t> video_capture_queue::s_ringbuf(100);
+std::shared_ptr<Util::buffer_pool> video_capture_queue::s_pool;
 
 // pointers to all std::threads started by the raw queue object (this->)
 std::vector<std::thread *> video_capture_queue::s_workerthreads;
@@ -84,21 +87,21 @@ void VideoCapture::raw_buffer_queue_handler()
 
     auto loggerp = Util::UtilLogger::getLoggerPtr();
 
-    loggerp->debug() << "VideoCapture::raw_buffer_queue_handler: Waiting for kick-start...";
+    LOGGER_DEBUG(*loggerp) << "VideoCapture::raw_buffer_queue_handler: Waiting for kick-start...";
 
     if (video_capture_queue::s_terminated)
     {
-        loggerp->info() << "VideoCapture::raw_buffer_queue_handler: Terminated before start of streaming...";
+        LOGGER_INFO(*loggerp) << "VideoCapture::raw_buffer_queue_handler: Terminated before start of streaming...";
         return;
     }
     else
     {
         // Main is going to kick-start us to free this.
         // Wait for main() to signal us to start
-        video_capture_queue::s_condvar.wait_for_ready();
+        video_capture_queue::s_event.wait_for_ready();
     }
 
-    loggerp->debug() << "VideoCapture::raw_buffer_queue_handler: Running.";
+    LOGGER_DEBUG(*loggerp) << "VideoCapture::raw_buffer_queue_handler: Running.";
 
 
     // This for loop checks all the registered worker threads
@@ -111,7 +114,7 @@ void VideoCapture::raw_buffer_queue_handler()
         }
         else
         {
-            loggerp->debug() << "VideoCapture::raw_buffer_queue_handler(): found worker " <<
+            LOGGER_DEBUG(*loggerp) << "VideoCapture::raw_buffer_queue_handler(): found worker " <<
                                 Utility::string_enquote((*itr)->m_label);
         }
     }
@@ -123,38 +126,43 @@ void VideoCapture::raw_buffer_queue_handler()
     }
 
     /////////////////////////////////////////////////////////////////////
+    size_t frame_number = 0;
     while (!video_capture_queue::s_terminated)
     {
-        video_capture_queue::s_condvar.wait_for_ready();
+        // One post for each frame put in the ring buffer
+        video_capture_queue::s_event.wait_for_ready();
 
-        while (!video_capture_queue::s_terminated && !video_capture_queue::s_ringbuf.empty())
+        // This shared_ptr serves all consumers of this particular video data buffer
+        auto sp_frame = video_capture_queue::s_ringbuf.get();
+        if (video_capture_queue::s_terminated || !sp_frame)
         {
-            // This shared_ptr serves all consumers of this particular video data buffer
-            auto sp_frame = video_capture_queue::s_ringbuf.get();
+            // Posted by set_terminated(), or the frame was dropped by a full ring buffer
+            continue;
+        }
+        LOGGER_BINARY(*loggerp, Log::Log::eDebug, "VideoCapture::raw_buffer_queue_handler(): frame {} with {} bytes to {} workers",
+                      ++frame_number, sp_frame->num_items(), video_capture_queue::s_workers.size());
 
-            // Go through all the registered worker threads and add
-            // the frame buffer to their queue.
-            for (auto itr = video_capture_queue::s_workers.begin();
-                            itr != video_capture_queue::s_workers.end(); itr++)
+        // Go through all the registered worker threads and add
+        // the frame buffer to their queue.
+        for (auto itr = video_capture_queue::s_workers.begin();
+                        itr != video_capture_queue::s_workers.end(); itr++)
+        {
+            if (! (*itr))
             {
-                if (! (*itr))
-                {
-                    // TODO: Should this be an exception?
-                    loggerp->error() << "VideoCapture::raw_buffer_queue_handler(): ERROR: null <worker*> object";
-                }
-                else
-                {
-                    // this call goes to the derived virtual worker object.
-                    // The buffer (shared ptr to it) is simply added to its queue.
-                    (*itr)->add_buffer_to_queue(sp_frame);
-                    // and... that's it for this buffer.
-                }
+                // TODO: Should this be an exception?
+                loggerp->error() << "VideoCapture::raw_buffer_queue_handler(): ERROR: null <worker*> object";
+            }
+            else
+            {
+                // this call goes to the derived virtual worker object.
+                // The buffer (shared ptr to it) is simply added to its queue.
+                (*itr)->add_buffer_to_queue(sp_frame);
+                // and... that's it for this buffer.
             }
-
         }
     }
 
-    loggerp->debug() << "Queue thread terminating ...";
+    LOGGER_DEBUG(*loggerp) << "Queue thread terminating ...";
 
 #if 0
     // terminating: clear out the circular buffer queue
@@ -187,9 +195,9 @@ void video_capture_queue::set_terminated(bool t)
 
     video_capture_queue::s_terminated = t;
 
-    // Free up a potential wait on the condition variable
+    // Free up a potential wait on the event
     // so that the thread can be terminated (otherwise it may hang).
-    VideoCapture::video_capture_queue::s_condvar.flush(0, Util::condition_data<int>::NotifyEnum::All);
+    VideoCapture::video_capture_queue::s_event.post();
 }
 
 // Note: this method runs on a different thread than the other methods in this object.
@@ -201,11 +209,80 @@ void video_capture_queue::add_buffer_to_raw_queue(void *p, size_t bsize)
     if (p != NULL)
     {
         uint8_t *up = static_cast<uint8_t*>(p);
-        auto sp = shared_uint8_data_t::create(up, bsize);
-        VideoCapture::video_capture_queue::s_ringbuf.put(sp, VideoCapture::video_capture_queue::s_condvar);
+        shared_ptr_uint8_data_t sp;
+        if (s_pool)
+        {
+            sp = s_pool->copy(up, bsize);   // null if out of (huge page) memory
+        }
+        if (!sp)
+        {
+            sp = shared_uint8_data_t::create(up, bsize);
+        }
+        VideoCapture::video_capture_queue::s_ringbuf.put(sp, VideoCapture::video_capture_queue::s_event);
     }
 }
 
+bool video_capture_queue::setup_frame_buffers(std::string& info)
+{
+    using Video::vcGlobals;
+
+    Util::buffer_policy& policy = vcGlobals::frame_buffer_policy;
+    std::ostringstream strm;
+    bool bound = true;
+
+    policy.numa_node = -1;
+    if (vcGlobals::frame_buffer_numa == "device")
+    {
+        policy.numa_node = Util::numa_device_node(vcGlobals::str_dev_name);
+        if (policy.numa_node < 0)
+        {
+            strm << "the NUMA node of " << vcGlobals::str_dev_name << " is not known (or there is one node): no NUMA binding; ";
+        }
+    }
+    else if (vcGlobals::frame_buffer_numa != "none")
+    {
+        // loadVideoConfig() checked that it is a number
+        policy.numa_node = std::stoi(vcGlobals::frame_buffer_numa);
+    }
+
+    if (policy.numa_node >= 0)
+    {
+        std::string error;
+        if (Util::numa_bind_current_thread(policy.numa_node, error))
+        {
+            strm << "capture threads and frame buffers on NUMA node " << policy.numa_node << "; ";
+        }
+        else
+        {
+            strm << "cannot bind to NUMA node " << policy.numa_node << ": " << error << "; ";
+            policy.numa_node = -1;
+            bound = false;
+        }
+    }
+
+    if (policy.pages == Util::huge_pages::off && policy.numa_node < 0)
+    {
+        strm << "frame buffers are allocated for each frame";
+    }
+    else
+    {
+        // Enough spare buffers for every frame the ring buffers can hold: the
+        // raw queue's, and those of the workers (register_worker() adds the
+        // workers that come later).
+        std::lock_guard<std::mutex> lock(video_capture_queue::capture_queue_mutex);
+        size_t ring_frames = s_ringbuf.capacity();
+        for (frame_worker_thread_base *worker : s_workers)
+        {
+            ring_frames += worker->m_ringbuf.capacity();
+        }
+        s_pool = Util::buffer_pool::create(policy, ring_frames);
+        strm << "frame buffers are reused from a pool, huge pages: " << vcGlobals::huge_pages_name(policy.pages);
+    }
+
+    info = strm.str();
+    return bound;
+}
+
 void video_capture_queue::register_worker_thread(std::thread *workerthread)
 {
     std::lock_guard<std::mutex> lock(video_capture_queue::capture_queue_mutex);
@@ -216,4 +293,8 @@ void video_capture_queue::register_worker(frame_worker_thread_base *worker)
 {
     std::lock_guard<std::mutex> lock(video_capture_queue::capture_queue_mutex);
     s_workers.push_back(worker);
+    if (s_pool)
+    {
+        s_pool->add_max_free(worker->m_ringbuf.capacity());
+    }
 }
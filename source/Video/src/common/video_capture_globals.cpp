@@ -25,6 +25,7 @@
 
 #include <video_capture_commandline.hpp>
 #include <ConfigSingleton.hpp>
+#include <ConfigSchema.hpp>
 #include <video_capture_globals.hpp>
 #include <vidcap_capture_thread.hpp>
 #include <Utility.hpp>
@@ -34,7 +35,10 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string>
 
 // Video::vcGlobals statics' definition
@@ -48,11 +52,15 @@ bool            Video::vcGlobals::display_runtime_config =      false;
 std::string     Video::vcGlobals::runtime_config_output_file =  Video::vcGlobals::logChannelName + "_runtime_config.txt";
 Log::Log::Level Video::vcGlobals::loglevel =                    Log::Log::Level::eNotice;
 std::string     Video::vcGlobals::log_level =                   Log::Log::toString(Video::vcGlobals::loglevel);
+bool            Video::vcGlobals::log_async =                   false;
+std::string     Video::vcGlobals::log_binary_file =             "";                                        // empty: per-frame logs are formatted into the log file
+unsigned        Video::vcGlobals::log_rate_limit =              10;                                        // UTIL_LOG_RATE_LIMITED() lines per second and call site
+unsigned        Video::vcGlobals::log_sample_one_in =           100;                                       // UTIL_LOG_SAMPLED() outputs 1 line in this many
 std::string     Video::vcGlobals::config_file_name =            Video::vcGlobals::logChannelName + ".json";
 bool            Video::vcGlobals::profiling_enabled =           false;
 bool            Video::vcGlobals::profile_logprint_enabled =    true;
 
-int             Video::vcGlobals::profile_timeslice_ms =        800;
+std::atomic<int> Video::vcGlobals::profile_timeslice_ms(800);
 
 // Video configuration
 std::string     Video::vcGlobals::video_grabber_name =          "v4l2";
@@ -65,6 +73,10 @@ std::string     Video::vcGlobals::str_plugin_file_name =        "./undefined.so"
 bool            Video::vcGlobals::proc_redir =                  true;
 std::string     Video::vcGlobals::redir_filename =              "/dev/null";
 bool            Video::vcGlobals::test_suspend_resume =         false;
+Util::buffer_policy Video::vcGlobals::frame_buffer_policy;                                                // new[]'ed, no NUMA node preference
+std::string     Video::vcGlobals::frame_buffer_numa =           "none";
+std::map<std::string, Util::thread_placement> Video::vcGlobals::thread_placements;                    // no names, default scheduling
+const std::vector<std::string> Video::vcGlobals::thread_roles = { "capture", "queue", "workers", "profiler" };
 
 
 // See /usr/include/linux/videodev2.h for the descriptive strings in the vector<>
@@ -81,6 +93,63 @@ std::vector<std::string> Video::vcGlobals::pixel_formats_strings ={         // i
 
 // static size_t framecount;
 // static std::string str_frame_count;
+const char* Video::vcGlobals::huge_pages_name(Util::huge_pages pages)
+{
+    switch (pages)
+    {
+    case Util::huge_pages::transparent:     return "transparent";
+    case Util::huge_pages::explicit_pages:  return "explicit";
+    default:                                return "off";
+    }
+}
+
+bool Video::vcGlobals::place_thread(std::thread& thread, const std::string& role, const std::string& name)
+{
+    Util::thread_placement placement;
+    auto itr = thread_placements.find(role);
+    if (itr != thread_placements.end())
+    {
+        placement = itr->second;
+    }
+    if (role == "workers" && placement.cpus.empty())
+    {
+        std::vector<std::string> taken;
+        for (const char* other : { "capture", "queue" })
+        {
+            auto pinned = thread_placements.find(other);
+            if (pinned != thread_placements.end() && ! pinned->second.cpus.empty())
+            {
+                taken.push_back(pinned->second.cpus);
+            }
+        }
+        if (! taken.empty())
+        {
+            placement.cpus = Util::cpus_except(taken);      // "" if no cpu is left: not pinned
+        }
+    }
+
+    std::string error;
+    bool placed = Util::place_thread(thread, name, placement, error);
+
+    std::ostringstream strm;
+    strm << "Thread " << name << " (" << role << "): cpus " << (placement.cpus.empty() ? "any" : placement.cpus);
+    if (placement.fifo_priority > 0)
+    {
+        strm << ", SCHED_FIFO priority " << placement.fifo_priority;
+    }
+
+    auto loggerp = Util::UtilLogger::getLoggerPtr();
+    if (placed)
+    {
+        loggerp->info() << strm.str();
+    }
+    else
+    {
+        loggerp->warning() << strm.str() << ": " << error;
+    }
+    return placed;
+}
+
 void Video::vcGlobals::set_framecount(int count)
 {
     Video::vcGlobals::framecount = count;
@@ -99,29 +168,26 @@ void Video::vcGlobals::set_framecount(std::string strcount)
 std::map<std::string,std::string> Video::pixel_format::s_pixformat;
 bool Video::pixel_format::s_pix_initialized = false;
 std::string Video::pixel_format::s_video_interface;
+std::shared_ptr<const Video::video_config> Video::pixel_format::s_config;
 
-// This method probes the JSON object for all the pixel formats
-// allowed in the preferred-interface selected in the "Video" section
-// of the JSON config file.
-bool Video::pixel_format::pixfmt_setup(const Json::Value& cfg_root)
+// This method adds all the pixel formats allowed in the preferred-interface
+// selected in the "Video" section of the (already loaded) JSON config.
+bool Video::pixel_format::pixfmt_setup(const video_config& cfg)
 {
-    using namespace Util;
-
-    s_video_interface = cfg_root["Config"]["Video"]["preferred-interface"].asString();
+    s_video_interface = cfg.preferred_interface;
 
-    Json::Value pixfmt = cfg_root["Config"]
-                                  ["Video"]
-                                   ["frame-capture"]
-                                    [s_video_interface]
-                                     ["pixel-format"];
+    // loadVideoConfig() checked that the preferred interface is there.
+    auto capture = cfg.frame_capture.find(s_video_interface);
+    if (capture == cfg.frame_capture.end())
+    {
+        return false;
+    }
 
-    for (auto itr = pixfmt.begin(); itr != pixfmt.end(); itr++)
+    for (const auto& pixfmt : capture->second.pixel_formats)
     {
-        std::string itrkey = itr.key().asString();
-        if (itrkey != "other")
+        if (pixfmt.first != "other")
         {
-            std::string fdesc = (*itr)["format-description"].asString();
-            s_pixformat[itrkey] = fdesc;
+            s_pixformat[pixfmt.first] = pixfmt.second.format_description;
         }
     }
 
@@ -137,8 +203,11 @@ bool Video::pixel_format::pixfmt_setup(const Json::Value& cfg_root)
 // overload
 bool Video::pixel_format::pixfmt_setup(void)
 {
-    Json::Value& Root = Config::ConfigSingleton::instance()->JsonRoot();
-    return Video::pixel_format::pixfmt_setup(Root);
+    if (! s_config)
+    {
+        return false;
+    }
+    return Video::pixel_format::pixfmt_setup(*s_config);
 }
 
 std::string Video::pixel_format::pixfmt_description(std::string pixfmtname)
@@ -161,95 +230,237 @@ void Video::pixel_format::displayPixelFormatConfig(std::ostream& ostrm)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+// function loadVideoConfig
+//////////////////////////////////////////////////////////////////////////////
+
+// Every key of the json config file that the app reads is bound here.
+static const Config::ConfigSchema<Video::video_config>& video_config_schema()
+{
+    using Video::video_config;
+    using Config::ConfigSchema;
+
+    static const ConfigSchema<video_config> schema = []
+    {
+        ConfigSchema<video_config::pixel_format_config> pixel_format;
+        pixel_format.required(".format-description", &video_config::pixel_format_config::format_description)
+                    .required(".output-process",     &video_config::pixel_format_config::output_process);
+
+        ConfigSchema<video_config::frame_capture_config> frame_capture;
+        frame_capture.required(".name",                   &video_config::frame_capture_config::name)
+                     .required(".device-name",            &video_config::frame_capture_config::device_name)
+                     .required(".preferred-pixel-format", &video_config::frame_capture_config::preferred_pixel_format)
+                     .required(".plugin-file-name",       &video_config::frame_capture_config::plugin_file_name)
+                     .each(".pixel-format",               &video_config::frame_capture_config::pixel_formats, pixel_format)
+                     .choice(".buffers.huge-pages",       &video_config::frame_capture_config::huge_pages,
+                             { { "off", Util::huge_pages::off },
+                               { "transparent", Util::huge_pages::transparent },
+                               { "explicit", Util::huge_pages::explicit_pages } }, false)
+                     .optional(".buffers.numa-node",      &video_config::frame_capture_config::numa_node);
+
+        ConfigSchema<Util::thread_placement> placement;
+        placement.optional(".cpus",          &Util::thread_placement::cpus)
+                 .optional(".fifo-priority", &Util::thread_placement::fifo_priority, 0, 99);
+
+        ConfigSchema<video_config> config;
+        config.required(".Config.Logger.channel-name",            &video_config::log_channel_name)
+              .required(".Config.Logger.file-name",               &video_config::log_file_name)
+              .required(".Config.Logger.log-level",               &video_config::log_level)
+              .optional(".Config.Logger.async",                   &video_config::log_async)
+              .optional(".Config.Logger.binary-file",             &video_config::log_binary_file)
+              .optional(".Config.Logger.rate-limit-per-sec",      &video_config::log_rate_limit)
+              .optional(".Config.Logger.sample-one-in",           &video_config::log_sample_one_in)
+              .required(".Config.App-options.output-file",        &video_config::output_file)
+              .required(".Config.App-options.write-to-file",      &video_config::write_to_file)
+              .required(".Config.App-options.write-to-process",   &video_config::write_to_process)
+              .required(".Config.App-options.profiling",          &video_config::profiling)
+              .optional(".Config.App-options.profile-timeslice-ms", &video_config::profile_timeslice_ms, 1, 3600 * 1000)
+              .required(".Config.Video.preferred-interface",      &video_config::preferred_interface)
+              .required(".Config.Video.frame-count",              &video_config::frame_count, 0, std::numeric_limits<int>::max())
+              .each(".Config.Video.frame-capture",                &video_config::frame_capture, frame_capture)
+              .each(".Config.Threads",                            &video_config::threads, placement, false);
+        return config;
+    }();
+
+    return schema;
+}
+
+bool Video::loadVideoConfig(std::ostream& strm, const Json::Value& cfg_root, video_config& cfg)
+{
+    Config::SchemaReport report = video_config_schema().load(cfg_root, cfg);
+
+    // Checks that involve more than one value
+    if (report.ok())
+    {
+        if (Util::UtilLogger::stringToEnumLoglevel(Util::Utility::trim(cfg.log_level)) < 0)
+        {
+            report.errors.push_back(".Config.Logger.log-level: \"" + cfg.log_level +
+                                    "\" is not one of \"DBUG\", \"INFO\", \"NOTE\", \"WARN\", \"EROR\", \"CRIT\"");
+        }
+
+        auto capture = cfg.frame_capture.find(cfg.preferred_interface);
+        if (capture == cfg.frame_capture.end())
+        {
+            report.errors.push_back(".Config.Video.preferred-interface: there is no \"" + cfg.preferred_interface +
+                                    "\" in .Config.Video.frame-capture");
+        }
+        else if (capture->second.pixel_formats.count(capture->second.preferred_pixel_format) == 0)
+        {
+            report.errors.push_back(".Config.Video.frame-capture." + cfg.preferred_interface +
+                                    ".preferred-pixel-format: there is no \"" + capture->second.preferred_pixel_format +
+                                    "\" in its pixel-format");
+        }
+
+        for (const auto& entry : cfg.frame_capture)
+        {
+            const std::string& node = entry.second.numa_node;
+            if (node != "none" && node != "device" &&
+                (node.empty() || node.size() > 4 || node.find_first_not_of("0123456789") != std::string::npos))
+            {
+                report.errors.push_back(".Config.Video.frame-capture." + entry.first + ".buffers.numa-node: \"" + node +
+                                        "\" is not \"none\", \"device\" or a node number");
+            }
+        }
+
+        for (const auto& entry : cfg.threads)
+        {
+            const auto& roles = Video::vcGlobals::thread_roles;
+            if (std::find(roles.begin(), roles.end(), entry.first) == roles.end())
+            {
+                report.errors.push_back(".Config.Threads." + entry.first + ": is not one of \"capture\", \"queue\", \"workers\", \"profiler\"");
+            }
+            cpu_set_t cpus;
+            if (! entry.second.cpus.empty() && ! Util::parse_cpu_list(entry.second.cpus, cpus))
+            {
+                report.errors.push_back(".Config.Threads." + entry.first + ".cpus: \"" + entry.second.cpus +
+                                        "\" is not a list of cpus (i.e. \"2\" or \"2-3,6\")");
+            }
+        }
+    }
+
+    strm << report;
+    return report.ok();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // function updateInternalConfigsWithJsonValues
 //////////////////////////////////////////////////////////////////////////////
 
 // This function overwrites values in Video::vcGlobals with content from
-// the json config file.
+// the json config file. The values are loaded (and checked) all at once by
+// loadVideoConfig(): errors are written to strm, and false is returned.
 //
 // We do not use std::endl here to avoid flushing subtleties at the end of each line.
-// We count on JsonCpp to throw an exception if the [] access to the node yields an error.
-// Caller should try/catch(std::exception)'s.
 bool Video::updateInternalConfigsWithJsonValues(std::ostream& strm, const Json::Value& cfg_root)
 {
     using namespace Util;
 
+    // Optional values keep their current settings when they are not in the file.
+    Video::video_config cfg;
+    cfg.log_async = Video::vcGlobals::log_async;
+    cfg.log_binary_file = Video::vcGlobals::log_binary_file;
+    cfg.log_rate_limit = Video::vcGlobals::log_rate_limit;
+    cfg.log_sample_one_in = Video::vcGlobals::log_sample_one_in;
+    cfg.profile_timeslice_ms = Video::vcGlobals::profile_timeslice_ms;
+
+    if (! Video::loadVideoConfig(strm, cfg_root, cfg))
+    {
+        return false;
+    }
+
+    // For pixel_format::pixfmt_setup(), once the plugin is loaded
+    Video::pixel_format::s_config = std::make_shared<const Video::video_config>(cfg);
+
     // TODO: This block has to move from here until after plugin_factory loads up the plugin
-    // Video::pixel_format::pixfmt_setup(cfg_root);
+    // Video::pixel_format::pixfmt_setup(cfg);
     // strm << "\nFrom JSON:  ";
     // Video::pixel_format::displayPixelFormatConfig(strm);
     // TODO: The above block has to move from here until after plugin_factory loads up the plugin
 
-    Video::vcGlobals::logChannelName = Utility::trim(cfg_root["Config"]["Logger"]["channel-name"].asString());
+    Video::vcGlobals::logChannelName = Utility::trim(cfg.log_channel_name);
     strm << "\nFrom JSON:  Set logger channel-name to: " << Video::vcGlobals::logChannelName;
 
     // logFilelName
-    Video::vcGlobals::logFilelName = Utility::trim(cfg_root["Config"]["Logger"]["file-name"].asString());
+    Video::vcGlobals::logFilelName = Utility::trim(cfg.log_file_name);
     strm << "\nFrom JSON:  Set logger file-name to: " << Video::vcGlobals::logFilelName;
 
     // loglevel and log_level
-    Video::vcGlobals::log_level = Utility::trim(cfg_root["Config"]["Logger"]["log-level"].asString());
+    Video::vcGlobals::log_level = Utility::trim(cfg.log_level);
     strm << "\nFrom JSON:  Set default logger log level to: " << Video::vcGlobals::log_level;
 
+    // Asynchronous logging (the capture threads never wait on the log file)
+    Video::vcGlobals::log_async = cfg.log_async;
+    strm << "\nFrom JSON:  Enable asynchronous logging: " << (Video::vcGlobals::log_async? "true" : "false");
+
+    // Binary file for the per-frame (LOGGER_BINARY) logs
+    Video::vcGlobals::log_binary_file = Utility::trim(cfg.log_binary_file);
+    strm << "\nFrom JSON:  Set binary log file to: " << Utility::string_enquote(Video::vcGlobals::log_binary_file);
+
+    // Per-frame and per-chunk log lines: rate limit per call site, and sampling
+    Video::vcGlobals::log_rate_limit = cfg.log_rate_limit;
+    strm << "\nFrom JSON:  Set log rate limit (lines per second per call site) to: " << Video::vcGlobals::log_rate_limit;
+    Video::vcGlobals::log_sample_one_in = cfg.log_sample_one_in;
+    strm << "\nFrom JSON:  Set log sampling (1 line in N) to: " << Video::vcGlobals::log_sample_one_in;
+
     // Enable writing raw video frames to output file
-    bool enable_write_to_file = !(cfg_root["Config"]["App-options"]["write-to-file"].asInt() == 0);
-    Video::vcGlobals::write_frames_to_file = enable_write_to_file;
-    strm << "\nFrom JSON:  Enable writing raw video frames to output file: " << (enable_write_to_file? "true" : "false");
+    Video::vcGlobals::write_frames_to_file = cfg.write_to_file;
+    strm << "\nFrom JSON:  Enable writing raw video frames to output file: " << (cfg.write_to_file? "true" : "false");
 
     // Raw video output file
-    Video::vcGlobals::output_file = Utility::trim(cfg_root["Config"]["App-options"]["output-file"].asString());
+    Video::vcGlobals::output_file = Utility::trim(cfg.output_file);
     strm << "\nFrom JSON:  Set raw video output file name to: " << Video::vcGlobals::output_file;
 
     // Enable writing raw video frames to process
-    bool enable_write_to_process = !(cfg_root["Config"]["App-options"]["write-to-process"].asInt() == 0);
-    Video::vcGlobals::write_frames_to_process = enable_write_to_process;
-    strm << "\nFrom JSON:  Enable writing raw video frames to process: " << (enable_write_to_process? "true" : "false");
+    Video::vcGlobals::write_frames_to_process = cfg.write_to_process;
+    strm << "\nFrom JSON:  Enable writing raw video frames to process: " << (cfg.write_to_process? "true" : "false");
 
     // Enable profiling operations
-    bool enable_profiling = !(cfg_root["Config"]["App-options"]["profiling"].asInt() == 0);
-    Video::vcGlobals::profiling_enabled = enable_profiling;
-    strm << "\nFrom JSON:  Enable profiling: " << (enable_profiling? "true" : "false");
+    Video::vcGlobals::profiling_enabled = cfg.profiling;
+    strm << "\nFrom JSON:  Enable profiling: " << (cfg.profiling? "true" : "false");
 
     // Milliseconds between profile snapshots
-    Video::vcGlobals::profile_timeslice_ms = cfg_root["Config"]["App-options"]["profile-timeslice-ms"].asInt();
+    Video::vcGlobals::profile_timeslice_ms = cfg.profile_timeslice_ms;
     strm << "\nFrom JSON:  Set milliseconds between profile snapshots to: " << Video::vcGlobals::profile_timeslice_ms;
 
     // video frame grabber
-    Video::vcGlobals::video_grabber_name = Utility::trim(cfg_root["Config"]["Video"]["preferred-interface"].asString());
+    Video::vcGlobals::video_grabber_name = Utility::trim(cfg.preferred_interface);
     strm << "\nFrom JSON:  Set default video-frame-grabber to: " << Video::vcGlobals::video_grabber_name;
 
     // video grabber frame count
-    int ct = cfg_root["Config"]["Video"]["frame-count"].asInt();
-    Video::vcGlobals::set_framecount(ct);
+    Video::vcGlobals::set_framecount(cfg.frame_count);
     strm << "\nFrom JSON:  Set number of frames to grab (framecount) to: " << Video::vcGlobals::framecount;
 
     ///////////// Specific video-grabber section (i.e. v4l2, opencv, etc) /////////////////
 
-    strm << "\nFrom JSON:  " << Video::vcGlobals::video_grabber_name << " is labeled as: "
-            << cfg_root["Config"]["Video"]["frame-capture"][Video::vcGlobals::video_grabber_name]["name"].asString();
+    // loadVideoConfig() checked that the preferred interface and its pixel format are there.
+    const Video::video_config::frame_capture_config& capture = cfg.frame_capture[cfg.preferred_interface];
+
+    strm << "\nFrom JSON:  " << Video::vcGlobals::video_grabber_name << " is labeled as: " << capture.name;
 
-    Video::vcGlobals::str_dev_name = cfg_root["Config"]
-                                              ["Video"]
-                                               ["frame-capture"]
-                                                [Video::vcGlobals::video_grabber_name]
-                                                 ["device-name"].asString();
+    Video::vcGlobals::str_dev_name = capture.device_name;
     strm << "\nFrom JSON:  Set " << Video::vcGlobals::video_grabber_name << " device name to " << Video::vcGlobals::str_dev_name;
 
     // plugin-file-name - Video::vcGlobals::str_plugin_file_name
-    Video::vcGlobals::str_plugin_file_name = cfg_root["Config"]
-                                                  ["Video"]
-                                                   ["frame-capture"]
-                                                    [Video::vcGlobals::video_grabber_name]
-                                                     ["plugin-file-name"].asString();
+    Video::vcGlobals::str_plugin_file_name = capture.plugin_file_name;
     strm << "\nFrom JSON:  Set grabber plugin file name to " << Video::vcGlobals::str_plugin_file_name;
 
+    // Frame buffer memory: the NUMA node is resolved when the capture starts
+    // (see video_capture_queue::setup_frame_buffers()), as the device can change on the command line.
+    Video::vcGlobals::frame_buffer_policy.pages = capture.huge_pages;
+    Video::vcGlobals::frame_buffer_numa = capture.numa_node;
+    strm << "\nFrom JSON:  Set frame buffer huge pages to " << Video::vcGlobals::huge_pages_name(capture.huge_pages)
+         << ", NUMA node to " << Video::vcGlobals::frame_buffer_numa;
+
+    // Thread placement: applied as each thread starts (see vcGlobals::place_thread())
+    Video::vcGlobals::thread_placements = cfg.threads;
+    for (const auto& entry : Video::vcGlobals::thread_placements)
+    {
+        strm << "\nFrom JSON:  Set " << entry.first << " thread cpus to " << Utility::string_enquote(entry.second.cpus)
+             << ", SCHED_FIFO priority to " << entry.second.fifo_priority;
+    }
+
     // Video::vcGlobals::pixel_fmt is either "h264" or "yuyv"
-    std::string pixelFormat = cfg_root["Config"]
-                                       ["Video"]
-                                        ["frame-capture"]
-                                         [Video::vcGlobals::video_grabber_name]
-                                          ["preferred-pixel-format"].asString();
+    const std::string& pixelFormat = capture.preferred_pixel_format;
     if (pixelFormat == "h264")
     {
         Video::vcGlobals::pixel_fmt = Video::pxl_formats::h264;
@@ -266,13 +477,7 @@ bool Video::updateInternalConfigsWithJsonValues(std::ostream& strm, const Json::
             << Video::vcGlobals::pixel_formats_strings[Video::vcGlobals::pixel_fmt];
 
     // Raw video output file
-    Video::vcGlobals::output_process = cfg_root["Config"]
-                                                ["Video"]
-                                                 ["frame-capture"]
-                                                  [Video::vcGlobals::video_grabber_name]
-                                                   ["pixel-format"]
-                                                    [pixelFormat]
-                                                     ["output-process"].asString();
+    Video::vcGlobals::output_process = capture.pixel_formats.at(pixelFormat).output_process;
     strm << "\nFrom JSON:  Set raw video output process command to: " << Video::vcGlobals::output_process;
 
     return true;
@@ -320,6 +525,34 @@ void Video::vcGlobals::print_globals(std::ostream& strm)
          << "    in json config:       Root[\"Config\"][\"Logger\"][\"log-level\"]\n"
          << "\n";
 
+    strm << "Asynchronous logging:     " << Utility::stringify_bool(vcGlobals::log_async) << "\n"
+         << "    command line flag(s): NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << "\n"
+         << "    in object:            vcGlobals::log_async\n"
+         << "    in json config:       Root[\"Config\"][\"Logger\"][\"async\"]\n"
+         << "\n";
+
+    strm << "Binary log file:          " << Utility::string_enquote(vcGlobals::log_binary_file)
+         << (vcGlobals::log_binary_file.empty()? " (per-frame logs go to the log file)" : "") << "\n"
+         << "    command line flag(s): NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << "\n"
+         << "    in object:            vcGlobals::log_binary_file\n"
+         << "    in json config:       Root[\"Config\"][\"Logger\"][\"binary-file\"]\n"
+         << "    decode with:          main_LoggerCpp_binary_log -decode <file>\n"
+         << "\n";
+
+    strm << "Log rate limit:           " << vcGlobals::log_rate_limit
+         << (vcGlobals::log_rate_limit == 0? " (no limit)" : " lines per second per call site") << "\n"
+         << "    command line flag(s): NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << "\n"
+         << "    in object:            vcGlobals::log_rate_limit\n"
+         << "    in json config:       Root[\"Config\"][\"Logger\"][\"rate-limit-per-sec\"]\n"
+         << "\n";
+
+    strm << "Log sampling:             1 line in " << vcGlobals::log_sample_one_in
+         << (vcGlobals::log_sample_one_in <= 1? " (no sampling)" : "") << "\n"
+         << "    command line flag(s): NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << "\n"
+         << "    in object:            vcGlobals::log_sample_one_in\n"
+         << "    in json config:       Root[\"Config\"][\"Logger\"][\"sample-one-in\"]\n"
+         << "\n";
+
     strm << "Enable profiling:         " << Utility::stringify_bool(vcGlobals::profiling_enabled) << ", " << vcGlobals::profile_timeslice_ms << " milliseconds per slice\n"
          << "    command line flag:    [ -pr [ timeslice_ms ] ]\n"
          << "    in object:            vcGlobals::profiling_enabled\n"
@@ -357,6 +590,24 @@ void Video::vcGlobals::print_globals(std::ostream& strm)
          << "    in json config:       Root[\"Config\"][\"Video\"][\"frame-count\"]\n"
          << "\n";
 
+    strm << "Thread placement:        ";
+    for (const std::string& role : vcGlobals::thread_roles)
+    {
+        auto itr = vcGlobals::thread_placements.find(role);
+        Util::thread_placement placement = (itr != vcGlobals::thread_placements.end() ? itr->second : Util::thread_placement());
+        strm << " " << role << " cpus " << Utility::string_enquote(placement.cpus);
+        if (placement.fifo_priority > 0)
+        {
+            strm << " (SCHED_FIFO " << placement.fifo_priority << ")";
+        }
+        strm << (role == vcGlobals::thread_roles.back() ? "\n" : ",");
+    }
+    strm << "    command line flag(s): NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << "\n"
+         << "    in object:            vcGlobals::thread_placements\n"
+         << "    in json config:       Root[\"Config\"][\"Threads\"][role][\"cpus\"]\n"
+         << "                          Root[\"Config\"][\"Threads\"][role][\"fifo-priority\"]\n"
+         << "\n";
+
     strm << "\nThe following section displays the runtime CONFIGURATION DETAILS OF \n"
          << "THE SPECIFIC PLUGIN which is already loaded and running at this time.\n\n"
          << "   For each item detailed below, the runtime value of the item is displayed,\n"
@@ -438,6 +689,16 @@ void Video::vcGlobals::print_globals(std::ostream& strm)
          << "    in json config:       frameRoot[\"device-name\"].asString(); \n"
          << "\n";
 
+    strm << "    Frame buffers:        huge pages " << Utility::string_enquote(huge_pages_name(vcGlobals::frame_buffer_policy.pages))
+         << ", NUMA node " << Utility::string_enquote(vcGlobals::frame_buffer_numa)
+         << (vcGlobals::frame_buffer_policy.numa_node >= 0 ? " (node " + std::to_string(vcGlobals::frame_buffer_policy.numa_node) + ")" : "") << "\n"
+         << "    command line flag:    NONE: can only be set in " << Utility::string_enquote(vcGlobals::logChannelName + ".json") << " before runtime.\n"
+         << "    in object:            vcGlobals::frame_buffer_policy\n"
+         << "                          vcGlobals::frame_buffer_numa\n"
+         << "    in json config:       frameRoot[\"buffers\"][\"huge-pages\"] \n"
+         << "                          frameRoot[\"buffers\"][\"numa-node\"] \n"
+         << "\n";
+
     strm << "    Current pixel format: " << Utility::string_enquote(frameRoot["preferred-pixel-format"].asString()) << " - description: " << vcGlobals::pixel_formats_strings[vcGlobals::pixel_fmt] << "\n"
          << "    command line flag:    [ -pf pixel-format ]\n"
          << "    in object:            vcGlobals::pixel_fmt (enum)\n"
@@ -493,7 +754,7 @@ FILE * Video::vcGlobals::create_runtime_conf_output_file(const std::string& cmdl
         return NULL;
     }
 
-    loggerp->debug() << "Created/truncated runtime config output file " << Utility::string_enquote(vcGlobals::output_file);
+    LOGGER_DEBUG(*loggerp) << "Created/truncated runtime config output file " << Utility::string_enquote(vcGlobals::output_file);
 
     char outstr[200];
     time_t t;
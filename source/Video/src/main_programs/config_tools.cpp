@@ -99,3 +99,76 @@ bool Config::setup_config_singleton(std::string& error_string,
     return true;
 }
 
+
+// Values which can change while the capture is running follow the json
+// file: each reload of the file (see ConfigSingleton::StartWatching()) calls
+// back for the ones that changed. Others need a restart to take effect.
+bool Config::setup_config_hot_reload(std::string& error_string)
+{
+    using Util::MainLogger;
+
+    // A file with an unusable value is not published: the current values stay.
+    Config::ConfigSingleton::SetValidator([](const Json::Value& root, std::ostream& logstream)
+    {
+        Video::video_config cfg;
+        if (! Video::loadVideoConfig(logstream, root, cfg))
+        {
+            return false;
+        }
+        // The values followed live have to be in the file.
+        const Json::Value& logger = root["Config"]["Logger"];
+        if (! logger["rate-limit-per-sec"].isUInt() || ! logger["sample-one-in"].isUInt())
+        {
+            logstream << "rate-limit-per-sec and sample-one-in have to be positive integers or 0.\n";
+            return false;
+        }
+        const Json::Value& timeslice = root["Config"]["App-options"]["profile-timeslice-ms"];
+        if (! timeslice.isInt() || timeslice.asInt() <= 0)
+        {
+            logstream << "profile-timeslice-ms (" << timeslice << ") has to be positive.\n";
+            return false;
+        }
+        return true;
+    });
+
+    Config::ConfigSingleton::Subscribe(".Config.Logger.log-level", [](const Json::Value& value, const JsonSnapshot&)
+    {
+        int level = Util::UtilLogger::stringToEnumLoglevel(Util::Utility::trim(value.asString()));
+        Util::UtilLogger::getLoggerPtr()->setLevel(static_cast<Log::Log::Level>(level));
+        Util::UtilLogger::getLoggerPtr()->notice() << "Config change: log level is now " << value.asString();
+    });
+    Config::ConfigSingleton::Subscribe(".Config.Logger.rate-limit-per-sec", [](const Json::Value& value, const JsonSnapshot&)
+    {
+        MainLogger::rate_limit_per_sec.store(value.asUInt(), std::memory_order_relaxed);
+        Util::UtilLogger::getLoggerPtr()->notice() << "Config change: log rate limit is now " << value.asUInt();
+    });
+    Config::ConfigSingleton::Subscribe(".Config.Logger.sample-one-in", [](const Json::Value& value, const JsonSnapshot&)
+    {
+        MainLogger::sample_one_in.store(value.asUInt(), std::memory_order_relaxed);
+        Util::UtilLogger::getLoggerPtr()->notice() << "Config change: log sampling is now 1 in " << value.asUInt();
+    });
+    Config::ConfigSingleton::Subscribe(".Config.App-options.profile-timeslice-ms", [](const Json::Value& value, const JsonSnapshot&)
+    {
+        Video::vcGlobals::profile_timeslice_ms.store(value.asInt(), std::memory_order_relaxed);
+        Util::UtilLogger::getLoggerPtr()->notice() << "Config change: profile timeslice is now " << value.asInt() << " ms";
+    });
+
+    std::stringstream strm;
+    bool watching = Config::ConfigSingleton::StartWatching(strm, [](bool published, const std::string& messages)
+    {
+        if (published)
+        {
+            Util::UtilLogger::getLoggerPtr()->info() << "Reloaded the json config file: " << messages;
+        }
+        else
+        {
+            Util::UtilLogger::getLoggerPtr()->warning() << "Ignored a change to the json config file: " << messages;
+        }
+    });
+
+    if (! watching)
+    {
+        error_string = strm.str();
+    }
+    return watching;
+}
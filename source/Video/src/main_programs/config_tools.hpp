@@ -34,5 +34,8 @@ namespace Config
     bool setup_config_singleton(std::string& restring,
                                 std::vector<std::string>& delayedLinesForLogger);
 
+    // Call after the logger is set up (the changes are logged).
+    bool setup_config_hot_reload(std::string& error_string);
+
 } // end of namespace Config
 
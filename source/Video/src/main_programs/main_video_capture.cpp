@@ -32,6 +32,7 @@
 #include <commandline.hpp>
 #include <Utility.hpp>
 #include <MainLogger.hpp>
+#include <LoggerCpp/BinaryLog.h>
 #include <config_tools.hpp>
 #include <ConfigSingleton.hpp>
 #include <vidcap_capture_thread.hpp>
@@ -194,19 +195,38 @@ int main(int argc, const char *argv[])
     setup_video_capture_logger(command_line_string, delayedLinesForLogger);
     std::shared_ptr<Log::Logger> uloggerp = Util::UtilLogger::getLoggerPtr();
 
+    // Changes to the json file (log level, profiling timeslice...) now apply
+    // while the capture runs. Without it, they take a restart as before.
+    std::string hot_reload_error;
+    if (! Config::setup_config_hot_reload(hot_reload_error))
+    {
+        uloggerp->warning() << "The json config file is not watched for changes: " << hot_reload_error;
+    }
+
     // TODO: This is going to the log regardless of --loginit:
     //                      if (vcGlobals::log_initialization_info)
 
     // DEBUG:  std::cerr << "\n\nFrom Plugin Factory: " << fromFactory << std::endl;
 
-    uloggerp->debug() << "\nFrom Plugin Factory:\n" << fromFactory;
+    LOGGER_DEBUG(*uloggerp) << "\nFrom Plugin Factory:\n" << fromFactory;
 
-    uloggerp->debug() << "\n" << ParseOutputString;
+    LOGGER_DEBUG(*uloggerp) << "\n" << ParseOutputString;
 
     /////////////////
     // Finally, get to work
     /////////////////
 
+    // Before any capture thread is started: they inherit the NUMA binding.
+    std::string frame_buffers_info;
+    if (video_capture_queue::setup_frame_buffers(frame_buffers_info))
+    {
+        uloggerp->info() << "Frame buffers: " << frame_buffers_info;
+    }
+    else
+    {
+        uloggerp->warning() << "Frame buffers: " << frame_buffers_info;
+    }
+
     std::thread queuethread;
     std::thread profilingthread;
     std::thread videocapturethread;
@@ -221,12 +241,14 @@ int main(int argc, const char *argv[])
         if (Video::vcGlobals::profiling_enabled)
         {
             profilingthread = std::thread(VideoCapture::video_profiler);
-            uloggerp->debug() << argv0 << ":  started video profiler thread";
+            vcGlobals::place_thread(profilingthread, "profiler", "vc_profiler");
+            LOGGER_DEBUG(*uloggerp) << argv0 << ":  started video profiler thread";
             profilingthread.detach();
         }
 
         // Start the thread which handles the queue of raw buffers that obtained from the video hardware.
         queuethread = std::thread(VideoCapture::raw_buffer_queue_handler);
+        vcGlobals::place_thread(queuethread, "queue", "vc_queue");
 
         /////////////////////////////////////////////////////////////////////////
         // Set up the queue thread consumer objects needed in this run.
@@ -240,6 +262,7 @@ int main(int argc, const char *argv[])
             // start the thread
             ff = new write2file_frame_worker(50);
             std::thread fileworkerthread(&write2file_frame_worker::run, std::ref(*ff));
+            vcGlobals::place_thread(fileworkerthread, "workers", "vc_file_worker");
             fileworkerthread.detach();
             video_capture_queue::register_worker_thread( &fileworkerthread );
         }
@@ -250,6 +273,7 @@ int main(int argc, const char *argv[])
             // start the thread
             fw = new write2process_frame_worker(100);
             std::thread processworkerthread(&write2process_frame_worker::run, std::ref(*fw));
+            vcGlobals::place_thread(processworkerthread, "workers", "vc_proc_worker");
             processworkerthread.detach();
             video_capture_queue::register_worker_thread( &processworkerthread );
         }
@@ -261,17 +285,18 @@ int main(int argc, const char *argv[])
         //  START THE VIDEO CAPTURE THREAD INTERFACE
         //
         /////////////////////////////////////////////////////////////////////
-        uloggerp->debug() << argv0 << ":  starting the video capture thread.";
+        LOGGER_DEBUG(*uloggerp) << argv0 << ":  starting the video capture thread.";
 
         videocapturethread = std::thread(VideoCapture::video_capture, command_line_string);
+        vcGlobals::place_thread(videocapturethread, "capture", "vc_capture");
         videocapturethread.detach();
-        uloggerp->debug() << argv0 << ":  kick-starting the video capture operations.";
+        LOGGER_DEBUG(*uloggerp) << argv0 << ":  kick-starting the video capture operations.";
         VideoCapture::video_plugin_base::s_condvar.send_ready(0, Util::condition_data<int>::NotifyEnum::All);
         ifptr->start_streaming(vcGlobals::framecount);
-        uloggerp->debug() << argv0 << ":  sent start_streaming indicator to driver.";
+        LOGGER_DEBUG(*uloggerp) << argv0 << ":  sent start_streaming indicator to driver.";
         ifptr->set_paused(false);
         ifptr->start_profiling();
-        uloggerp->debug() << argv0 << ":  kick-started the video_profiler operations.";
+        LOGGER_DEBUG(*uloggerp) << argv0 << ":  kick-started the video_profiler operations.";
 
         // Start the test for suspend/resume (-test-suspend-resume command line flag)
         if (vcGlobals::test_suspend_resume)
@@ -306,11 +331,11 @@ int main(int argc, const char *argv[])
 
         if (error_termination)
         {
-            uloggerp->debug() << "main_video_capture: ERROR: Video Capture thread terminating. Cleanup and terminate.";
+            LOGGER_DEBUG(*uloggerp) << "main_video_capture: ERROR: Video Capture thread terminating. Cleanup and terminate.";
         }
         else
         {
-            uloggerp->debug() << "main_video_capture: Video Capture thread is done. Cleanup and terminate.";
+            LOGGER_DEBUG(*uloggerp) << "main_video_capture: Video Capture thread is done. Cleanup and terminate.";
         }
     }
     catch (std::exception &exp)
@@ -360,9 +385,19 @@ int main(int argc, const char *argv[])
     // unload the plugin
     std::stringstream dstrm;
     plugin_factory.destroy_factory(dstrm);
-    uloggerp->info() << dstrm.str();
+    LOGGER_INFO(*uloggerp) << dstrm.str();
 
-    uloggerp->info() << "Terminating the logger.";
+    if (Log::Manager::getDroppedCount() > 0)
+    {
+        uloggerp->warning() << "Asynchronous logging dropped " << Log::Manager::getDroppedCount() << " log lines (queue full).";
+    }
+    if (Log::BinaryLog::getDroppedCount() > 0)
+    {
+        uloggerp->warning() << "Per-frame logging dropped " << Log::BinaryLog::getDroppedCount() << " log lines (thread buffer full).";
+    }
+    Config::ConfigSingleton::StopWatching();
+    Util::LogRateLimiter::report_suppressed();
+    LOGGER_INFO(*uloggerp) << "Terminating the logger.";
 
     // Terminate the Log Manager (destroy the Output objects)
     Log::Manager::terminate();
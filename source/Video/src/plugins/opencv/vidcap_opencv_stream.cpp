@@ -92,7 +92,7 @@ void vidcap_opencv_stream::initialize()
     std::string str = ostr.str();
 
     std::cerr << str << std::endl;
-    logger.info() << str;
+    LOGGER_INFO(logger) << str;
 
     cv::namedWindow("frame",1);
     for(;;)
@@ -150,7 +150,7 @@ void vidcap_opencv_stream::run()
 
         if (Video::vcGlobals::profiling_enabled)
         {
-            logger.debug() << "vidcap_opencv_stream::run() - kick-starting the video_profiler operations.";
+            LOGGER_DEBUG(logger) << "vidcap_opencv_stream::run() - kick-starting the video_profiler operations.";
             VideoCapture::vidcap_profiler::s_condvar.send_ready(0, Util::condition_data<int>::NotifyEnum::All);
         }
 
@@ -169,7 +169,7 @@ void vidcap_opencv_stream::run()
 
         if (Video::vcGlobals::profiling_enabled)
         {
-            logger.debug() << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
+            LOGGER_DEBUG(logger) << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
             VideoCapture::vidcap_profiler::set_terminated(true);
         }
 
@@ -181,11 +181,11 @@ void vidcap_opencv_stream::run()
                     "        ***** ERROR TERMINATION REQUESTED. *****\n"
                     "        ****************************************\n";
 
-                    logger.info() << msg;
+                    LOGGER_INFO(logger) << msg;
         }
         else
         {
-            logger.info() << "vidcap_opencv_stream: NORMAL TERMINATION REQUESTED";
+            LOGGER_INFO(logger) << "vidcap_opencv_stream: NORMAL TERMINATION REQUESTED";
             std::cerr << "NORMAL TERMINATION..." << std::endl;
         }
     }
@@ -216,7 +216,7 @@ void vidcap_opencv_stream::opencv_errno_exit(const char *s, int errnocopy)
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        logger.debug() << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
+        LOGGER_DEBUG(logger) << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
         VideoCapture::vidcap_profiler::set_terminated(true);
     }
 
@@ -240,7 +240,7 @@ void vidcap_opencv_stream::opencv_error_exit(const char *s)
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        logger.debug() << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
+        LOGGER_DEBUG(logger) << "vidcap_opencv_stream::run() - terminating the video_profiler thread.";
         VideoCapture::vidcap_profiler::set_terminated(true);
     }
 
@@ -253,7 +253,7 @@ void vidcap_opencv_stream::opencv_error_exit(const char *s)
 
 void vidcap_opencv_stream::opencv_exit(const char *s)
 {
-    logger.info() << "vidcap_opencv_stream: NORMAL TERMINATION REQUESTED";
+    LOGGER_INFO(logger) << "vidcap_opencv_stream: NORMAL TERMINATION REQUESTED";
     std::cerr << "NORMAL TERMINATION..." << std::endl;
     set_terminated(true);
 }
@@ -401,7 +401,7 @@ bool vidcap_opencv_stream::opencv_open_device(void)
                        << Video::vcGlobals::str_dev_name << ": errno=" << errnocopy << ": " << strerror(errnocopy);
         return false;
     }
-    logger.info() << "Device " << Video::vcGlobals::str_dev_name;
+    LOGGER_INFO(logger) << "Device " << Video::vcGlobals::str_dev_name;
 #endif // 0
     return true;
 }
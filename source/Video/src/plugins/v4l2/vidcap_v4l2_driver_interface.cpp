@@ -86,14 +86,14 @@ void vidcap_v4l2_driver_interface::initialize()
     {
         throw std::runtime_error("vidcap_v4l2_driver_interface: ERROR: found NULL logger pointer.");
     }
-    loggerp->debug() << "vidcap_v4l2_driver_interface: Initialized.";
+    LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface: Initialized.";
 
     std::string actual_process = this->set_popen_process_string();
     if (actual_process == "")
     {
         throw std::runtime_error("vidcap_v4l2_driver_interface: base popen() process string is empty.");
     }
-    loggerp->debug() << "vidcap_v4l2_driver_interface: Process popen() string is:  " << actual_process;
+    LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface: Process popen() string is:  " << actual_process;
 }
 
 void vidcap_v4l2_driver_interface::run()
@@ -102,7 +102,7 @@ void vidcap_v4l2_driver_interface::run()
     {
         throw std::runtime_error("vidcap_v4l2_driver_interface::run() ERROR: found NULL logger pointer.");
     }
-    loggerp->debug() << "vidcap_v4l2_driver_interface: Running.";
+    LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface: Running.";
 
     try {
         if (isterminated() || !v4l2if_open_device())
@@ -121,7 +121,7 @@ void vidcap_v4l2_driver_interface::run()
                 loggerp->error() << "vidcap_v4l2_driver_interface::run() - v4l2if_init_device() FAILED. Terminating...";
                 set_error_terminated(true);
             }
-            loggerp->debug() << "vidcap_v4l2_driver_interface::run() - v4l2if_init_device() SUCCEEDED.";
+            LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::run() - v4l2if_init_device() SUCCEEDED.";
         }
 
         if (isterminated() || !v4l2if_start_capturing())
@@ -130,7 +130,7 @@ void vidcap_v4l2_driver_interface::run()
             {
                 loggerp->error() << "vidcap_v4l2_driver_interface::run() - v4l2if_start_capturing() FAILED. Terminating...";
                 set_error_terminated(true);
-                loggerp->debug() << "vidcap_v4l2_driver_interface::run() - v4l2if_start_capturing() SUCCEEDED.";
+                LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::run() - v4l2if_start_capturing() SUCCEEDED.";
             }
         }
 
@@ -141,7 +141,7 @@ void vidcap_v4l2_driver_interface::run()
                 loggerp->error() << "vidcap_v4l2_driver_interface::run() - v4l2if_mainloop() FAILED. Terminating...";
                 set_error_terminated(true);
             }
-            loggerp->debug() << "vidcap_v4l2_driver_interface::run() - v4l2if_mainloop() SUCCEEDED.";
+            LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::run() - v4l2if_mainloop() SUCCEEDED.";
         }
 
         v4l2if_stop_capturing();
@@ -155,11 +155,11 @@ void vidcap_v4l2_driver_interface::run()
                     "        ****************************************\n"
                     "        ***** ERROR TERMINATION REQUESTED. *****\n"
                     "        ****************************************\n";
-                    loggerp->info() << msg;
+                    LOGGER_INFO(*loggerp) << msg;
         }
         else
         {
-            loggerp->info() << "vidcap_v4l2_driver_interface: NORMAL TERMINATION REQUESTED";
+            LOGGER_INFO(*loggerp) << "vidcap_v4l2_driver_interface: NORMAL TERMINATION REQUESTED";
             std::cerr << "NORMAL TERMINATION..." << std::endl;
         }
     }
@@ -188,7 +188,7 @@ void vidcap_v4l2_driver_interface::v4l2if_errno_exit(const char *s, int errnocop
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        loggerp->debug() << "vidcap_v4l2_driver_interface::run() - terminating the video_profiler thread.";
+        LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::run() - terminating the video_profiler thread.";
         VideoCapture::vidcap_profiler::set_terminated(true);
     }
 
@@ -212,7 +212,7 @@ void vidcap_v4l2_driver_interface::v4l2if_error_exit(const char *s)
 
     if (Video::vcGlobals::profiling_enabled)
     {
-        loggerp->debug() << "vidcap_v4l2_driver_interface::run() - terminating the video_profiler thread.";
+        LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::run() - terminating the video_profiler thread.";
         VideoCapture::vidcap_profiler::set_terminated(true);
     }
 
@@ -225,7 +225,7 @@ void vidcap_v4l2_driver_interface::v4l2if_error_exit(const char *s)
 
 void vidcap_v4l2_driver_interface::v4l2if_exit(const char *s)
 {
-    loggerp->info() << "vidcap_v4l2_driver_interface: NORMAL TERMINATION REQUESTED";
+    LOGGER_INFO(*loggerp) << "vidcap_v4l2_driver_interface: NORMAL TERMINATION REQUESTED";
     std::cerr << "NORMAL TERMINATION..." << std::endl;
     set_terminated(true);
 }
@@ -383,12 +383,12 @@ bool vidcap_v4l2_driver_interface::v4l2if_mainloop(void)
 
     for (int count = 0; video_plugin_base::s_start_streaming_frame_count == -1; count++)
     {
-        if ((count % 10) == 0) loggerp->debug() << "vidcap_v4l2_driver_interface::v4l2if_mainloop: Waiting for start-streaming call";
+        if ((count % 10) == 0) LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::v4l2if_mainloop: Waiting for start-streaming call";
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
     static int count = Video::vcGlobals::framecount;
-    loggerp->debug() << "vidcap_v4l2_driver_interface::v4l2if_mainloop: Frame count is " << count;
+    LOGGER_DEBUG(*loggerp) << "vidcap_v4l2_driver_interface::v4l2if_mainloop: Frame count is " << count;
 
     profiler_frame::initialize(true);  // resets the counters in the profiler (num frames, duration, etc)
 
@@ -399,7 +399,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_mainloop(void)
         if (Video::vcGlobals::framecount != 0 && count-- <= 0)
         {
             // count+1 below because of count-- above
-            loggerp->debug() << "In v4l2if_mainloop: end of loop, count = " << count+1;
+            LOGGER_DEBUG(*loggerp) << "In v4l2if_mainloop: end of loop, count = " << count+1;
             set_terminated(true);
             break;
         }
@@ -453,11 +453,11 @@ bool vidcap_v4l2_driver_interface::v4l2if_mainloop(void)
     {
         if (iserror_terminated())
         {
-            loggerp->info() << "v4l2if_mainloop: ERROR:  CAPTURE TERMINATION REQUESTED.";
+            LOGGER_INFO(*loggerp) << "v4l2if_mainloop: ERROR:  CAPTURE TERMINATION REQUESTED.";
         }
         else
         {
-            loggerp->info() << "v4l2if_mainloop: CAPTURE TERMINATION REQUESTED.";
+            LOGGER_INFO(*loggerp) << "v4l2if_mainloop: CAPTURE TERMINATION REQUESTED.";
         }
         return false;
     }
@@ -600,7 +600,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_uninit_device(void)
 
     case IO_METHOD_USERPTR:
         for (i = 0; i < numbufs; ++i)
-                free(buffers[i].start);
+                Util::free_pages(buffers[i].start, buffers[i].length, Video::vcGlobals::frame_buffer_policy);
         break;
     }
 
@@ -625,7 +625,7 @@ void vidcap_v4l2_driver_interface::v4l2if_cleanup_uninit_device(void)
 
     case IO_METHOD_USERPTR:
         for (i = 0; i < numbufs; ++i)
-            free(buffers[i].start);
+            Util::free_pages(buffers[i].start, buffers[i].length, Video::vcGlobals::frame_buffer_policy);
         break;
     }
 
@@ -769,19 +769,22 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_userp(unsigned int buffer_size)
         return false;
     }
 
+    // Page aligned, and backed by huge pages and/or on a NUMA node if the json config says so.
+    std::string backing;
     for (numbufs = 0; numbufs < 4; ++numbufs)
     {
         buffers[numbufs].length = buffer_size;
-        buffers[numbufs].start = malloc(buffer_size);
+        buffers[numbufs].start = Util::allocate_pages(buffer_size, Video::vcGlobals::frame_buffer_policy, &backing);
         errnocopy = errno;
         if (!buffers[numbufs].start)
         {
             std::stringstream ostr;
-            ostr << "v4l2if_init_userp: Allocating (malloc) " << (4* sizeof(*buffers));
+            ostr << "v4l2if_init_userp: Allocating (mmap) " << buffer_size;
             v4l2if_errno_exit(ostr.str().c_str(), errnocopy);
             return false;
         }
     }
+    LOGGER_DEBUG(*loggerp) << "v4l2if_init_userp: 4 buffers of " << buffer_size << " bytes, " << backing;
     return true;
 }
 
@@ -879,7 +882,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
                 errnocopy = errno;
                 if (errnocopy == EIO)
                 {
-                    loggerp->debug() << "v4l2if_init_device: Got EIO setting pixel format to h264 (VIDIOC_S_FMT ioctl)";
+                    LOGGER_DEBUG(*loggerp) << "v4l2if_init_device: Got EIO setting pixel format to h264 (VIDIOC_S_FMT ioctl)";
                 }
                 else
                 {
@@ -890,7 +893,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
                     return false;
                 }
             }
-            loggerp->debug() << "Set video format to (" << fmt.fmt.pix.width << " x " << fmt.fmt.pix.height
+            LOGGER_DEBUG(*loggerp) << "Set video format to (" << fmt.fmt.pix.width << " x " << fmt.fmt.pix.height
                            << "), pixel format is " << Video::vcGlobals::pixel_formats_strings[Video::vcGlobals::pixel_fmt];
 
         } else if (Video::vcGlobals::pixel_fmt ==  Video::pxl_formats::yuyv) {
@@ -904,7 +907,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
             {
                 if (errnocopy == EIO)
                 {
-                    loggerp->debug() << "v4l2if_init_device: Got EIO setting pixel format to yuyv (VIDIOC_S_FMT ioctl)";
+                    LOGGER_DEBUG(*loggerp) << "v4l2if_init_device: Got EIO setting pixel format to yuyv (VIDIOC_S_FMT ioctl)";
                 }
                 else
                 {
@@ -912,7 +915,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
                     return false;
                 }
             }
-            loggerp->debug() << "Set video format to (" << fmt.fmt.pix.width << " x " << fmt.fmt.pix.height
+            LOGGER_DEBUG(*loggerp) << "Set video format to (" << fmt.fmt.pix.width << " x " << fmt.fmt.pix.height
                            << "), pixel format is " << Video::vcGlobals::pixel_formats_strings[Video::vcGlobals::pixel_fmt];
         } else {
             /* Preserve original settings as set by v4l2-ctl for example */
@@ -937,7 +940,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
                 ostr << "v4l2 driver: frame: " << fmt.fmt.pix.width << " x " << fmt.fmt.pix.height;
                 std::string s = ostr.str();
                 std::cerr << s << std::endl;
-                loggerp->debug() << s;
+                LOGGER_DEBUG(*loggerp) << s;
             }
 
             std::string bfp;
@@ -959,12 +962,12 @@ bool vidcap_v4l2_driver_interface::v4l2if_init_device(void)
                      << std::hex << fmt.fmt.pix.pixelformat << " - " << bfp;
                 std::string s = ostr.str();
                 std::cerr << s << std::endl;
-                loggerp->debug() << s;
+                LOGGER_DEBUG(*loggerp) << s;
             }
         }
 
-        loggerp->debug() << "v4l2 driver: bytes required: " << fmt.fmt.pix.sizeimage;
-        loggerp->debug() << "v4l2 driver: I/O METHOD: " << string_io_methods[io];
+        LOGGER_DEBUG(*loggerp) << "v4l2 driver: bytes required: " << fmt.fmt.pix.sizeimage;
+        LOGGER_DEBUG(*loggerp) << "v4l2 driver: I/O METHOD: " << string_io_methods[io];
 
         // PLEASE NOTE:  The streaming method IO_METHOD_MMAP is the only one actually
         // tested.  Please do not use IO_METHOD_USERPTR or IO_METHOD_READ until they are tested.
@@ -1048,7 +1051,7 @@ bool vidcap_v4l2_driver_interface::v4l2if_open_device(void)
                        << Video::vcGlobals::str_dev_name << ": errno=" << errnocopy << ": " << strerror(errnocopy);
         return false;
     }
-    loggerp->info() << "Device " << Video::vcGlobals::str_dev_name;
+    LOGGER_INFO(*loggerp) << "Device " << Video::vcGlobals::str_dev_name;
     return true;
 }
 
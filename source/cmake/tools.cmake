@@ -35,6 +35,21 @@ endif()
 
 option(BUILD_SHARED_LIBS "Build using shared libraries" ON)
 
+# Lowest log level compiled into Release builds by the LOGGER_DEBUG() ... LOGGER_CRITIC()
+# macros of LoggerCpp (see LoggerCpp/Logger.h): the call sites of the lower levels are
+# removed from the targets passed to logger_min_level(). Debug builds keep all of them.
+set (LOGGER_MIN_LEVEL_RELEASE "INFO" CACHE STRING "Lowest log level compiled into Release builds (DBUG, INFO, NOTE, WARN, EROR or CRIT)")
+set_property (CACHE LOGGER_MIN_LEVEL_RELEASE PROPERTY STRINGS DBUG INFO NOTE WARN EROR CRIT)
+
+function (logger_min_level target)
+    set (levels DBUG INFO NOTE WARN EROR CRIT)
+    list (FIND levels "${LOGGER_MIN_LEVEL_RELEASE}" level)
+    if (level LESS 0)
+        message (FATAL_ERROR "Unknown LOGGER_MIN_LEVEL_RELEASE log level: ${LOGGER_MIN_LEVEL_RELEASE}")
+    endif()
+    target_compile_definitions (${target} PRIVATE $<$<CONFIG:Release>:LOGGER_MIN_LEVEL=${level}>)
+endfunction()
+
 set( TOOLS_INCLUDED:BOOL ON )
 
 set (EnetUtil_HEADERS         "${SampleRoot_DIR}/source/EnetUtil/include" )